@@ -0,0 +1,129 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_BOUNDED_QUEUE_H
+#define HEPMC_BOUNDED_QUEUE_H
+
+//////////////////////////////////////////////////////////////////////////
+// BoundedQueue: a fixed size, lock free queue for several producers and
+// several consumers
+//
+// The queue is a ring of cells, each with a sequence number which tells
+// whether the cell is free for the producer or full for the consumer of
+// a given turn around the ring (D. Vyukov's bounded MPMC queue).  A push
+// or pop claims its position with one compare-and-swap and never waits
+// for another thread; when the queue is full or empty it fails instead.
+//////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace HepMC {
+
+    //! BoundedQueue passes values between threads without locks
+
+    ///
+    /// \class  BoundedQueue
+    /// T must be copyable; the pipeline stages use pointers and small
+    /// structs.  The capacity is rounded up to a power of two.
+    ///
+    template <class T>
+    class BoundedQueue {
+
+    public:
+	/// a queue holding at least capacity values
+	explicit BoundedQueue( std::size_t capacity );
+
+	/// append x; false if the queue is full
+	bool try_push( const T& x );
+	/// remove the oldest value into x; false if the queue is empty
+	bool try_pop( T& x );
+
+	/// the number of values the queue can hold
+	std::size_t capacity() const { return m_mask + 1; }
+
+    private:
+	struct Cell {
+	    std::atomic<std::size_t> sequence;
+	    T                        value;
+	};
+
+	BoundedQueue( const BoundedQueue& ) = delete;
+	BoundedQueue& operator=( const BoundedQueue& ) = delete;
+
+    private:
+	std::unique_ptr<Cell[]>  m_cells;
+	std::size_t              m_mask;
+	// the two positions are written by different threads, so they are
+	// kept on different cache lines
+	char                     m_pad0[64];
+	std::atomic<std::size_t> m_push;
+	char                     m_pad1[64];
+	std::atomic<std::size_t> m_pop;
+	char                     m_pad2[64];
+    };
+
+    ///////////////////////////
+    // INLINES               //
+    ///////////////////////////
+
+    template <class T>
+    BoundedQueue<T>::BoundedQueue( std::size_t capacity )
+      : m_cells(), m_mask(1), m_push(0), m_pop(0)
+    {
+	while ( m_mask + 1 < capacity ) m_mask = 2 * m_mask + 1;
+	m_cells.reset( new Cell[m_mask + 1] );
+	for ( std::size_t i = 0; i <= m_mask; ++i ) {
+	    m_cells[i].sequence.store( i, std::memory_order_relaxed );
+	}
+    }
+
+    template <class T>
+    bool BoundedQueue<T>::try_push( const T& x )
+    {
+	std::size_t pos = m_push.load( std::memory_order_relaxed );
+	for ( ;; ) {
+	    Cell& cell = m_cells[pos & m_mask];
+	    std::size_t seq = cell.sequence.load( std::memory_order_acquire );
+	    if ( seq == pos ) {
+		// the cell is free in this turn: claim it
+		if ( m_push.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+		    cell.value = x;
+		    cell.sequence.store( pos + 1, std::memory_order_release );
+		    return true;
+		}
+	    } else if ( seq < pos ) {
+		// the cell still holds the value of the previous turn
+		return false;
+	    } else {
+		pos = m_push.load( std::memory_order_relaxed );
+	    }
+	}
+    }
+
+    template <class T>
+    bool BoundedQueue<T>::try_pop( T& x )
+    {
+	std::size_t pos = m_pop.load( std::memory_order_relaxed );
+	for ( ;; ) {
+	    Cell& cell = m_cells[pos & m_mask];
+	    std::size_t seq = cell.sequence.load( std::memory_order_acquire );
+	    if ( seq == pos + 1 ) {
+		// the cell is full in this turn: take it
+		if ( m_pop.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+		    x = cell.value;
+		    cell.sequence.store( pos + m_mask + 1, std::memory_order_release );
+		    return true;
+		}
+	    } else if ( seq < pos + 1 ) {
+		// nothing has been pushed here yet
+		return false;
+	    } else {
+		pos = m_pop.load( std::memory_order_relaxed );
+	    }
+	}
+    }
+
+} // HepMC
+
+#endif  // HEPMC_BOUNDED_QUEUE_H
+//--------------------------------------------------------------------------
@@ -10,12 +10,17 @@
 //////////////////////////////////////////////////////////////////////////
 //
 
+#include <cstddef>
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "HepMC/GenEvent.h"
 
 namespace HepMC {
 
+/// The comparisons below use the ones with a tolerance further down,
+/// without tolerance, and print the first differences to std::cerr.
 bool compareGenEvent( GenEvent*, GenEvent* );
 bool compareSignalProcessVertex( GenEvent*, GenEvent* );
 bool compareBeamParticles( GenEvent*, GenEvent* );
@@ -24,6 +29,45 @@ bool compareVertices( GenEvent*, GenEvent* );
 bool compareParticles( GenEvent*, GenEvent* );
 bool compareVertex( GenVertex* v1, GenVertex* v2 );
 
+/// one difference between two events, found by compareGenEvent
+/// with a tolerance
+struct GenEventDifference {
+    std::string object;  ///< "event", "particle" or "vertex"
+    int         barcode; ///< of the particle or vertex, 0 for the event
+    std::string field;   ///< the property which differs, e.g. "momentum"
+    std::string first;   ///< its value in the first event
+    std::string second;  ///< its value in the second event
+};
+
+/// Compare e1 and e2 without printing: the differences are appended to
+/// differences, up to max_differences of them (0 means all), and true
+/// is returned if there are none.
+/// Particles and vertices are matched by barcode, and the particles at
+/// a vertex are compared as sets of barcodes.  Floating point values
+/// a and b are equal if |a-b| <= tolerance*max(|a|,|b|); tolerance 0
+/// asks for identical values.
+bool compareGenEvent( const GenEvent& e1, const GenEvent& e2, double tolerance,
+                      std::vector<GenEventDifference>& differences,
+                      std::size_t max_differences = 0 );
+/// Compare the event information (numbers, scales, weights, units,
+/// cross section, heavy ion and pdf information, beams and signal vertex).
+bool compareEventInfo( const GenEvent& e1, const GenEvent& e2, double tolerance,
+                       std::vector<GenEventDifference>& differences,
+                       std::size_t max_differences = 0 );
+/// Compare the particles with the same barcodes.
+bool compareParticles( const GenEvent& e1, const GenEvent& e2, double tolerance,
+                       std::vector<GenEventDifference>& differences,
+                       std::size_t max_differences = 0 );
+/// Compare the vertices with the same barcodes.
+bool compareVertices( const GenEvent& e1, const GenEvent& e2, double tolerance,
+                      std::vector<GenEventDifference>& differences,
+                      std::size_t max_differences = 0 );
+
+/// one line per difference: object, barcode, field and both values,
+/// separated by tabs
+void printDifferences( const std::vector<GenEventDifference>& differences,
+                       std::ostream& ostr = std::cout );
+
 } // HepMC
 
 #endif  // HEPMC_COMPARE_GENEVENT_H
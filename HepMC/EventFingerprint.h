@@ -0,0 +1,67 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_EVENT_FINGERPRINT_H
+#define HEPMC_EVENT_FINGERPRINT_H
+
+//////////////////////////////////////////////////////////////////////////
+// EventFingerprint: a 128 bit hash of the content of a GenEvent
+//
+// Each vertex and particle is hashed on its own, including the barcodes
+// of the vertices it is attached to, and the hashes are added up.  Since
+// addition does not depend on the order, neither does the fingerprint:
+// events which differ only in the storage order of their vertices or of
+// the particles at a vertex have the same fingerprint.
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+namespace HepMC {
+
+    //! EventFingerprint identifies the content of an event
+
+    ///
+    /// \class  EventFingerprint
+    /// Returned by GenEvent::fingerprint() and parallel_fingerprint().
+    /// The fingerprint covers
+    ///  - the particles: barcode, PDG id, status, momentum, generated
+    ///    mass, flow, polarization and the barcodes of their vertices,
+    ///  - the vertices: barcode, position, id and weights,
+    ///  - the event: signal process id, event number, mpi, scale and
+    ///    couplings, random states, weight values, units, beam particle
+    ///    and signal vertex barcodes, cross section, heavy ion and pdf
+    ///    information.
+    /// Weight names are not included.
+    ///
+    /// With a tolerance t > 0, floating point values are rounded to the
+    /// nearest multiple of t before hashing, so that events differing by
+    /// rounding errors much smaller than t usually compare equal; values
+    /// close to a rounding boundary may still differ.  With t = 0 the
+    /// exact bit pattern is used (with -0 equal to 0).
+    ///
+    /// The fingerprint is the same on all platforms with 64 bit IEEE
+    /// doubles, and between serial and parallel computation.
+    ///
+    struct EventFingerprint {
+	std::uint64_t high;
+	std::uint64_t low;
+
+	bool operator==( const EventFingerprint& o ) const
+	{ return high == o.high && low == o.low; }
+	bool operator!=( const EventFingerprint& o ) const
+	{ return !( *this == o ); }
+	/// ordering, so that fingerprints can be sorted or used as map keys
+	bool operator<( const EventFingerprint& o ) const
+	{ return high < o.high || ( high == o.high && low < o.low ); }
+
+	/// 32 hexadecimal digits
+	std::string str() const;
+    };
+
+    /// write the 32 hexadecimal digits
+    std::ostream& operator<<( std::ostream& ostr, const EventFingerprint& f );
+
+} // HepMC
+
+#endif  // HEPMC_EVENT_FINGERPRINT_H
+//--------------------------------------------------------------------------
@@ -0,0 +1,150 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_EVENT_LIBRARY_H
+#define HEPMC_EVENT_LIBRARY_H
+
+//////////////////////////////////////////////////////////////////////////
+// EventLibrary: many events held in memory in packed arrays, to be
+// sampled at random, as minimum bias events for pile-up
+//
+// The events are read once.  Each is stored as a few plain records per
+// vertex and particle, with the connections as particle indices, all
+// in arrays shared by the whole library, so that a library of thousands
+// of events needs a fraction of the memory of the GenEvent objects and
+// no allocation per event.  An event is rebuilt as a GenEvent, or moved
+// into a pile-up overlay, when it is sampled.
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "HepMC/GraphSnapshot.h"
+#include "HepMC/SimpleVector.h"
+#include "HepMC/Units.h"
+
+namespace HepMC {
+
+    class GenEvent;
+    class IO_BaseClass;
+    class PileupOverlay;
+
+    //! EventLibrary keeps events in a compact form for random access
+
+    ///
+    /// \class  EventLibrary
+    /// The library keeps the vertices (barcode, position, id), the
+    /// particles (barcode, PDG id, status, momentum, generated mass),
+    /// how they are connected, in the original order, and the basic
+    /// event information: signal process id, event number, mpi, scale
+    /// and couplings, units, signal process vertex and beam particles.
+    /// Weights, random states, vertex weights, flow, polarization, cross
+    /// section, heavy ion and pdf information are not kept.
+    ///
+    /// Events are found by index in constant time.  Once loaded, the
+    /// library is not modified by the const methods, so any number of
+    /// threads may sample from it at the same time.
+    ///
+    /// Example:
+    ///     HepMC::IO_GenEvent file( "minbias.dat", std::ios::in );
+    ///     HepMC::EventLibrary minbias;
+    ///     minbias.load( file );
+    ///     std::mt19937 engine( seed );   // one per thread
+    ///     HepMC::PileupOverlay overlay( *signal );
+    ///     for ( int i = 0; i < npileup; ++i ) {
+    ///         minbias.overlay( minbias.random_index( engine ), overlay );
+    ///     }
+    ///
+    class EventLibrary {
+
+    public:
+	/// an empty library
+	EventLibrary();
+
+	/// read and pack up to max_events events (all if 0) from input;
+	/// returns the number of events added
+	std::size_t load( IO_BaseClass& input, std::size_t max_events = 0 );
+	/// pack one event and add it at the end
+	void        add( const GenEvent& evt );
+	/// remove all events
+	void        clear();
+
+	/// number of events
+	std::size_t size() const { return m_events.size(); }
+	/// true if there are no events
+	bool        empty() const { return m_events.empty(); }
+	/// number of particles of event i
+	int         particles_size( std::size_t i ) const { return m_events[i].nparticles; }
+	/// number of vertices of event i
+	int         vertices_size( std::size_t i ) const { return m_events[i].nvertices; }
+	/// approximate memory used by the packed events, in bytes
+	std::size_t memory_size() const;
+
+	/// a new event with the contents of event i
+	GenEvent*   event( std::size_t i ) const;
+	/// clear evt and fill it with the contents of event i
+	void        fill_event( std::size_t i, GenEvent* evt ) const;
+	/// add event i to an overlay, shifting its vertices by shift
+	void        overlay( std::size_t i, PileupOverlay& overlay,
+	                     const FourVector& shift = FourVector(0,0,0,0) ) const;
+
+	/// an index drawn uniformly from [0,size()) with engine g;
+	/// use one engine per thread.  Throws std::range_error if the
+	/// library is empty.
+	template <class Engine>
+	std::size_t random_index( Engine& g ) const
+	{
+	    if ( empty() ) throw(std::range_error("EventLibrary: random_index of an empty library"));
+	    return std::uniform_int_distribution<std::size_t>( 0, size() - 1 )( g );
+	}
+
+    private:
+	/// a packed vertex; its nin incoming and nout outgoing particle
+	/// indices follow those of the previous vertex in m_links
+	struct Vertex {
+	    double x, y, z, t;
+	    int    barcode;
+	    int    id;
+	    int    nin;
+	    int    nout;
+	};
+	/// a packed particle
+	struct Particle {
+	    double px, py, pz, e;
+	    double generated_mass;
+	    int    barcode;
+	    int    pdg_id;
+	    int    status;
+	};
+	/// where an event is in the arrays, and its event information
+	struct Event {
+	    std::size_t         first_vertex;
+	    std::size_t         first_particle;
+	    std::size_t         first_link;
+	    int                 nvertices;
+	    int                 nparticles;
+	    int                 signal_process_id;
+	    int                 event_number;
+	    int                 mpi;
+	    int                 signal_vertex;   // vertex index, or -1
+	    int                 beam_1;          // particle indices, or -1
+	    int                 beam_2;
+	    double              event_scale;
+	    double              alpha_qcd;
+	    double              alpha_qed;
+	    Units::MomentumUnit momentum_unit;
+	    Units::LengthUnit   length_unit;
+	};
+
+    private:
+	std::vector<Event>    m_events;
+	std::vector<Vertex>   m_vertices;
+	std::vector<Particle> m_particles;
+	std::vector<int>      m_links;    // particle indices within the event
+	GraphSnapshot         m_graph;    // scratch space for add
+    };
+
+} // HepMC
+
+#endif  // HEPMC_EVENT_LIBRARY_H
+//--------------------------------------------------------------------------
@@ -0,0 +1,102 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_EVENT_PIPELINE_H
+#define HEPMC_EVENT_PIPELINE_H
+
+//////////////////////////////////////////////////////////////////////////
+// EventPipeline: read events, process them on several threads, and
+// write them
+//
+// One thread reads events through an IO_BaseClass, several worker
+// threads call a function on each event, and the thread calling run()
+// writes them through another IO_BaseClass.  The stages are connected by
+// lock free BoundedQueues.  The number of events between the reader and
+// the writer is bounded, so that a slow event only holds back the output
+// by a fixed amount of memory.
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <functional>
+
+namespace HepMC {
+
+    class GenEvent;
+    class IO_BaseClass;
+
+    //! EventPipeline runs a function on all events of an input on several threads
+
+    ///
+    /// \class  EventPipeline
+    /// The function is called by all workers at the same time, on
+    /// different events, so it must be safe to call concurrently.  It may
+    /// modify the event, but must not delete it; it returns false to drop
+    /// the event from the output.
+    ///
+    /// By default the events are written in the order they were read.
+    /// Without ordering each event is written as soon as it is done.
+    /// With recycling, written events are cleared and handed back to the
+    /// reader, instead of being deleted and allocated again.
+    ///
+    /// If the function or an IO class throws, the pipeline stops and run()
+    /// rethrows the first exception.
+    ///
+    /// Example:
+    ///     HepMC::IO_GenEvent in( "in.dat", std::ios::in );
+    ///     HepMC::IO_GenEvent out( "out.dat", std::ios::out );
+    ///     HepMC::EventPipeline pipeline( in, &out, select_and_boost );
+    ///     pipeline.run();
+    ///
+    class EventPipeline {
+
+    public:
+	/// the work done on each event; returns false to drop the event
+	typedef std::function<bool( GenEvent* )> event_function;
+
+	/// a pipeline from input to output (none if null), with nworkers
+	/// workers; 0 uses the hardware threads not taken by the reader and
+	/// the writer
+	EventPipeline( IO_BaseClass& input, IO_BaseClass* output,
+	               const event_function& work, unsigned nworkers = 0 );
+
+	unsigned    workers() const        { return m_nworkers; }
+	bool        ordered() const        { return m_ordered; }
+	bool        recycle_events() const { return m_recycle; }
+	std::size_t queue_size() const     { return m_queue_size; }
+	std::size_t max_events() const     { return m_max_events; }
+
+	/// write the events in the order they were read (default true)
+	void set_ordered( bool ordered )          { m_ordered = ordered; }
+	/// reuse the written events for reading (default true)
+	void set_recycle_events( bool recycle )   { m_recycle = recycle; }
+	/// capacity of the queues between the stages (default 64)
+	void set_queue_size( std::size_t size )   { m_queue_size = size ? size : 1; }
+	/// stop after this many events, 0 for all (default 0)
+	void set_max_events( std::size_t n )      { m_max_events = n; }
+
+	/// read, process and write the events; returns the number written
+	std::size_t run();
+
+	/// number of events read by the last run()
+	std::size_t events_read() const    { return m_read; }
+	/// number of events written by the last run()
+	std::size_t events_written() const { return m_written; }
+	/// number of events dropped by the function in the last run()
+	std::size_t events_dropped() const { return m_dropped; }
+
+    private:
+	IO_BaseClass&  m_input;
+	IO_BaseClass*  m_output;
+	event_function m_work;
+	unsigned       m_nworkers;
+	bool           m_ordered;
+	bool           m_recycle;
+	std::size_t    m_queue_size;
+	std::size_t    m_max_events;
+	std::size_t    m_read;
+	std::size_t    m_written;
+	std::size_t    m_dropped;
+    };
+
+} // HepMC
+
+#endif  // HEPMC_EVENT_PIPELINE_H
+//--------------------------------------------------------------------------
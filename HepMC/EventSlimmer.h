@@ -0,0 +1,118 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_EVENT_SLIMMER_H
+#define HEPMC_EVENT_SLIMMER_H
+
+//////////////////////////////////////////////////////////////////////////
+// EventSlimmer: remove particles and vertices from an event in one pass
+//
+// The graph is contracted on index arrays (a union-find of merged
+// vertices and linked lists of outgoing particles), and the vertices
+// and particles of the event are only rewritten once at the end.
+// The cost is linear in the size of the event, where removing particles
+// one by one with GenVertex::remove_particle is quadratic.
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "HepMC/GraphSnapshot.h"
+
+namespace HepMC {
+
+    class GenEvent;
+    class GenVertex;
+    class GenParticle;
+
+    //! EventSlimmer removes unwanted particles and vertices from an event
+
+    ///
+    /// \class  EventSlimmer
+    /// Removing a particle contracts the graph: the outgoing particles of
+    /// its end vertex are moved to its production vertex, and the end
+    /// vertex is deleted.  Other particles entering the deleted vertex
+    /// lose their end vertex.  If the particle has no production vertex,
+    /// the daughters lose theirs, and those without an end vertex are
+    /// deleted.
+    /// Particles are removed in order of decreasing barcode, which is
+    /// what the old filterEvent function did, so the result is the same.
+    ///
+    /// A vertex which is not kept is merged into its mother vertex, as if
+    /// its first incoming particle had been removed.  A vertex without
+    /// incoming particles is deleted.
+    ///
+    /// Surviving particles and vertices keep their barcodes.  Vertices
+    /// left without particles are deleted.  Beam particles which are
+    /// removed are reset to null, and the signal process vertex follows
+    /// the vertex it was merged into.  The particle lists of the
+    /// surviving vertices are reallocated to their new size.
+    ///
+    /// Example:
+    ///     HepMC::EventSlimmer slimmer( keep_final_and_hadrons );
+    ///     while( evt ) {
+    ///         slimmer.slim( *evt );
+    ///         ...
+    ///     }
+    ///
+    class EventSlimmer {
+
+    public:
+	/// returns true for a particle to keep
+	typedef std::function<bool( const GenParticle* )> particle_predicate;
+	/// returns true for a vertex to keep
+	typedef std::function<bool( const GenVertex* )>   vertex_predicate;
+
+	/// a slimmer which keeps everything
+	EventSlimmer();
+	/// a slimmer with these predicates; an empty predicate keeps all
+	explicit EventSlimmer( const particle_predicate& keep_particle,
+	                       const vertex_predicate& keep_vertex = vertex_predicate() );
+
+	/// set the particle predicate
+	void set_particle_predicate( const particle_predicate& keep )
+	{ m_keep_particle = keep; }
+	/// set the vertex predicate
+	void set_vertex_predicate( const vertex_predicate& keep )
+	{ m_keep_vertex = keep; }
+
+	/// slim the event; returns the number of particles deleted
+	std::size_t slim( GenEvent& evt );
+
+	/// number of particles deleted by the last slim()
+	std::size_t removed_particles() const { return m_removed_particles; }
+	/// number of vertices deleted by the last slim()
+	std::size_t removed_vertices() const  { return m_removed_vertices; }
+
+    private:
+	/// the vertex v was merged into, -1 if it has been deleted
+	int  find( int v );
+	/// current production and end vertex of particle p, -1 for none
+	int  producer( int p );
+	int  consumer( int p ) const;
+	/// contract the graph at particle p
+	void remove( int p );
+	/// delete vertex v, moving its particles to into (or to none if -1)
+	void remove_vertex( int v, int into, int except );
+	/// rewrite the event from the index arrays
+	void rebuild( GenEvent& evt );
+
+    private:
+	particle_predicate m_keep_particle;
+	vertex_predicate   m_keep_vertex;
+	GraphSnapshot      m_graph;
+	// scratch space, kept between events
+	std::vector<int>   m_forward;   // merge target, alive or deleted flag
+	std::vector<int>   m_out_head;  // outgoing particle lists
+	std::vector<int>   m_out_tail;
+	std::vector<int>   m_next_out;
+	std::vector<char>  m_state;     // particle flags
+	std::vector<char>  m_drop;      // particles to remove
+	std::vector<int>   m_roots;     // vertices without mother to delete
+	std::size_t        m_removed_particles;
+	std::size_t        m_removed_vertices;
+    };
+
+} // HepMC
+
+#endif  // HEPMC_EVENT_SLIMMER_H
+//--------------------------------------------------------------------------
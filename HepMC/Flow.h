@@ -47,8 +47,10 @@
 //  would return a list containing q1, g, and q4.
 //
 
+#include <cstddef>
 #include <iostream>
-#include <map>
+#include <iterator>
+#include <utility>
 #include <vector>
 
 namespace HepMC {
@@ -63,6 +65,12 @@ namespace HepMC {
     /// keeps track of an arbitrary number of flow patterns within a graph 
     /// (i.e. color flow, charge flow, lepton number flow, ...) 
     /// Flow patterns are coded with an integer, in the same manner as in Herwig.
+    ///
+    /// The (code_index,icode) pairs are kept sorted by code_index.
+    /// Up to inline_capacity pairs (enough for colour and anticolour)
+    /// are stored inside the object itself, so colourless particles and
+    /// ordinary partons never touch the heap.  Larger patterns spill over
+    /// into a vector which holds all pairs until the pattern shrinks again.
     class Flow {
 
         /// for printing
@@ -122,10 +130,11 @@ namespace HepMC {
 	/// empty flow pattern container
 	bool            erase( int code_index );
 
-        /// iterator for flow pattern container
-        typedef std::map<int,int>::iterator       iterator;
+        /// (code_index,icode) pair held by the flow pattern container
+        typedef std::pair<int,int>  value_type;
+        class iterator;
         /// const iterator for flow pattern container
-        typedef std::map<int,int>::const_iterator const_iterator;
+        typedef const value_type*   const_iterator;
 	/// beginning of flow pattern container
         iterator            begin();
 	/// end of flow pattern container
@@ -148,11 +157,68 @@ namespace HepMC {
 						     visited_particles, 
 						     int code, int code_index, 
 						     int num_indices ) const; 
+    private:
+        /// number of pairs stored without a heap allocation
+        enum { inline_capacity = 2 };
+
+	value_type*       data();
+	const value_type* data() const;
+	/// first pair with code_index >= index
+	value_type*       lower_bound( int index );
+	void              insert( value_type* pos, int code_index, int code );
+
     private:
 	GenParticle*         m_particle_owner;
-	std::map<int,int> m_icode; // stores flow patterns as(code_index,icode)
+	// stores flow patterns as (code_index,icode), sorted by code_index
+	value_type           m_inline[inline_capacity];
+	int                  m_size;     // number of pairs in m_inline
+	std::vector<value_type>* m_overflow; // all pairs once m_inline is full
     };  
 
+    //! iterator for the flow pattern container
+
+    ///
+    /// \class  Flow::iterator
+    /// Like the std::map<int,int>::iterator it replaces, it lets
+    /// (*i).second be modified but not (*i).first, since the pairs must
+    /// stay sorted by code_index.
+    ///
+    class Flow::iterator {
+    public:
+	/// the pair an iterator points to, with a read only code_index
+	struct reference {
+	    const int& first;
+	    int&       second;
+	    reference( Flow::value_type& p ) : first(p.first), second(p.second) {}
+	    operator Flow::value_type() const { return Flow::value_type( first, second ); }
+	};
+	/// what operator-> returns
+	struct pointer {
+	    reference  r;
+	    reference* operator->() { return &r; }
+	};
+	typedef std::bidirectional_iterator_tag iterator_category;
+	typedef std::pair<const int,int>        value_type;
+	typedef std::ptrdiff_t                  difference_type;
+
+	iterator() : m_pos(0) {}
+	explicit iterator( Flow::value_type* pos ) : m_pos(pos) {}
+
+	reference  operator*() const  { return reference( *m_pos ); }
+	pointer    operator->() const { pointer p = { reference( *m_pos ) }; return p; }
+	iterator&  operator++()       { ++m_pos; return *this; }
+	iterator   operator++( int )  { iterator i( *this ); ++m_pos; return i; }
+	iterator&  operator--()       { --m_pos; return *this; }
+	iterator   operator--( int )  { iterator i( *this ); --m_pos; return i; }
+	bool       operator==( const iterator& i ) const { return m_pos == i.m_pos; }
+	bool       operator!=( const iterator& i ) const { return m_pos != i.m_pos; }
+	/// an iterator converts to a const_iterator, as for std::map
+	operator const_iterator() const { return m_pos; }
+
+    private:
+	Flow::value_type* m_pos;
+    };
+
     ///////////////////////////
     // INLINE Access Methods //
     ///////////////////////////
@@ -160,31 +226,48 @@ namespace HepMC {
     inline const GenParticle* Flow::particle_owner() const {
 	return m_particle_owner;
     }
+    inline Flow::value_type* Flow::data() {
+	return m_overflow ? &(*m_overflow)[0] : m_inline;
+    }
+    inline const Flow::value_type* Flow::data() const {
+	return m_overflow ? &(*m_overflow)[0] : m_inline;
+    }
+    inline Flow::value_type* Flow::lower_bound( int index ) {
+	// patterns are tiny, so a linear scan beats a binary search
+	value_type* i = data();
+	value_type* e = i + size();
+	while ( i != e && i->first < index ) ++i;
+	return i;
+    }
     inline int Flow::icode( int code_index ) const {
-	std::map<int,int>::const_iterator a = m_icode.find(code_index);
-	return a==m_icode.end() ? 0 : (*a).second;
+	for ( const_iterator i = begin(), e = end(); i != e; ++i ) {
+	    if ( i->first == code_index ) return i->second;
+	    if ( i->first > code_index ) break;
+	}
+	return 0;
     }
     inline Flow Flow::set_icode( int code_index, int code ) {
-	m_icode[code_index] = code;
+	value_type* pos = lower_bound( code_index );
+	if ( pos != data() + size() && pos->first == code_index ) {
+	    pos->second = code;
+	} else {
+	    insert( pos, code_index, code );
+	}
 	return *this;
     }
     inline Flow Flow::set_unique_icode( int flow_num ) {
 	/// use this method if you want to assign a unique flow code, but
 	/// do not want the burden of choosing it yourself
-	m_icode[flow_num] = size_t(this);
-	return *this;
+	return set_icode( flow_num, int(size_t(this)) );
     }
-    inline bool Flow::empty() const { return (bool)m_icode.empty(); }
-    inline int Flow::size() const { return (int)m_icode.size(); }
-    inline void Flow::clear() { m_icode.clear(); }
-    inline bool Flow::erase( int code_index ) {
-	// this will return true if the number of elements removed is nonzero
-	return m_icode.erase( code_index )==0 ? false : true ;
+    inline bool Flow::empty() const { return size() == 0; }
+    inline int Flow::size() const { 
+	return m_overflow ? (int)m_overflow->size() : m_size;
     }
-    inline Flow::iterator Flow::begin() { return m_icode.begin(); }
-    inline Flow::iterator Flow::end() { return m_icode.end(); }
-    inline Flow::const_iterator Flow::begin() const { return m_icode.begin(); }
-    inline Flow::const_iterator Flow::end() const { return m_icode.end(); }
+    inline Flow::iterator Flow::begin() { return iterator( data() ); }
+    inline Flow::iterator Flow::end() { return iterator( data() + size() ); }
+    inline Flow::const_iterator Flow::begin() const { return data(); }
+    inline Flow::const_iterator Flow::end() const { return data() + size(); }
 
     ///////////////////////////
     // INLINE Operators      //
@@ -192,21 +275,17 @@ namespace HepMC {
 
     inline bool Flow::operator==( const Flow& a ) const {
 	/// equivalent flows have the same flow codes for all flow_numbers 
-	/// (i.e. their m_icode maps are identical), but they need not have the
-	/// same m_particle owner
-	return (m_icode == a.m_icode);
+	/// (i.e. their (code_index,icode) pairs are identical), but they 
+	/// need not have the same m_particle owner
+	if ( size() != a.size() ) return false;
+	for ( const_iterator i = begin(), j = a.begin(); i != end(); ++i, ++j ) {
+	    if ( *i != *j ) return false;
+	}
+	return true;
     }
     inline bool Flow::operator!=( const Flow& a ) const {
 	return !( *this == a );
     }
-    inline Flow& Flow::operator=( const Flow& inflow ) {
-	/// copies only the m_icode ... not the particle_owner
-	/// this is intuitive behaviour so you can do
-	/// oneparticle->flow() = otherparticle->flow()
-	//
-	m_icode = inflow.m_icode;
-	return *this;
-    }
 
 } // HepMC
 
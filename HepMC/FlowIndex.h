@@ -0,0 +1,90 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_FLOW_INDEX_H
+#define HEPMC_FLOW_INDEX_H
+
+//////////////////////////////////////////////////////////////////////////
+// FlowIndex: all flow lines (e.g. colour lines) of an event at once
+//
+// Flow::connected_partners finds the line through one particle.  The
+// FlowIndex finds every line of the event in a single pass: particles
+// carrying the same code are joined with a union-find wherever they meet
+// at a vertex, and the number of flow neighbours of each particle is
+// counted at the same time to find the dangling ends.
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace HepMC {
+
+    class GenEvent;
+    class GenParticle;
+
+    //! FlowLine is one connected flow pattern of an event
+
+    ///
+    /// \class  FlowLine
+    /// The particles connected by one flow code, as returned by
+    /// Flow::connected_partners, and those among them with at most one
+    /// flow neighbour, as returned by Flow::dangling_connected_partners.
+    /// Both lists are in the order of GenEvent::particle_iterator.
+    ///
+    struct FlowLine {
+	int                       code;
+	std::vector<GenParticle*> partners;
+	std::vector<GenParticle*> dangling;
+    };
+
+    //! FlowIndex finds all flow lines of an event
+
+    ///
+    /// \class  FlowIndex
+    /// The index is built for the num_indices flow code indices starting
+    /// at code_index; the default covers the two colour indices.  Like
+    /// Flow::connected_partners, particles are connected if they have the
+    /// same code and share a production or end vertex.  Several lines
+    /// may have the same code if they are not connected.
+    /// The index is a snapshot and is not updated when the event changes.
+    ///
+    /// Example:
+    ///     HepMC::FlowIndex colour( *evt );
+    ///     for( std::size_t i = 0; i < colour.size(); ++i )
+    ///         if( colour.line(i).dangling.size() != 2 ) ...
+    ///
+    class FlowIndex {
+
+    public:
+	/// find the flow lines of this event
+	explicit FlowIndex( const GenEvent& evt, int code_index = 1,
+	                    int num_indices = 2 );
+
+	/// number of flow lines
+	std::size_t size() const { return m_lines.size(); }
+	/// flow line i, ordered by code and then by the first particle
+	const FlowLine& line( std::size_t i ) const { return m_lines[i]; }
+	/// all flow lines
+	const std::vector<FlowLine>& lines() const { return m_lines; }
+
+	/// the line through particle p with this code, -1 if none
+	int  line_of( const GenParticle* p, int code ) const;
+	/// same as p->flow().connected_partners( code, code_index, num_indices ),
+	/// in a different order
+	std::vector<GenParticle*> connected_partners( const GenParticle* p,
+	                                              int code ) const;
+	/// same as p->flow().dangling_connected_partners( code, code_index,
+	/// num_indices ), in a different order
+	std::vector<GenParticle*> dangling_connected_partners( const GenParticle* p,
+	                                                       int code ) const;
+
+    private:
+	typedef std::pair<const GenParticle*,int> particle_code;
+	std::vector<FlowLine> m_lines;
+	// (particle, code) -> line, sorted
+	std::vector<std::pair<particle_code,int> > m_lookup;
+    };
+
+} // HepMC
+
+#endif  // HEPMC_FLOW_INDEX_H
+//--------------------------------------------------------------------------
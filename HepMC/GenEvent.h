@@ -132,6 +132,7 @@ namespace HepMC {
 #include "HepMC/PdfInfo.h"
 #include "HepMC/Units.h"
 #include "HepMC/HepMCDefs.h"
+#include "HepMC/EventFingerprint.h"
 #include <map>
 #include <string>
 #include <vector>
@@ -144,6 +145,7 @@ namespace HepMC {
     class ConstGenEventVertexRange;
     class GenEventParticleRange;
     class ConstGenEventParticleRange;
+    class GenealogyIndex;
 
     //! The GenEvent class is the core of HepMC
 
@@ -155,6 +157,8 @@ namespace HepMC {
     class GenEvent {
 	friend class GenParticle;
 	friend class GenVertex;  
+	friend class EventSlimmer; // rewrites the graph in one pass
+	friend class PileupOverlay; // moves whole events into this one
     public:
         /// default constructor creates null pointers to HeavyIon, PdfInfo, and GenCrossSection
 	GenEvent( int signal_process_id = 0, int event_number = 0,
@@ -184,9 +188,14 @@ namespace HepMC {
 		  const HeavyIon& ion, const PdfInfo& pdf );
 	GenEvent( const GenEvent& inevent );          //!< deep copy
 	GenEvent& operator=( const GenEvent& inevent ); //!< make a deep copy
+	/// take the contents of inevent, leaving it empty; constant time
+	GenEvent( GenEvent&& inevent );
+	/// take the contents of inevent, which is left with the former
+	/// contents of this event; constant time
+	GenEvent& operator=( GenEvent&& inevent );
 	virtual ~GenEvent(); //!<deletes all vertices/particles in this evt
 
-        void swap( GenEvent & other );  //!< swap
+        void swap( GenEvent & other );  //!< swap, in constant time
     
 	void print( std::ostream& ostr = std::cout ) const; //!< dumps to ostr
 	void print_version( std::ostream& ostr = std::cout ) const; //!< dumps release version to ostr
@@ -269,6 +278,25 @@ namespace HepMC {
 	bool    add_vertex( GenVertex* vtx );    //!< adds to evt and adopts
 	bool    remove_vertex( GenVertex* vtx ); //!< erases vtx from evt
 	void    clear();                         //!< empties the entire event
+
+	/// how splice() numbers the vertices and particles it moves
+	enum BarcodePolicy {
+	    keep_barcodes,   //!< keep the free barcodes, new ones for the others
+	    offset_barcodes  //!< move all by one offset past the barcodes in use
+	};
+	/// move root, all vertices descending from it and their particles
+	/// from the event from into this one, in one pass.
+	/// Particles entering the subgraph from a vertex outside it stay in
+	/// from and lose their end vertex; connect them again with
+	/// GenVertex::add_particle_in if needed.  The signal process vertex
+	/// and beam particles of from are reset if they are moved.
+	/// Returns false if root is not in from, or from is this event.
+	bool    splice( GenVertex* root, GenEvent& from,
+	                BarcodePolicy policy = keep_barcodes );
+	/// a new event with the units, process id and event number of this
+	/// one, holding root and its descendants moved out of this event as
+	/// by splice(); null if root is not in this event
+	GenEvent* extract_subgraph( GenVertex* root );
 	
 	void set_signal_process_id( int id ); //!< set unique signal process id
 	void set_event_number( int eventno ); //!< set event number
@@ -318,6 +346,38 @@ namespace HepMC {
 	/// particle range
 	ConstGenEventParticleRange particle_range() const;
 
+	////////////////////////
+	// genealogy queries  //
+	////////////////////////
+
+	/// build the genealogy index now rather than at the first query.
+	/// The index is deleted whenever vertices or particles are added
+	/// to or removed from the event, and rebuilt when needed.
+	void build_genealogy_index() const;
+	/// true if the genealogy index is built and up to date
+	bool has_genealogy_index() const { return m_genealogy_index != 0; }
+	/// the genealogy index, built if necessary
+	const GenealogyIndex& genealogy_index() const;
+	/// true if particle a is an ancestor of particle b, see GenealogyIndex
+	bool is_ancestor( const GenParticle* a, const GenParticle* b ) const;
+	/// true if particle a is a descendant of particle b
+	bool is_descendant( const GenParticle* a, const GenParticle* b ) const
+	{ return is_ancestor( b, a ); }
+	/// the latest vertex from which both particles descend,
+	/// null if there is none
+	GenVertex* common_ancestor( const GenParticle* a, 
+	                            const GenParticle* b ) const;
+
+	////////////////////////
+	// fingerprint        //
+	////////////////////////
+
+	/// hash of the content and links of the event, which does not depend
+	/// on the order in which vertices and particles are stored.
+	/// Floating point values are rounded to multiples of tolerance if it
+	/// is positive.  See EventFingerprint, and parallel_fingerprint()
+	EventFingerprint fingerprint( double tolerance = 0 ) const;
+
     public:
 	///////////////////////////////
 	// vertex_iterators          //
@@ -613,6 +673,8 @@ namespace HepMC {
         std::istream & read_weight_names( std::istream & );
 	/// read the event header line
         std::istream & process_event_line( std::istream &, int &, int &, int &, int & );
+	/// delete the genealogy index after the graph has changed
+	void invalidate_genealogy_index() const;
 
     private: // data members
 	int                   m_signal_process_id;
@@ -636,6 +698,8 @@ namespace HepMC {
 	PdfInfo*              m_pdf_info; 	      // undefined by default
 	Units::MomentumUnit   m_momentum_unit;    // default value set by configure switch
 	Units::LengthUnit     m_position_unit;    // default value set by configure switch
+	mutable GenealogyIndex* m_genealogy_index; // built on demand
+	GenEventLink*         m_link;  // the vertices point to this, see swap
 
     };
 
@@ -651,6 +715,8 @@ namespace HepMC {
     /// set the units for this input stream
     std::istream & set_input_units(std::istream &, 
                                    Units::MomentumUnit, Units::LengthUnit);
+    /// the weight names most recently read from this input stream
+    const WeightContainer & stream_weight_names(std::istream &);
     /// Explicitly write the begin block lines that IO_GenEvent uses
     std::ostream & write_HepMC_IO_block_begin(std::ostream & );
     /// Explicitly write the end block line that IO_GenEvent uses
@@ -772,10 +838,18 @@ namespace HepMC {
     { m_random_states = randomstates; }
 
     inline void GenEvent::remove_barcode( GenParticle* p )
-    { m_particle_barcodes.erase( p->barcode() ); }
+    {
+	// a beam particle which leaves the event may be deleted next
+	if ( p == m_beam_particle_1 ) m_beam_particle_1 = 0;
+	if ( p == m_beam_particle_2 ) m_beam_particle_2 = 0;
+	m_particle_barcodes.erase( p->barcode() );
+    }
 
     inline void GenEvent::remove_barcode( GenVertex* v )
-    { m_vertex_barcodes.erase( v->barcode() ); }
+    {
+	invalidate_genealogy_index();
+	m_vertex_barcodes.erase( v->barcode() );
+    }
 
     /// Each vertex or particle has a barcode, which is just an integer which
     /// uniquely identifies it inside the event (i.e. there is a one to one
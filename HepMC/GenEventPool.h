@@ -0,0 +1,83 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_GENEVENT_POOL_H
+#define HEPMC_GENEVENT_POOL_H
+
+//////////////////////////////////////////////////////////////////////////
+// GenEventPool: reuse GenEvent objects instead of deleting them
+//
+// A released event is cleared and kept, first in a small cache of the
+// pool for the releasing thread, then in a shared lock free queue.
+// Clearing an event gives its particles and vertices back to their
+// RecyclingStore, so the memory of all parts of an event is recycled.
+//////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "HepMC/BoundedQueue.h"
+
+namespace HepMC {
+
+    class GenEvent;
+
+    //! GenEventPool hands out cleared events and takes them back
+
+    ///
+    /// \class  GenEventPool
+    /// acquire() and release() may be called from any thread; an event
+    /// may be released by another thread than the one which acquired it.
+    /// The pool has a small cache per thread, holding up to local_size
+    /// released events (threads beyond the number of caches share them),
+    /// and keeps up to capacity more for all threads; beyond that,
+    /// released events are deleted.
+    ///
+    /// The caches belong to the pool, so all events it holds, including
+    /// those released by other threads, are deleted with the pool.
+    ///
+    /// Example:
+    ///     HepMC::GenEventPool pool;
+    ///     HepMC::GenEvent* evt = pool.acquire();
+    ///     input.fill_next_event( evt );
+    ///     ...
+    ///     pool.release( evt );
+    ///
+    class GenEventPool {
+
+    public:
+	/// number of events kept in the cache of a thread
+	static const std::size_t local_size = 4;
+
+	/// a pool sharing up to capacity events between threads
+	explicit GenEventPool( std::size_t capacity = 256 );
+	/// deletes the events held by the pool
+	~GenEventPool();
+
+	/// an empty event, reused if possible
+	GenEvent* acquire();
+	/// clear evt and keep it for reuse (null is ignored)
+	void      release( GenEvent* evt );
+
+	/// number of events the pool created with new
+	std::size_t created() const { return m_created.load( std::memory_order_relaxed ); }
+
+    private:
+	/// the cache of the threads with the same thread number
+	struct Local;
+	/// the cache of the calling thread
+	Local& local();
+
+	GenEventPool( const GenEventPool& ) = delete;
+	GenEventPool& operator=( const GenEventPool& ) = delete;
+
+    private:
+	std::size_t              m_nlocal;  // number of caches
+	std::unique_ptr<Local[]> m_local;
+	BoundedQueue<GenEvent*>  m_shared;
+	std::atomic<std::size_t> m_created;
+    };
+
+} // HepMC
+
+#endif  // HEPMC_GENEVENT_POOL_H
+//--------------------------------------------------------------------------
@@ -0,0 +1,108 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_GEN_EVENT_VALIDATOR_H
+#define HEPMC_GEN_EVENT_VALIDATOR_H
+
+//////////////////////////////////////////////////////////////////////////
+// GenEventValidator: consistency checks of a GenEvent
+//
+// The per-vertex checks run in parallel on a ThreadPool, over a
+// GraphSnapshot of the event.  Problems are returned as a list of
+// ValidationIssue objects rather than printed.
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "HepMC/ThreadPool.h"
+
+namespace HepMC {
+
+    class GenEvent;
+
+    //! ValidationIssue is one problem found by GenEventValidator
+
+    ///
+    /// \class  ValidationIssue
+    /// barcode is that of the vertex or particle concerned, or 0 for
+    /// problems of the whole event.  value is the size of the violation
+    /// where that makes sense (e.g. the momentum imbalance), otherwise 0.
+    ///
+    struct ValidationIssue {
+	unsigned    check;     // one of GenEventValidator::Check
+	int         barcode;
+	double      value;
+	std::string message;
+    };
+
+    //! GenEventValidator runs a configurable set of checks on an event
+
+    ///
+    /// \class  GenEventValidator
+    /// Checks:
+    ///  - momentum_conservation: GenVertex::check_momentum_conservation()
+    ///    is at most the tolerance, for vertices with incoming and
+    ///    outgoing particles
+    ///  - barcodes: particle barcodes are positive, vertex barcodes are
+    ///    negative, and each vertex and particle is found in the event
+    ///    under its own barcode (so barcodes are unique)
+    ///  - links: vertices and particles point to each other in both
+    ///    directions, and every particle of the event is attached to a
+    ///    vertex of the event, so there are no dangling particles
+    ///  - beam_particles: both beam particles are set and in the event
+    ///  - parent_event: every vertex points back to the event
+    ///  - cycles: no vertex is its own ancestor
+    ///
+    /// The validator keeps no state between events, so one validator may
+    /// check several events at once, from different threads.
+    ///
+    /// Example:
+    ///     HepMC::GenEventValidator validator;
+    ///     std::vector<HepMC::ValidationIssue> issues = validator.validate( *evt );
+    ///     if( !issues.empty() ) HepMC::GenEventValidator::print( issues );
+    ///
+    class GenEventValidator {
+
+    public:
+	/// the checks, which may be combined with |
+	enum Check { momentum_conservation = 1, barcodes = 2, links = 4,
+	             beam_particles = 8, parent_event = 16, cycles = 32,
+		     all_checks = 63 };
+
+	/// a validator running the given checks on the threads of pool
+	explicit GenEventValidator( unsigned checks = all_checks,
+	                            double momentum_tolerance = 1e-6,
+	                            ThreadPool& pool = ThreadPool::global() );
+
+	/// the checks which are run
+	unsigned checks() const { return m_checks; }
+	/// choose the checks to run
+	void     set_checks( unsigned checks ) { m_checks = checks; }
+	/// largest momentum imbalance accepted at a vertex, in event units
+	double   momentum_tolerance() const { return m_tolerance; }
+	/// set the largest momentum imbalance accepted at a vertex
+	void     set_momentum_tolerance( double t ) { m_tolerance = t; }
+
+	/// run the checks; an empty result means the event is valid.
+	/// Vertex problems come first, in the order of the vertices in the
+	/// event, followed by the problems of the whole event.
+	std::vector<ValidationIssue> validate( const GenEvent& evt ) const;
+	/// true if the event passes all checks
+	bool is_valid( const GenEvent& evt ) const { return validate( evt ).empty(); }
+
+	/// name of a check
+	static const char* check_name( unsigned check );
+	/// print the issues, one per line
+	static void print( const std::vector<ValidationIssue>& issues,
+	                   std::ostream& ostr = std::cout );
+
+    private:
+	unsigned    m_checks;
+	double      m_tolerance;
+	ThreadPool* m_pool;
+    };
+
+} // HepMC
+
+#endif  // HEPMC_GEN_EVENT_VALIDATOR_H
+//--------------------------------------------------------------------------
@@ -30,7 +30,9 @@
 #include "HepMC/Polarization.h"
 #include "HepMC/SimpleVector.h"
 #include "HepMC/IteratorRange.h"
+#include <cstddef>
 #include <iostream>
+#include <new>
 #ifdef _WIN32
 #define hepmc_uint64_t  __int64
 #else
@@ -61,6 +63,8 @@ namespace HepMC {
 
 	friend class GenVertex; // so vertex can set decay/production vertexes
 	friend class GenEvent;  // so event can set the barCodes
+	friend class EventSlimmer; // so slimming can relink particles
+	friend class PileupOverlay; // so overlays can move barcodes
 	/// print particle
 	friend std::ostream& operator<<( std::ostream&, const GenParticle& );
 
@@ -74,6 +78,19 @@ namespace HepMC {
 	GenParticle( const GenParticle& inparticle ); //!< shallow copy.
 	virtual ~GenParticle();
 
+	/// particles are allocated from a RecyclingStore
+	static void* operator new( std::size_t size );
+	/// particles are returned to a RecyclingStore
+	static void  operator delete( void* p, std::size_t size );
+	/// as operator new, but returns null if out of memory
+	static void* operator new( std::size_t size, const std::nothrow_t& ) throw();
+	/// frees memory from the nothrow new if the constructor throws
+	static void  operator delete( void* p, const std::nothrow_t& ) throw();
+	/// placement new, constructing in memory provided by the caller
+	static void* operator new( std::size_t, void* where ) throw() { return where; }
+	/// matches placement new; the memory is not freed
+	static void  operator delete( void*, void* ) throw() {}
+
         void swap( GenParticle & other); //!< swap
 	GenParticle& operator=( const GenParticle& inparticle ); //!< shallow.
         /// check for equality
@@ -25,6 +25,7 @@
 #include "HepMC/SimpleVector.h"
 #include "HepMC/IteratorRange.h"
 #include <iostream>
+#include <new>
 #include <iterator>
 #include <vector>
 #include <set>
@@ -41,6 +42,21 @@ namespace HepMC {
 
     class GenParticle;
     class GenEvent;
+    class GraphTraversal;
+
+    //! GenEventLink is the link from the vertices of an event to the event
+
+    ///
+    /// \class  GenEventLink
+    /// Each GenEvent owns one GenEventLink, and its vertices point to the
+    /// link rather than to the event.  GenEvent::swap exchanges the links
+    /// of two events with their vertices and repoints the two links, so
+    /// it does not need to visit the vertices.
+    ///
+    struct GenEventLink {
+	explicit GenEventLink( GenEvent* evt ) : event(evt) {}
+	GenEvent* event;
+    };
 
     //! GenVertex contains information about decay vertices.
 
@@ -54,6 +70,9 @@ namespace HepMC {
         /// print vertex information
 	friend std::ostream& operator<<( std::ostream&, const GenVertex& );
 	friend class GenEvent;
+	friend class GraphTraversal;
+	friend class EventSlimmer;
+	friend class PileupOverlay;
 
 #ifdef NEED_SOLARIS_FRIEND_FEATURE
 	// This bit of ugly code is only for CC-5.2 compiler. 
@@ -74,6 +93,19 @@ namespace HepMC {
 	GenVertex( const GenVertex& invertex );            //!< shallow copy
 	virtual    ~GenVertex();
 
+	/// vertices are allocated from a RecyclingStore
+	static void* operator new( std::size_t size );
+	/// vertices are returned to a RecyclingStore
+	static void  operator delete( void* p, std::size_t size );
+	/// as operator new, but returns null if out of memory
+	static void* operator new( std::size_t size, const std::nothrow_t& ) throw();
+	/// frees memory from the nothrow new if the constructor throws
+	static void  operator delete( void* p, const std::nothrow_t& ) throw();
+	/// placement new, constructing in memory provided by the caller
+	static void* operator new( std::size_t, void* where ) throw() { return where; }
+	/// matches placement new; the memory is not freed
+	static void  operator delete( void*, void* ) throw() {}
+
         void swap( GenVertex & other); //!< swap
 	GenVertex& operator= ( const GenVertex& invertex ); //!< shallow
 	bool       operator==( const GenVertex& a ) const; //!< equality
@@ -174,7 +206,6 @@ namespace HepMC {
 	///  vertex to an event
 	void                    set_parent_event_( GenEvent* evt ); //!< set parent event
 	void                    set_barcode_( int the_bar_code ); //!< set identifier
-	void                    change_parent_event_( GenEvent* evt ); //!< for use with swap
 
 	/////////////////////////////
 	// edge_iterator           // (protected - for internal use only)
@@ -389,7 +420,7 @@ namespace HepMC {
 	std::vector<HepMC::GenParticle*>  m_particles_out; //all outgoing particles
 	int                  m_id;
 	WeightContainer      m_weights;       // weights for this vtx
-	GenEvent*            m_event;
+	GenEventLink*        m_event;     // owned by the event, null if none
 	int                  m_barcode;   // unique identifier in the event
 
 	//static unsigned int  s_counter;
@@ -405,7 +436,8 @@ namespace HepMC {
 
     inline const FourVector & GenVertex::position() const { return m_position; }
 
-    inline GenEvent* GenVertex::parent_event() const { return m_event; }
+    inline GenEvent* GenVertex::parent_event() const
+    { return m_event ? m_event->event : 0; }
 
     inline ThreeVector GenVertex::point3d() const { 
 	return ThreeVector(m_position.x(),m_position.y(),m_position.z()); 
@@ -0,0 +1,123 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_GENEALOGY_INDEX_H
+#define HEPMC_GENEALOGY_INDEX_H
+
+//////////////////////////////////////////////////////////////////////////
+// GenealogyIndex: precomputed ancestor/descendant relations of an event
+//
+// The vertices of the event are ordered topologically, after collapsing
+// loops (strongly connected vertices) into single nodes.  Each node keeps
+// a bitset of all nodes it descends from, so that ancestor queries are
+// a lookup of the two vertices and a single bit test.  Large events use
+// interval labels instead, which need no more than a few intervals per
+// node for the nearly tree-like graphs of generators.
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace HepMC {
+
+    class GenEvent;
+    class GenVertex;
+    class GenParticle;
+
+    //! GenealogyIndex answers ancestor and descendant queries quickly
+
+    ///
+    /// \class  GenealogyIndex
+    /// GenealogyIndex is a snapshot of the graph of a GenEvent.
+    /// It is normally built and owned by the event, see
+    /// GenEvent::build_genealogy_index(), which deletes the index when
+    /// the graph is modified.  An index built directly must not be used
+    /// after the event has changed.
+    ///
+    /// A particle A is an ancestor of particle B if B is produced at the
+    /// end vertex of A, or at a vertex descending from it.  This is the
+    /// same relation as GenVertex::particles_begin(ancestors).
+    /// Vertices connected in a loop are ancestors of each other.
+    ///
+    /// The reachability bitsets need (number of vertices)^2 bits.
+    /// Above max_bitset_nodes they are not built.  The nodes are then
+    /// numbered in the preorder of a spanning forest, and each node keeps
+    /// the sorted, disjoint intervals of preorder numbers of all its
+    /// descendants: its own subtree, plus what is reached through the
+    /// other parents of its descendants.  An ancestor query is then a
+    /// binary search in these intervals, and common_ancestor walks up the
+    /// ancestors of one vertex, latest first, until one reaches the other.
+    /// Queries do not allocate memory, except for the buffer of
+    /// common_ancestor, kept per thread.
+    ///
+    class GenealogyIndex {
+
+    public:
+	/// build the index for this event.
+	/// The bitsets of n nodes take n*n/8 bytes: 512 KiB for the default
+	/// max_bitset_nodes of 2048, but 32 MiB for 16384.
+	explicit GenealogyIndex( const GenEvent& evt,
+	                         std::size_t max_bitset_nodes = 2048 );
+
+	/// number of vertices in the index
+	std::size_t size() const { return m_order.size(); }
+	/// true if the reachability bitsets were built
+	bool        has_bitsets() const { return m_has_bitsets; }
+
+	/// vertices in topological order: ancestors before descendants.
+	/// Vertices in a loop are adjacent, in no particular order.
+	const std::vector<GenVertex*>& topological_order() const { return m_order; }
+	/// position of v in topological_order(), -1 if not in the index
+	int  topological_index( const GenVertex* v ) const;
+	/// true if v is part of a loop, i.e. is its own ancestor
+	bool is_in_loop( const GenVertex* v ) const;
+
+	/// true if vertex b descends from vertex a
+	bool is_ancestor( const GenVertex* a, const GenVertex* b ) const;
+	/// true if vertex a descends from vertex b
+	bool is_descendant( const GenVertex* a, const GenVertex* b ) const
+	{ return is_ancestor( b, a ); }
+	/// true if particle a is an ancestor of particle b
+	bool is_ancestor( const GenParticle* a, const GenParticle* b ) const;
+	/// true if particle a is a descendant of particle b
+	bool is_descendant( const GenParticle* a, const GenParticle* b ) const
+	{ return is_ancestor( b, a ); }
+
+	/// the latest vertex which is, or is an ancestor of, both a and b.
+	/// Returns null if there is none.
+	GenVertex* common_ancestor( const GenVertex* a, const GenVertex* b ) const;
+	/// the latest vertex from which both particles descend,
+	/// i.e. common_ancestor of their production vertices
+	GenVertex* common_ancestor( const GenParticle* a, const GenParticle* b ) const;
+
+    private:
+	/// the node (loop-free vertex group) of a vertex, -1 if not indexed
+	int  node( const GenVertex* v ) const;
+	/// true if node a is node b or one of its ancestors
+	bool reaches( int a, int b ) const;
+	/// build the interval labels, used instead of the bitsets
+	void build_intervals();
+	/// latest common ancestor of nodes a and b from the interval labels
+	int  common_ancestor_node( int a, int b ) const;
+
+    private:
+	typedef std::pair<const GenVertex*,int> vertex_node;
+	std::vector<vertex_node>  m_lookup;   // sorted by vertex address
+	std::vector<GenVertex*>   m_order;    // vertices in topological order
+	std::vector<int>          m_first;    // first vertex of each node in m_order
+	std::vector<char>         m_cyclic;   // true if the node contains a loop
+	std::vector<int>          m_parent_begin; // parent nodes of each node
+	std::vector<int>          m_parents;
+	int                       m_nodes;
+	bool                      m_has_bitsets;
+	std::size_t               m_words;    // bitset words per node
+	std::vector<unsigned int> m_ancestors;  // bitsets, m_words per node
+	typedef std::pair<int,int> interval;  // first and last preorder number
+	std::vector<int>          m_preorder;   // preorder number of each node
+	std::vector<int>          m_interval_begin; // by m_nodes-1-c for node c
+	std::vector<interval>     m_intervals;  // descendants of each node
+    };
+
+} // HepMC
+
+#endif  // HEPMC_GENEALOGY_INDEX_H
+//--------------------------------------------------------------------------
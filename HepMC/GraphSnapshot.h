@@ -0,0 +1,162 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_GRAPH_SNAPSHOT_H
+#define HEPMC_GRAPH_SNAPSHOT_H
+
+//////////////////////////////////////////////////////////////////////////
+// GraphSnapshot: the vertex and particle graph of an event in
+// compressed sparse row (CSR) arrays
+//
+// Vertices and particles are given dense indices.  For each vertex the
+// incoming and outgoing particles are stored contiguously, addressed by
+// an offset array, and for each particle the indices of its production
+// and end vertex are stored.  Graph algorithms then work on arrays of
+// integers instead of following GenVertex and GenParticle pointers.
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "HepMC/IteratorRange.h"
+
+namespace HepMC {
+
+    class GenEvent;
+    class GenVertex;
+    class GenParticle;
+
+    //! GraphSnapshot is a read-only copy of the connections of a GenEvent
+
+    ///
+    /// \class  GraphSnapshot
+    /// A GraphSnapshot is a copy of the graph at the time it was built.
+    /// It keeps pointers to the vertices and particles of the event, but
+    /// does not follow later changes to the event; rebuild it with build()
+    /// after modifying the event.  Since a snapshot is never modified
+    /// after it is built, all const methods may be called from several
+    /// threads at once.
+    ///
+    /// Vertices are numbered in the order of GenEvent::vertex_iterator and
+    /// particles in the order of GenEvent::particle_iterator.
+    /// Index -1 stands for "no vertex" or "not in the snapshot".
+    ///
+    /// Example:
+    ///     HepMC::GraphSnapshot g( *evt );
+    ///     for( int v = 0; v < g.vertices_size(); ++v )
+    ///         for( const int* p = g.particles_out_begin(v);
+    ///              p != g.particles_out_end(v); ++p )
+    ///             if( g.end_vertex(*p) < 0 ) ... // a final state particle
+    ///
+    class GraphSnapshot {
+
+    public:
+	/// an empty snapshot
+	GraphSnapshot();
+	/// snapshot of this event
+	explicit GraphSnapshot( const GenEvent& evt );
+
+	/// replace the snapshot with one of this event, reusing the memory
+	void build( const GenEvent& evt );
+	/// swap
+	void swap( GraphSnapshot& other );
+
+	/// number of vertices
+	int vertices_size() const  { return (int)m_vertices.size(); }
+	/// number of particles
+	int particles_size() const { return (int)m_particles.size(); }
+
+	/// the vertex with index v
+	GenVertex*   vertex( int v ) const   { return m_vertices[v]; }
+	/// the particle with index p
+	GenParticle* particle( int p ) const { return m_particles[p]; }
+	/// all vertices, by index
+	const std::vector<GenVertex*>&   vertices() const  { return m_vertices; }
+	/// all particles, by index
+	const std::vector<GenParticle*>& particles() const { return m_particles; }
+
+	/// index of a vertex, -1 if it is not in the snapshot
+	int index( const GenVertex* v ) const;
+	/// index of a particle, -1 if it is not in the snapshot
+	int index( const GenParticle* p ) const;
+
+	/// index of the production vertex of particle p, -1 if none
+	int production_vertex( int p ) const { return m_production[p]; }
+	/// index of the end vertex of particle p, -1 if none
+	int end_vertex( int p ) const        { return m_end[p]; }
+
+	/// first incoming particle index of vertex v
+	const int* particles_in_begin( int v ) const
+	{ return in_data() + m_in_offset[v]; }
+	/// end of the incoming particle indices of vertex v
+	const int* particles_in_end( int v ) const
+	{ return in_data() + m_in_offset[v+1]; }
+	/// number of incoming particles of vertex v
+	int particles_in_size( int v ) const
+	{ return m_in_offset[v+1] - m_in_offset[v]; }
+	/// first outgoing particle index of vertex v
+	const int* particles_out_begin( int v ) const
+	{ return out_data() + m_out_offset[v]; }
+	/// end of the outgoing particle indices of vertex v
+	const int* particles_out_end( int v ) const
+	{ return out_data() + m_out_offset[v+1]; }
+	/// number of outgoing particles of vertex v
+	int particles_out_size( int v ) const
+	{ return m_out_offset[v+1] - m_out_offset[v]; }
+
+	/// the raw CSR arrays: the incoming particles of vertex v are
+	/// in_particles()[ in_offsets()[v] ... in_offsets()[v+1] )
+	const std::vector<int>& in_offsets() const   { return m_in_offset; }
+	const std::vector<int>& in_particles() const { return m_in; }
+	/// the outgoing particles, arranged like in_offsets and in_particles
+	const std::vector<int>& out_offsets() const   { return m_out_offset; }
+	const std::vector<int>& out_particles() const { return m_out; }
+	/// production vertex index of each particle
+	const std::vector<int>& production_vertices() const { return m_production; }
+	/// end vertex index of each particle
+	const std::vector<int>& end_vertices() const { return m_end; }
+
+	/// breadth first search from vertex root, filling result with the
+	/// indices of the vertices in range, starting with root itself.
+	/// The ranges are those of GenVertex::vertex_iterator; the order
+	/// is breadth first rather than the post order of the iterator.
+	void vertices( int root, IteratorRange range,
+	               std::vector<int>& result ) const;
+	/// the particle p followed by all particles descending from it
+	void decay_chain( int p, std::vector<int>& result ) const;
+	/// label each vertex with the number of its connected component;
+	/// returns the number of components
+	int  connected_components( std::vector<int>& component ) const;
+
+    private:
+	typedef std::pair<const void*,int> address_index;
+	/// open addressing hash table from addresses to indices; the size
+	/// is a power of two and empty slots have a null address
+	typedef std::vector<address_index> address_table;
+	/// empty table with room for n addresses
+	static void reset( address_table& table, std::size_t n );
+	/// add an address which is not yet in the table
+	static void insert( address_table& table, const void* a, int i );
+	/// index of an address in the table, -1 if it is not there
+	static int find( const address_table& table, const void* a );
+	/// the CSR arrays as pointers, null if empty
+	const int* in_data() const  { return m_in.empty() ? 0 : &m_in[0]; }
+	const int* out_data() const { return m_out.empty() ? 0 : &m_out[0]; }
+
+    private:
+	std::vector<GenVertex*>   m_vertices;
+	std::vector<GenParticle*> m_particles;
+	std::vector<int>          m_in_offset;   // vertices_size()+1 entries
+	std::vector<int>          m_in;
+	std::vector<int>          m_out_offset;  // vertices_size()+1 entries
+	std::vector<int>          m_out;
+	std::vector<int>          m_production;  // particles_size() entries
+	std::vector<int>          m_end;         // particles_size() entries
+	// hashed by address, to find indices
+	address_table             m_vertex_lookup;
+	address_table             m_particle_lookup;
+    };
+
+} // HepMC
+
+#endif  // HEPMC_GRAPH_SNAPSHOT_H
+//--------------------------------------------------------------------------
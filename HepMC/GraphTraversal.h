@@ -0,0 +1,129 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_GRAPH_TRAVERSAL_H
+#define HEPMC_GRAPH_TRAVERSAL_H
+
+//////////////////////////////////////////////////////////////////////////
+// GraphTraversal: iterative walks over the vertices and particles
+// connected to a vertex
+//
+// The walk uses an explicit stack and a table of visited vertices, both
+// kept between calls, so a walk no larger than an earlier one does not
+// allocate.
+//////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <cstddef>
+
+#include "HepMC/IteratorRange.h"
+
+namespace HepMC {
+
+    class GenVertex;
+    class GenParticle;
+
+    //! VertexVisitor is the callback interface used by GraphTraversal
+
+    ///
+    /// \class  VertexVisitor
+    /// Derive from VertexVisitor and implement visit() to be called
+    /// for each vertex found by GraphTraversal::visit.
+    ///
+    class VertexVisitor {
+    public:
+	virtual ~VertexVisitor() {}
+	/// called once for each vertex
+	virtual void visit( GenVertex* ) = 0;
+    };
+
+    //! ParticleVisitor is the callback interface used by GraphTraversal
+
+    ///
+    /// \class  ParticleVisitor
+    /// Derive from ParticleVisitor and implement visit() to be called
+    /// for each particle found by GraphTraversal::visit.
+    ///
+    class ParticleVisitor {
+    public:
+	virtual ~ParticleVisitor() {}
+	/// called once for each particle
+	virtual void visit( GenParticle* ) = 0;
+    };
+
+    //! GraphTraversal walks the graph without recursion or heap allocation
+
+    ///
+    /// \class  GraphTraversal
+    /// GraphTraversal returns the same vertices and particles, in the same
+    /// order, as GenVertex::vertex_iterator and GenVertex::particle_iterator
+    /// for the same IteratorRange: vertices are returned in post order
+    /// with the root vertex last.
+    /// Keep a GraphTraversal and reuse it; its buffers grow to the size
+    /// of the largest walk and are not released between walks.
+    ///
+    /// The visitors are called after the walk has finished, so they may
+    /// use the GenVertex iterators or another GraphTraversal object,
+    /// but not the GraphTraversal which calls them.
+    /// The visited vertices are recorded in the GraphTraversal, not in
+    /// the vertices, so several threads may walk the same event at the
+    /// same time, each with its own GraphTraversal.
+    ///
+    /// Example:
+    ///     HepMC::GraphTraversal walk;
+    ///     const std::vector<HepMC::GenParticle*>& d =
+    ///              walk.particles( *vtx, HepMC::descendants );
+    ///
+    class GraphTraversal {
+
+    public:
+	/// default constructor
+	GraphTraversal();
+
+	/// the vertices connected to root in the given range
+	/// the result is valid until the next walk with this object
+	const std::vector<GenVertex*>&   vertices( GenVertex& root,
+	                                     IteratorRange range = relatives );
+	/// the particles connected to root in the given range
+	/// the result is valid until the next walk with this object
+	const std::vector<GenParticle*>& particles( GenVertex& root,
+	                                     IteratorRange range = relatives );
+
+	/// call v.visit() for each vertex connected to root
+	void visit( GenVertex& root, IteratorRange range, VertexVisitor& v );
+	/// call v.visit() for each particle connected to root
+	void visit( GenVertex& root, IteratorRange range, ParticleVisitor& v );
+
+    private:
+	/// a vertex on the stack, and the next of its edges to follow
+	struct Frame {
+	    GenVertex*  vertex;
+	    std::size_t next;
+	    std::size_t end;
+	};
+	/// fill m_vertices
+	void walk_vertices( GenVertex& root, IteratorRange range );
+	/// push a vertex, with the edges to follow in this range
+	void push( GenVertex* v, IteratorRange range, bool follow_edges );
+	/// a slot of the table of visited vertices, in use if its mark
+	/// is that of the current walk
+	struct Slot {
+	    const GenVertex* vertex;
+	    unsigned long    mark;
+	};
+	/// forget the vertices visited so far, with room for n of them
+	void start_walk( std::size_t n );
+	/// mark v as visited, false if it was visited before
+	bool mark_visited( const GenVertex* v );
+
+    private:
+	std::vector<Frame>        m_stack;
+	std::vector<GenVertex*>   m_vertices;
+	std::vector<GenParticle*> m_particles;
+	std::vector<Slot>         m_visited;  // open addressing, size 2^k
+	std::size_t               m_nvisited;
+	unsigned long             m_mark;
+    };
+
+} // HepMC
+
+#endif  // HEPMC_GRAPH_TRAVERSAL_H
+//--------------------------------------------------------------------------
@@ -0,0 +1,175 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_HEPEVT_BUFFER_H
+#define HEPMC_HEPEVT_BUFFER_H
+
+//////////////////////////////////////////////////////////////////////////
+// HEPEVT_Buffer: a HEPEVT block with its own floorplan
+//
+// A buffer either owns its storage, sized at run time, or views storage
+// owned elsewhere, such as a fortran common block.  The fortran HEPEVT
+// common block used by HEPEVT_Wrapper is one such view, see
+// HEPEVT_Wrapper::common_block(); other buffers let events be converted
+// to and from HEPEVT on several threads at once, each with its own.
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <iostream>
+
+#include "HepMC/HEPEVT_Layout.h"
+
+namespace HepMC {
+
+    //! A HEPEVT block with its own floorplan
+
+    ///
+    /// \class  HEPEVT_Buffer
+    /// The floorplan - number of entries and sizes of integers and
+    /// floating point numbers - is that of HEPEVT_Wrapper, but belongs to
+    /// the buffer.  A buffer which owns its storage grows it when the
+    /// floorplan needs more; a view can not, and dispatch() refuses a
+    /// floorplan larger than the storage viewed.
+    ///
+    /// Use IO_HEPEVT::fill_next_event( buffer, evt ) and
+    /// IO_HEPEVT::write_event( evt, buffer ) to convert events.  A buffer
+    /// may be used by one thread at a time.
+    ///
+    class HEPEVT_Buffer {
+    public:
+	/// storage of its own for max_entries entries
+	explicit HEPEVT_Buffer( int max_entries = 4000,
+	                        unsigned int sizeof_int = 4,
+	                        unsigned int sizeof_real = sizeof(double) );
+	/// view of capacity bytes at data, which stay owned by the caller
+	constexpr HEPEVT_Buffer( void* data, std::size_t capacity, int max_entries,
+	                         unsigned int sizeof_int, unsigned int sizeof_real );
+	/// storage of its own, with the floorplan and contents of other
+	HEPEVT_Buffer( const HEPEVT_Buffer& other );
+	~HEPEVT_Buffer();
+	/// take the floorplan and contents of other; a view which is too
+	/// small is left unchanged
+	HEPEVT_Buffer& operator=( const HEPEVT_Buffer& other );
+
+	////////////////////
+	// Floorplan      //
+	////////////////////
+	int          max_number_entries() const; //!< size of the block
+	unsigned int sizeof_int() const;  //!< size of integer in bytes
+	unsigned int sizeof_real() const; //!< size of real in bytes
+	bool         is_double_precision() const; //!< True if block uses double
+	void set_max_number_entries( int size ); //!< define size of the block
+	void set_sizeof_int( unsigned int size );   //!< define size of integer
+	void set_sizeof_real( unsigned int size );  //!< define size of real
+
+	/// bytes taken by the floorplan
+	std::size_t bytes() const;
+	/// bytes of storage available
+	std::size_t capacity() const;
+	/// start of the storage
+	void* data() const;
+	/// true unless the buffer is a view
+	bool owns_data() const;
+
+	////////////////////
+	// Typed Access   //
+	////////////////////
+	/// typed view of the block, for a floorplan known in advance
+	template <class IntT, class RealT>
+	HEPEVT_Layout<IntT,RealT> layout() const;
+	/// call visitor( layout ) once, with the HEPEVT_Layout which matches
+	/// the floorplan.  Returns false if there is no such layout, or if the
+	/// floorplan does not fit in the storage.
+	template <class Visitor>
+	bool dispatch( Visitor& visitor ) const;
+
+	/// set all entries to zero
+	void zero_everything();
+
+    private:
+	/// make room for bytes(), if the storage is owned
+	void reserve();
+	/// dispatch for one floating point type
+	template <class RealT, class Visitor>
+	bool dispatch_int( Visitor& visitor ) const;
+
+    private: // data members
+	void*        m_data;
+	std::size_t  m_capacity;
+	bool         m_owns_data;
+	int          m_max_number_entries;
+	unsigned int m_sizeof_int;
+	unsigned int m_sizeof_real;
+    };
+
+    ///////////////////////////
+    // INLINES               //
+    ///////////////////////////
+
+    // constexpr, so that a view of a common block is set up before any
+    // dynamic initialization
+    constexpr HEPEVT_Buffer::HEPEVT_Buffer( void* data, std::size_t capacity,
+                                            int max_entries, unsigned int sizeof_int,
+                                            unsigned int sizeof_real )
+      : m_data( data ), m_capacity( capacity ), m_owns_data( false ),
+	m_max_number_entries( max_entries ), m_sizeof_int( sizeof_int ),
+	m_sizeof_real( sizeof_real )
+    {}
+
+    inline int HEPEVT_Buffer::max_number_entries() const
+    { return m_max_number_entries; }
+
+    inline unsigned int HEPEVT_Buffer::sizeof_int() const { return m_sizeof_int; }
+
+    inline unsigned int HEPEVT_Buffer::sizeof_real() const { return m_sizeof_real; }
+
+    inline bool HEPEVT_Buffer::is_double_precision() const
+    { return m_sizeof_real == sizeof(double); }
+
+    inline std::size_t HEPEVT_Buffer::bytes() const
+    {
+	std::size_t n = m_max_number_entries > 0 ? m_max_number_entries : 0;
+	return m_sizeof_int * ( 2 + 6 * n ) + m_sizeof_real * ( 9 * n );
+    }
+
+    inline std::size_t HEPEVT_Buffer::capacity() const { return m_capacity; }
+
+    inline void* HEPEVT_Buffer::data() const { return m_data; }
+
+    inline bool HEPEVT_Buffer::owns_data() const { return m_owns_data; }
+
+    template <class IntT, class RealT>
+    inline HEPEVT_Layout<IntT,RealT> HEPEVT_Buffer::layout() const
+    { return HEPEVT_Layout<IntT,RealT>( m_data, m_max_number_entries ); }
+
+    template <class Visitor>
+    inline bool HEPEVT_Buffer::dispatch( Visitor& visitor ) const
+    {
+	if ( bytes() > m_capacity ) {
+	    std::cerr << "HEPEVT_Buffer: requested hepevt data exceeds allocation"
+		      << std::endl;
+	    return false;
+	}
+	if ( m_sizeof_real == sizeof(double) ) return dispatch_int<double>( visitor );
+	if ( m_sizeof_real == sizeof(float) ) return dispatch_int<float>( visitor );
+	return false;
+    }
+
+    template <class RealT, class Visitor>
+    inline bool HEPEVT_Buffer::dispatch_int( Visitor& visitor ) const
+    {
+	// same order as HEPEVT_Wrapper::byte_num_to_int
+	if ( m_sizeof_int == sizeof(short int) ) {
+	    visitor( layout<short int,RealT>() );
+	} else if ( m_sizeof_int == sizeof(long int) ) {
+	    visitor( layout<long int,RealT>() );
+	} else if ( m_sizeof_int == sizeof(int) ) {
+	    visitor( layout<int,RealT>() );
+	} else {
+	    return false;
+	}
+	return true;
+    }
+
+} // HepMC
+
+#endif  // HEPMC_HEPEVT_BUFFER_H
+//--------------------------------------------------------------------------
@@ -0,0 +1,349 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_HEPEVT_LAYOUT_H
+#define HEPMC_HEPEVT_LAYOUT_H
+
+//////////////////////////////////////////////////////////////////////////
+// HEPEVT_Layout: typed access to a HEPEVT common block whose integer and
+// floating point types are known at compile time
+//
+// HEPEVT_Wrapper decodes the block byte by byte, with the sizes given at
+// run time; here the types are template arguments, so every accessor is
+// a plain load or store at an offset into the integer or the floating
+// point part of the block.  Indices are checked with assert only.
+// Loads and stores go through memcpy, which compiles to a single move,
+// since with 2-byte integers the floating point part need not be aligned.
+//////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+namespace HepMC {
+
+    //! Typed view of a HEPEVT common block
+
+    ///
+    /// \class  HEPEVT_Layout
+    /// The block at data is laid out as
+    ///
+    ///     COMMON/HEPEVT/NEVHEP,NHEP,ISTHEP(NMXHEP),IDHEP(NMXHEP),
+    ///    &   JMOHEP(2,NMXHEP),JDAHEP(2,NMXHEP),PHEP(5,NMXHEP),VHEP(4,NMXHEP)
+    ///
+    /// with integers of type IntT, floating point numbers of type RealT
+    /// and NMXHEP = NMax.  With NMax = 0 the number of entries is given to
+    /// the constructor instead, as for a block sized with
+    /// HEPEVT_Wrapper::set_max_number_entries.
+    ///
+    /// The accessors have the same meaning as those of HEPEVT_Wrapper,
+    /// including the fortran style index: 1 is the first entry.
+    /// The view does not own the block.
+    ///
+    template <class IntT, class RealT, int NMax = 0>
+    class HEPEVT_Layout {
+    public:
+	typedef IntT  int_type;   //!< type of the integers in the block
+	typedef RealT real_type;  //!< type of the floating point numbers
+
+	/// view of the block at data with max_entries entries, if NMax is 0
+	explicit HEPEVT_Layout( void* data, int max_entries = NMax );
+
+	/// size in bytes of a block with max_entries entries
+	static std::size_t bytes( int max_entries = NMax );
+
+	int    max_number_entries() const; //!< size of the block
+	void*  data() const;               //!< start of the block
+
+	////////////////////
+	// Access Methods //
+	////////////////////
+	int    event_number() const;             //!< event number
+	int    number_entries() const;           //!< num entries in current evt
+	int    status( int index ) const;        //!< status code
+	int    id( int index ) const;            //!< PDG particle id
+	int    first_parent( int index ) const;  //!< index of 1st mother
+	int    last_parent( int index ) const;   //!< index of last mother
+	int    number_parents( int index ) const; //!< number of parents
+	int    first_child( int index ) const;   //!< index of 1st daughter
+	int    last_child( int index ) const;    //!< index of last daughter
+	int    number_children( int index ) const; //!< number of children
+	double px( int index ) const;            //!< X momentum
+	double py( int index ) const;            //!< Y momentum
+	double pz( int index ) const;            //!< Z momentum
+	double e( int index ) const;             //!< Energy
+	double m( int index ) const;             //!< generated mass
+	double x( int index ) const;             //!< X Production vertex
+	double y( int index ) const;             //!< Y Production vertex
+	double z( int index ) const;             //!< Z Production vertex
+	double t( int index ) const;             //!< production time
+
+	////////////////////
+	// Set Methods    //
+	////////////////////
+	void set_event_number( int evtno );                         //!< set event number
+	void set_number_entries( int noentries );                   //!< set number of entries
+	void set_status( int index, int status );                   //!< set particle status
+	void set_id( int index, int id );                           //!< set particle ID
+	void set_parents( int index, int firstparent, int lastparent ); //!< define parents
+	void set_children( int index, int firstchild, int lastchild );  //!< define children
+	/// set particle momentum
+	void set_momentum( int index, double px, double py, double pz, double e );
+	void set_mass( int index, double mass );                    //!< set particle mass
+	/// set particle production vertex
+	void set_position( int index, double x, double y, double z, double t );
+
+	/// set all entries to zero, in one pass over the block
+	void zero_everything();
+
+    private:
+	char*  integer( int k ) const;  // k-th integer of the block
+	char*  real( int k ) const;     // k-th floating point number
+	int    get_int( int k ) const;
+	double get_real( int k ) const;
+	void   put_int( int k, int value );
+	void   put_real( int k, double value );
+
+    private: // data members
+	char* m_data;
+	int   m_max_entries;
+    };
+
+    //////////////
+    // INLINES  //
+    //////////////
+
+    template <class IntT, class RealT, int NMax>
+    inline HEPEVT_Layout<IntT,RealT,NMax>::HEPEVT_Layout( void* data, int max_entries )
+      : m_data( static_cast<char*>(data) ),
+	m_max_entries( NMax > 0 ? NMax : max_entries )
+    {}
+
+    template <class IntT, class RealT, int NMax>
+    inline std::size_t HEPEVT_Layout<IntT,RealT,NMax>::bytes( int max_entries )
+    {
+	std::size_t n = NMax > 0 ? NMax : max_entries;
+	return sizeof(IntT) * ( 2 + 6 * n ) + sizeof(RealT) * ( 9 * n );
+    }
+
+    template <class IntT, class RealT, int NMax>
+    inline int HEPEVT_Layout<IntT,RealT,NMax>::max_number_entries() const
+    { return NMax > 0 ? NMax : m_max_entries; }
+
+    template <class IntT, class RealT, int NMax>
+    inline void* HEPEVT_Layout<IntT,RealT,NMax>::data() const
+    { return m_data; }
+
+    template <class IntT, class RealT, int NMax>
+    inline char* HEPEVT_Layout<IntT,RealT,NMax>::integer( int k ) const
+    {
+	assert( k >= 0 && k < 2 + 6 * max_number_entries() );
+	return m_data + sizeof(IntT) * k;
+    }
+
+    template <class IntT, class RealT, int NMax>
+    inline char* HEPEVT_Layout<IntT,RealT,NMax>::real( int k ) const
+    {
+	assert( k >= 0 && k < 9 * max_number_entries() );
+	return m_data + sizeof(IntT) * ( 2 + 6 * max_number_entries() ) + sizeof(RealT) * k;
+    }
+
+    template <class IntT, class RealT, int NMax>
+    inline int HEPEVT_Layout<IntT,RealT,NMax>::get_int( int k ) const
+    {
+	IntT value;
+	std::memcpy( &value, integer(k), sizeof(IntT) );
+	return int(value);
+    }
+
+    template <class IntT, class RealT, int NMax>
+    inline double HEPEVT_Layout<IntT,RealT,NMax>::get_real( int k ) const
+    {
+	RealT value;
+	std::memcpy( &value, real(k), sizeof(RealT) );
+	return double(value);
+    }
+
+    template <class IntT, class RealT, int NMax>
+    inline void HEPEVT_Layout<IntT,RealT,NMax>::put_int( int k, int value )
+    {
+	IntT v = IntT(value);
+	std::memcpy( integer(k), &v, sizeof(IntT) );
+    }
+
+    template <class IntT, class RealT, int NMax>
+    inline void HEPEVT_Layout<IntT,RealT,NMax>::put_real( int k, double value )
+    {
+	RealT v = RealT(value);
+	std::memcpy( real(k), &v, sizeof(RealT) );
+    }
+
+    template <class IntT, class RealT, int NMax>
+    inline int HEPEVT_Layout<IntT,RealT,NMax>::event_number() const
+    { return get_int(0); }
+
+    template <class IntT, class RealT, int NMax>
+    inline int HEPEVT_Layout<IntT,RealT,NMax>::number_entries() const
+    {
+	int nhep = get_int(1);
+	return nhep <= max_number_entries() ? nhep : max_number_entries();
+    }
+
+    template <class IntT, class RealT, int NMax>
+    inline int HEPEVT_Layout<IntT,RealT,NMax>::status( int index ) const
+    { return get_int( 2 + index - 1 ); }
+
+    template <class IntT, class RealT, int NMax>
+    inline int HEPEVT_Layout<IntT,RealT,NMax>::id( int index ) const
+    { return get_int( 2 + max_number_entries() + index - 1 ); }
+
+    template <class IntT, class RealT, int NMax>
+    inline int HEPEVT_Layout<IntT,RealT,NMax>::first_parent( int index ) const
+    {
+	int parent = get_int( 2 + 2*max_number_entries() + 2*(index-1) );
+	return ( parent > 0 && parent <= number_entries() ) ? parent : 0;
+    }
+
+    template <class IntT, class RealT, int NMax>
+    inline int HEPEVT_Layout<IntT,RealT,NMax>::last_parent( int index ) const
+    {
+	// as HEPEVT_Wrapper::last_parent: at least the first parent
+	int firstparent = first_parent(index);
+	int parent = get_int( 2 + 2*max_number_entries() + 2*(index-1) + 1 );
+	return ( parent > firstparent && parent <= number_entries() )
+	    ? parent : firstparent;
+    }
+
+    template <class IntT, class RealT, int NMax>
+    inline int HEPEVT_Layout<IntT,RealT,NMax>::number_parents( int index ) const
+    {
+	int firstparent = first_parent(index);
+	return ( firstparent > 0 ) ? ( 1 + last_parent(index) - firstparent ) : 0;
+    }
+
+    template <class IntT, class RealT, int NMax>
+    inline int HEPEVT_Layout<IntT,RealT,NMax>::first_child( int index ) const
+    {
+	int child = get_int( 2 + 4*max_number_entries() + 2*(index-1) );
+	return ( child > 0 && child <= number_entries() ) ? child : 0;
+    }
+
+    template <class IntT, class RealT, int NMax>
+    inline int HEPEVT_Layout<IntT,RealT,NMax>::last_child( int index ) const
+    {
+	// as HEPEVT_Wrapper::last_child: at least the first child
+	int firstchild = first_child(index);
+	int child = get_int( 2 + 4*max_number_entries() + 2*(index-1) + 1 );
+	return ( child > firstchild && child <= number_entries() )
+	    ? child : firstchild;
+    }
+
+    template <class IntT, class RealT, int NMax>
+    inline int HEPEVT_Layout<IntT,RealT,NMax>::number_children( int index ) const
+    {
+	int firstchild = first_child(index);
+	return ( firstchild > 0 ) ? ( 1 + last_child(index) - firstchild ) : 0;
+    }
+
+    template <class IntT, class RealT, int NMax>
+    inline double HEPEVT_Layout<IntT,RealT,NMax>::px( int index ) const
+    { return get_real( 5*(index-1) + 0 ); }
+
+    template <class IntT, class RealT, int NMax>
+    inline double HEPEVT_Layout<IntT,RealT,NMax>::py( int index ) const
+    { return get_real( 5*(index-1) + 1 ); }
+
+    template <class IntT, class RealT, int NMax>
+    inline double HEPEVT_Layout<IntT,RealT,NMax>::pz( int index ) const
+    { return get_real( 5*(index-1) + 2 ); }
+
+    template <class IntT, class RealT, int NMax>
+    inline double HEPEVT_Layout<IntT,RealT,NMax>::e( int index ) const
+    { return get_real( 5*(index-1) + 3 ); }
+
+    template <class IntT, class RealT, int NMax>
+    inline double HEPEVT_Layout<IntT,RealT,NMax>::m( int index ) const
+    { return get_real( 5*(index-1) + 4 ); }
+
+    template <class IntT, class RealT, int NMax>
+    inline double HEPEVT_Layout<IntT,RealT,NMax>::x( int index ) const
+    { return get_real( 5*max_number_entries() + 4*(index-1) + 0 ); }
+
+    template <class IntT, class RealT, int NMax>
+    inline double HEPEVT_Layout<IntT,RealT,NMax>::y( int index ) const
+    { return get_real( 5*max_number_entries() + 4*(index-1) + 1 ); }
+
+    template <class IntT, class RealT, int NMax>
+    inline double HEPEVT_Layout<IntT,RealT,NMax>::z( int index ) const
+    { return get_real( 5*max_number_entries() + 4*(index-1) + 2 ); }
+
+    template <class IntT, class RealT, int NMax>
+    inline double HEPEVT_Layout<IntT,RealT,NMax>::t( int index ) const
+    { return get_real( 5*max_number_entries() + 4*(index-1) + 3 ); }
+
+    template <class IntT, class RealT, int NMax>
+    inline void HEPEVT_Layout<IntT,RealT,NMax>::set_event_number( int evtno )
+    { put_int( 0, evtno ); }
+
+    template <class IntT, class RealT, int NMax>
+    inline void HEPEVT_Layout<IntT,RealT,NMax>::set_number_entries( int noentries )
+    { put_int( 1, noentries ); }
+
+    template <class IntT, class RealT, int NMax>
+    inline void HEPEVT_Layout<IntT,RealT,NMax>::set_status( int index, int status )
+    { put_int( 2 + index - 1, status ); }
+
+    template <class IntT, class RealT, int NMax>
+    inline void HEPEVT_Layout<IntT,RealT,NMax>::set_id( int index, int id )
+    { put_int( 2 + max_number_entries() + index - 1, id ); }
+
+    template <class IntT, class RealT, int NMax>
+    inline void HEPEVT_Layout<IntT,RealT,NMax>::set_parents( int index, int firstparent,
+                                                             int lastparent )
+    {
+	int jmohep = 2 + 2*max_number_entries() + 2*(index-1);
+	put_int( jmohep, firstparent );
+	put_int( jmohep + 1, lastparent );
+    }
+
+    template <class IntT, class RealT, int NMax>
+    inline void HEPEVT_Layout<IntT,RealT,NMax>::set_children( int index, int firstchild,
+                                                              int lastchild )
+    {
+	int jdahep = 2 + 4*max_number_entries() + 2*(index-1);
+	put_int( jdahep, firstchild );
+	put_int( jdahep + 1, lastchild );
+    }
+
+    template <class IntT, class RealT, int NMax>
+    inline void HEPEVT_Layout<IntT,RealT,NMax>::set_momentum( int index, double px, double py,
+                                                              double pz, double e )
+    {
+	int phep = 5*(index-1);
+	put_real( phep, px );
+	put_real( phep + 1, py );
+	put_real( phep + 2, pz );
+	put_real( phep + 3, e );
+    }
+
+    template <class IntT, class RealT, int NMax>
+    inline void HEPEVT_Layout<IntT,RealT,NMax>::set_mass( int index, double mass )
+    { put_real( 5*(index-1) + 4, mass ); }
+
+    template <class IntT, class RealT, int NMax>
+    inline void HEPEVT_Layout<IntT,RealT,NMax>::set_position( int index, double x, double y,
+                                                              double z, double t )
+    {
+	int vhep = 5*max_number_entries() + 4*(index-1);
+	put_real( vhep, x );
+	put_real( vhep + 1, y );
+	put_real( vhep + 2, z );
+	put_real( vhep + 3, t );
+    }
+
+    template <class IntT, class RealT, int NMax>
+    inline void HEPEVT_Layout<IntT,RealT,NMax>::zero_everything()
+    { std::memset( m_data, 0, bytes( max_number_entries() ) ); }
+
+} // HepMC
+
+#endif  // HEPMC_HEPEVT_LAYOUT_H
+//--------------------------------------------------------------------------
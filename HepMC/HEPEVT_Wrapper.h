@@ -118,6 +118,7 @@ extern "C" {
 
 #include <iostream>
 #include <cstdio>       // needed for formatted output using sprintf
+#include "HepMC/HEPEVT_Buffer.h"
 
 namespace HepMC {
 
@@ -200,6 +201,22 @@ namespace HepMC {
 	static void set_sizeof_real(unsigned int); //!< define size of real
 	static void set_max_number_entries(unsigned int); //!< define size of common block
 
+	//////////////////////
+	// Typed Access     //
+	//////////////////////
+	/// the common block as a HEPEVT_Buffer, whose floorplan is the one
+	/// set here; IO_HEPEVT can also use buffers of its own
+	static HEPEVT_Buffer& common_block();
+	/// typed view of the common block, for a floorplan known in advance
+	template <class IntT, class RealT>
+	static HEPEVT_Layout<IntT,RealT> layout();
+	/// call visitor( layout ) once, with the HEPEVT_Layout of the common
+	/// block which matches sizeof_int() and sizeof_real(), so that a whole
+	/// event is read or written without decoding the sizes for each entry.
+	/// Returns false if there is no such layout.
+	template <class Visitor>
+	static bool dispatch( Visitor& visitor );
+
     protected:
         /// navigate a byte array
 	static double byte_num_to_double( unsigned int );
@@ -213,21 +230,22 @@ namespace HepMC {
 	static void   print_legend( std::ostream& ostr = std::cout );
 
     private:
-	static unsigned int s_sizeof_int;
-	static unsigned int s_sizeof_real;
-	static unsigned int s_max_number_entries;
+	/// the floorplan and storage of the common block
+	static HEPEVT_Buffer s_common_block;
 
     };
 
     //////////////////////////////
     // HEPEVT Floorplan Inlines //
     //////////////////////////////
-    inline unsigned int HEPEVT_Wrapper::sizeof_int(){ return s_sizeof_int; }
+    inline unsigned int HEPEVT_Wrapper::sizeof_int()
+    { return s_common_block.sizeof_int(); }
 
-    inline unsigned int HEPEVT_Wrapper::sizeof_real(){ return s_sizeof_real; }
+    inline unsigned int HEPEVT_Wrapper::sizeof_real()
+    { return s_common_block.sizeof_real(); }
 
     inline int HEPEVT_Wrapper::max_number_entries()
-    { return (int)s_max_number_entries; }
+    { return s_common_block.max_number_entries(); }
 
     inline void HEPEVT_Wrapper::set_sizeof_int( unsigned int size )
     {
@@ -236,7 +254,7 @@ namespace HepMC {
 		      << " of size other than 2 or 4."
 		      << " You requested: " << size << std::endl;
 	}
-	s_sizeof_int = size;
+	s_common_block.set_sizeof_int( size );
     }
 
     inline void HEPEVT_Wrapper::set_sizeof_real( unsigned int size ) {
@@ -245,27 +263,41 @@ namespace HepMC {
 		      << " of size other than 4 or 8."
 		      << " You requested: " << size << std::endl;
 	}
-	s_sizeof_real = size;
+	s_common_block.set_sizeof_real( size );
     }
 
     inline void HEPEVT_Wrapper::set_max_number_entries( unsigned int size ) {
-	s_max_number_entries = size;
+	s_common_block.set_max_number_entries( size );
     }
 
+    ///////////////////////////
+    // Typed Access Inlines  //
+    ///////////////////////////
+    inline HEPEVT_Buffer& HEPEVT_Wrapper::common_block()
+    { return s_common_block; }
+
+    template <class IntT, class RealT>
+    inline HEPEVT_Layout<IntT,RealT> HEPEVT_Wrapper::layout()
+    { return s_common_block.layout<IntT,RealT>(); }
+
+    template <class Visitor>
+    inline bool HEPEVT_Wrapper::dispatch( Visitor& visitor )
+    { return s_common_block.dispatch( visitor ); }
+
     inline double HEPEVT_Wrapper::byte_num_to_double( unsigned int b ) {
 	if ( b >= hepevt_bytes_allocation ) std::cerr
 		  << "HEPEVT_Wrapper: requested hepevt data exceeds allocation"
 		  << std::endl;
-	if ( s_sizeof_real == sizeof(float) ) {
+	if ( sizeof_real() == sizeof(float) ) {
 	    float* myfloat = (float*)&hepevt.data[b];
 	    return (double)(*myfloat);
-	} else if ( s_sizeof_real == sizeof(double) ) {
+	} else if ( sizeof_real() == sizeof(double) ) {
 	    double* mydouble = (double*)&hepevt.data[b];
 	    return (*mydouble);
 	} else {
 	    std::cerr
 		<< "HEPEVT_Wrapper: illegal floating point number length."
-		<< s_sizeof_real << std::endl;
+		<< sizeof_real() << std::endl;
 	}
 	return 0;
     }
@@ -274,20 +306,20 @@ namespace HepMC {
 	if ( b >= hepevt_bytes_allocation ) std::cerr
 		  << "HEPEVT_Wrapper: requested hepevt data exceeds allocation"
 		  << std::endl;
-	if ( s_sizeof_int == sizeof(short int) ) {
+	if ( sizeof_int() == sizeof(short int) ) {
 	    short int* myshortint = (short int*)&hepevt.data[b];
 	    return (int)(*myshortint);
-	} else if ( s_sizeof_int == sizeof(long int) ) {
+	} else if ( sizeof_int() == sizeof(long int) ) {
 	    long int* mylongint = (long int*)&hepevt.data[b];
 	    return (*mylongint);
        // on some 64 bit machines, int, short, and long are all different
-	} else if ( s_sizeof_int == sizeof(int) ) {
+	} else if ( sizeof_int() == sizeof(int) ) {
 	    int* myint = (int*)&hepevt.data[b];
 	    return (*myint);
 	} else {
 	    std::cerr
 		<< "HEPEVT_Wrapper: illegal integer number length."
-		<< s_sizeof_int << std::endl;
+		<< sizeof_int() << std::endl;
 	}
 	return 0;
     }
@@ -296,16 +328,16 @@ namespace HepMC {
 	if ( b >= hepevt_bytes_allocation ) std::cerr
 		  << "HEPEVT_Wrapper: requested hepevt data exceeds allocation"
 		  << std::endl;
-	if ( s_sizeof_real == sizeof(float) ) {
+	if ( sizeof_real() == sizeof(float) ) {
 	    float* myfloat = (float*)&hepevt.data[b];
 	    (*myfloat) = (float)in;
-	} else if ( s_sizeof_real == sizeof(double) ) {
+	} else if ( sizeof_real() == sizeof(double) ) {
 	    double* mydouble = (double*)&hepevt.data[b];
 	    (*mydouble) = (double)in;
 	} else {
 	    std::cerr
 		<< "HEPEVT_Wrapper: illegal floating point number length."
-		<< s_sizeof_real << std::endl;
+		<< sizeof_real() << std::endl;
 	}
     }
 
@@ -313,20 +345,20 @@ namespace HepMC {
 	if ( b >= hepevt_bytes_allocation ) std::cerr
 		  << "HEPEVT_Wrapper: requested hepevt data exceeds allocation"
 		  << std::endl;
-	if ( s_sizeof_int == sizeof(short int) ) {
+	if ( sizeof_int() == sizeof(short int) ) {
 	    short int* myshortint = (short int*)&hepevt.data[b];
 	    (*myshortint) = (short int)in;
-	} else if ( s_sizeof_int == sizeof(long int) ) {
+	} else if ( sizeof_int() == sizeof(long int) ) {
 	    long int* mylongint = (long int*)&hepevt.data[b];
 	    (*mylongint) = (int)in;
        // on some 64 bit machines, int, short, and long are all different
-	} else if ( s_sizeof_int == sizeof(int) ) {
+	} else if ( sizeof_int() == sizeof(int) ) {
 	    int* myint = (int*)&hepevt.data[b];
 	    (*myint) = (int)in;
 	} else {
 	    std::cerr
 		<< "HEPEVT_Wrapper: illegal integer number length."
-		<< s_sizeof_int << std::endl;
+		<< sizeof_int() << std::endl;
 	}
     }
 
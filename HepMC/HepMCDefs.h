@@ -60,6 +60,16 @@
 #define HEPMC_HAS_NAMED_WEIGHTS
 #endif
 
+// the HepMC::WeightHandle class gives fast access to named weights
+#ifndef HEPMC_HAS_WEIGHT_HANDLES
+#define HEPMC_HAS_WEIGHT_HANDLES
+#endif
+
+// GenEvent::is_ancestor and friends use a precomputed HepMC::GenealogyIndex
+#ifndef HEPMC_HAS_GENEALOGY_INDEX
+#define HEPMC_HAS_GENEALOGY_INDEX
+#endif
+
 // define the version of HepMC. 
 #ifndef HEPMC_VERSION
 #define HEPMC_VERSION "2.06.10"
@@ -20,6 +20,7 @@
 //
 
 #include <map>
+#include <utility>
 #include <vector>
 #include "HepMC/IO_BaseClass.h"
 #include "HepMC/HEPEVT_Wrapper.h"
@@ -36,12 +37,20 @@ namespace HepMC {
     /// \class  IO_HEPEVT
     /// IO class for reading the standard HEPEVT common block.
     ///
+    /// Events can also be read from and written to a HEPEVT_Buffer other
+    /// than the common block, so that several threads can convert events
+    /// at once, each with its own IO_HEPEVT and HEPEVT_Buffer.
+    ///
     class IO_HEPEVT : public IO_BaseClass {
     public:
 	IO_HEPEVT();
 	virtual           ~IO_HEPEVT();
 	bool              fill_next_event( GenEvent* );
 	void              write_event( const GenEvent* );
+	/// read one event from buffer, instead of the HEPEVT common block
+	bool              fill_next_event( const HEPEVT_Buffer& buffer, GenEvent* evt );
+	/// write an event to buffer, instead of the HEPEVT common block
+	void              write_event( const GenEvent* evt, HEPEVT_Buffer& buffer );
 	void              print( std::ostream& ostr = std::cout ) const;
 	
 	// see comments below for these switches.
@@ -97,8 +106,32 @@ namespace HepMC {
 	int  find_in_map( 
 	    const std::map<HepMC::GenParticle*,int>& m, GenParticle* p) const;
 
+    private: // the work is done on the HEPEVT_Layout of the buffer
+	template <class Layout>
+	bool fill_from_layout( const Layout& block, GenEvent* evt );
+	template <class Layout>
+	void write_to_layout( Layout block, const GenEvent* evt );
+	/// position of vtx in the vertices of the event being written, -1 if
+	/// it is not one of them
+	int  vertex_position( const GenVertex* vtx ) const;
+	template <class Layout>
+	GenParticle* build_particle( const Layout& block, int index );
+	template <class Layout>
+	void build_production_vertex( const Layout& block,
+	    int i, std::vector<HepMC::GenParticle*>& hepevt_particle, GenEvent* evt );
+	template <class Layout>
+	void build_end_vertex( const Layout& block,
+	    int i, std::vector<HepMC::GenParticle*>& hepevt_particle, GenEvent* evt );
+
+	// visitors given to HEPEVT_Buffer::dispatch
+	struct Reader;
+	struct Writer;
+	struct ParticleBuilder;
+	struct VertexBuilder;
+
     private: // use of copy constructor is not allowed
-	IO_HEPEVT( const IO_HEPEVT& ) : IO_BaseClass() {}
+	IO_HEPEVT( const IO_HEPEVT& ) : IO_BaseClass(), m_entries(), m_vertex_lookup(),
+	                                m_first_in() {}
 
     private: // data members
 
@@ -106,6 +139,15 @@ namespace HepMC {
 	bool m_trust_both_mothers_and_daughters;
 	bool m_print_inconsistency_errors; 
 	bool m_trust_beam_particles;
+
+	// scratch of write_event, sized to the largest event written so far
+	std::vector<const GenParticle*> m_entries;   // by HEPEVT index - 1
+	std::vector<std::pair<const GenVertex*,int> >
+	                                m_vertex_lookup; // position of a vertex
+	                                                 // in the event, hashed
+	                                                 // by its address
+	std::vector<int>                m_first_in;  // HEPEVT index of the first
+	                                             // incoming particle, by vertex
     };
 
     ////////////////////////////
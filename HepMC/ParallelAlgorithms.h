@@ -0,0 +1,164 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_PARALLEL_ALGORITHMS_H
+#define HEPMC_PARALLEL_ALGORITHMS_H
+
+//////////////////////////////////////////////////////////////////////////
+// ParallelAlgorithms: loops and reductions over the particles and
+// vertices of one event, shared among the threads of a ThreadPool
+//
+// The loops run over a GraphSnapshot, so that the list of particles and
+// vertices is fixed while the threads work on it.  The overloads taking
+// a GenEvent build the snapshot first.
+//
+// Thread safety of GenEvent: any number of threads may read an event
+// at the same time, through the const methods and const iterators of
+// GenEvent, GenVertex and GenParticle, as long as no thread modifies it.
+// The exceptions are
+//   - GenEvent::is_ancestor and friends, which build the genealogy index
+//     on first use: call GenEvent::build_genealogy_index() beforehand;
+//   - GraphTraversal, which keeps the result of its last walk: give each
+//     thread its own;
+//   - WeightHandle, which remembers its last lookup: give each thread
+//     its own handles.
+// A loop body may modify the particle or vertex it is given (momentum,
+// status, position...) but must not add, remove or reconnect particles
+// and vertices, or touch the barcodes.
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <vector>
+
+#include "HepMC/EventFingerprint.h"
+#include "HepMC/GraphSnapshot.h"
+#include "HepMC/ThreadPool.h"
+#include "HepMC/SimpleVector.h"
+
+namespace HepMC {
+
+    class GenEvent;
+    class GenVertex;
+    class GenParticle;
+
+    /// call f(GenParticle*) for each particle of the snapshot;
+    /// f is shared by all threads
+    template <class Function>
+    void parallel_for_particles( const GraphSnapshot& g, Function f,
+                                 ThreadPool& pool = ThreadPool::global() );
+    /// call f(GenParticle*) for each particle of the event
+    template <class Function>
+    void parallel_for_particles( const GenEvent& evt, Function f,
+                                 ThreadPool& pool = ThreadPool::global() );
+    /// call f(GenVertex*) for each vertex of the snapshot;
+    /// f is shared by all threads
+    template <class Function>
+    void parallel_for_vertices( const GraphSnapshot& g, Function f,
+                                ThreadPool& pool = ThreadPool::global() );
+    /// call f(GenVertex*) for each vertex of the event
+    template <class Function>
+    void parallel_for_vertices( const GenEvent& evt, Function f,
+                                ThreadPool& pool = ThreadPool::global() );
+
+    /// reduce the indices [0,n): fold( sum, i ) adds item i to a partial
+    /// result, and combine( a, b ) returns the union of two partial results.
+    /// The work is done in blocks of block_size indices; each block starts
+    /// from init, and the block results are combined in order.  The result
+    /// therefore does not depend on the number of threads, also for
+    /// floating point sums.  init must be the identity of combine.
+    template <class T, class Fold, class Combine>
+    T parallel_reduce( std::size_t n, const T& init, Fold fold, Combine combine,
+                       ThreadPool& pool = ThreadPool::global(),
+                       std::size_t block_size = 1024 );
+
+    /// sum of the momenta of the particles with this status,
+    /// or of all particles if status is 0
+    FourVector parallel_sum_momentum( const GraphSnapshot& g, int status = 1,
+                                      ThreadPool& pool = ThreadPool::global() );
+    /// number of particles of each status
+    std::map<int,int> parallel_count_by_status( const GraphSnapshot& g,
+                                      ThreadPool& pool = ThreadPool::global() );
+    /// indices of the vertices, with both incoming and outgoing particles,
+    /// where some component of the momentum differs between the sum of
+    /// the incoming and the sum of the outgoing particles by more than
+    /// tolerance; in increasing order
+    std::vector<int> parallel_check_momentum_conservation( const GraphSnapshot& g,
+                                      double tolerance,
+                                      ThreadPool& pool = ThreadPool::global() );
+    /// GenEvent::fingerprint(), with the vertices and particles hashed
+    /// in parallel; the result is the same as that of the serial method
+    EventFingerprint parallel_fingerprint( const GenEvent& evt, double tolerance = 0,
+                                      ThreadPool& pool = ThreadPool::global() );
+
+    ///////////////////////////
+    // INLINES               //
+    ///////////////////////////
+
+    namespace detail {
+
+	template <class Function, class Item>
+	void parallel_for_each( const std::vector<Item*>& items, Function& f,
+	                        ThreadPool& pool )
+	{
+	    pool.run( items.size(), 
+	              [&]( std::size_t begin, std::size_t end ) {
+			  for ( std::size_t i = begin; i < end; ++i ) f( items[i] );
+		      } );
+	}
+
+    } // detail
+
+    template <class Function>
+    inline void parallel_for_particles( const GraphSnapshot& g, Function f,
+                                        ThreadPool& pool )
+    { detail::parallel_for_each( g.particles(), f, pool ); }
+
+    template <class Function>
+    inline void parallel_for_particles( const GenEvent& evt, Function f,
+                                        ThreadPool& pool )
+    {
+	GraphSnapshot g( evt );
+	detail::parallel_for_each( g.particles(), f, pool );
+    }
+
+    template <class Function>
+    inline void parallel_for_vertices( const GraphSnapshot& g, Function f,
+                                       ThreadPool& pool )
+    { detail::parallel_for_each( g.vertices(), f, pool ); }
+
+    template <class Function>
+    inline void parallel_for_vertices( const GenEvent& evt, Function f,
+                                       ThreadPool& pool )
+    {
+	GraphSnapshot g( evt );
+	detail::parallel_for_each( g.vertices(), f, pool );
+    }
+
+    template <class T, class Fold, class Combine>
+    T parallel_reduce( std::size_t n, const T& init, Fold fold, Combine combine,
+                       ThreadPool& pool, std::size_t block_size )
+    {
+	if ( block_size == 0 ) block_size = 1;
+	std::size_t nblocks = ( n + block_size - 1 ) / block_size;
+	std::vector<T> partial( nblocks, init );
+	pool.run( nblocks, 
+	          [&]( std::size_t begin, std::size_t end ) {
+		      for ( std::size_t b = begin; b < end; ++b ) {
+			  std::size_t last = std::min( n, ( b + 1 ) * block_size );
+			  T& sum = partial[b];
+			  for ( std::size_t i = b * block_size; i < last; ++i ) {
+			      fold( sum, i );
+			  }
+		      }
+		  }, 1 );
+	T result = init;
+	for ( std::size_t b = 0; b < nblocks; ++b ) {
+	    result = combine( result, partial[b] );
+	}
+	return result;
+    }
+
+} // HepMC
+
+#endif  // HEPMC_PARALLEL_ALGORITHMS_H
+//--------------------------------------------------------------------------
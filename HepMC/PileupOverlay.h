@@ -0,0 +1,102 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_PILEUP_OVERLAY_H
+#define HEPMC_PILEUP_OVERLAY_H
+
+//////////////////////////////////////////////////////////////////////////
+// PileupOverlay: merge many events into one, as for pile-up
+//
+// The vertices and particles of a sub-event are moved into the merged
+// event as a whole.  Their barcodes are moved by one offset per
+// sub-event, chosen so that they follow all barcodes already in use;
+// they can then be appended to the barcode maps of the merged event
+// without any search, and the cost of a merge is linear in its size,
+// where GenEvent::add_vertex registers each barcode one at a time.
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <vector>
+
+#include "HepMC/SimpleVector.h"
+
+namespace HepMC {
+
+    class GenEvent;
+    class GenVertex;
+    class GenParticle;
+
+    //! PileupOverlay merges sub-events into one event and remembers their origin
+
+    ///
+    /// \class  PileupOverlay
+    /// The contents of the target event when the overlay is made, usually
+    /// the signal, are sub-event 0.  Each add() moves all vertices and
+    /// particles of a source event into the target, as the next
+    /// sub-event, and leaves the source without vertices and particles.
+    /// The event information of the source (weights, event number,
+    /// signal process vertex, beam particles...) is not merged.
+    ///
+    /// Within a sub-event, barcodes keep their order and their gaps; a
+    /// sub-event whose barcodes do not collide with those in use keeps
+    /// them unchanged.  Vertex positions of a sub-event can be shifted
+    /// by a four vector, which includes a time offset.  Momenta and
+    /// positions are converted to the units of the target if necessary.
+    ///
+    /// sub_event() finds the sub-event of a particle or vertex from its
+    /// barcode, so it is only reliable as long as no other vertices or
+    /// particles are added to the target.
+    ///
+    /// Example:
+    ///     HepMC::PileupOverlay overlay( *signal );
+    ///     for ( int i = 0; i < npileup; ++i ) {
+    ///         HepMC::GenEvent* minbias = input.read_next_event();
+    ///         overlay.add( *minbias, HepMC::FourVector( 0, 0, z[i], t[i] ) );
+    ///         delete minbias;
+    ///     }
+    ///
+    class PileupOverlay {
+
+    public:
+	/// where the vertices and particles of one sub-event are
+	struct SubEvent {
+	    int        particle_offset;  // added to the original barcodes
+	    int        vertex_offset;
+	    int        first_particle;   // barcode range in the target, empty
+	    int        last_particle;    //   if last_particle < first_particle
+	    int        first_vertex;     // vertex barcodes are negative:
+	    int        last_vertex;      //   first_vertex >= last_vertex
+	    FourVector shift;            // added to the vertex positions
+	};
+
+	/// an overlay into target, with the present contents as sub-event 0
+	explicit PileupOverlay( GenEvent& target );
+
+	/// move the vertices and particles of source into the target as
+	/// the next sub-event, shifting vertex positions by shift.
+	/// Returns false, and does nothing, if source is the target.
+	bool add( GenEvent& source, const FourVector& shift = FourVector(0,0,0,0) );
+
+	/// the merged event
+	GenEvent&       target() const { return *m_target; }
+	/// number of sub-events, including sub-event 0
+	std::size_t     sub_events_size() const { return m_sub_events.size(); }
+	/// the barcode ranges of a sub-event
+	const SubEvent& sub_event( std::size_t i ) const { return m_sub_events[i]; }
+
+	/// the sub-event a particle came from, -1 if unknown
+	int             sub_event( const GenParticle* p ) const;
+	/// the sub-event a vertex came from, -1 if unknown
+	int             sub_event( const GenVertex* v ) const;
+
+    private:
+	/// the sub-event whose particle or vertex range holds barcode
+	int find( int barcode ) const;
+
+    private:
+	GenEvent*             m_target;
+	std::vector<SubEvent> m_sub_events;
+    };
+
+} // HepMC
+
+#endif  // HEPMC_PILEUP_OVERLAY_H
+//--------------------------------------------------------------------------
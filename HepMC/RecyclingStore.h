@@ -0,0 +1,192 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_RECYCLING_STORE_H
+#define HEPMC_RECYCLING_STORE_H
+
+//////////////////////////////////////////////////////////////////////////
+// RecyclingStore: memory for objects of one class, recycled instead of
+// returned to the global allocator
+//
+// Each thread keeps the memory of the objects it deleted in a private
+// list, and uses it for the next objects it creates.  A thread which
+// deletes more objects than it creates, like the writer of an event
+// pipeline, passes its surplus in batches to a shared lock free queue,
+// where threads which create more than they delete, like the reader,
+// pick it up.  Only when the queue is empty or full is the global
+// allocator called.
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <new>
+
+#include "HepMC/BoundedQueue.h"
+
+namespace HepMC {
+
+    //! RecyclingStore provides operator new and delete for one class
+
+    ///
+    /// \class  RecyclingStore
+    /// Used by GenParticle and GenVertex.  Each block is allocated by the
+    /// global operator new, so a block can always be given back to the
+    /// global operator delete, for instance after the cache of its thread
+    /// has been destroyed at thread exit.  Objects of a derived class,
+    /// whose size differs from sizeof(T), bypass the store.
+    ///
+    /// At most two batches per thread, and batches_shared batches in the
+    /// shared queue, are kept.
+    ///
+    template <class T>
+    class RecyclingStore {
+
+    public:
+	/// number of blocks moved between a thread and the shared queue at once
+	static const std::size_t batch_size = 256;
+	/// number of batches kept in the shared queue
+	static const std::size_t batches_shared = 256;
+
+	/// memory for an object of this size
+	static void* allocate( std::size_t size );
+	/// give back memory from allocate
+	static void  deallocate( void* p, std::size_t size );
+
+    private:
+	struct Node { Node* next; };
+
+	/// the list of this thread; flushed when the thread ends
+	struct Cache {
+	    Node*       head;
+	    std::size_t count;
+	    int         state;   // 0 before first use, 1 in use, 2 destroyed
+	};
+	/// flushes the cache of its thread at thread exit
+	struct Guard {
+	    ~Guard();
+	};
+	/// the shared queue; deletes the blocks left in it at exit
+	struct Shared {
+	    Shared() : batches( batches_shared ) {}
+	    ~Shared();
+	    BoundedQueue<Node*> batches;
+	};
+
+	static Shared& shared();
+	/// the cache of this thread, or null when it is gone
+	static Cache* cache();
+	/// pass batch_size blocks from the front of c to the shared queue
+	static void   give_batch( Cache& c );
+	/// free all blocks of a list
+	static void   free_list( Node* n );
+
+	static thread_local Cache t_cache;
+    };
+
+    ///////////////////////////
+    // INLINES               //
+    ///////////////////////////
+
+    template <class T>
+    thread_local typename RecyclingStore<T>::Cache RecyclingStore<T>::t_cache = { 0, 0, 0 };
+
+    template <class T>
+    const std::size_t RecyclingStore<T>::batch_size;
+
+    template <class T>
+    const std::size_t RecyclingStore<T>::batches_shared;
+
+    template <class T>
+    RecyclingStore<T>::Guard::~Guard()
+    {
+	Cache& c = t_cache;
+	while ( c.count >= batch_size ) give_batch( c );
+	free_list( c.head );
+	c.head = 0;
+	c.count = 0;
+	c.state = 2;
+    }
+
+    template <class T>
+    RecyclingStore<T>::Shared::~Shared()
+    {
+	Node* n;
+	while ( batches.try_pop( n ) ) free_list( n );
+    }
+
+    template <class T>
+    typename RecyclingStore<T>::Shared& RecyclingStore<T>::shared()
+    {
+	static Shared s;
+	return s;
+    }
+
+    template <class T>
+    typename RecyclingStore<T>::Cache* RecyclingStore<T>::cache()
+    {
+	Cache& c = t_cache;
+	if ( c.state == 0 ) {
+	    // the shared queue is made first, so that it outlives the guard
+	    shared();
+	    static thread_local Guard guard;
+	    (void)guard;
+	    c.state = 1;
+	}
+	return c.state == 1 ? &c : 0;
+    }
+
+    template <class T>
+    void RecyclingStore<T>::give_batch( Cache& c )
+    {
+	Node* first = c.head;
+	Node* last = first;
+	for ( std::size_t i = 1; i < batch_size; ++i ) last = last->next;
+	c.head = last->next;
+	c.count -= batch_size;
+	last->next = 0;
+	if ( !shared().batches.try_push( first ) ) free_list( first );
+    }
+
+    template <class T>
+    void RecyclingStore<T>::free_list( Node* n )
+    {
+	while ( n ) {
+	    Node* next = n->next;
+	    ::operator delete( n );
+	    n = next;
+	}
+    }
+
+    template <class T>
+    void* RecyclingStore<T>::allocate( std::size_t size )
+    {
+	Cache* c = ( size == sizeof(T) ? cache() : 0 );
+	if ( !c ) return ::operator new( size );
+	if ( !c->head ) {
+	    Node* batch;
+	    if ( !shared().batches.try_pop( batch ) ) return ::operator new( size );
+	    c->head = batch;
+	    c->count = batch_size;
+	}
+	Node* n = c->head;
+	c->head = n->next;
+	--c->count;
+	return n;
+    }
+
+    template <class T>
+    void RecyclingStore<T>::deallocate( void* p, std::size_t size )
+    {
+	if ( !p ) return;
+	Cache* c = ( size == sizeof(T) ? cache() : 0 );
+	if ( !c ) {
+	    ::operator delete( p );
+	    return;
+	}
+	Node* n = static_cast<Node*>( p );
+	n->next = c->head;
+	c->head = n;
+	if ( ++c->count >= 2 * batch_size ) give_batch( *c );
+    }
+
+} // HepMC
+
+#endif  // HEPMC_RECYCLING_STORE_H
+//--------------------------------------------------------------------------
@@ -0,0 +1,134 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_SHARED_EVENT_H
+#define HEPMC_SHARED_EVENT_H
+
+//////////////////////////////////////////////////////////////////////////
+// SharedEvent: a reference counted handle to an event which is copied
+// only when a holder wants to modify it
+//
+// Several consumers of the same event, like independent analyses, each
+// keep a copy of the handle.  Consumers which only read share a single
+// GenEvent; the first call to mutable_event() through a handle which is
+// not the only one makes a deep copy for that handle alone.
+//////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <algorithm>
+
+namespace HepMC {
+
+    class GenEvent;
+
+    //! SharedEvent shares one GenEvent between its copies, copy-on-write
+
+    ///
+    /// \class  SharedEvent
+    /// Copies of a handle may be used in different threads at the same
+    /// time: the reference count is atomic, and an event is never modified
+    /// while more than one handle refers to it.  Each thread must use its
+    /// own copy of the handle.  Reading the shared event concurrently
+    /// follows the rules of ParallelAlgorithms.h; in particular call
+    /// GenEvent::build_genealogy_index() before sharing an event whose
+    /// consumers use GenEvent::is_ancestor.
+    ///
+    /// The pointer returned by mutable_event() is valid until the handle
+    /// is copied, assigned, reset or destroyed; do not keep it while
+    /// copies of the handle are made.
+    ///
+    /// Example:
+    ///     HepMC::SharedEvent evt( input.read_next_event() );
+    ///     for ( ... ) analysis[i]->analyze( evt );  // each takes a copy
+    ///     ...
+    ///     void MyAnalysis::analyze( HepMC::SharedEvent evt ) {
+    ///         double e = evt->beam_particles().first->momentum().e();
+    ///         evt.mutable_event()->set_event_scale( e );  // copies
+    ///     }
+    ///
+    class SharedEvent {
+
+    public:
+	/// an empty handle
+	SharedEvent();
+	/// take ownership of evt (null gives an empty handle)
+	explicit SharedEvent( GenEvent* evt );
+	/// share the event of another handle
+	SharedEvent( const SharedEvent& other );
+	/// deletes the event when this is the last handle
+	~SharedEvent();
+
+	SharedEvent& operator=( const SharedEvent& other );
+	void swap( SharedEvent& other );
+
+	/// the event, for reading (null for an empty handle)
+	const GenEvent* get() const;
+	const GenEvent* operator->() const { return get(); }
+	const GenEvent& operator*() const { return *get(); }
+	/// true if the handle has no event
+	bool            empty() const { return m_holder == 0; }
+
+	/// the event, for modification; copies it first unless this is the
+	/// only handle to it (null for an empty handle)
+	GenEvent*       mutable_event();
+	/// give up the event and return it; the caller owns the result,
+	/// which is a copy unless this was the only handle to it
+	GenEvent*       release();
+	/// replace the event with evt, taking ownership of it
+	void            reset( GenEvent* evt = 0 );
+
+	/// number of handles which share this event (0 for an empty handle)
+	long            use_count() const;
+	/// true if this is the only handle to its event
+	bool            unique() const { return use_count() == 1; }
+
+    private:
+	/// the event with its reference count
+	struct Holder {
+	    Holder( GenEvent* e ) : event(e), count(1) {}
+	    GenEvent*         event;
+	    std::atomic<long> count;
+	};
+
+	/// a copy of the shared event, owned by this handle alone
+	/// for internal use only
+	void unshare();
+	/// drop our reference, deleting the event if it was the last one
+	/// for internal use only
+	void drop();
+
+    private:
+	Holder* m_holder;  // null for an empty handle
+    };
+
+    ///////////////////////////
+    // INLINES               //
+    ///////////////////////////
+
+    inline SharedEvent::SharedEvent() : m_holder(0) {}
+
+    inline SharedEvent::SharedEvent( const SharedEvent& other )
+      : m_holder(other.m_holder)
+    { if( m_holder ) m_holder->count.fetch_add( 1, std::memory_order_relaxed ); }
+
+    inline SharedEvent::~SharedEvent() { drop(); }
+
+    inline SharedEvent& SharedEvent::operator=( const SharedEvent& other )
+    {
+	/// best practices implementation
+	SharedEvent tmp( other );
+	swap( tmp );
+	return *this;
+    }
+
+    inline void SharedEvent::swap( SharedEvent& other )
+    { std::swap( m_holder, other.m_holder ); }
+
+    inline const GenEvent* SharedEvent::get() const
+    { return m_holder ? m_holder->event : 0; }
+
+    inline long SharedEvent::use_count() const
+    { return m_holder ? m_holder->count.load( std::memory_order_acquire ) : 0; }
+
+} // HepMC
+
+#endif  // HEPMC_SHARED_EVENT_H
+//--------------------------------------------------------------------------
@@ -10,6 +10,7 @@
 
 #include <string>
 #include "HepMC/Units.h"
+#include "HepMC/WeightContainer.h"
 
 namespace HepMC {
 
@@ -94,6 +95,14 @@ public:
     /// set the reading_event_header flag
     void set_reading_event_header(bool);
 
+    /// the last named weight line read from this stream
+    const std::string& weight_names_line() const { return m_weight_names_line; }
+    /// weights carrying the names from weight_names_line()
+    /// events read from this stream share this table of names
+    const WeightContainer& weight_names() const { return m_weight_names; }
+    /// remember the names found on a named weight line
+    void set_weight_names( const std::string& line, const WeightContainer& w );
+
 private: // data members
     bool        m_finished_first_event_io;
     // GenEvent I/O method keys
@@ -116,9 +125,11 @@ private: // data members
     Units::LengthUnit   m_io_position_unit;
     // used to keep identify the I/O stream
     unsigned int m_stream_id;
-    static unsigned int m_stream_counter;
     // used to keep track when reading event
     bool m_reading_event_header;
+    // weight names interned for all events read from this stream
+    std::string     m_weight_names_line;
+    WeightContainer m_weight_names;
 
 };
 
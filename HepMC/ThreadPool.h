@@ -0,0 +1,116 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_THREAD_POOL_H
+#define HEPMC_THREAD_POOL_H
+
+//////////////////////////////////////////////////////////////////////////
+// ThreadPool: a fixed set of threads which share the work of a loop
+//
+// run() splits the range [0,n) into one block per thread.  Each thread
+// takes small chunks from the front of its own block; a thread which has
+// finished its block steals the back half of the largest remaining part
+// of another block, so uneven work is rebalanced without a central queue.
+//////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace HepMC {
+
+//! ThreadPool runs loops over an index range on several threads
+
+///
+/// \class  ThreadPool
+/// The thread calling run() works on the loop too, so a pool of size n
+/// starts n-1 threads.  A pool runs one loop at a time; run() called
+/// from several threads waits for the pool to be free.  run() called
+/// from inside a loop body of the same pool, directly or through the
+/// loops of other pools, runs the inner loop in the calling thread,
+/// since the threads of the pool are all busy with the outer loop.  A
+/// loop body may run loops on another pool in parallel; those wait for
+/// each other if several threads of the outer loop start them.
+/// If a loop body throws, the remaining chunks are skipped and the first
+/// exception is rethrown by run().
+///
+/// Most code uses the shared pool returned by ThreadPool::global(),
+/// whose size can be set before its first use.
+///
+class ThreadPool {
+
+public:
+    /// the loop body, called with a range [begin,end) of indices
+    typedef std::function<void( std::size_t, std::size_t )> range_function;
+
+    /// a pool of nthreads threads (including the caller of run());
+    /// 0 means one per hardware thread
+    explicit ThreadPool( unsigned nthreads = 0 );
+    /// waits for the threads to finish
+    ~ThreadPool();
+
+    /// number of threads working on a loop, including the caller
+    unsigned size() const { return m_size; }
+
+    /// call body for all indices in [0,n), in chunks of about grain
+    /// indices; grain 0 chooses a chunk size from n and size().
+    /// Returns when all indices are done.
+    void run( std::size_t n, const range_function& body, std::size_t grain = 0 );
+
+    /// the shared pool
+    static ThreadPool& global();
+    /// set the size of the shared pool; returns false (and does nothing)
+    /// if the shared pool is already in use
+    static bool set_global_size( unsigned nthreads );
+
+private:
+    /// a loop a thread is working on, and the loop from which it was
+    /// started, if any (defined in ThreadPool.cc)
+    struct LoopScope;
+    /// the part of the range still to be done by one thread
+    struct Block {
+	std::mutex  lock;
+	std::size_t begin;
+	std::size_t end;
+    };
+    /// wait for loops and work on them, for the threads of the pool
+    void worker( unsigned id );
+    /// work on the current loop until no chunks are left
+    void work( unsigned id );
+    /// the next chunk for thread id, from its own block or stolen
+    bool next_chunk( unsigned id, std::size_t& begin, std::size_t& end );
+    /// true if the calling thread works on a loop of this pool,
+    /// possibly through the loops of other pools
+    bool is_running_here() const;
+
+    ThreadPool( const ThreadPool& ) = delete;
+    ThreadPool& operator=( const ThreadPool& ) = delete;
+
+private:
+    unsigned                  m_size;
+    std::unique_ptr<Block[]>  m_blocks;      // one per thread
+    std::vector<std::thread>  m_threads;
+    std::mutex                m_run;         // one loop at a time
+    std::mutex                m_lock;        // protects the state below
+    std::condition_variable   m_start;
+    std::condition_variable   m_finished;
+    unsigned long             m_generation;  // number of loops started
+    unsigned                  m_busy;        // threads still in the loop
+    bool                      m_stop;
+    std::atomic<bool>         m_failed;      // a loop body has thrown
+    std::exception_ptr        m_error;
+    const range_function*     m_body;
+    std::size_t               m_grain;
+    const LoopScope*          m_scope;       // of the current loop
+    /// the loops the calling thread is working on, innermost first
+    static thread_local const LoopScope* s_scope;
+};
+
+} // HepMC
+
+#endif  // HEPMC_THREAD_POOL_H
+//--------------------------------------------------------------------------
@@ -0,0 +1,117 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_TRUTH_SKIMMER_H
+#define HEPMC_TRUTH_SKIMMER_H
+
+//////////////////////////////////////////////////////////////////////////
+// TruthSkimmer: copy selected particles with their ancestry and decays
+//
+// The ancestors and descendants of all seeds are found together, by one
+// breadth first search in each direction, so a particle shared by several
+// seeds is visited and copied only once.  The cost is proportional to the
+// size of the reduced event, not of the whole event.
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace HepMC {
+
+    class GenEvent;
+    class GenVertex;
+    class GenParticle;
+
+    //! TruthSkimmer builds a reduced event around a set of seed particles
+
+    ///
+    /// \class  TruthSkimmer
+    /// The reduced event contains copies of
+    ///  - the seed particles,
+    ///  - their ancestors, up to ancestor_depth generations,
+    ///  - their descendants, down to descendant_depth generations,
+    ///  - if keep_hard_process is set, the beam particles and the
+    ///    particles entering and leaving the signal process vertex,
+    /// and of every vertex which one of these particles enters or leaves.
+    /// A depth of 0 takes no relatives, 1 the parents (or children), and
+    /// all_generations the whole ancestry (or decay chain), as in the
+    /// IteratorRange values parents and ancestors.  As for
+    /// GenVertex::particles_begin(ancestors), the ancestors are the
+    /// particles entering the production vertex, and their ancestors;
+    /// sisters of the seeds are not copied.
+    ///
+    /// Vertices and particles keep their barcodes, positions, momenta and
+    /// all other properties, and the vertices keep the order of their
+    /// particles.  The event information (numbers, weights, units, cross
+    /// section, heavy ion and pdf information) is copied as well.
+    ///
+    /// Example:
+    ///     HepMC::TruthSkimmer skimmer( HepMC::TruthSkimmer::all_generations,
+    ///                                  HepMC::TruthSkimmer::all_generations );
+    ///     HepMC::GenEvent slim;
+    ///     skimmer.skim( *evt, is_lepton_or_heavy_hadron, slim );
+    ///
+    class TruthSkimmer {
+
+    public:
+	/// returns true for a seed particle
+	typedef std::function<bool( const GenParticle* )> particle_predicate;
+	/// depth which follows the whole ancestry or decay chain
+	static const int all_generations = -1;
+
+	/// skimmer keeping the whole ancestry and decay chain of the seeds,
+	/// and the hard process
+	explicit TruthSkimmer( int ancestor_depth = all_generations,
+	                       int descendant_depth = all_generations,
+	                       bool keep_hard_process = true );
+
+	int  ancestor_depth() const    { return m_ancestor_depth; }
+	int  descendant_depth() const  { return m_descendant_depth; }
+	bool keep_hard_process() const { return m_keep_hard_process; }
+	/// number of generations of ancestors to keep
+	void set_ancestor_depth( int depth )    { m_ancestor_depth = depth; }
+	/// number of generations of descendants to keep
+	void set_descendant_depth( int depth )  { m_descendant_depth = depth; }
+	/// keep the beams and the particles of the signal process vertex
+	void set_keep_hard_process( bool keep ) { m_keep_hard_process = keep; }
+
+	/// replace the contents of out with the reduced event
+	/// for these seeds (particles of evt); returns the number of
+	/// particles copied
+	std::size_t skim( const GenEvent& evt,
+	                  const std::vector<const GenParticle*>& seeds,
+	                  GenEvent& out );
+	/// replace the contents of out with the reduced event for the
+	/// particles of evt selected by is_seed
+	std::size_t skim( const GenEvent& evt, const particle_predicate& is_seed,
+	                  GenEvent& out );
+
+    private:
+	/// breadth first search from m_seeds, adding particles to m_copy
+	void search( bool up, int depth );
+	/// copy the kept particles and their vertices into out
+	std::size_t copy( const GenEvent& evt, GenEvent& out );
+	/// keep particle p
+	void keep( const GenParticle* p ) { m_copy.insert( std::make_pair( p, (GenParticle*)0 ) ); }
+
+    private:
+	typedef std::pair<const GenParticle*,int> particle_generation;
+	int              m_ancestor_depth;
+	int              m_descendant_depth;
+	bool             m_keep_hard_process;
+	// scratch space, kept between events
+	std::vector<const GenParticle*>   m_seeds;
+	std::vector<particle_generation>  m_queue;
+	std::unordered_set<const GenParticle*> m_queued;
+	std::unordered_set<const GenVertex*>   m_vertex_done; // vertices expanded
+	// the kept particles, and their copies
+	std::unordered_map<const GenParticle*,GenParticle*> m_copy;
+	std::vector<const GenVertex*>     m_vertices;
+    };
+
+} // HepMC
+
+#endif  // HEPMC_TRUTH_SKIMMER_H
+//--------------------------------------------------------------------------
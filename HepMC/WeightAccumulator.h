@@ -0,0 +1,107 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_WEIGHT_ACCUMULATOR_H
+#define HEPMC_WEIGHT_ACCUMULATOR_H
+
+//////////////////////////////////////////////////////////////////////////
+// WeightAccumulator: running sums of all event weights
+//
+// Accumulates the sum of weights and the sum of squared weights for
+// every weight of a WeightContainer.  Events whose weights share the name
+// table of the accumulator (e.g. all events read from one stream) are
+// added position by position; other events are matched by name.
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "HepMC/WeightContainer.h"
+#include "HepMC/GenCrossSection.h"
+
+namespace HepMC {
+
+//! WeightAccumulator sums event weights for cross sections and uncertainties
+
+///
+/// \class  WeightAccumulator
+/// Add the weights of each event with add().  When processing events in
+/// several threads, give every worker its own WeightAccumulator and
+/// merge() them once the workers are done; no locking is needed since
+/// a single accumulator is never shared.
+///
+/// The statistics assume the usual convention that the event weights
+/// are in pb, so the mean weight estimates the cross section.
+///
+class WeightAccumulator {
+
+public:
+    /// size type used for the weight positions
+    typedef WeightContainer::size_type size_type;
+
+    /// an empty accumulator, which takes its names from the first event
+    WeightAccumulator();
+    /// an empty accumulator with the weight names of w
+    explicit WeightAccumulator( const WeightContainer& w );
+
+    /// swap
+    void swap( WeightAccumulator & other );
+
+    /// add the weights of one event
+    void add( const WeightContainer& w );
+    /// add the sums of another accumulator
+    void merge( const WeightAccumulator& other );
+    /// same as merge
+    WeightAccumulator& operator+=( const WeightAccumulator& other );
+    /// reset all sums, keeping the names
+    void reset();
+
+    /// number of weights being accumulated
+    size_type     size() const { return m_sumw.size(); }
+    /// number of events added
+    unsigned long entries() const { return m_entries; }
+    /// the sums of weights, with the weight names
+    const WeightContainer& sums() const { return m_sumw; }
+
+    /// position of a named weight, size() if the name is not known
+    size_type index( const std::string& name ) const;
+
+    /// sum of weights
+    double sum_of_weights( size_type i = 0 ) const { return m_sumw[i]; }
+    /// sum of squared weights
+    double sum_of_squared_weights( size_type i = 0 ) const { return m_sumw2[i]; }
+    /// mean weight, which is the cross section estimate
+    double mean( size_type i = 0 ) const;
+    /// statistical error of the mean weight
+    double error_of_mean( size_type i = 0 ) const;
+    /// effective number of entries (sum w)^2 / (sum w^2)
+    double effective_entries( size_type i = 0 ) const;
+
+    /// cross section and its error for the weight at position i
+    GenCrossSection cross_section( size_type i = 0 ) const;
+    /// cross section and its error for the named weight
+    /// throws std::out_of_range if the name is not known
+    GenCrossSection cross_section( const std::string& name ) const;
+
+    /// write the statistics of all weights in a readable table
+    void write( std::ostream& ostr = std::cout ) const;
+
+private:
+    /// the position of each weight of w in our sums, adding new names
+    void map_names( const WeightContainer& w, std::vector<size_type>& pos );
+    /// make room for new weights
+    void resize( size_type n );
+    /// true if no weight names are known yet
+    bool empty_names() const;
+
+private:
+    WeightContainer     m_sumw;    // sums of weights, with the names
+    std::vector<double> m_sumw2;
+    unsigned long       m_entries;
+    // scratch space used when the names of an event differ from ours
+    std::vector<size_type> m_positions;
+};
+
+} // HepMC
+
+#endif  // HEPMC_WEIGHT_ACCUMULATOR_H
+//--------------------------------------------------------------------------
@@ -11,8 +11,11 @@
 //
 // This implementation adds a map-like interface in addition to the 
 // vector-like interface.
+// The weight names are held in an immutable, reference counted table
+// which is shared between copies and copied only when it is modified.
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <string>
@@ -20,14 +23,23 @@
 
 namespace HepMC {
 
+    class WeightHandle;
+
     //! Container for the Weights associated with an event or vertex.
 
     ///
     /// \class  WeightContainer
     /// This class has both map-like and vector-like functionality.
     /// Named weights are now supported.
+    /// Copies share the table of weight names, so copying a WeightContainer
+    /// costs only the copy of the weight values.  A private copy of the
+    /// names is made when a shared table is modified (copy-on-write).
+    /// The table is reference counted atomically, so copies sharing it
+    /// may be made and destroyed in different threads.
     class WeightContainer {
 	friend class GenEvent;
+	friend class WeightHandle;
+	friend class WeightAccumulator;
 
     public:
         /// defining the size type used by vector and map
@@ -70,6 +82,10 @@ namespace HepMC {
 
 	/// check to see if a name exists in the map
 	bool          has_key( const std::string& s ) const;
+	/// true if both containers use the very same table of weight names
+	bool          shares_names_with( const WeightContainer& ) const;
+	/// the weight names, in the order of the weights
+	std::vector<std::string> names() const;
 
         /// access the weight container
 	double&       operator[]( size_type n );  // unchecked access
@@ -79,6 +95,12 @@ namespace HepMC {
 	double&       operator[]( const std::string& s );  // unchecked access
         /// access the weight container
 	const double& operator[]( const std::string& s ) const;
+        /// access the weight container using a resolved name
+        /// (defined in WeightHandle.h)
+	double&       operator[]( const WeightHandle& h );
+        /// access the weight container using a resolved name
+        /// (defined in WeightHandle.h)
+	const double& operator[]( const WeightHandle& h ) const;
 
         /// equality
 	bool operator==( const WeightContainer & ) const;
@@ -106,32 +128,47 @@ namespace HepMC {
     private:
         // for internal use only
 
+	/// map from weight name to position in the weight vector
+	typedef std::map<std::string,size_type> name_map;
         /// maplike iterator for the weight container
 	/// for internal use only
-	typedef std::map<std::string,size_type>::iterator       map_iterator;
-        /// const iterator for the weight container
-	/// for internal use only
-	typedef std::map<std::string,size_type>::const_iterator const_map_iterator;
-	/// begining of the weight container
-	/// for internal use only
-	map_iterator            map_begin();
-	/// end of the weight container
-	/// for internal use only
-	map_iterator            map_end();
+	typedef name_map::const_iterator const_map_iterator;
 	/// begining of the weight container
 	/// for internal use only
 	const_map_iterator      map_begin() const;
 	/// end of the weight container
 	/// for internal use only
 	const_map_iterator      map_end() const;
-	
+
+	/// reference counted table of weight names, immutable while shared
+	/// (defined in WeightContainer.cc)
+	struct NameTable;
+
 	/// used by the constructors to set initial names
 	/// for internal use only
 	void set_default_names( size_type n );
+	/// get a table of names which is not shared with anyone else
+	/// for internal use only
+	name_map& unshared_names();
+	/// use the same table of names as another container
+	/// for internal use only
+	void share_names( const WeightContainer& other );
+	/// drop our reference to the table of names
+	/// for internal use only
+	void release_names();
+	/// find a name in the table, map_end() if there is none
+	/// for internal use only
+	const_map_iterator find_name( const std::string& s ) const;
+	/// add a reference to a table, which may be null
+	/// for internal use only
+	static NameTable* acquire( NameTable* t );
+	/// drop a reference to a table, which may be null
+	/// for internal use only
+	static void release( NameTable* t );
 	
     private:
 	std::vector<double>          m_weights;
-	std::map<std::string,size_type> m_names;
+	NameTable*                   m_names;  // null if there are no names
     };
 
     ///////////////////////////
@@ -140,14 +177,14 @@ namespace HepMC {
 
     inline WeightContainer::WeightContainer( const WeightContainer& in )
 	: m_weights(in.m_weights), m_names(in.m_names)
-    {}
+    { acquire( m_names ); }
 
-    inline WeightContainer::~WeightContainer() {}
+    inline WeightContainer::~WeightContainer() { release_names(); }
 
     inline void WeightContainer::swap( WeightContainer & other)
     { 
         m_weights.swap( other.m_weights ); 
-        m_names.swap( other.m_names ); 
+        std::swap( m_names, other.m_names ); 
     }
 
     inline WeightContainer& WeightContainer::operator=
@@ -173,7 +210,23 @@ namespace HepMC {
     inline void WeightContainer::clear() 
     { 
 	m_weights.clear(); 
-	m_names.clear(); 
+	release_names(); 
+    }
+
+    inline bool WeightContainer::shares_names_with( const WeightContainer& other ) const
+    { return m_names != 0 && m_names == other.m_names; }
+
+    inline void WeightContainer::release_names()
+    {
+	release( m_names );
+	m_names = 0;
+    }
+
+    inline void WeightContainer::share_names( const WeightContainer& other )
+    {
+	if( m_names == other.m_names ) return;
+	release_names();
+	m_names = acquire( other.m_names );
     }
 
     inline double& WeightContainer::operator[]( size_type n ) 
@@ -204,18 +257,6 @@ namespace HepMC {
     inline WeightContainer::const_iterator WeightContainer::end() const 
     { return m_weights.end(); }
 
-    inline WeightContainer::map_iterator WeightContainer::map_begin() 
-    { return m_names.begin(); }
-
-    inline WeightContainer::map_iterator WeightContainer::map_end() 
-    { return m_names.end(); }
-
-    inline WeightContainer::const_map_iterator WeightContainer::map_begin() const 
-    { return m_names.begin(); }
-
-    inline WeightContainer::const_map_iterator WeightContainer::map_end() const 
-    { return m_names.end(); }
-
 } // HepMC
 
 #endif  // HEPMC_WEIGHT_CONTAINER_H
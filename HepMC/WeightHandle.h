@@ -0,0 +1,150 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_WEIGHT_HANDLE_H
+#define HEPMC_WEIGHT_HANDLE_H
+
+//////////////////////////////////////////////////////////////////////////
+// WeightHandle: a weight name resolved to its position in the weights
+//
+// Looking up a named weight in a WeightContainer is a string search.
+// A WeightHandle does that search once and remembers the table of names
+// it was resolved against.  As long as a WeightContainer uses the same
+// table (e.g. all events read from one stream), access is a plain
+// vector index.  If the table changes, the handle resolves itself again.
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "HepMC/WeightContainer.h"
+
+namespace HepMC {
+
+//! WeightHandle gives fast access to one named weight
+
+///
+/// \class  WeightHandle
+/// A WeightHandle is created from a weight name and resolved against
+/// the names of a WeightContainer (for instance from the first event or
+/// a header) or against the names last read from an input stream.
+/// Validity is checked by comparing table identity, so it is cheap.
+///
+/// Example:
+///     HepMC::WeightHandle up("scale_up");
+///     while( evt ) {
+///         double w = evt->weights()[up];
+///         ...
+///     }
+///
+class WeightHandle {
+
+public:
+    /// size type used for the position of the weight
+    typedef WeightContainer::size_type size_type;
+
+    /// an unnamed handle which never resolves
+    WeightHandle();
+    /// a named handle which is resolved on first use
+    explicit WeightHandle( const std::string& name );
+    /// a named handle resolved against the names of this container
+    WeightHandle( const std::string& name, const WeightContainer& names );
+    /// a named handle resolved against the weight names read from this stream
+    WeightHandle( const std::string& name, std::istream& is );
+    /// copy
+    WeightHandle( const WeightHandle& );
+    ~WeightHandle();
+
+    /// swap
+    void swap( WeightHandle& other );
+    /// copy assignment
+    WeightHandle& operator=( const WeightHandle& );
+
+    /// the weight name
+    const std::string& name() const { return m_name; }
+
+    /// resolve against the names of this container;
+    /// return true if the name was found
+    bool resolve( const WeightContainer& names ) const;
+    /// resolve against the weight names last read from this stream;
+    /// return true if the name was found
+    bool resolve( std::istream& is ) const;
+
+    /// true if the handle was resolved against the names used by w,
+    /// i.e. index() may be used with w without a new lookup
+    bool is_valid_for( const WeightContainer& w ) const;
+    /// true if the name was found the last time the handle was resolved
+    bool is_found() const { return m_index != npos(); }
+    /// position of the weight, npos() if the name was not found
+    size_type index() const { return m_index; }
+    /// returned by index() if the name is not known
+    static size_type npos() { return size_type(-1); }
+
+    /// the named weight in w, resolving again if the names have changed
+    /// throws std::out_of_range if w has no weight with this name
+    const double& value( const WeightContainer& w ) const;
+    /// the named weight in w, resolving again if the names have changed
+    /// throws std::out_of_range if w has no weight with this name
+    double&       value( WeightContainer& w ) const;
+
+private:
+    /// resolve again if w uses another table of names
+    size_type checked_index( const WeightContainer& w ) const;
+    /// drop our reference to the table of names
+    void      release() const;
+    /// throw std::out_of_range for a name which is not in the container
+    void      not_found() const;
+
+private:
+    std::string                           m_name;
+    // the table of names we were resolved against, and our reference to it
+    mutable WeightContainer::NameTable*   m_table;
+    mutable size_type                     m_index;
+};
+
+/// fill values with the weights named by the handles, in the same order
+/// throws std::out_of_range if any name is not in w
+void get_weights( const WeightContainer& w,
+                  const std::vector<WeightHandle>& handles,
+                  std::vector<double>& values );
+/// return the weights named by the handles, in the same order
+std::vector<double> get_weights( const WeightContainer& w,
+                                 const std::vector<WeightHandle>& handles );
+
+///////////////////////////
+// INLINES               //
+///////////////////////////
+
+inline bool WeightHandle::is_valid_for( const WeightContainer& w ) const
+{ return m_table != 0 && m_table == w.m_names; }
+
+inline WeightHandle::size_type
+WeightHandle::checked_index( const WeightContainer& w ) const
+{
+    if( m_table != w.m_names ) resolve( w );
+    return m_index;
+}
+
+inline const double& WeightHandle::value( const WeightContainer& w ) const
+{
+    size_type i = checked_index( w );
+    if( i >= w.size() ) not_found();
+    return w.m_weights[i];
+}
+
+inline double& WeightHandle::value( WeightContainer& w ) const
+{
+    size_type i = checked_index( w );
+    if( i >= w.size() ) not_found();
+    return w.m_weights[i];
+}
+
+inline double& WeightContainer::operator[]( const WeightHandle& h )
+{ return h.value( *this ); }
+
+inline const double& WeightContainer::operator[]( const WeightHandle& h ) const
+{ return h.value( *this ); }
+
+} // HepMC
+
+#endif  // HEPMC_WEIGHT_HANDLE_H
+//--------------------------------------------------------------------------
@@ -2,7 +2,9 @@
 #  building HepMC with cmake
 #-------------------------------------------------------------
 
-This package requires cmake 2.6 or later.
+This package requires cmake 2.6 or later,
+and a C++11 compiler (see INSTALL).
+g++ and clang build with -std=c++11 -pthread.
 
 #-------------------------------------------------------------
 #  installing from a source code tar ball
@@ -35,14 +35,14 @@ macro( hepmc_autoconf_variables )
 
   # these variables are used by <package>-config.in
   # typical values from autoconf:
-  #   AM_CXXFLAGS = -O -ansi -pedantic -Wall -D_GNU_SOURCE
+  #   AM_CXXFLAGS = -O -std=c++11 -pedantic -Wall -D_GNU_SOURCE -pthread
   #   CXXFLAGS = -g -O2
   #   CXX = g++
   #   CXXCPP = g++ -E
   #   CPPFLAGS = 
   #   CXXLD = $(CXX)
   #   AM_LDFLAGS = 
-  #   LDFLAGS = 
+  #   LDFLAGS = -pthread
   #   LIBS = 
 
   # automake/autoconf variables
@@ -84,11 +84,20 @@ macro( hepmc_set_compiler_flags )
   if( CMAKE_COMPILER_IS_GNUCC )
     set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -O -ansi -pedantic -Wall -D_GNU_SOURCE")
   endif(CMAKE_COMPILER_IS_GNUCC)
-  if(CMAKE_COMPILER_IS_GNUCXX)
-    set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -O -ansi -pedantic -Wall -D_GNU_SOURCE")
-  endif(CMAKE_COMPILER_IS_GNUCXX)
+  # HepMC and code using its headers need C++11 and the thread library;
+  # the same flags are written to the example makefiles
+  if(CMAKE_COMPILER_IS_GNUCXX OR CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -O -std=c++11 -pedantic -Wall -D_GNU_SOURCE -pthread")
+    set(CMAKE_EXE_LINKER_FLAGS "${CMAKE_EXE_LINKER_FLAGS} -pthread")
+    set(CMAKE_SHARED_LINKER_FLAGS "${CMAKE_SHARED_LINKER_FLAGS} -pthread")
+    set(CMAKE_MODULE_LINKER_FLAGS "${CMAKE_MODULE_LINKER_FLAGS} -pthread")
+  endif()
   if( ${CMAKE_SYSTEM_NAME} MATCHES "Windows" )
     if( ${CMAKE_BASE_NAME} MATCHES "cl" )
+      # thread_local and the C++11 thread library need Visual C++ 2015
+      if( MSVC_VERSION LESS 1900 )
+        message(FATAL_ERROR "HepMC needs Visual C++ 2015 or later")
+      endif()
       set(CMAKE_C_FLAGS "/EHsc /nologo /GR /MD")
       set(CMAKE_CXX_FLAGS "/EHsc /nologo /GR /MD")
     endif()
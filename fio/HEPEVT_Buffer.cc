@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////////////////
+// HEPEVT_Buffer.cc
+//
+// a HEPEVT block with its own floorplan, owning or viewing its storage
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstring>
+
+#include "HepMC/HEPEVT_Buffer.h"
+
+namespace HepMC {
+
+HEPEVT_Buffer::HEPEVT_Buffer( int max_entries, unsigned int sizeof_int,
+                              unsigned int sizeof_real )
+  : m_data(0), m_capacity(0), m_owns_data(true),
+    m_max_number_entries(max_entries), m_sizeof_int(sizeof_int),
+    m_sizeof_real(sizeof_real)
+{
+    reserve();
+}
+
+HEPEVT_Buffer::HEPEVT_Buffer( const HEPEVT_Buffer& other )
+  : m_data(0), m_capacity(0), m_owns_data(true),
+    m_max_number_entries(other.m_max_number_entries),
+    m_sizeof_int(other.m_sizeof_int), m_sizeof_real(other.m_sizeof_real)
+{
+    reserve();
+    std::memcpy( m_data, other.m_data, std::min( bytes(), other.m_capacity ) );
+}
+
+HEPEVT_Buffer::~HEPEVT_Buffer()
+{
+    if ( m_owns_data ) delete [] static_cast<double*>( m_data );
+}
+
+HEPEVT_Buffer& HEPEVT_Buffer::operator=( const HEPEVT_Buffer& other )
+{
+    if ( this == &other ) return *this;
+    if ( !m_owns_data && other.bytes() > m_capacity ) {
+	std::cerr << "HEPEVT_Buffer: requested hepevt data exceeds allocation"
+		  << std::endl;
+	return *this;
+    }
+    m_max_number_entries = other.m_max_number_entries;
+    m_sizeof_int = other.m_sizeof_int;
+    m_sizeof_real = other.m_sizeof_real;
+    reserve();
+    std::memcpy( m_data, other.m_data, std::min( bytes(), other.m_capacity ) );
+    return *this;
+}
+
+void HEPEVT_Buffer::set_max_number_entries( int size )
+{
+    m_max_number_entries = size;
+    reserve();
+}
+
+void HEPEVT_Buffer::set_sizeof_int( unsigned int size )
+{
+    m_sizeof_int = size;
+    reserve();
+}
+
+void HEPEVT_Buffer::set_sizeof_real( unsigned int size )
+{
+    m_sizeof_real = size;
+    reserve();
+}
+
+void HEPEVT_Buffer::reserve()
+{
+    /// new storage starts zeroed; what was stored before is not kept,
+    /// since it was laid out for another floorplan
+    if ( !m_owns_data || bytes() <= m_capacity ) return;
+    std::size_t n = ( bytes() + sizeof(double) - 1 ) / sizeof(double);
+    // doubles, so that the storage is aligned for any floorplan
+    double* storage = new double[n]();
+    delete [] static_cast<double*>( m_data );
+    m_data = storage;
+    m_capacity = n * sizeof(double);
+}
+
+void HEPEVT_Buffer::zero_everything()
+{
+    std::memset( m_data, 0, std::min( bytes(), m_capacity ) );
+}
+
+} // HepMC
@@ -14,11 +14,8 @@ namespace HepMC {
     // static data member initializations //
     ////////////////////////////////////////
 
-    unsigned int HEPEVT_Wrapper::s_sizeof_int = 4;
-
-    unsigned int HEPEVT_Wrapper::s_sizeof_real = sizeof(double);
-
-    unsigned int HEPEVT_Wrapper::s_max_number_entries = 4000;
+    HEPEVT_Buffer HEPEVT_Wrapper::s_common_block( hepevt.data, hepevt_bytes_allocation,
+                                                  4000, 4, sizeof(double) );
 
     ///////////////////
     // Print Methods //
@@ -211,17 +208,8 @@ namespace HepMC {
 
     void HEPEVT_Wrapper::zero_everything()
     {
-	set_event_number( 0 );
-        set_number_entries( 0 );
-	for ( int i = 1; i<=max_number_entries(); ++i ) {
-	    set_status( i, 0 );
-	    set_id( i, 0 );
-	    set_parents( i, 0, 0 );
-	    set_children( i, 0, 0 );
-	    set_momentum( i, 0, 0, 0, 0 );
-	    set_mass( i, 0 );
-	    set_position( i, 0, 0, 0, 0 );
-	}
+	/// the whole block is cleared at once
+	s_common_block.zero_everything();
     }
 
 } // HepMC
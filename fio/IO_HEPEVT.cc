@@ -3,8 +3,11 @@
 // HEPEVT IO class
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+
 #include "HepMC/IO_HEPEVT.h"
 #include "HepMC/GenEvent.h"
+#include "src/AddressSlot.h"
 #include <cstdio>       // needed for formatted output using sprintf 
 
 namespace HepMC {
@@ -12,7 +15,8 @@ namespace HepMC {
     IO_HEPEVT::IO_HEPEVT() : m_trust_mothers_before_daughters(1),
 			     m_trust_both_mothers_and_daughters(0),
 			     m_print_inconsistency_errors(1),
-			     m_trust_beam_particles(true)
+			     m_trust_beam_particles(true),
+			     m_entries(), m_vertex_lookup(), m_first_in()
     {}
 
     IO_HEPEVT::~IO_HEPEVT(){}
@@ -28,6 +32,49 @@ namespace HepMC {
 	     << m_print_inconsistency_errors << std::endl;
     }
 
+    ///////////////////////////////////////////////
+    // visitors given to HEPEVT_Buffer::dispatch //
+    ///////////////////////////////////////////////
+
+    struct IO_HEPEVT::Reader {
+	IO_HEPEVT* io;
+	GenEvent*  evt;
+	bool       ok;
+	template <class Layout>
+	void operator()( const Layout& block ) { ok = io->fill_from_layout( block, evt ); }
+    };
+
+    struct IO_HEPEVT::Writer {
+	IO_HEPEVT*      io;
+	const GenEvent* evt;
+	template <class Layout>
+	void operator()( const Layout& block ) { io->write_to_layout( block, evt ); }
+    };
+
+    struct IO_HEPEVT::ParticleBuilder {
+	IO_HEPEVT*   io;
+	int          index;
+	GenParticle* particle;
+	template <class Layout>
+	void operator()( const Layout& block ) { particle = io->build_particle( block, index ); }
+    };
+
+    struct IO_HEPEVT::VertexBuilder {
+	IO_HEPEVT* io;
+	bool       production;
+	int        i;
+	std::vector<HepMC::GenParticle*>* hepevt_particle;
+	GenEvent*  evt;
+	template <class Layout>
+	void operator()( const Layout& block ) {
+	    if ( production ) {
+		io->build_production_vertex( block, i, *hepevt_particle, evt );
+	    } else {
+		io->build_end_vertex( block, i, *hepevt_particle, evt );
+	    }
+	}
+    };
+
     bool IO_HEPEVT::fill_next_event( GenEvent* evt ) {
 	/// read one event from the HEPEVT common block and fill GenEvent
 	/// return T/F =success/failure
@@ -43,35 +90,52 @@ namespace HepMC {
 	/// The situation is opposite for the HEPEVT which comes from Isajet
 	/// via stdhep, so then use the switch trust_mothers_before_daughters=0
 	//
-	// 1. test that evt pointer is not null and set event number
+	return fill_next_event( HEPEVT_Wrapper::common_block(), evt );
+    }
+
+    bool IO_HEPEVT::fill_next_event( const HEPEVT_Buffer& buffer, GenEvent* evt ) {
+	// 1. test that evt pointer is not null
 	if ( !evt ) {
 	    std::cerr 
 		<< "IO_HEPEVT::fill_next_event error - passed null event." 
 		<< std::endl;
 	    return false;
 	}
-	evt->set_event_number( HEPEVT_Wrapper::event_number() );
+	// the sizes of the HEPEVT fields are decoded once for the event
+	Reader reader = { this, evt, false };
+	if ( !buffer.dispatch( reader ) ) {
+	    std::cerr 
+		<< "IO_HEPEVT::fill_next_event error - unsupported HEPEVT "
+		<< "floorplan." << std::endl;
+	    return false;
+	}
+	return reader.ok;
+    }
+
+    template <class Layout>
+    bool IO_HEPEVT::fill_from_layout( const Layout& block, GenEvent* evt ) {
+	evt->set_event_number( block.event_number() );
+	int nhep = block.number_entries();
 	//
 	// 2. create a particle instance for each HEPEVT entry and fill a map
 	//    create a vector which maps from the HEPEVT particle index to the 
 	//    GenParticle address
 	//    (+1 in size accounts for hepevt_particle[0] which is unfilled)
-	std::vector<GenParticle*> hepevt_particle( 
-	                                HEPEVT_Wrapper::number_entries()+1 );
+	std::vector<GenParticle*> hepevt_particle( nhep+1 );
 	hepevt_particle[0] = 0;
-	for ( int i1 = 1; i1 <= HEPEVT_Wrapper::number_entries(); ++i1 ) {
-	    hepevt_particle[i1] = build_particle(i1);
+	for ( int i1 = 1; i1 <= nhep; ++i1 ) {
+	    hepevt_particle[i1] = build_particle( block, i1 );
 	}
-	std::set<GenVertex*> new_vertices;
 	//
 	// Here we assume that the first two particles in the list 
 	// are the incoming beam particles.
 	if( trust_beam_particles() ) {
-	evt->set_beam_particles( hepevt_particle[1], hepevt_particle[2] );
+	evt->set_beam_particles( nhep > 0 ? hepevt_particle[1] : 0,
+	                         nhep > 1 ? hepevt_particle[2] : 0 );
 	}
 	//
 	// 3.+4. loop over HEPEVT particles AGAIN, this time creating vertices
-	for ( int i = 1; i <= HEPEVT_Wrapper::number_entries(); ++i ) {
+	for ( int i = 1; i <= nhep; ++i ) {
 	    // We go through and build EITHER the production or decay 
 	    // vertex for each entry in hepevt, depending on the switch
 	    // m_trust_mothers_before_daughters (new 2001-02-28)
@@ -81,14 +145,14 @@ namespace HepMC {
 	    // 3. Build the production_vertex (if necessary)
 	    if ( m_trust_mothers_before_daughters || 
 		 m_trust_both_mothers_and_daughters ) {
-		build_production_vertex( i, hepevt_particle, evt );
+		build_production_vertex( block, i, hepevt_particle, evt );
 	    }
 	    //
 	    // 4. Build the end_vertex (if necessary) 
 	    //    Identical steps as for production vertex
 	    if ( !m_trust_mothers_before_daughters || 
 		 m_trust_both_mothers_and_daughters ) {
-		build_end_vertex( i, hepevt_particle, evt );
+		build_end_vertex( block, i, hepevt_particle, evt );
 	    }
 	}
 	// 5.             01.02.2000
@@ -96,7 +160,7 @@ namespace HepMC {
 	//  i.e. particles without mothers or daughters.
 	//  These particles need to be attached to a vertex, or else they
 	//  will never become part of the event. check for this situation
-	for ( int i3 = 1; i3 <= HEPEVT_Wrapper::number_entries(); ++i3 ) {
+	for ( int i3 = 1; i3 <= nhep; ++i3 ) {
 	    if ( !hepevt_particle[i3]->end_vertex() && 
 			!hepevt_particle[i3]->production_vertex() ) {
 		GenVertex* prod_vtx = new GenVertex();
@@ -114,105 +178,148 @@ namespace HepMC {
 	/// This is consistent with how pythia fills HEPEVT (daughters are not
 	/// necessarily filled properly) and how IO_HEPEVT reads HEPEVT.
 	//
+	write_event( evt, HEPEVT_Wrapper::common_block() );
+    }
+
+    void IO_HEPEVT::write_event( const GenEvent* evt, HEPEVT_Buffer& buffer ) {
 	if ( !evt ) return;
-	//
-	// map all particles onto a unique index
-	std::vector<GenParticle*> index_to_particle(
-	    HEPEVT_Wrapper::max_number_entries()+1 );
-	index_to_particle[0]=0;
-	std::map<GenParticle*,int> particle_to_index;
-	int particle_counter=0;
+	Writer writer = { this, evt };
+	if ( !buffer.dispatch( writer ) ) {
+	    std::cerr 
+		<< "IO_HEPEVT::write_event error - unsupported HEPEVT "
+		<< "floorplan." << std::endl;
+	}
+    }
+
+    template <class Layout>
+    void IO_HEPEVT::write_to_layout( Layout block, const GenEvent* evt ) {
+	/// The particles get their HEPEVT index in one pass over the vertices,
+	/// which also records the index of the first incoming particle of each
+	/// vertex.  A second pass over the entries finds the mothers through
+	/// the production vertex, looked up in a table hashed by vertex
+	/// address, and fills the HEPEVT arrays field by field.
+	int max_entries = block.max_number_entries();
+	m_entries.clear();
+	m_first_in.clear();
+	m_entries.reserve( std::min( evt->particles_size(), max_entries ) );
+	m_first_in.reserve( evt->vertices_size() );
+	// at most half full, so that probe sequences stay short
+	std::size_t size = 16;
+	while ( size < 2 * (std::size_t)evt->vertices_size() ) size *= 2;
+	m_vertex_lookup.assign( size, std::pair<const GenVertex*,int>( 0, -1 ) );
 	for ( GenEvent::vertex_const_iterator v = evt->vertices_begin();
 	      v != evt->vertices_end(); ++v ) {
+	    std::size_t k = detail::address_slot( *v, size - 1 );
+	    while ( m_vertex_lookup[k].first ) k = ( k + 1 ) & ( size - 1 );
+	    m_vertex_lookup[k] = std::pair<const GenVertex*,int>( *v, (int)m_first_in.size() );
 	    // all "mothers" or particles_in are kept adjacent in the list
-	    // so that the mother indices in hepevt can be filled properly
+	    // so that the mother indices in hepevt can be filled properly;
+	    // 0 if they do not fit
+	    m_first_in.push_back( (int)m_entries.size() < max_entries
+	                          ? (int)m_entries.size() + 1 : 0 );
 	    for ( GenVertex::particles_in_const_iterator p1 
 		      = (*v)->particles_in_const_begin();
-		  p1 != (*v)->particles_in_const_end(); ++p1 ) {
-		++particle_counter;
-		if ( particle_counter > 
-		     HEPEVT_Wrapper::max_number_entries() ) break; 
-		index_to_particle[particle_counter] = *p1;
-		particle_to_index[*p1] = particle_counter;
+		  p1 != (*v)->particles_in_const_end()
+		      && (int)m_entries.size() < max_entries; ++p1 ) {
+		m_entries.push_back( *p1 );
 	    }
 	    // daughters are entered only if they aren't a mother of 
 	    // another vtx
 	    for ( GenVertex::particles_out_const_iterator p2 
 		      = (*v)->particles_out_const_begin();
-		  p2 != (*v)->particles_out_const_end(); ++p2 ) {
-		if ( !(*p2)->end_vertex() ) {
-		    ++particle_counter;
-		    if ( particle_counter > 
-			 HEPEVT_Wrapper::max_number_entries() ) {
-			break;
-		    }
-		    index_to_particle[particle_counter] = *p2;
-		    particle_to_index[*p2] = particle_counter;
-		}
+		  p2 != (*v)->particles_out_const_end()
+		      && (int)m_entries.size() < max_entries; ++p2 ) {
+		if ( !(*p2)->end_vertex() ) m_entries.push_back( *p2 );
 	    }
 	}
-	if ( particle_counter > HEPEVT_Wrapper::max_number_entries() ) {
-	    particle_counter = HEPEVT_Wrapper::max_number_entries();
-	}
+	int nhep = (int)m_entries.size();
 	// 	
 	// fill the HEPEVT event record
-	HEPEVT_Wrapper::set_event_number( evt->event_number() );
-	HEPEVT_Wrapper::set_number_entries( particle_counter );
-	for ( int i = 1; i <= particle_counter; ++i ) {
-	    HEPEVT_Wrapper::set_status( i, index_to_particle[i]->status() );
-	    HEPEVT_Wrapper::set_id( i, index_to_particle[i]->pdg_id() );
-	    FourVector m = index_to_particle[i]->momentum();
-	    HEPEVT_Wrapper::set_momentum( i, m.px(), m.py(), m.pz(), m.e() );
-	    HEPEVT_Wrapper::set_mass( i, index_to_particle[i]->generatedMass() );
+	block.set_event_number( evt->event_number() );
+	block.set_number_entries( nhep );
+	for ( int i = 1; i <= nhep; ++i ) {
+	    block.set_status( i, m_entries[i-1]->status() );
+	}
+	for ( int i = 1; i <= nhep; ++i ) {
+	    block.set_id( i, m_entries[i-1]->pdg_id() );
+	}
+	for ( int i = 1; i <= nhep; ++i ) {
+	    const FourVector& m = m_entries[i-1]->momentum();
+	    block.set_momentum( i, m.px(), m.py(), m.pz(), m.e() );
+	    block.set_mass( i, m_entries[i-1]->generated_mass() );
+	}
+	for ( int i = 1; i <= nhep; ++i ) {
+	    const GenVertex* prod = m_entries[i-1]->production_vertex();
 	    // there should ALWAYS be particles in any vertex, but some generators
 	    // are making non-kosher HepMC events
-	    if ( index_to_particle[i]->production_vertex() && 
-	         index_to_particle[i]->production_vertex()->particles_in_size()) {
-		FourVector p = index_to_particle[i]->
-				     production_vertex()->position();
-		HEPEVT_Wrapper::set_position( i, p.x(), p.y(), p.z(), p.t() );
-		int num_mothers = index_to_particle[i]->production_vertex()->
-				  particles_in_size();
-		int first_mother = find_in_map( particle_to_index,
-						*(index_to_particle[i]->
-						  production_vertex()->
-						  particles_in_const_begin()));
-		int last_mother = first_mother + num_mothers - 1;
+	    if ( prod && prod->particles_in_size() ) {
+		int k = vertex_position( prod );
+		int first_mother = k < 0 ? 0 : m_first_in[k];
+		int last_mother = first_mother + prod->particles_in_size() - 1;
 		if ( first_mother == 0 ) last_mother = 0;
-		HEPEVT_Wrapper::set_parents( i, first_mother, last_mother );
+		block.set_parents( i, first_mother, last_mother );
+	    } else {
+		block.set_parents( i, 0, 0 );
+	    }
+	}
+	for ( int i = 1; i <= nhep; ++i ) {
+	    block.set_children( i, 0, 0 );
+	}
+	for ( int i = 1; i <= nhep; ++i ) {
+	    const GenVertex* prod = m_entries[i-1]->production_vertex();
+	    if ( prod && prod->particles_in_size() ) {
+		const FourVector& p = prod->position();
+		block.set_position( i, p.x(), p.y(), p.z(), p.t() );
 	    } else {
-		HEPEVT_Wrapper::set_position( i, 0, 0, 0, 0 );
-		HEPEVT_Wrapper::set_parents( i, 0, 0 );
+		block.set_position( i, 0, 0, 0, 0 );
 	    }
-	    HEPEVT_Wrapper::set_children( i, 0, 0 );
 	}
     }
 
+    int IO_HEPEVT::vertex_position( const GenVertex* vtx ) const {
+	/// Linear probing in the table filled by write_to_layout.
+	if ( !vtx || m_vertex_lookup.empty() ) return -1;
+	std::size_t mask = m_vertex_lookup.size() - 1;
+	for ( std::size_t k = detail::address_slot( vtx, mask ); m_vertex_lookup[k].first;
+	      k = ( k + 1 ) & mask ) {
+	    if ( m_vertex_lookup[k].first == vtx ) return m_vertex_lookup[k].second;
+	}
+	return -1;
+    }
+
     void IO_HEPEVT::build_production_vertex(int i, 
 					    std::vector<HepMC::GenParticle*>& 
 					    hepevt_particle,
 					    GenEvent* evt ) {
+	VertexBuilder builder = { this, true, i, &hepevt_particle, evt };
+	HEPEVT_Wrapper::dispatch( builder );
+    }
+
+    template <class Layout>
+    void IO_HEPEVT::build_production_vertex( const Layout& block, int i, 
+					    std::vector<HepMC::GenParticle*>& 
+					    hepevt_particle,
+					    GenEvent* evt ) {
 	/// 
 	/// for particle in HEPEVT with index i, build a production vertex
 	/// if appropriate, and add that vertex to the event
 	GenParticle* p = hepevt_particle[i];
+	int first_mother = block.first_parent(i);
+	int last_mother = block.last_parent(i);
 	// a. search to see if a production vertex already exists
-	int mother = HEPEVT_Wrapper::first_parent(i);
+	int mother = first_mother;
 	GenVertex* prod_vtx = p->production_vertex();
 	while ( !prod_vtx && mother > 0 ) {
 	    prod_vtx = hepevt_particle[mother]->end_vertex();
 	    if ( prod_vtx ) prod_vtx->add_particle_out( p );
 	    // increment mother for next iteration
-	    if ( ++mother > HEPEVT_Wrapper::last_parent(i) ) mother = 0;
+	    if ( ++mother > last_mother ) mother = 0;
 	}
 	// b. if no suitable production vertex exists - and the particle
 	// has atleast one mother or position information to store - 
 	// make one
-	FourVector prod_pos( HEPEVT_Wrapper::x(i), HEPEVT_Wrapper::y(i), 
-				   HEPEVT_Wrapper::z(i), HEPEVT_Wrapper::t(i) 
-	                         ); 
-	if ( !prod_vtx && (HEPEVT_Wrapper::number_parents(i)>0 
-			   || prod_pos!=FourVector(0,0,0,0)) )
+	FourVector prod_pos( block.x(i), block.y(i), block.z(i), block.t(i) ); 
+	if ( !prod_vtx && (first_mother > 0 || prod_pos!=FourVector(0,0,0,0)) )
 	{
 	    prod_vtx = new GenVertex();
 	    prod_vtx->add_particle_out( p );
@@ -224,7 +331,7 @@ namespace HepMC {
 	}
 	// d. loop over mothers to make sure their end_vertices are
 	//     consistent
-	mother = HEPEVT_Wrapper::first_parent(i);
+	mother = first_mother;
 	while ( prod_vtx && mother > 0 ) {
 	    if ( !hepevt_particle[mother]->end_vertex() ) {
 		// if end vertex of the mother isn't specified, do it now
@@ -241,7 +348,7 @@ namespace HepMC {
 		if ( m_print_inconsistency_errors ) std::cerr
 		    << "HepMC::IO_HEPEVT: inconsistent mother/daugher "
 		    << "information in HEPEVT event " 
-		    << HEPEVT_Wrapper::event_number()
+		    << block.event_number()
 		    << ". \n I recommend you try "
 		    << "inspecting the event first with "
 		    << "\n\tHEPEVT_Wrapper::check_hepevt_consistency()"
@@ -249,29 +356,40 @@ namespace HepMC {
 		    << "IO_HEPEVT::print_inconsistency_errors switch."
 		    << std::endl;
 	    }
-	    if ( ++mother > HEPEVT_Wrapper::last_parent(i) ) mother = 0;
+	    if ( ++mother > last_mother ) mother = 0;
 	}
     }
 
     void IO_HEPEVT::build_end_vertex
     ( int i, std::vector<HepMC::GenParticle*>& hepevt_particle, GenEvent* evt ) 
+    {
+	VertexBuilder builder = { this, false, i, &hepevt_particle, evt };
+	HEPEVT_Wrapper::dispatch( builder );
+    }
+
+    template <class Layout>
+    void IO_HEPEVT::build_end_vertex
+    ( const Layout& block, int i, std::vector<HepMC::GenParticle*>& hepevt_particle,
+      GenEvent* evt ) 
     {
 	/// 
 	/// for particle in HEPEVT with index i, build an end vertex
 	/// if appropriate, and add that vertex to the event
 	//    Identical steps as for build_production_vertex
 	GenParticle* p = hepevt_particle[i];
+	int first_daughter = block.first_child(i);
+	int last_daughter = block.last_child(i);
 	// a.
-	int daughter = HEPEVT_Wrapper::first_child(i);
+	int daughter = first_daughter;
 	GenVertex* end_vtx = p->end_vertex();
 	while ( !end_vtx && daughter > 0 ) {
 	    end_vtx = hepevt_particle[daughter]->production_vertex();
 	    if ( end_vtx ) end_vtx->add_particle_in( p );
-	    if ( ++daughter > HEPEVT_Wrapper::last_child(i) ) daughter = 0;
+	    if ( ++daughter > last_daughter ) daughter = 0;
 	}
 	// b. (different from 3c. because HEPEVT particle can not know its
 	//        decay position )
-	if ( !end_vtx && HEPEVT_Wrapper::number_children(i)>0 ) {
+	if ( !end_vtx && first_daughter > 0 ) {
 	    end_vtx = new GenVertex();
 	    end_vtx->add_particle_in( p );
 	    evt->add_vertex( end_vtx );
@@ -279,7 +397,7 @@ namespace HepMC {
 	// c+d. loop over daughters to make sure their production vertices 
 	//    point back to the current vertex.
 	//    We get the vertex position from the daughter as well.
-	daughter = HEPEVT_Wrapper::first_child(i);
+	daughter = first_daughter;
 	while ( end_vtx && daughter > 0 ) {
 	    if ( !hepevt_particle[daughter]->production_vertex() ) {
 		// if end vertex of the mother isn't specified, do it now
@@ -287,11 +405,8 @@ namespace HepMC {
 		// 
 		// 2001-03-29 M.Dobbs, fill vertex the position.
 		if ( end_vtx->position()==FourVector(0,0,0,0) ) {
-		    FourVector prod_pos( HEPEVT_Wrapper::x(daughter), 
-					       HEPEVT_Wrapper::y(daughter), 
-					       HEPEVT_Wrapper::z(daughter), 
-					       HEPEVT_Wrapper::t(daughter) 
-			);
+		    FourVector prod_pos( block.x(daughter), block.y(daughter), 
+					 block.z(daughter), block.t(daughter) );
 		    if ( prod_pos != FourVector(0,0,0,0) ) {
 			end_vtx->set_position( prod_pos );
 		    }
@@ -306,7 +421,7 @@ namespace HepMC {
 		if ( m_print_inconsistency_errors ) std::cerr
 		    << "HepMC::IO_HEPEVT: inconsistent mother/daugher "
 		    << "information in HEPEVT event " 
-		    << HEPEVT_Wrapper::event_number()
+		    << block.event_number()
 		    << ". \n I recommend you try "
 		    << "inspecting the event first with "
 		    << "\n\tHEPEVT_Wrapper::check_hepevt_consistency()"
@@ -314,25 +429,32 @@ namespace HepMC {
 		    << "IO_HEPEVT::print_inconsistency_errors switch."
 		    << std::endl;
 	    }
-	    if ( ++daughter > HEPEVT_Wrapper::last_child(i) ) daughter = 0;
+	    if ( ++daughter > last_daughter ) daughter = 0;
 	}
 	if ( !p->end_vertex() && !p->production_vertex() ) {
 	    // Added 2001-11-04, to try and handle Isajet problems.
-	    build_production_vertex( i, hepevt_particle, evt );
+	    build_production_vertex( block, i, hepevt_particle, evt );
 	}
     }
 
     GenParticle* IO_HEPEVT::build_particle( int index ) {
+	ParticleBuilder builder = { this, index, 0 };
+	HEPEVT_Wrapper::dispatch( builder );
+	return builder.particle;
+    }
+
+    template <class Layout>
+    GenParticle* IO_HEPEVT::build_particle( const Layout& block, int index ) {
 	/// Builds a particle object corresponding to index in HEPEVT
 	// 
 	GenParticle* p 
-	    = new GenParticle( FourVector( HEPEVT_Wrapper::px(index), 
-						 HEPEVT_Wrapper::py(index), 
-						 HEPEVT_Wrapper::pz(index), 
-						 HEPEVT_Wrapper::e(index) ),
-			       HEPEVT_Wrapper::id(index), 
-			       HEPEVT_Wrapper::status(index) );
-        p->setGeneratedMass( HEPEVT_Wrapper::m(index) );
+	    = new GenParticle( FourVector( block.px(index), 
+					   block.py(index), 
+					   block.pz(index), 
+					   block.e(index) ),
+			       block.id(index), 
+			       block.status(index) );
+        p->setGeneratedMass( block.m(index) );
 	p->suggest_barcode( index );
 	return p;
     }
@@ -0,0 +1,35 @@
+//--------------------------------------------------------------------------
+#ifndef HEPMC_ADDRESS_SLOT_H
+#define HEPMC_ADDRESS_SLOT_H
+
+//////////////////////////////////////////////////////////////////////////
+// AddressSlot.h
+//
+// hash of the address of a particle or vertex, for the open addressing
+// tables of GraphSnapshot, GraphTraversal and IO_HEPEVT.
+// Internal to the HepMC libraries: it is not installed.
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+
+namespace HepMC {
+
+namespace detail {
+
+/// slot of an address in a table of size mask+1, a power of two.
+/// Particles and vertices are at least 8 byte aligned, so the low bits
+/// are dropped; the Fibonacci multiplication mixes the others into the
+/// top bits, which are the ones kept.
+inline std::size_t address_slot( const void* a, std::size_t mask )
+{
+    std::size_t h = reinterpret_cast<std::size_t>( a ) >> 3;
+    h *= static_cast<std::size_t>( 0x9E3779B97F4A7C15ULL );
+    return ( h >> ( sizeof(std::size_t) * 4 ) ) & mask;
+}
+
+} // detail
+
+} // HepMC
+
+#endif  // HEPMC_ADDRESS_SLOT_H
+//--------------------------------------------------------------------------
@@ -6,187 +6,399 @@
 //////////////////////////////////////////////////////////////////////////
 //
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <sstream>
 
 #include "HepMC/CompareGenEvent.h"
 #include "HepMC/GenEvent.h"
 
 namespace HepMC {
 
+namespace {
+
+    // text of the values in a difference
+    template <class T>
+    std::string text( const T& x )
+    {
+	std::ostringstream os;
+	os.precision( 17 );
+	os << x;
+	return os.str();
+    }
+
+    std::string text( const FourVector& v )
+    {
+	std::ostringstream os;
+	os.precision( 17 );
+	os << "(" << v.x() << "," << v.y() << "," << v.z() << "," << v.t() << ")";
+	return os.str();
+    }
+
+    template <class T>
+    std::string text( const std::vector<T>& v )
+    {
+	std::ostringstream os;
+	os.precision( 17 );
+	for ( std::size_t i = 0; i < v.size(); ++i ) os << ( i ? " " : "" ) << v[i];
+	return os.str();
+    }
+
+    std::string text( const Flow& f )
+    {
+	std::ostringstream os;
+	for ( Flow::const_iterator i = f.begin(); i != f.end(); ++i ) {
+	    os << ( i != f.begin() ? " " : "" ) << i->first << ":" << i->second;
+	}
+	return os.str();
+    }
+
+    int barcode( const GenVertex* v ) { return v ? v->barcode() : 0; }
+    int barcode( const GenParticle* p ) { return p ? p->barcode() : 0; }
+
+    // the barcodes of a range of particles, sorted
+    template <class Iterator>
+    std::vector<int> barcodes( Iterator begin, Iterator end )
+    {
+	std::vector<int> b;
+	for ( ; begin != end; ++begin ) b.push_back( (*begin)->barcode() );
+	std::sort( b.begin(), b.end() );
+	return b;
+    }
+
+    // the differences found so far, up to a maximum number
+    class Differences {
+    public:
+	Differences( double tolerance, std::vector<GenEventDifference>& out,
+	             std::size_t max_differences )
+	  : m_tolerance(tolerance), m_out(out), m_start(out.size()),
+	    m_max(max_differences), m_found(false) {}
+
+	bool found() const { return m_found; }
+	bool full() const { return m_max > 0 && m_out.size() - m_start >= m_max; }
+
+	void add( const char* object, int bc, const std::string& field,
+	          const std::string& first, const std::string& second )
+	{
+	    m_found = true;
+	    if ( full() ) return;
+	    GenEventDifference d;
+	    d.object = object;
+	    d.barcode = bc;
+	    d.field = field;
+	    d.first = first;
+	    d.second = second;
+	    m_out.push_back( d );
+	}
+	bool same( double a, double b ) const
+	{
+	    if ( a == b || ( a != a && b != b ) ) return true;
+	    return std::fabs( a - b ) <= m_tolerance * std::max( std::fabs( a ), std::fabs( b ) );
+	}
+	bool same( const FourVector& a, const FourVector& b ) const
+	{
+	    return same( a.x(), b.x() ) && same( a.y(), b.y() )
+		&& same( a.z(), b.z() ) && same( a.t(), b.t() );
+	}
+	bool same( const WeightContainer& a, const WeightContainer& b ) const
+	{
+	    if ( a.size() != b.size() ) return false;
+	    for ( std::size_t i = 0; i < a.size(); ++i ) {
+		if ( !same( a[i], b[i] ) ) return false;
+	    }
+	    return true;
+	}
+	/// values compared with ==
+	template <class T>
+	void exact( const char* object, int bc, const char* field, const T& a, const T& b )
+	{
+	    if ( !( a == b ) ) add( object, bc, field, text( a ), text( b ) );
+	}
+	/// values compared with the tolerance
+	template <class T>
+	void close( const char* object, int bc, const char* field, const T& a, const T& b )
+	{
+	    if ( !same( a, b ) ) add( object, bc, field, text( a ), text( b ) );
+	}
+	void close( const char* object, int bc, const char* field,
+	            const WeightContainer& a, const WeightContainer& b )
+	{
+	    if ( same( a, b ) ) return;
+	    std::vector<double> va( a.begin(), a.end() );
+	    std::vector<double> vb( b.begin(), b.end() );
+	    add( object, bc, field, text( va ), text( vb ) );
+	}
+
+    private:
+	double      m_tolerance;
+	std::vector<GenEventDifference>& m_out;
+	std::size_t m_start;
+	std::size_t m_max;
+	bool        m_found;
+    };
+
+    void compare_weights( const GenEvent& e1, const GenEvent& e2, Differences& d )
+    {
+	d.close( "event", 0, "weights", e1.weights(), e2.weights() );
+	d.exact( "event", 0, "weight_names", e1.weights().names(), e2.weights().names() );
+    }
+
+    void compare_beam_particles( const GenEvent& e1, const GenEvent& e2, Differences& d )
+    {
+	d.exact( "event", 0, "beam_particle_1", barcode( e1.beam_particles().first ),
+	         barcode( e2.beam_particles().first ) );
+	d.exact( "event", 0, "beam_particle_2", barcode( e1.beam_particles().second ),
+	         barcode( e2.beam_particles().second ) );
+    }
+
+    void compare_signal_process_vertex( const GenEvent& e1, const GenEvent& e2, Differences& d )
+    {
+	d.exact( "event", 0, "signal_process_vertex", barcode( e1.signal_process_vertex() ),
+	         barcode( e2.signal_process_vertex() ) );
+    }
+
+    void compare_event_info( const GenEvent& e1, const GenEvent& e2, Differences& d )
+    {
+	const char* e = "event";
+	d.exact( e, 0, "event_number", e1.event_number(), e2.event_number() );
+	d.exact( e, 0, "signal_process_id", e1.signal_process_id(), e2.signal_process_id() );
+	d.exact( e, 0, "mpi", e1.mpi(), e2.mpi() );
+	d.close( e, 0, "event_scale", e1.event_scale(), e2.event_scale() );
+	d.close( e, 0, "alphaQCD", e1.alphaQCD(), e2.alphaQCD() );
+	d.close( e, 0, "alphaQED", e1.alphaQED(), e2.alphaQED() );
+	d.exact( e, 0, "random_states", e1.random_states(), e2.random_states() );
+	compare_weights( e1, e2, d );
+	d.exact( e, 0, "momentum_unit", name( e1.momentum_unit() ), name( e2.momentum_unit() ) );
+	d.exact( e, 0, "length_unit", name( e1.length_unit() ), name( e2.length_unit() ) );
+	compare_beam_particles( e1, e2, d );
+	compare_signal_process_vertex( e1, e2, d );
+	d.exact( e, 0, "particles_size", e1.particles_size(), e2.particles_size() );
+	d.exact( e, 0, "vertices_size", e1.vertices_size(), e2.vertices_size() );
+
+	const GenCrossSection* x1 = e1.cross_section();
+	const GenCrossSection* x2 = e2.cross_section();
+	d.exact( e, 0, "cross_section_set", x1 != 0, x2 != 0 );
+	if ( x1 && x2 ) {
+	    d.close( e, 0, "cross_section", x1->cross_section(), x2->cross_section() );
+	    d.close( e, 0, "cross_section_error", x1->cross_section_error(),
+	             x2->cross_section_error() );
+	}
+	const HeavyIon* h1 = e1.heavy_ion();
+	const HeavyIon* h2 = e2.heavy_ion();
+	d.exact( e, 0, "heavy_ion_set", h1 != 0, h2 != 0 );
+	if ( h1 && h2 ) {
+	    d.exact( e, 0, "Ncoll_hard", h1->Ncoll_hard(), h2->Ncoll_hard() );
+	    d.exact( e, 0, "Npart_proj", h1->Npart_proj(), h2->Npart_proj() );
+	    d.exact( e, 0, "Npart_targ", h1->Npart_targ(), h2->Npart_targ() );
+	    d.exact( e, 0, "Ncoll", h1->Ncoll(), h2->Ncoll() );
+	    d.exact( e, 0, "spectator_neutrons", h1->spectator_neutrons(), h2->spectator_neutrons() );
+	    d.exact( e, 0, "spectator_protons", h1->spectator_protons(), h2->spectator_protons() );
+	    d.exact( e, 0, "N_Nwounded_collisions", h1->N_Nwounded_collisions(),
+	             h2->N_Nwounded_collisions() );
+	    d.exact( e, 0, "Nwounded_N_collisions", h1->Nwounded_N_collisions(),
+	             h2->Nwounded_N_collisions() );
+	    d.exact( e, 0, "Nwounded_Nwounded_collisions", h1->Nwounded_Nwounded_collisions(),
+	             h2->Nwounded_Nwounded_collisions() );
+	    d.close( e, 0, "impact_parameter", (double)h1->impact_parameter(),
+	             (double)h2->impact_parameter() );
+	    d.close( e, 0, "event_plane_angle", (double)h1->event_plane_angle(),
+	             (double)h2->event_plane_angle() );
+	    d.close( e, 0, "eccentricity", (double)h1->eccentricity(),
+	             (double)h2->eccentricity() );
+	    d.close( e, 0, "sigma_inel_NN", (double)h1->sigma_inel_NN(),
+	             (double)h2->sigma_inel_NN() );
+	    d.close( e, 0, "centrality", (double)h1->centrality(), (double)h2->centrality() );
+	}
+	const PdfInfo* f1 = e1.pdf_info();
+	const PdfInfo* f2 = e2.pdf_info();
+	d.exact( e, 0, "pdf_info_set", f1 != 0, f2 != 0 );
+	if ( f1 && f2 ) {
+	    d.exact( e, 0, "id1", f1->id1(), f2->id1() );
+	    d.exact( e, 0, "id2", f1->id2(), f2->id2() );
+	    d.exact( e, 0, "pdf_id1", f1->pdf_id1(), f2->pdf_id1() );
+	    d.exact( e, 0, "pdf_id2", f1->pdf_id2(), f2->pdf_id2() );
+	    d.close( e, 0, "x1", f1->x1(), f2->x1() );
+	    d.close( e, 0, "x2", f1->x2(), f2->x2() );
+	    d.close( e, 0, "scalePDF", f1->scalePDF(), f2->scalePDF() );
+	    d.close( e, 0, "pdf1", f1->pdf1(), f2->pdf1() );
+	    d.close( e, 0, "pdf2", f1->pdf2(), f2->pdf2() );
+	}
+    }
+
+    void compare_particles( const GenEvent& e1, const GenEvent& e2, Differences& d )
+    {
+	const char* o = "particle";
+	for ( GenEvent::particle_const_iterator p = e1.particles_begin();
+	      p != e1.particles_end() && !d.full(); ++p ) {
+	    const GenParticle* p1 = *p;
+	    const GenParticle* p2 = e2.barcode_to_particle( p1->barcode() );
+	    int bc = p1->barcode();
+	    if ( !p2 ) {
+		d.add( o, bc, "presence", "present", "absent" );
+		continue;
+	    }
+	    d.exact( o, bc, "pdg_id", p1->pdg_id(), p2->pdg_id() );
+	    d.exact( o, bc, "status", p1->status(), p2->status() );
+	    d.close( o, bc, "momentum", p1->momentum(), p2->momentum() );
+	    d.close( o, bc, "generated_mass", p1->generated_mass(), p2->generated_mass() );
+	    d.exact( o, bc, "production_vertex", barcode( p1->production_vertex() ),
+	             barcode( p2->production_vertex() ) );
+	    d.exact( o, bc, "end_vertex", barcode( p1->end_vertex() ),
+	             barcode( p2->end_vertex() ) );
+	    if ( p1->flow() != p2->flow() ) {
+		d.add( o, bc, "flow", text( p1->flow() ), text( p2->flow() ) );
+	    }
+	    d.close( o, bc, "polarization_theta", p1->polarization().theta(),
+	             p2->polarization().theta() );
+	    d.close( o, bc, "polarization_phi", p1->polarization().phi(),
+	             p2->polarization().phi() );
+	}
+	for ( GenEvent::particle_const_iterator p = e2.particles_begin();
+	      p != e2.particles_end() && !d.full(); ++p ) {
+	    if ( !e1.barcode_to_particle( (*p)->barcode() ) ) {
+		d.add( o, (*p)->barcode(), "presence", "absent", "present" );
+	    }
+	}
+    }
+
+    void compare_vertex( const GenVertex* v1, const GenVertex* v2, Differences& d )
+    {
+	const char* o = "vertex";
+	int bc = v1->barcode();
+	d.close( o, bc, "position", v1->position(), v2->position() );
+	d.exact( o, bc, "id", v1->id(), v2->id() );
+	d.close( o, bc, "weights", v1->weights(), v2->weights() );
+	d.exact( o, bc, "particles_in",
+	         barcodes( v1->particles_in_const_begin(), v1->particles_in_const_end() ),
+	         barcodes( v2->particles_in_const_begin(), v2->particles_in_const_end() ) );
+	d.exact( o, bc, "particles_out",
+	         barcodes( v1->particles_out_const_begin(), v1->particles_out_const_end() ),
+	         barcodes( v2->particles_out_const_begin(), v2->particles_out_const_end() ) );
+    }
+
+    void compare_vertices( const GenEvent& e1, const GenEvent& e2, Differences& d )
+    {
+	const char* o = "vertex";
+	for ( GenEvent::vertex_const_iterator v = e1.vertices_begin();
+	      v != e1.vertices_end() && !d.full(); ++v ) {
+	    const GenVertex* v1 = *v;
+	    const GenVertex* v2 = e2.barcode_to_vertex( v1->barcode() );
+	    int bc = v1->barcode();
+	    if ( !v2 ) {
+		d.add( o, bc, "presence", "present", "absent" );
+		continue;
+	    }
+	    compare_vertex( v1, v2, d );
+	}
+	for ( GenEvent::vertex_const_iterator v = e2.vertices_begin();
+	      v != e2.vertices_end() && !d.full(); ++v ) {
+	    if ( !e1.barcode_to_vertex( (*v)->barcode() ) ) {
+		d.add( o, (*v)->barcode(), "presence", "absent", "present" );
+	    }
+	}
+    }
+
+    void compare_event( const GenEvent& e1, const GenEvent& e2, Differences& d )
+    {
+	compare_event_info( e1, e2, d );
+	compare_particles( e1, e2, d );
+	compare_vertices( e1, e2, d );
+    }
+
+    // the old comparisons report at most this many differences
+    const std::size_t max_reported = 10;
+
+    // compare with one of the functions above, without tolerance,
+    // and print the differences to std::cerr
+    template <class Compare, class T>
+    bool check( const char* function, Compare compare, const T& a, const T& b )
+    {
+	std::vector<GenEventDifference> differences;
+	Differences d( 0., differences, max_reported );
+	compare( a, b, d );
+	if ( !d.found() ) return true;
+	std::cerr << function << ": differences found" << std::endl;
+	printDifferences( differences, std::cerr );
+	return false;
+    }
+
+} // unnamed namespace
+
 bool compareGenEvent( GenEvent* e1, GenEvent* e2)
 {
-   //std::cout << "compareGenEvent: comparing event " << e1->event_number() << " to event " 
-   //          << e2->event_number() << std::endl;
-   if( e1->event_number() != e2->event_number() ) { 
-       std::cerr << "compareGenEvent: event numbers differ " << std::endl;
-       return false; 
-   }
-   if( e1->signal_process_id() != e2->signal_process_id() ) { 
-       std::cerr << "compareGenEvent: signal process ids differ " << std::endl;
-       return false; 
-   }
-   if( e1->event_scale() != e2->event_scale() ) { 
-       std::cerr << "compareGenEvent: event scales differ " << std::endl;
-       return false; 
-   }
-   if( e1->alphaQCD() != e2->alphaQCD() ) { 
-       std::cerr << "compareGenEvent: alphaQCD differs " << std::endl;
-       return false; 
-   }
-   if( e1->alphaQED() != e2->alphaQED() ) { 
-       std::cerr << "alphaQED differs " << std::endl;
-       return false; 
-   }
-   if( e1->mpi() != e2->mpi() ) { 
-       std::cerr << "compareGenEvent: mpi differs " << std::endl;
-       return false; 
-   }
-   if ( !compareSignalProcessVertex( e1, e2 ) ) { return false; }
-   if ( !compareBeamParticles( e1, e2 ) ) { return false; }
-   if ( !compareWeights( e1, e2 ) ) { return false; }
-   if( e1->random_states() != e2->random_states() ) { 
-       std::cerr << "compareGenEvent: random states differ " << std::endl;
-       return false; 
-   }
-   if( e1->heavy_ion() != e2->heavy_ion() ) { 
-       std::cerr << "compareGenEvent: heavy ions differ " << std::endl;
-       return false; 
-   }
-   if( e1->pdf_info() != e2->pdf_info() ) { 
-       std::cerr << "compareGenEvent: pdf info differs " << std::endl;
-       return false; 
-   }
-   if ( !compareParticles( e1, e2 ) ) { return false; }
-   if ( !compareVertices( e1, e2 ) ) { return false; }
-   return true;
+   return check( "compareGenEvent", compare_event, *e1, *e2 );
 }
 
 bool compareSignalProcessVertex( GenEvent* e1, GenEvent* e2 ) {
-   // compare signal process vertex
-   GenVertex* s1 = e1->signal_process_vertex();
-   GenVertex* s2 = e2->signal_process_vertex();
-   if( s1 && s2 ) {
-       if( (*s1) != (*s2) ) { 
-	   std::cerr << "compareSignalProcessVertex: signal process vertices differ " << std::endl;
-	   return false; 
-       }
-   }
-   return true;
+   return check( "compareSignalProcessVertex", compare_signal_process_vertex, *e1, *e2 );
 }
 
 bool compareBeamParticles( GenEvent* e1, GenEvent* e2 ) {
-   GenParticle* e1b1 = e1->beam_particles().first;
-   GenParticle* e1b2 = e1->beam_particles().second;
-   GenParticle* e2b1 = e2->beam_particles().first;
-   GenParticle* e2b2 = e2->beam_particles().second;
-   if( e1b1 && e1b2 && e2b1 && e2b2 ) {
-       if( (*e1b1) == (*e2b1)  && (*e1b2) == (*e2b2) ) {
-       } else { 
-	   std::cerr << "compareBeamParticles: beam particles differ " << std::endl;
-	   return false; 
-       }
-   }
-   return true;
+   return check( "compareBeamParticles", compare_beam_particles, *e1, *e2 );
 }
 
 bool compareWeights( GenEvent* e1, GenEvent* e2 ) {
-   if( e1->weights() == e2->weights() ) return true;
-   std::cerr << "compareWeights: weight containers differ " << std::endl;
-   return false;
+   return check( "compareWeights", compare_weights, *e1, *e2 );
 }
 
 bool compareParticles( GenEvent* e1, GenEvent* e2 ) {
-   if( e1->particles_size() != e2->particles_size() ) { 
-       std::cerr << "compareParticles: number of particles differs " << std::endl;
-       return false; 
-   }
-   if( e1->particles_size() == 0 ) { return true; }
-   for ( GenEvent::particle_const_iterator p1 =  e1->particles_begin(),
-         p2 = e2->particles_begin();
-         p1 !=  e1->particles_end(); ++p1, ++p2 ) {
-       /* std::cout << "compareParticles: particle " 
-		 << (*p1)->barcode() << " " << (*p2)->barcode()
-		 << std::endl; */
-       if ( **p1 != **p2 ) {
-	   std::cerr << "compareParticles: particle " 
-	             << (*p1)->barcode() << " differs from " 
-		     << (*p2)->barcode() << std::endl;
-	   return false; 
-       }
-   }
-   return true;
+   return check( "compareParticles", compare_particles, *e1, *e2 );
 }
 
 bool compareVertices( GenEvent* e1, GenEvent* e2 ) {
-   if( e1->vertices_size() != e2->vertices_size() ) { 
-       std::cerr << "compareVertices: number of vertices differs " << std::endl;
-       return false; 
-   }
-   for ( GenEvent::vertex_const_iterator v =  e1->vertices_begin();
-         v !=  e1->vertices_end(); ++v ) {
-       //std::cout << "compareVertices:  comparing vertex " 
-	//         << (*v)->barcode() << std::endl;
-       GenVertex* v1 = (*v);
-       GenVertex* v2 = e2->barcode_to_vertex((*v)->barcode());
-       compareVertex( (*v), e2->barcode_to_vertex((*v)->barcode()));
-       if ( (*v1) != (*v2) ) {
-	   std::cerr << "compareVertices: vertex " 
-	             << (*v)->barcode() << " differs" << std::endl;
-	   return false; 
-       }
-   }
-   return true;
+   return check( "compareVertices", compare_vertices, *e1, *e2 );
 }
 
 bool compareVertex( GenVertex* v1, GenVertex* v2 ) {
-       if ( v1->position() !=  v2->position() ) {
-	  std::cerr << "compareVertex: position " 
-	            << v1->barcode() << " differs" << std::endl;
-	  return false; 
-       }
-       // if the size of the inlist differs, return false.
-       if ( v1->particles_in_size() !=  v2->particles_in_size() ) {
-	  std::cerr << "compareVertex: particles_in_size " 
-	            << v1->barcode() << " differs" << std::endl;
-	  return false; 
-       }
-       // loop over the inlist and ensure particles are identical
-       if ( v1->particles_in_const_begin() != v1->particles_in_const_end() ) {
-	   for ( GenVertex::particles_in_const_iterator 
-		    ia = v1->particles_in_const_begin(),
-		    ib = v2->particles_in_const_begin();
-		ia != v1->particles_in_const_end(); ia++, ib++ ){
-	      if ( **ia != **ib ) {
-		 std::cerr << "compareVertex: incoming particle " 
-	        	   << v1->barcode() << " differs: " 
-			   << (*ia)->barcode() << " " << (*ib)->barcode()
-			   << std::endl;
-		  //return false; 
-	      }
-	   }
-       }
-       // if the size of the outlist differs, return false.
-       if ( v1->particles_out_size() !=  v2->particles_out_size() ) {
-	  std::cerr << "compareVertex: particles_out_size " 
-	            << v1->barcode() << " differs" << std::endl;
-	  return false; 
-       }
-       // loop over the outlist and ensure particles are identical
-       if ( v1->particles_out_const_begin() != v1->particles_out_const_end() ) {
-	   for ( GenVertex::particles_out_const_iterator 
-		     ia = v1->particles_out_const_begin(),
-		     ib = v2->particles_out_const_begin();
-		 ia != v1->particles_out_const_end(); ia++, ib++ ){
-	       if ( **ia != **ib ) {
-		   std::cerr << "compareVertex: outgoing particle " 
-	        	     << v1->barcode() << " differs: " 
-			     << (*ia)->barcode() << " " << (*ib)->barcode()
-			     << std::endl;
-		   //return false; 
-	       }
-	   }
-       }
-   return true;
+   return check( "compareVertex", compare_vertex, 
+                 static_cast<const GenVertex*>(v1), static_cast<const GenVertex*>(v2) );
+}
+
+bool compareGenEvent( const GenEvent& e1, const GenEvent& e2, double tolerance,
+                      std::vector<GenEventDifference>& differences,
+                      std::size_t max_differences )
+{
+    Differences d( tolerance, differences, max_differences );
+    compare_event( e1, e2, d );
+    return !d.found();
+}
+
+bool compareEventInfo( const GenEvent& e1, const GenEvent& e2, double tolerance,
+                       std::vector<GenEventDifference>& differences,
+                       std::size_t max_differences )
+{
+    Differences d( tolerance, differences, max_differences );
+    compare_event_info( e1, e2, d );
+    return !d.found();
+}
+
+bool compareParticles( const GenEvent& e1, const GenEvent& e2, double tolerance,
+                       std::vector<GenEventDifference>& differences,
+                       std::size_t max_differences )
+{
+    Differences d( tolerance, differences, max_differences );
+    compare_particles( e1, e2, d );
+    return !d.found();
+}
+
+bool compareVertices( const GenEvent& e1, const GenEvent& e2, double tolerance,
+                      std::vector<GenEventDifference>& differences,
+                      std::size_t max_differences )
+{
+    Differences d( tolerance, differences, max_differences );
+    compare_vertices( e1, e2, d );
+    return !d.found();
+}
+
+void printDifferences( const std::vector<GenEventDifference>& differences,
+                       std::ostream& ostr )
+{
+    for ( std::size_t i = 0; i < differences.size(); ++i ) {
+	const GenEventDifference& d = differences[i];
+	ostr << d.object << "\t" << d.barcode << "\t" << d.field << "\t"
+	     << d.first << "\t" << d.second << "\n";
+    }
 }
 
 } // HepMC
@@ -0,0 +1,250 @@
+//////////////////////////////////////////////////////////////////////////
+// EventFingerprint.cc
+//
+// GenEvent::fingerprint() and parallel_fingerprint()
+//////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "HepMC/EventFingerprint.h"
+#include "HepMC/GenEvent.h"
+#include "HepMC/ParallelAlgorithms.h"
+
+namespace HepMC {
+
+namespace {
+
+    typedef std::uint64_t word;
+
+    // the splitmix64 finalizer
+    word mix( word x )
+    {
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ULL;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebULL;
+	x ^= x >> 31;
+	return x;
+    }
+
+    // the bits hashed for a floating point value
+    word bits( double x, double tolerance )
+    {
+	if ( x == 0 ) return 0;                       // also -0
+	if ( x != x ) return 0x7ff8000000000000ULL;   // any NaN
+	if ( tolerance > 0 ) {
+	    double q = std::floor( x / tolerance + 0.5 );
+	    if ( std::fabs( q ) < 9e18 ) return (word)(long long)q;
+	    x = q;
+	}
+	word w;
+	std::memcpy( &w, &x, sizeof(w) );
+	return w;
+    }
+
+    // two independent 64 bit hashes of a sequence of words
+    class Hasher {
+    public:
+	Hasher( word seed, double tolerance )
+	  : m_a( mix( seed ) ), m_b( mix( seed ^ 0x6a09e667f3bcc909ULL ) ),
+	    m_tolerance( tolerance ) {}
+	void add( word x )
+	{
+	    m_a = mix( m_a ^ x );
+	    m_b = mix( m_b + x + 0x9e3779b97f4a7c15ULL );
+	}
+	void add( int x )    { add( (word)(long long)x ); }
+	void add( double x ) { add( bits( x, m_tolerance ) ); }
+	void add( const FourVector& v )
+	{ add( v.x() ); add( v.y() ); add( v.z() ); add( v.t() ); }
+	word a() const { return mix( m_a ^ 0x510e527fade682d1ULL ); }
+	word b() const { return mix( m_b ^ 0x9b05688c2b3e6c1fULL ); }
+    private:
+	word   m_a;
+	word   m_b;
+	double m_tolerance;
+    };
+
+    // the sum of the hashes of a set of vertices or particles, which
+    // does not depend on their order
+    struct Sum {
+	word a;
+	word b;
+	Sum() : a(0), b(0) {}
+	void add( const Hasher& h ) { a += h.a(); b += h.b(); }
+    };
+
+    Sum add( Sum x, const Sum& y )
+    {
+	x.a += y.a;
+	x.b += y.b;
+	return x;
+    }
+
+    int barcode( const GenVertex* v ) { return v ? v->barcode() : 0; }
+    int barcode( const GenParticle* p ) { return p ? p->barcode() : 0; }
+
+    void hash_particle( Sum& sum, const GenParticle* p, double tolerance )
+    {
+	Hasher h( 1, tolerance );
+	h.add( p->barcode() );
+	h.add( p->pdg_id() );
+	h.add( p->status() );
+	h.add( p->momentum() );
+	h.add( p->generated_mass() );
+	h.add( barcode( p->production_vertex() ) );
+	h.add( barcode( p->end_vertex() ) );
+	const Flow& flow = p->flow();
+	h.add( flow.size() );
+	for ( Flow::const_iterator f = flow.begin(); f != flow.end(); ++f ) {
+	    h.add( f->first );
+	    h.add( f->second );
+	}
+	h.add( p->polarization().theta() );
+	h.add( p->polarization().phi() );
+	sum.add( h );
+    }
+
+    void hash_vertex( Sum& sum, const GenVertex* v, double tolerance )
+    {
+	Hasher h( 2, tolerance );
+	h.add( v->barcode() );
+	h.add( v->position() );
+	h.add( v->id() );
+	const WeightContainer& w = v->weights();
+	h.add( (int)w.size() );
+	for ( WeightContainer::const_iterator i = w.begin(); i != w.end(); ++i ) {
+	    h.add( *i );
+	}
+	sum.add( h );
+    }
+
+    EventFingerprint finish( const GenEvent& evt, const Sum& vertices,
+                             const Sum& particles, double tolerance )
+    {
+	Hasher h( 3, tolerance );
+	h.add( evt.signal_process_id() );
+	h.add( evt.event_number() );
+	h.add( evt.mpi() );
+	h.add( evt.event_scale() );
+	h.add( evt.alphaQCD() );
+	h.add( evt.alphaQED() );
+	const std::vector<long>& rnd = evt.random_states();
+	h.add( (int)rnd.size() );
+	for ( std::size_t i = 0; i < rnd.size(); ++i ) h.add( (word)rnd[i] );
+	const WeightContainer& w = evt.weights();
+	h.add( (int)w.size() );
+	for ( WeightContainer::const_iterator i = w.begin(); i != w.end(); ++i ) {
+	    h.add( *i );
+	}
+	h.add( (int)evt.momentum_unit() );
+	h.add( (int)evt.length_unit() );
+	h.add( barcode( evt.beam_particles().first ) );
+	h.add( barcode( evt.beam_particles().second ) );
+	h.add( barcode( evt.signal_process_vertex() ) );
+	if ( const GenCrossSection* xs = evt.cross_section() ) {
+	    h.add( 1 );
+	    h.add( xs->cross_section() );
+	    h.add( xs->cross_section_error() );
+	} else {
+	    h.add( 0 );
+	}
+	if ( const HeavyIon* ion = evt.heavy_ion() ) {
+	    h.add( 1 );
+	    h.add( ion->Ncoll_hard() );
+	    h.add( ion->Npart_proj() );
+	    h.add( ion->Npart_targ() );
+	    h.add( ion->Ncoll() );
+	    h.add( ion->spectator_neutrons() );
+	    h.add( ion->spectator_protons() );
+	    h.add( ion->N_Nwounded_collisions() );
+	    h.add( ion->Nwounded_N_collisions() );
+	    h.add( ion->Nwounded_Nwounded_collisions() );
+	    h.add( (double)ion->impact_parameter() );
+	    h.add( (double)ion->event_plane_angle() );
+	    h.add( (double)ion->eccentricity() );
+	    h.add( (double)ion->sigma_inel_NN() );
+	    h.add( (double)ion->centrality() );
+	} else {
+	    h.add( 0 );
+	}
+	if ( const PdfInfo* pdf = evt.pdf_info() ) {
+	    h.add( 1 );
+	    h.add( pdf->id1() );
+	    h.add( pdf->id2() );
+	    h.add( pdf->pdf_id1() );
+	    h.add( pdf->pdf_id2() );
+	    h.add( pdf->x1() );
+	    h.add( pdf->x2() );
+	    h.add( pdf->scalePDF() );
+	    h.add( pdf->pdf1() );
+	    h.add( pdf->pdf2() );
+	} else {
+	    h.add( 0 );
+	}
+	h.add( evt.vertices_size() );
+	h.add( vertices.a );
+	h.add( vertices.b );
+	h.add( evt.particles_size() );
+	h.add( particles.a );
+	h.add( particles.b );
+	EventFingerprint f;
+	f.high = h.a();
+	f.low = h.b();
+	return f;
+    }
+
+} // unnamed namespace
+
+std::string EventFingerprint::str() const
+{
+    char buf[33];
+    std::snprintf( buf, sizeof(buf), "%016llx%016llx",
+                   (unsigned long long)high, (unsigned long long)low );
+    return std::string( buf );
+}
+
+std::ostream& operator<<( std::ostream& ostr, const EventFingerprint& f )
+{
+    return ostr << f.str();
+}
+
+EventFingerprint GenEvent::fingerprint( double tolerance ) const
+{
+    Sum vertices, particles;
+    for ( vertex_const_iterator v = vertices_begin(); v != vertices_end(); ++v ) {
+	hash_vertex( vertices, *v, tolerance );
+    }
+    for ( particle_const_iterator p = particles_begin(); p != particles_end(); ++p ) {
+	hash_particle( particles, *p, tolerance );
+    }
+    return finish( *this, vertices, particles, tolerance );
+}
+
+EventFingerprint parallel_fingerprint( const GenEvent& evt, double tolerance,
+                                       ThreadPool& pool )
+{
+    // the barcode maps are walked once to get random access
+    std::vector<const GenVertex*> v;
+    std::vector<const GenParticle*> p;
+    v.reserve( evt.vertices_size() );
+    p.reserve( evt.particles_size() );
+    v.assign( evt.vertices_begin(), evt.vertices_end() );
+    p.assign( evt.particles_begin(), evt.particles_end() );
+    Sum vertices = parallel_reduce( v.size(), Sum(),
+                                    [&]( Sum& sum, std::size_t i ) {
+					hash_vertex( sum, v[i], tolerance );
+				    },
+				    add, pool );
+    Sum particles = parallel_reduce( p.size(), Sum(),
+                                     [&]( Sum& sum, std::size_t i ) {
+					 hash_particle( sum, p[i], tolerance );
+				     },
+				     add, pool );
+    return finish( evt, vertices, particles, tolerance );
+}
+
+} // HepMC
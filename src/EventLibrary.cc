@@ -0,0 +1,151 @@
+//////////////////////////////////////////////////////////////////////////
+// EventLibrary.cc
+//
+// events held in memory in packed arrays, for random sampling
+//////////////////////////////////////////////////////////////////////////
+
+#include "HepMC/EventLibrary.h"
+#include "HepMC/GenEvent.h"
+#include "HepMC/IO_BaseClass.h"
+#include "HepMC/PileupOverlay.h"
+
+namespace HepMC {
+
+EventLibrary::EventLibrary()
+  : m_events(), m_vertices(), m_particles(), m_links(), m_graph()
+{}
+
+std::size_t EventLibrary::load( IO_BaseClass& input, std::size_t max_events )
+{
+    std::size_t n = 0;
+    GenEvent evt;
+    while ( ( max_events == 0 || n < max_events ) && input.fill_next_event( &evt ) ) {
+	add( evt );
+	evt.clear();
+	++n;
+    }
+    return n;
+}
+
+void EventLibrary::add( const GenEvent& evt )
+{
+    m_graph.build( evt );
+    Event e;
+    e.first_vertex = m_vertices.size();
+    e.first_particle = m_particles.size();
+    e.first_link = m_links.size();
+    e.nvertices = m_graph.vertices_size();
+    e.nparticles = m_graph.particles_size();
+    e.signal_process_id = evt.signal_process_id();
+    e.event_number = evt.event_number();
+    e.mpi = evt.mpi();
+    e.signal_vertex = evt.signal_process_vertex() ? m_graph.index( evt.signal_process_vertex() ) : -1;
+    e.beam_1 = evt.beam_particles().first ? m_graph.index( evt.beam_particles().first ) : -1;
+    e.beam_2 = evt.beam_particles().second ? m_graph.index( evt.beam_particles().second ) : -1;
+    e.event_scale = evt.event_scale();
+    e.alpha_qcd = evt.alphaQCD();
+    e.alpha_qed = evt.alphaQED();
+    e.momentum_unit = evt.momentum_unit();
+    e.length_unit = evt.length_unit();
+
+    for ( int v = 0; v < e.nvertices; ++v ) {
+	const GenVertex* vtx = m_graph.vertex(v);
+	Vertex packed;
+	packed.x = vtx->position().x();
+	packed.y = vtx->position().y();
+	packed.z = vtx->position().z();
+	packed.t = vtx->position().t();
+	packed.barcode = vtx->barcode();
+	packed.id = vtx->id();
+	packed.nin = m_graph.particles_in_size(v);
+	packed.nout = m_graph.particles_out_size(v);
+	m_vertices.push_back( packed );
+	m_links.insert( m_links.end(), m_graph.particles_in_begin(v), m_graph.particles_in_end(v) );
+	m_links.insert( m_links.end(), m_graph.particles_out_begin(v), m_graph.particles_out_end(v) );
+    }
+    for ( int p = 0; p < e.nparticles; ++p ) {
+	const GenParticle* part = m_graph.particle(p);
+	Particle packed;
+	packed.px = part->momentum().px();
+	packed.py = part->momentum().py();
+	packed.pz = part->momentum().pz();
+	packed.e = part->momentum().e();
+	packed.generated_mass = part->generated_mass();
+	packed.barcode = part->barcode();
+	packed.pdg_id = part->pdg_id();
+	packed.status = part->status();
+	m_particles.push_back( packed );
+    }
+    m_events.push_back( e );
+}
+
+void EventLibrary::clear()
+{
+    m_events.clear();
+    m_vertices.clear();
+    m_particles.clear();
+    m_links.clear();
+}
+
+std::size_t EventLibrary::memory_size() const
+{
+    return m_events.capacity() * sizeof(Event)
+	+ m_vertices.capacity() * sizeof(Vertex)
+	+ m_particles.capacity() * sizeof(Particle)
+	+ m_links.capacity() * sizeof(int);
+}
+
+GenEvent* EventLibrary::event( std::size_t i ) const
+{
+    GenEvent* evt = new GenEvent();
+    fill_event( i, evt );
+    return evt;
+}
+
+void EventLibrary::fill_event( std::size_t i, GenEvent* evt ) const
+{
+    const Event& e = m_events[i];
+    evt->clear();
+    evt->set_signal_process_id( e.signal_process_id );
+    evt->set_event_number( e.event_number );
+    evt->set_mpi( e.mpi );
+    evt->set_event_scale( e.event_scale );
+    evt->set_alphaQCD( e.alpha_qcd );
+    evt->set_alphaQED( e.alpha_qed );
+    evt->define_units( e.momentum_unit, e.length_unit );
+
+    // the particles get their barcodes before they are attached, so that
+    // the event accepts them as they are
+    std::vector<GenParticle*> particles( e.nparticles );
+    const Particle* part = e.nparticles ? &m_particles[e.first_particle] : 0;
+    for ( int p = 0; p < e.nparticles; ++p, ++part ) {
+	particles[p] = new GenParticle( FourVector( part->px, part->py, part->pz, part->e ),
+	                                part->pdg_id, part->status );
+	particles[p]->set_generated_mass( part->generated_mass );
+	particles[p]->suggest_barcode( part->barcode );
+    }
+    GenVertex* signal_vertex = 0;
+    const int* link = e.nvertices ? &m_links[e.first_link] : 0;
+    const Vertex* vtx = e.nvertices ? &m_vertices[e.first_vertex] : 0;
+    for ( int v = 0; v < e.nvertices; ++v, ++vtx ) {
+	GenVertex* made = new GenVertex( FourVector( vtx->x, vtx->y, vtx->z, vtx->t ), vtx->id );
+	made->suggest_barcode( vtx->barcode );
+	evt->add_vertex( made );
+	for ( int k = 0; k < vtx->nin; ++k ) made->add_particle_in( particles[*link++] );
+	for ( int k = 0; k < vtx->nout; ++k ) made->add_particle_out( particles[*link++] );
+	if ( v == e.signal_vertex ) signal_vertex = made;
+    }
+    evt->set_signal_process_vertex( signal_vertex );
+    evt->set_beam_particles( e.beam_1 >= 0 ? particles[e.beam_1] : 0,
+                             e.beam_2 >= 0 ? particles[e.beam_2] : 0 );
+}
+
+void EventLibrary::overlay( std::size_t i, PileupOverlay& overlay,
+                            const FourVector& shift ) const
+{
+    GenEvent evt;
+    fill_event( i, &evt );
+    overlay.add( evt, shift );
+}
+
+} // HepMC
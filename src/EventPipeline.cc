@@ -0,0 +1,247 @@
+//////////////////////////////////////////////////////////////////////////
+// EventPipeline.cc
+//
+// read events, process them on several threads, and write them
+//////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "HepMC/EventPipeline.h"
+#include "HepMC/BoundedQueue.h"
+#include "HepMC/GenEvent.h"
+#include "HepMC/GenEventPool.h"
+#include "HepMC/IO_BaseClass.h"
+
+namespace HepMC {
+
+namespace {
+
+    // an event on its way through the pipeline
+    struct Item {
+	GenEvent*   event;  // null marks the end of the input
+	std::size_t index;  // position in the input
+	bool        keep;   // to be written
+    };
+
+    // retry attempt() until it succeeds, first spinning, then yielding,
+    // then sleeping; false if the pipeline stops first
+    template <class Attempt>
+    bool wait_for( Attempt attempt, const std::atomic<bool>& stop )
+    {
+	for ( unsigned n = 0; !attempt(); ++n ) {
+	    if ( stop.load( std::memory_order_relaxed ) ) return false;
+	    if ( n < 64 ) continue;
+	    if ( n < 256 ) std::this_thread::yield();
+	    else std::this_thread::sleep_for( std::chrono::microseconds( 50 ) );
+	}
+	return true;
+    }
+
+    // the state of one run of the pipeline
+    class PipelineRun {
+    public:
+	PipelineRun( IO_BaseClass& input, IO_BaseClass* output,
+	             const EventPipeline::event_function& work, unsigned nworkers,
+	             bool ordered, bool recycle, std::size_t queue_size,
+	             std::size_t max_events )
+	  : m_input(input), m_output(output), m_work(work), m_nworkers(nworkers),
+	    m_ordered(ordered), m_recycle(recycle), m_max_events(max_events),
+	    m_in_flight( 2 * queue_size + nworkers ),
+	    m_to_workers( queue_size ), m_to_writer( queue_size ),
+	    m_pool( m_in_flight + 1 ),
+	    m_stop(false), m_finished(0), m_read(0), m_written(0), m_dropped(0),
+	    m_error_lock(), m_error()
+	{}
+
+	~PipelineRun()
+	{
+	    // after a stop, events may be left in the queues
+	    Item item;
+	    while ( m_to_workers.try_pop( item ) ) delete item.event;
+	    while ( m_to_writer.try_pop( item ) ) delete item.event;
+	}
+
+	void read();
+	void work();
+	void write();
+
+	std::size_t read_count() const    { return m_read; }
+	std::size_t written_count() const { return m_written; }
+	std::size_t dropped_count() const { return m_dropped; }
+	/// rethrow the first exception of any stage
+	void rethrow() const { if ( m_error ) std::rethrow_exception( m_error ); }
+
+    private:
+	/// remember the current exception and stop all stages
+	void fail();
+	/// write or drop an event which is done, and recycle it
+	void finish( const Item& item );
+
+    private:
+	IO_BaseClass&                        m_input;
+	IO_BaseClass*                        m_output;
+	const EventPipeline::event_function& m_work;
+	unsigned                             m_nworkers;
+	bool                                 m_ordered;
+	bool                                 m_recycle;
+	std::size_t                          m_max_events;
+	std::size_t                          m_in_flight;  // events read but not finished
+	BoundedQueue<Item>                   m_to_workers;
+	BoundedQueue<Item>                   m_to_writer;
+	GenEventPool                         m_pool;       // events for the reader
+	std::atomic<bool>                    m_stop;
+	std::atomic<std::size_t>             m_finished;   // written or dropped
+	std::size_t                          m_read;       // only used by the reader
+	std::size_t                          m_written;    // only used by the writer
+	std::size_t                          m_dropped;    // only used by the writer
+	std::mutex                           m_error_lock;
+	std::exception_ptr                   m_error;
+    };
+
+    void PipelineRun::fail()
+    {
+	std::lock_guard<std::mutex> guard( m_error_lock );
+	if ( !m_error ) m_error = std::current_exception();
+	m_stop.store( true );
+    }
+
+    void PipelineRun::read()
+    {
+	try {
+	    while ( m_max_events == 0 || m_read < m_max_events ) {
+		// bound the events in flight, so that the ordered output
+		// needs a fixed buffer
+		if ( !wait_for( [this]() {
+			    return m_read - m_finished.load( std::memory_order_acquire ) < m_in_flight;
+			}, m_stop ) ) break;
+		GenEvent* evt = m_recycle ? m_pool.acquire() : new GenEvent();
+		if ( !m_input.fill_next_event( evt ) ) {
+		    delete evt;
+		    break;
+		}
+		Item item = { evt, m_read, true };
+		if ( !wait_for( [&]() { return m_to_workers.try_push( item ); }, m_stop ) ) {
+		    delete evt;
+		    break;
+		}
+		++m_read;
+	    }
+	} catch ( ... ) {
+	    fail();
+	}
+	// one end marker for each worker
+	Item end = { 0, 0, false };
+	for ( unsigned i = 0; i < m_nworkers; ++i ) {
+	    if ( !wait_for( [&]() { return m_to_workers.try_push( end ); }, m_stop ) ) break;
+	}
+    }
+
+    void PipelineRun::work()
+    {
+	Item item;
+	while ( wait_for( [&]() { return m_to_workers.try_pop( item ); }, m_stop ) ) {
+	    if ( item.event ) {
+		try {
+		    item.keep = m_work( item.event );
+		} catch ( ... ) {
+		    fail();
+		    delete item.event;
+		    return;
+		}
+	    }
+	    if ( !wait_for( [&]() { return m_to_writer.try_push( item ); }, m_stop ) ) {
+		delete item.event;
+		return;
+	    }
+	    // pass on the end marker, after all earlier events of this worker
+	    if ( !item.event ) return;
+	}
+    }
+
+    void PipelineRun::finish( const Item& item )
+    {
+	if ( item.keep && m_output ) {
+	    m_output->write_event( item.event );
+	    ++m_written;
+	} else if ( !item.keep ) {
+	    ++m_dropped;
+	}
+	if ( m_recycle ) {
+	    m_pool.release( item.event );
+	} else {
+	    delete item.event;
+	}
+	m_finished.fetch_add( 1, std::memory_order_release );
+    }
+
+    void PipelineRun::write()
+    {
+	// the events waiting for an earlier one, at index % m_in_flight
+	std::vector<Item> pending( m_ordered ? m_in_flight : 0 );
+	for ( std::size_t i = 0; i < pending.size(); ++i ) pending[i].event = 0;
+	std::size_t next = 0;
+	unsigned ended = 0;
+	try {
+	    Item item;
+	    while ( ended < m_nworkers
+		    && wait_for( [&]() { return m_to_writer.try_pop( item ); }, m_stop ) ) {
+		if ( !item.event ) {
+		    ++ended;
+		} else if ( !m_ordered ) {
+		    finish( item );
+		} else {
+		    pending[item.index % m_in_flight] = item;
+		    for ( Item* p = &pending[next % m_in_flight]; p->event;
+			  p = &pending[next % m_in_flight] ) {
+			Item done = *p;
+			p->event = 0;
+			++next;
+			finish( done );
+		    }
+		}
+	    }
+	} catch ( ... ) {
+	    fail();
+	}
+	for ( std::size_t i = 0; i < pending.size(); ++i ) delete pending[i].event;
+    }
+
+} // unnamed namespace
+
+EventPipeline::EventPipeline( IO_BaseClass& input, IO_BaseClass* output,
+                              const event_function& work, unsigned nworkers )
+  : m_input(input), m_output(output), m_work(work), m_nworkers(nworkers),
+    m_ordered(true), m_recycle(true), m_queue_size(64), m_max_events(0),
+    m_read(0), m_written(0), m_dropped(0)
+{
+    if ( m_nworkers == 0 ) {
+	unsigned n = std::thread::hardware_concurrency();
+	m_nworkers = n > 3 ? n - 2 : 1;
+    }
+}
+
+std::size_t EventPipeline::run()
+{
+    PipelineRun pipeline( m_input, m_output, m_work, m_nworkers, m_ordered,
+                          m_recycle, m_queue_size, m_max_events );
+    std::vector<std::thread> threads;
+    threads.reserve( m_nworkers + 1 );
+    threads.push_back( std::thread( &PipelineRun::read, &pipeline ) );
+    for ( unsigned i = 0; i < m_nworkers; ++i ) {
+	threads.push_back( std::thread( &PipelineRun::work, &pipeline ) );
+    }
+    pipeline.write();
+    for ( std::size_t i = 0; i < threads.size(); ++i ) threads[i].join();
+    m_read = pipeline.read_count();
+    m_written = pipeline.written_count();
+    m_dropped = pipeline.dropped_count();
+    pipeline.rethrow();
+    return m_written;
+}
+
+} // HepMC
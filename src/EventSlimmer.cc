@@ -0,0 +1,233 @@
+//////////////////////////////////////////////////////////////////////////
+// EventSlimmer.cc
+//
+// remove particles and vertices from an event in one pass
+//////////////////////////////////////////////////////////////////////////
+
+#include "HepMC/EventSlimmer.h"
+#include "HepMC/GenEvent.h"
+
+namespace HepMC {
+
+namespace {
+
+    // values of EventSlimmer::m_forward which are not vertex indices
+    const int alive   = -1;
+    const int deleted = -2;
+
+    // particle state flags
+    const char dead     = 1;  // to be deleted
+    const char detached = 2;  // has lost its end vertex
+    const char orphan   = 4;  // has lost its production vertex
+
+} // unnamed namespace
+
+EventSlimmer::EventSlimmer()
+  : m_keep_particle(), m_keep_vertex(), m_graph(),
+    m_forward(), m_out_head(), m_out_tail(), m_next_out(),
+    m_state(), m_drop(), m_roots(),
+    m_removed_particles(0), m_removed_vertices(0)
+{}
+
+EventSlimmer::EventSlimmer( const particle_predicate& keep_particle,
+                            const vertex_predicate& keep_vertex )
+  : m_keep_particle(keep_particle), m_keep_vertex(keep_vertex), m_graph(),
+    m_forward(), m_out_head(), m_out_tail(), m_next_out(),
+    m_state(), m_drop(), m_roots(),
+    m_removed_particles(0), m_removed_vertices(0)
+{}
+
+std::size_t EventSlimmer::slim( GenEvent& evt )
+{
+    m_removed_particles = 0;
+    m_removed_vertices = 0;
+    m_graph.build( evt );
+    int nv = m_graph.vertices_size();
+    int np = m_graph.particles_size();
+    m_forward.assign( nv, alive );
+    m_out_head.assign( nv, -1 );
+    m_out_tail.assign( nv, -1 );
+    m_next_out.assign( np, -1 );
+    m_state.assign( np, 0 );
+    m_drop.assign( np, 0 );
+    m_roots.clear();
+    // the outgoing particles as linked lists, which can be spliced
+    for ( int v = 0; v < nv; ++v ) {
+	for ( const int* p = m_graph.particles_out_begin(v);
+	      p != m_graph.particles_out_end(v); ++p ) {
+	    if ( m_out_tail[v] < 0 ) m_out_head[v] = *p;
+	    else m_next_out[m_out_tail[v]] = *p;
+	    m_out_tail[v] = *p;
+	}
+    }
+    // decide everything before the graph changes
+    if ( m_keep_particle ) {
+	for ( int p = 0; p < np; ++p ) {
+	    if ( !m_keep_particle( m_graph.particle(p) ) ) m_drop[p] = 1;
+	}
+    }
+    if ( m_keep_vertex ) {
+	for ( int v = 0; v < nv; ++v ) {
+	    if ( m_keep_vertex( m_graph.vertex(v) ) ) continue;
+	    if ( m_graph.particles_in_size(v) > 0 ) {
+		m_drop[ *m_graph.particles_in_begin(v) ] = 1;
+	    } else {
+		m_roots.push_back( v );
+	    }
+	}
+    }
+    // particles are numbered by barcode
+    for ( int p = np-1; p >= 0; --p ) {
+	if ( m_drop[p] ) remove( p );
+    }
+    for ( std::size_t i = 0; i < m_roots.size(); ++i ) {
+	if ( m_forward[m_roots[i]] == alive ) remove_vertex( m_roots[i], -1, -1 );
+    }
+    rebuild( evt );
+    return m_removed_particles;
+}
+
+int EventSlimmer::find( int v )
+{
+    int r = v;
+    while ( m_forward[r] >= 0 ) r = m_forward[r];
+    // path compression
+    while ( m_forward[v] >= 0 ) {
+	int next = m_forward[v];
+	m_forward[v] = r;
+	v = next;
+    }
+    return ( m_forward[r] == alive ? r : -1 );
+}
+
+int EventSlimmer::producer( int p )
+{
+    int v = m_graph.production_vertex(p);
+    if ( v < 0 || ( m_state[p] & orphan ) ) return -1;
+    return find( v );
+}
+
+int EventSlimmer::consumer( int p ) const
+{
+    // the incoming particles of merged vertices are detached,
+    // so the end vertex never moves
+    if ( m_state[p] & detached ) return -1;
+    return m_graph.end_vertex(p);
+}
+
+void EventSlimmer::remove( int p )
+{
+    if ( m_state[p] & dead ) return;
+    int start = producer( p );
+    int end = consumer( p );
+    // for a loop (or a particle without vertices) only the particle goes
+    if ( end >= 0 && end != start ) remove_vertex( end, start, p );
+    m_state[p] |= dead;
+}
+
+void EventSlimmer::remove_vertex( int v, int into, int except )
+{
+    /// same order as the GenVertex destructor: outgoing particles first
+    if ( into >= 0 ) {
+	if ( m_out_head[v] >= 0 ) {
+	    if ( m_out_tail[into] < 0 ) m_out_head[into] = m_out_head[v];
+	    else m_next_out[m_out_tail[into]] = m_out_head[v];
+	    m_out_tail[into] = m_out_tail[v];
+	}
+	m_forward[v] = into;
+    } else {
+	for ( int p = m_out_head[v]; p >= 0; p = m_next_out[p] ) {
+	    if ( m_state[p] & dead ) continue;
+	    m_state[p] |= ( consumer(p) < 0 ? dead : orphan );
+	}
+	m_forward[v] = deleted;
+    }
+    m_out_head[v] = m_out_tail[v] = -1;
+    for ( const int* p = m_graph.particles_in_begin(v);
+	  p != m_graph.particles_in_end(v); ++p ) {
+	if ( *p == except || ( m_state[*p] & ( dead | detached ) ) ) continue;
+	m_state[*p] |= ( producer(*p) < 0 ? dead : detached );
+    }
+}
+
+void EventSlimmer::rebuild( GenEvent& evt )
+{
+    int nv = m_graph.vertices_size();
+    int np = m_graph.particles_size();
+    // particles left without any vertex are not in the event any more
+    for ( int p = 0; p < np; ++p ) {
+	if ( !( m_state[p] & dead ) && producer(p) < 0 && consumer(p) < 0 ) {
+	    m_state[p] |= dead;
+	}
+    }
+    // new particle lists for the surviving vertices
+    std::vector<GenParticle*> in, out;
+    for ( int v = 0; v < nv; ++v ) {
+	if ( m_forward[v] != alive ) continue;
+	in.clear();
+	out.clear();
+	for ( const int* p = m_graph.particles_in_begin(v);
+	      p != m_graph.particles_in_end(v); ++p ) {
+	    if ( !( m_state[*p] & ( dead | detached ) ) ) {
+		in.push_back( m_graph.particle(*p) );
+	    }
+	}
+	for ( int p = m_out_head[v]; p >= 0; p = m_next_out[p] ) {
+	    if ( !( m_state[p] & dead ) ) out.push_back( m_graph.particle(p) );
+	}
+	if ( in.empty() && out.empty() ) {
+	    m_forward[v] = deleted;
+	    continue;
+	}
+	GenVertex* vtx = m_graph.vertex(v);
+	std::vector<GenParticle*>( in ).swap( vtx->m_particles_in );
+	std::vector<GenParticle*>( out ).swap( vtx->m_particles_out );
+    }
+    // the particle links; the barcodes of the survivors do not change,
+    // so the members are set directly rather than by set_end_vertex_()
+    for ( int p = 0; p < np; ++p ) {
+	GenParticle* part = m_graph.particle(p);
+	if ( m_state[p] & dead ) continue;
+	int start = producer( p );
+	int end = consumer( p );
+	part->m_production_vertex = ( start >= 0 ? m_graph.vertex(start) : 0 );
+	part->m_end_vertex = ( end >= 0 ? m_graph.vertex(end) : 0 );
+    }
+    if ( evt.m_signal_process_vertex ) {
+	int v = m_graph.index( evt.m_signal_process_vertex );
+	if ( v >= 0 ) {
+	    int r = find( v );
+	    evt.m_signal_process_vertex = ( r >= 0 ? m_graph.vertex(r) : 0 );
+	}
+    }
+    if ( evt.m_beam_particle_1 ) {
+	int p = m_graph.index( evt.m_beam_particle_1 );
+	if ( p >= 0 && ( m_state[p] & dead ) ) evt.m_beam_particle_1 = 0;
+    }
+    if ( evt.m_beam_particle_2 ) {
+	int p = m_graph.index( evt.m_beam_particle_2 );
+	if ( p >= 0 && ( m_state[p] & dead ) ) evt.m_beam_particle_2 = 0;
+    }
+    // delete what was removed; the lists are emptied first, so that
+    // the destructors do not delete particles or change barcodes
+    for ( int v = 0; v < nv; ++v ) {
+	if ( m_forward[v] == alive ) continue;
+	GenVertex* vtx = m_graph.vertex(v);
+	vtx->m_particles_in.clear();
+	vtx->m_particles_out.clear();
+	delete vtx;
+	++m_removed_vertices;
+    }
+    for ( int p = 0; p < np; ++p ) {
+	if ( !( m_state[p] & dead ) ) continue;
+	GenParticle* part = m_graph.particle(p);
+	evt.remove_barcode( part );
+	part->m_production_vertex = 0;
+	part->m_end_vertex = 0;
+	delete part;
+	++m_removed_particles;
+    }
+    evt.invalidate_genealogy_index();
+}
+
+} // HepMC
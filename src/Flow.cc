@@ -3,32 +3,180 @@
 // particle's flow object
 //////////////////////////////////////////////////////////////////////////
 
+#include <set>
+
 #include "HepMC/Flow.h"
 #include "HepMC/GenParticle.h"
 #include "HepMC/GenVertex.h"
-#include "HepMC/SearchVector.h"
 
 namespace HepMC {
 
+namespace {
+
+    /// a particle being searched for flow partners
+    struct FlowFrame {
+	GenParticle* owner;
+	int          stage;     // 0: end vertex, 1: production vertex, 2: done
+	std::size_t  position;  // in the particles of the vertex, in then out
+	int          index;     // next code index to compare
+	int          partners;  // flow neighbours found so far
+    };
+
+    FlowFrame flow_frame( GenParticle* owner, int code_index )
+    {
+	FlowFrame f = { owner, 0, 0, code_index, 0 };
+	return f;
+    }
+
+    /// depth first search for the particles connected to start through
+    /// its end and production vertices by the same flow code.
+    /// Newly found particles are added to visited and appended to found;
+    /// particles with at most one neighbour are appended to dangling
+    /// once their partners have been searched.
+    /// An explicit stack replaces the recursion used before, so long
+    /// flow lines cannot exhaust the call stack.
+    void walk_flow( GenParticle* start, int code, int code_index, int num_indices,
+                    std::set<const GenParticle*>& visited,
+                    std::vector<GenParticle*>* found,
+                    std::vector<GenParticle*>* dangling )
+    {
+	std::vector<FlowFrame> stack;
+	stack.push_back( flow_frame( start, code_index ) );
+	while ( !stack.empty() ) {
+	    FlowFrame& f = stack.back();
+	    if ( f.stage == 2 ) {
+		if ( dangling && f.partners <= 1 ) dangling->push_back( f.owner );
+		stack.pop_back();
+		continue;
+	    }
+	    const GenVertex* v = ( f.stage == 0 ? f.owner->end_vertex()
+	                                        : f.owner->production_vertex() );
+	    std::size_t nin = v ? v->particles_in_size() : 0;
+	    if ( !v || f.position == nin + v->particles_out_size() ) {
+		++f.stage;
+		f.position = 0;
+		f.index = code_index;
+		continue;
+	    }
+	    if ( f.index == code_index + num_indices ) {
+		++f.position;
+		f.index = code_index;
+		continue;
+	    }
+	    GenParticle* p = ( f.position < nin 
+	                       ? *( v->particles_in_const_begin() + f.position )
+	                       : *( v->particles_out_const_begin() + ( f.position - nin ) ) );
+	    if ( p->flow( f.index++ ) != code ) continue;
+	    if ( p != f.owner ) ++f.partners;
+	    if ( visited.insert( p ).second ) {
+		if ( found ) found->push_back( p );
+		// f is invalidated by push_back
+		stack.push_back( flow_frame( p, code_index ) );
+	    }
+	}
+    }
+
+} // unnamed namespace
+
     Flow::Flow( GenParticle* particle_owner ) 
-	: m_particle_owner(particle_owner) 
+	: m_particle_owner(particle_owner),
+	  m_size(0),
+	  m_overflow(0)
     {}
 
     Flow::Flow( const Flow& inflow ) : 
 	m_particle_owner(inflow.m_particle_owner),
-	m_icode(inflow.m_icode)
+	m_size(inflow.m_size),
+	m_overflow(0)
     {
-	/// copies both the m_icode AND the m_particle_owner
+	/// copies both the flow codes AND the m_particle_owner
+	if ( inflow.m_overflow ) {
+	    m_overflow = new std::vector<value_type>( *inflow.m_overflow );
+	} else {
+	    for ( int i = 0; i < m_size; ++i ) m_inline[i] = inflow.m_inline[i];
+	}
     }
 
     Flow::~Flow() {
-	m_icode.clear();
+	delete m_overflow;
     }
 
     void Flow::swap( Flow & other)
     {
 	std::swap( m_particle_owner, other.m_particle_owner );
-	m_icode.swap( other.m_icode );
+	for ( int i = 0; i < inline_capacity; ++i ) {
+	    std::swap( m_inline[i], other.m_inline[i] );
+	}
+	std::swap( m_size, other.m_size );
+	std::swap( m_overflow, other.m_overflow );
+    }
+
+    Flow& Flow::operator=( const Flow& inflow ) {
+	/// copies only the flow codes ... not the particle_owner
+	/// this is intuitive behaviour so you can do
+	/// oneparticle->flow() = otherparticle->flow()
+	//
+	if ( this == &inflow ) return *this;
+	if ( inflow.m_overflow ) {
+	    if ( m_overflow ) {
+		*m_overflow = *inflow.m_overflow;
+	    } else {
+		m_overflow = new std::vector<value_type>( *inflow.m_overflow );
+	    }
+	    m_size = 0;
+	} else {
+	    delete m_overflow;
+	    m_overflow = 0;
+	    m_size = inflow.m_size;
+	    for ( int i = 0; i < m_size; ++i ) m_inline[i] = inflow.m_inline[i];
+	}
+	return *this;
+    }
+
+    void Flow::clear() {
+	delete m_overflow;
+	m_overflow = 0;
+	m_size = 0;
+    }
+
+    bool Flow::erase( int code_index ) {
+	/// returns true if a flow code was removed
+	value_type* pos = lower_bound( code_index );
+	value_type* last = data() + size();
+	if ( pos == last || pos->first != code_index ) return false;
+	if ( !m_overflow ) {
+	    for ( value_type* i = pos; i+1 != last; ++i ) *i = *(i+1);
+	    --m_size;
+	    return true;
+	}
+	m_overflow->erase( m_overflow->begin() + (pos - data()) );
+	if ( m_overflow->size() <= (size_t)inline_capacity ) {
+	    // small again: move the remaining codes back inline
+	    m_size = (int)m_overflow->size();
+	    for ( int i = 0; i < m_size; ++i ) m_inline[i] = (*m_overflow)[i];
+	    delete m_overflow;
+	    m_overflow = 0;
+	}
+	return true;
+    }
+
+    void Flow::insert( value_type* pos, int code_index, int code ) {
+	/// private: insert a new pair before pos, keeping the order
+	if ( m_overflow ) {
+	    m_overflow->insert( m_overflow->begin() + (pos - data()),
+	                        value_type(code_index,code) );
+	} else if ( m_size < inline_capacity ) {
+	    for ( value_type* i = m_inline + m_size; i != pos; --i ) *i = *(i-1);
+	    *pos = value_type(code_index,code);
+	    ++m_size;
+	} else {
+	    // inline storage is full: move everything to the overflow vector
+	    int offset = (int)(pos - m_inline);
+	    m_overflow = new std::vector<value_type>( m_inline, m_inline + m_size );
+	    m_overflow->insert( m_overflow->begin() + offset,
+	                        value_type(code_index,code) );
+	    m_size = 0;
+	}
     }
 
     void Flow::print( std::ostream& ostr ) const {
@@ -60,49 +208,14 @@ namespace HepMC {
     void Flow::connected_partners( std::vector<HepMC::GenParticle*>* output, int code, 
 				   int code_index, int num_indices ) const
     {
-	/// protected: for recursive use by Flow::connected_partners()
+	/// protected: used by Flow::connected_partners()
+	/// appends the partners which are not yet in output, in the order
+	/// of a depth first search
 	//
     	if ( !m_particle_owner ) return; // nothing to do
-	// look for connected partners joined to this m_particle_owner
-	// through its end_vertex
-	if ( m_particle_owner->end_vertex() ) {
-	    for ( GenVertex::particle_iterator p 
-		     = m_particle_owner->end_vertex()->particles_begin(family);
-		  p != m_particle_owner->end_vertex()->particles_end(family);
-		  ++p ) {
-		// if the particle has the correct flow code and is not yet in 
-		// the set, then we recursively call connected_partners
-		for ( int index = code_index; index!=code_index+num_indices; 
-		      ++index ){
-		    if ( (*p)->flow(index)==code && not_in_vector(output,(*p)) ) {
-			output->push_back(*p);
-			(*p)->flow().connected_partners( output, code,
-							 code_index, 
-							 num_indices );
-		    }
-		}
-	    }
-	}
-	// same for production_vertex
-	if ( m_particle_owner->production_vertex() ) {
-	    for ( GenVertex::particle_iterator p 
-		      = m_particle_owner->production_vertex()->
-		      particles_begin( family );
-		  p != m_particle_owner->production_vertex()->
-		      particles_end( family ); ++p ) {
-		// if the particle has the correct flow code and is not yet in 
-		// the set, then we recursively call connected_partners
-		for ( int index = code_index; index!=code_index+num_indices; 
-		      ++index ){
-		    if ( (*p)->flow(index)==code && not_in_vector(output,(*p)) ) {
-			output->push_back(*p);
-			(*p)->flow().connected_partners( output, code,
-							 code_index, 
-							 num_indices );
-		    }
-		}
-	    }
-	}
+	std::set<const GenParticle*> visited( output->begin(), output->end() );
+	walk_flow( m_particle_owner, code, code_index, num_indices, 
+	           visited, output, 0 );
     }
 
     std::vector<GenParticle*> Flow::dangling_connected_partners( int code, 
@@ -126,60 +239,15 @@ namespace HepMC {
 					    int code, int code_index, 
 					    int num_indices ) const 
     {
-	/// protected: for recursive use by Flow::dangling_connected_partners
+	/// protected: used by Flow::dangling_connected_partners
+	/// appends the partners with at most one flow neighbour to output,
+	/// and all partners to visited_particles
 	//
     	if ( !m_particle_owner ) return; // nothing to do
-	int count_partners = 0;
-	// look for connected partners joined to this m_particle_owner
-	// through its end_vertex
-	if ( m_particle_owner->end_vertex() ) {
-	    for ( GenVertex::particle_iterator p 
-		     = m_particle_owner->end_vertex()->particles_begin(family);
-		  p != m_particle_owner->end_vertex()->particles_end(family);
-		  ++p ) {
-		// if the particle has the correct flow code and is not yet in 
-		// the set, then we recursively call connected_partners
-		for ( int index = code_index; index!=code_index+num_indices; 
-		      ++index ){
-		    if ( (*p)->flow(index)==code ) {
-			if ( *p!=m_particle_owner ) ++count_partners;
-			if ( not_in_vector(visited_particles,(*p)) ) {
-			    visited_particles->push_back(*p);
-			    (*p)->flow().dangling_connected_partners( output, 
-					             visited_particles, code,
-						     code_index, num_indices );
-
-			}
-		    }		
-		}
-	    }
-	}
-	// same for production_vertex
-	if ( m_particle_owner->production_vertex() ) {
-	    for ( GenVertex::particle_iterator p = m_particle_owner->
-						production_vertex()->
-						particles_begin( family );
-		  p != m_particle_owner->production_vertex()->
-						particles_end( family ); 
-		  ++p ) {
-		// if the particle has the correct flow code and is not yet in 
-		// the set, then we recursively call connected_partners
-		for ( int index = code_index; index!=code_index+num_indices; 
-		      ++index ){
-		    if ( (*p)->flow(index)==code ) {
-			if ( *p!=m_particle_owner ) ++count_partners;
-			if ( not_in_vector(visited_particles,(*p)) ) {
-			    visited_particles->push_back(*p);
-			    (*p)->flow().dangling_connected_partners( output, 
-					             visited_particles, code,
-						     code_index, num_indices );
-
-			}
-		    }
-		}
-	    }
-	}
-	if ( count_partners <= 1 ) output->push_back( m_particle_owner );
+	std::set<const GenParticle*> visited( visited_particles->begin(), 
+	                                      visited_particles->end() );
+	walk_flow( m_particle_owner, code, code_index, num_indices, 
+	           visited, visited_particles, output );
     }
 	
     /////////////
@@ -188,9 +256,8 @@ namespace HepMC {
 
         /// send Flow informatin to ostr for printing
     std::ostream& operator<<( std::ostream& ostr, const Flow& f ) {
-	ostr << f.m_icode.size();
-	for ( std::map<int,int>::const_iterator i = f.m_icode.begin();
-	      i != f.m_icode.end(); ++i ) {
+	ostr << f.size();
+	for ( Flow::const_iterator i = f.begin(); i != f.end(); ++i ) {
 	    ostr << " " << (*i).first << " " << (*i).second;
 	}
 	return ostr;
@@ -0,0 +1,174 @@
+//////////////////////////////////////////////////////////////////////////
+// FlowIndex.cc
+//
+// all flow lines of an event at once
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include "HepMC/FlowIndex.h"
+#include "HepMC/GenEvent.h"
+
+namespace HepMC {
+
+namespace {
+
+    /// a particle carrying a code, in multiplicity of the code indices
+    struct FlowNode {
+	int code;
+	int particle;
+	int multiplicity;
+    };
+
+    /// a node attached to one of its vertices
+    struct FlowAttachment {
+	int              code;
+	const GenVertex* vertex;
+	int              node;
+    };
+
+    bool by_code_and_vertex( const FlowAttachment& a, const FlowAttachment& b )
+    {
+	if ( a.code != b.code ) return a.code < b.code;
+	if ( a.vertex != b.vertex ) return a.vertex < b.vertex;
+	return a.node < b.node;
+    }
+
+    struct by_code_and_particle {
+	const std::vector<FlowNode>* nodes;
+	bool operator()( int a, int b ) const
+	{
+	    const FlowNode& x = (*nodes)[a];
+	    const FlowNode& y = (*nodes)[b];
+	    if ( x.code != y.code ) return x.code < y.code;
+	    return x.particle < y.particle;
+	}
+    };
+
+    int find_root( std::vector<int>& parent, int i )
+    {
+	while ( parent[i] != i ) {
+	    parent[i] = parent[ parent[i] ];	// path halving
+	    i = parent[i];
+	}
+	return i;
+    }
+
+} // unnamed namespace
+
+FlowIndex::FlowIndex( const GenEvent& evt, int code_index, int num_indices )
+  : m_lines(), m_lookup()
+{
+    //
+    // 1. one node per particle and code, attached to the particle's vertices
+    std::vector<GenParticle*> particles;
+    std::vector<FlowNode> nodes;
+    std::vector<FlowAttachment> attached;
+    particles.reserve( evt.particles_size() );
+    for ( GenEvent::particle_const_iterator p = evt.particles_begin();
+	  p != evt.particles_end(); ++p ) {
+	int first = (int)nodes.size();
+	const Flow& flow = (*p)->flow();
+	for ( Flow::const_iterator f = flow.begin(); f != flow.end(); ++f ) {
+	    if ( f->first < code_index || f->second == 0 ) continue;
+	    if ( f->first >= code_index + num_indices ) break;
+	    int n = first;
+	    while ( n < (int)nodes.size() && nodes[n].code != f->second ) ++n;
+	    if ( n < (int)nodes.size() ) {
+		++nodes[n].multiplicity;
+		continue;
+	    }
+	    FlowNode node = { f->second, (int)particles.size(), 1 };
+	    nodes.push_back( node );
+	    const GenVertex* vertices[2] = { (*p)->production_vertex(), 
+	                                     (*p)->end_vertex() };
+	    for ( int k = 0; k < 2; ++k ) {
+		if ( !vertices[k] ) continue;
+		FlowAttachment a = { f->second, vertices[k], n };
+		attached.push_back( a );
+	    }
+	}
+	particles.push_back( *p );
+    }
+    //
+    // 2. join the nodes with the same code at each vertex, and count the
+    //    neighbours the way Flow::dangling_connected_partners does: once
+    //    per matching code index, and once per vertex they are met at
+    std::vector<int> parent( nodes.size() );
+    for ( std::size_t n = 0; n < nodes.size(); ++n ) parent[n] = (int)n;
+    std::vector<int> neighbours( nodes.size(), 0 );
+    std::sort( attached.begin(), attached.end(), by_code_and_vertex );
+    for ( std::size_t g = 0; g < attached.size(); ) {
+	std::size_t end = g;
+	int total = 0;
+	while ( end < attached.size() && attached[end].code == attached[g].code
+	        && attached[end].vertex == attached[g].vertex ) {
+	    total += nodes[ attached[end].node ].multiplicity;
+	    int a = find_root( parent, attached[g].node );
+	    int b = find_root( parent, attached[end].node );
+	    if ( a != b ) parent[b] = a;
+	    ++end;
+	}
+	// a node is attached twice if it starts and ends at this vertex
+	for ( std::size_t k = g; k < end; ) {
+	    std::size_t run = k;
+	    while ( run < end && attached[run].node == attached[k].node ) ++run;
+	    int node = attached[k].node;
+	    int own = (int)( run - k ) * nodes[node].multiplicity;
+	    neighbours[node] += (int)( run - k ) * ( total - own );
+	    k = run;
+	}
+	g = end;
+    }
+    //
+    // 3. collect the lines, ordered by code and first particle
+    std::vector<int> order( nodes.size() );
+    for ( std::size_t n = 0; n < nodes.size(); ++n ) order[n] = (int)n;
+    by_code_and_particle cmp = { &nodes };
+    std::sort( order.begin(), order.end(), cmp );
+    std::vector<int> line_of_root( nodes.size(), -1 );
+    m_lookup.reserve( nodes.size() );
+    for ( std::size_t k = 0; k < order.size(); ++k ) {
+	int n = order[k];
+	int root = find_root( parent, n );
+	if ( line_of_root[root] < 0 ) {
+	    line_of_root[root] = (int)m_lines.size();
+	    m_lines.push_back( FlowLine() );
+	    m_lines.back().code = nodes[n].code;
+	}
+	FlowLine& line = m_lines[ line_of_root[root] ];
+	GenParticle* p = particles[ nodes[n].particle ];
+	line.partners.push_back( p );
+	if ( neighbours[n] <= 1 ) line.dangling.push_back( p );
+	m_lookup.push_back( std::make_pair( particle_code( p, nodes[n].code ),
+	                                    line_of_root[root] ) );
+    }
+    std::sort( m_lookup.begin(), m_lookup.end() );
+}
+
+int FlowIndex::line_of( const GenParticle* p, int code ) const
+{
+    std::vector<std::pair<particle_code,int> >::const_iterator l =
+	std::lower_bound( m_lookup.begin(), m_lookup.end(),
+	                  std::make_pair( particle_code( p, code ), -1 ) );
+    if ( l == m_lookup.end() || l->first != particle_code( p, code ) ) return -1;
+    return l->second;
+}
+
+std::vector<GenParticle*> FlowIndex::connected_partners( const GenParticle* p,
+                                                         int code ) const
+{
+    int l = line_of( p, code );
+    if ( l < 0 ) return std::vector<GenParticle*>();
+    return m_lines[l].partners;
+}
+
+std::vector<GenParticle*> FlowIndex::dangling_connected_partners( 
+                                     const GenParticle* p, int code ) const
+{
+    int l = line_of( p, code );
+    if ( l < 0 ) return std::vector<GenParticle*>();
+    return m_lines[l].dangling;
+}
+
+} // HepMC
@@ -10,10 +10,13 @@
 // Event record for MC generators (for use at any stage of generation)
 //////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <iomanip>
+#include <unordered_set>
 
 #include "HepMC/GenEvent.h"
 #include "HepMC/GenCrossSection.h"
+#include "HepMC/GenealogyIndex.h"
 #include "HepMC/Version.h"
 #include "HepMC/StreamHelpers.h"
 
@@ -43,7 +46,9 @@ namespace HepMC {
 	m_heavy_ion(0), 
 	m_pdf_info(0),
 	m_momentum_unit(mom),
-	m_position_unit(len)
+	m_position_unit(len),
+	m_genealogy_index(0),
+	m_link( new GenEventLink( this ) )
     {
         /// This constructor only allows null pointers to HeavyIon and PdfInfo
 	///
@@ -77,7 +82,9 @@ namespace HepMC {
 	m_heavy_ion( new HeavyIon(ion) ), 
 	m_pdf_info( new PdfInfo(pdf) ),
 	m_momentum_unit(mom),
-	m_position_unit(len)
+	m_position_unit(len),
+	m_genealogy_index(0),
+	m_link( new GenEventLink( this ) )
     {
         /// GenEvent makes its own copy of HeavyIon and PdfInfo
 	///
@@ -109,7 +116,9 @@ namespace HepMC {
 	m_heavy_ion(0), 
 	m_pdf_info(0),
 	m_momentum_unit(mom),
-	m_position_unit(len)
+	m_position_unit(len),
+	m_genealogy_index(0),
+	m_link( new GenEventLink( this ) )
     {
         /// constructor requiring units - all else is default
         /// This constructor only allows null pointers to HeavyIon and PdfInfo
@@ -144,7 +153,9 @@ namespace HepMC {
 	m_heavy_ion( new HeavyIon(ion) ), 
 	m_pdf_info( new PdfInfo(pdf) ),
 	m_momentum_unit(mom),
-	m_position_unit(len)
+	m_position_unit(len),
+	m_genealogy_index(0),
+	m_link( new GenEventLink( this ) )
     {
         /// explicit constructor with units first that takes HeavyIon and PdfInfo
         /// GenEvent makes its own copy of HeavyIon and PdfInfo
@@ -171,7 +182,9 @@ namespace HepMC {
 	m_heavy_ion            ( inevent.heavy_ion() ? new HeavyIon(*inevent.heavy_ion()) : 0 ),
 	m_pdf_info             ( inevent.pdf_info() ? new PdfInfo(*inevent.pdf_info()) : 0 ),
 	m_momentum_unit        ( inevent.momentum_unit() ),
-	m_position_unit        ( inevent.length_unit() )
+	m_position_unit        ( inevent.length_unit() ),
+	m_genealogy_index      ( 0 ),
+	m_link                 ( new GenEventLink( this ) )
     {
 	/// deep copy - makes a copy of all vertices!
 	//
@@ -244,15 +257,12 @@ namespace HepMC {
 	std::swap(m_pdf_info             , other.m_pdf_info             );
 	std::swap(m_momentum_unit       , other.m_momentum_unit       );
 	std::swap(m_position_unit       , other.m_position_unit       );
-	// must now adjust GenVertex back pointers
-	for ( GenEvent::vertex_const_iterator vthis = vertices_begin();
-	      vthis != vertices_end(); ++vthis ) {
-	    (*vthis)->change_parent_event_( this );
-	}
-	for ( GenEvent::vertex_const_iterator voth = other.vertices_begin();
-	      voth != other.vertices_end(); ++voth ) {
-	    (*voth)->change_parent_event_( &other );
-	}
+	std::swap(m_genealogy_index     , other.m_genealogy_index     );
+	// the vertices point to the links, which go with them,
+	// so only the links need to point to their new events
+	std::swap(m_link                , other.m_link                );
+	m_link->event = this;
+	other.m_link->event = &other;
     }
 
     GenEvent::~GenEvent() 
@@ -264,6 +274,8 @@ namespace HepMC {
 	delete m_cross_section;
 	delete m_heavy_ion;
 	delete m_pdf_info;
+	delete m_genealogy_index;
+	delete m_link;
     }
 
     GenEvent& GenEvent::operator=( const GenEvent& inevent ) 
@@ -274,6 +286,18 @@ namespace HepMC {
 	return *this;
     }
 
+    GenEvent::GenEvent( GenEvent&& inevent )
+      : GenEvent()
+    {
+	swap( inevent );
+    }
+
+    GenEvent& GenEvent::operator=( GenEvent&& inevent )
+    {
+	swap( inevent );
+	return *this;
+    }
+
     void GenEvent::print( std::ostream& ostr ) const {
 	/// dumps the content of this event to ostr
 	///   to dump to cout use: event.print();
@@ -383,8 +407,9 @@ namespace HepMC {
 	m_event_scale = -1;
 	m_alphaQCD = -1;
 	m_alphaQED = -1;
-	m_weights = std::vector<double>();
-	m_random_states = std::vector<long>();
+	// keep the capacity of the containers, for events which are reused
+	m_weights.clear();
+	m_random_states.clear();
 	// resetting unit information
 	m_momentum_unit = Units::default_momentum_unit();
 	m_position_unit = Units::default_length_unit();
@@ -400,6 +425,149 @@ namespace HepMC {
 	return;
     }
     
+    namespace {
+
+	bool lower_barcode( const GenParticle* a, const GenParticle* b )
+	{ return a->barcode() < b->barcode(); }
+
+	// vertex barcodes are negative, and sorted from -1 downwards
+	bool higher_barcode( const GenVertex* a, const GenVertex* b )
+	{ return a->barcode() > b->barcode(); }
+
+    } // unnamed namespace
+
+    bool GenEvent::splice( GenVertex* root, GenEvent& from, BarcodePolicy policy )
+    {
+	/// moves the subgraph below root without add_vertex, so that the
+	/// barcodes are registered once, in order, rather than removed and
+	/// inserted again for every vertex and particle
+	if ( !root || root->parent_event() != &from || &from == this ) return false;
+	//
+	// 1. the vertices of the subgraph, breadth first from root
+	std::vector<GenVertex*> vertices( 1, root );
+	std::unordered_set<const GenVertex*> inside;
+	inside.insert( root );
+	for ( std::size_t i = 0; i < vertices.size(); ++i ) {
+	    const std::vector<GenParticle*>& out = vertices[i]->m_particles_out;
+	    for ( std::size_t j = 0; j < out.size(); ++j ) {
+		GenVertex* end = out[j]->m_end_vertex;
+		if ( end && inside.insert( end ).second ) vertices.push_back( end );
+	    }
+	}
+	//
+	// 2. the particles: the outgoing ones, and the incoming ones without
+	//    production vertex.  Those coming from outside are cut off and
+	//    stay in from, registered through their production vertex.
+	std::vector<GenParticle*> particles;
+	for ( std::size_t i = 0; i < vertices.size(); ++i ) {
+	    GenVertex* v = vertices[i];
+	    std::vector<GenParticle*>& in = v->m_particles_in;
+	    std::size_t kept = 0;
+	    for ( std::size_t j = 0; j < in.size(); ++j ) {
+		GenParticle* p = in[j];
+		if ( p->m_production_vertex && !inside.count( p->m_production_vertex ) ) {
+		    p->m_end_vertex = 0;
+		    continue;
+		}
+		if ( !p->m_production_vertex ) particles.push_back( p );
+		in[kept++] = p;
+	    }
+	    in.resize( kept );
+	    particles.insert( particles.end(), v->m_particles_out.begin(), v->m_particles_out.end() );
+	}
+	//
+	// 3. out of from
+	from.invalidate_genealogy_index();
+	invalidate_genealogy_index();
+	if ( vertices.size() == from.m_vertex_barcodes.size() ) {
+	    from.m_vertex_barcodes.clear();
+	} else {
+	    for ( std::size_t i = 0; i < vertices.size(); ++i ) {
+		from.m_vertex_barcodes.erase( vertices[i]->barcode() );
+	    }
+	}
+	if ( particles.size() == from.m_particle_barcodes.size() ) {
+	    from.m_particle_barcodes.clear();
+	} else {
+	    for ( std::size_t i = 0; i < particles.size(); ++i ) {
+		from.m_particle_barcodes.erase( particles[i]->barcode() );
+	    }
+	}
+	if ( inside.count( from.m_signal_process_vertex ) ) from.m_signal_process_vertex = 0;
+	//
+	// 4. into this event, in the order of the maps, so that the barcodes
+	//    past those in use are appended in constant time
+	std::sort( vertices.begin(), vertices.end(), higher_barcode );
+	std::sort( particles.begin(), particles.end(), lower_barcode );
+	int vertex_offset = 0;
+	int particle_offset = 0;
+	if ( policy == offset_barcodes ) {
+	    if ( !m_vertex_barcodes.empty() ) {
+		int last = m_vertex_barcodes.rbegin()->first;
+		if ( vertices.front()->barcode() >= last ) {
+		    vertex_offset = last - 1 - vertices.front()->barcode();
+		}
+	    }
+	    if ( !m_particle_barcodes.empty() && !particles.empty() ) {
+		int last = m_particle_barcodes.rbegin()->first;
+		if ( particles.front()->barcode() <= last ) {
+		    particle_offset = last + 1 - particles.front()->barcode();
+		}
+	    }
+	}
+	// those whose barcode is taken get the next free one afterwards,
+	// as set_barcode would choose it
+	std::vector<GenVertex*> taken_vertices;
+	for ( std::size_t i = 0; i < vertices.size(); ++i ) {
+	    GenVertex* v = vertices[i];
+	    v->m_event = m_link;
+	    v->m_barcode += vertex_offset;
+	    std::map<int,GenVertex*,std::greater<int> >::iterator it =
+		m_vertex_barcodes.insert( m_vertex_barcodes.end(), std::make_pair( v->m_barcode, v ) );
+	    if ( it->second != v ) taken_vertices.push_back( v );
+	}
+	for ( std::size_t i = 0; i < taken_vertices.size(); ++i ) {
+	    GenVertex* v = taken_vertices[i];
+	    v->m_barcode = m_vertex_barcodes.rbegin()->first - 1;
+	    m_vertex_barcodes.insert( m_vertex_barcodes.end(), std::make_pair( v->m_barcode, v ) );
+	}
+	std::vector<GenParticle*> taken_particles;
+	for ( std::size_t i = 0; i < particles.size(); ++i ) {
+	    GenParticle* p = particles[i];
+	    p->m_barcode += particle_offset;
+	    std::map<int,GenParticle*,std::less<int> >::iterator it =
+		m_particle_barcodes.insert( m_particle_barcodes.end(), std::make_pair( p->m_barcode, p ) );
+	    if ( it->second != p ) taken_particles.push_back( p );
+	}
+	for ( std::size_t i = 0; i < taken_particles.size(); ++i ) {
+	    GenParticle* p = taken_particles[i];
+	    p->m_barcode = std::max( m_particle_barcodes.rbegin()->first + 1, 10001 );
+	    m_particle_barcodes.insert( m_particle_barcodes.end(), std::make_pair( p->m_barcode, p ) );
+	}
+	if ( from.m_beam_particle_1 && from.m_beam_particle_1->parent_event() != &from ) {
+	    from.m_beam_particle_1 = 0;
+	}
+	if ( from.m_beam_particle_2 && from.m_beam_particle_2->parent_event() != &from ) {
+	    from.m_beam_particle_2 = 0;
+	}
+	return true;
+    }
+
+    GenEvent* GenEvent::extract_subgraph( GenVertex* root )
+    {
+	if ( !root || root->parent_event() != this ) return 0;
+	GenEvent* evt = new GenEvent( momentum_unit(), length_unit(),
+	                              signal_process_id(), event_number() );
+	// the signal process vertex and beam particles go with the subgraph
+	GenVertex* signal = m_signal_process_vertex;
+	std::pair<GenParticle*,GenParticle*> beams = beam_particles();
+	evt->splice( root, *this, keep_barcodes );
+	if ( signal && signal->parent_event() == evt ) evt->set_signal_process_vertex( signal );
+	evt->set_beam_particles( beams.first && beams.first->parent_event() == evt ? beams.first : 0,
+	                         beams.second && beams.second->parent_event() == evt ? beams.second : 0 );
+	return evt;
+    }
+
     void GenEvent::delete_all_vertices() {
 	/// deletes all vertices in the vertex container
 	/// (i.e. all vertices owned by this event)
@@ -407,6 +575,7 @@ namespace HepMC {
 	///   the vertices, the vertex desctructors are automatically
 	///   deleting their particles.
 
+	invalidate_genealogy_index();
   	// delete each vertex individually (this deletes particles as well)
 	while ( !vertices_empty() ) {
 	    GenVertex* vtx = ( m_vertex_barcodes.begin() )->second;
@@ -506,6 +675,7 @@ namespace HepMC {
 		      << std::endl;
 	    return false;
 	}
+	invalidate_genealogy_index();
 	// M.Dobbs Nov 4, 2002
 	// First we must check to see if the vertex already has a
 	// barcode which is different from the suggestion. If yes, we
@@ -564,21 +734,51 @@ namespace HepMC {
 	return insert_success;
     }
 
+    void GenEvent::build_genealogy_index() const
+    {
+	if ( !m_genealogy_index ) m_genealogy_index = new GenealogyIndex( *this );
+    }
+
+    const GenealogyIndex& GenEvent::genealogy_index() const
+    {
+	build_genealogy_index();
+	return *m_genealogy_index;
+    }
+
+    void GenEvent::invalidate_genealogy_index() const
+    {
+	delete m_genealogy_index;
+	m_genealogy_index = 0;
+    }
+
+    bool GenEvent::is_ancestor( const GenParticle* a, 
+                                const GenParticle* b ) const
+    {
+	return genealogy_index().is_ancestor( a, b );
+    }
+
+    GenVertex* GenEvent::common_ancestor( const GenParticle* a, 
+                                          const GenParticle* b ) const
+    {
+	return genealogy_index().common_ancestor( a, b );
+    }
+
     /// test to see if we have two valid beam particles
     bool  GenEvent::valid_beam_particles() const {
-        bool have1 = false;
-        bool have2 = false;
 	// first check that both are defined
-        if(m_beam_particle_1 && m_beam_particle_2) {
-	    // now look for a match with the particle "list"
-            for ( particle_const_iterator p = particles_begin();
-        	  p != particles_end(); ++p ) {
-		if( m_beam_particle_1 == *p ) have1 = true;
-		if( m_beam_particle_2 == *p ) have2 = true;
-	    }
+        if( !m_beam_particle_1 || !m_beam_particle_2 ) return false;
+	// remove_barcode forgets a beam particle which leaves the event,
+	// but one set before it was added may since have been deleted,
+	// so only the addresses are compared
+	bool have1 = false;
+	bool have2 = false;
+	for ( std::map<int,GenParticle*>::const_iterator p
+		  = m_particle_barcodes.begin();
+	      p != m_particle_barcodes.end() && !( have1 && have2 ); ++p ) {
+	    if( m_beam_particle_1 == p->second ) have1 = true;
+	    if( m_beam_particle_2 == p->second ) have2 = true;
 	}
-	if( have1 && have2 ) return true;
-	return false;
+	return have1 && have2;
     }
     
     /// construct the beam particle information using pointers to GenParticle
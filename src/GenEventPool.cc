@@ -0,0 +1,91 @@
+//////////////////////////////////////////////////////////////////////////
+// GenEventPool.cc
+//
+// reuse GenEvent objects instead of deleting them
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "HepMC/GenEventPool.h"
+#include "HepMC/GenEvent.h"
+
+namespace HepMC {
+
+namespace {
+
+    // numbers the threads, to choose their caches
+    std::atomic<unsigned> next_thread_number( 0 );
+
+    unsigned thread_number()
+    {
+	static thread_local unsigned number = next_thread_number.fetch_add( 1 );
+	return number;
+    }
+
+} // unnamed namespace
+
+struct GenEventPool::Local {
+    std::mutex             lock;    // only contended if threads share it
+    std::vector<GenEvent*> events;
+};
+
+const std::size_t GenEventPool::local_size;
+
+GenEventPool::GenEventPool( std::size_t capacity )
+  : m_nlocal( 2 * std::max( 1u, std::thread::hardware_concurrency() ) ),
+    m_local(), m_shared( capacity ), m_created(0)
+{
+    m_local.reset( new Local[m_nlocal] );
+}
+
+GenEventPool::~GenEventPool()
+{
+    for ( std::size_t i = 0; i < m_nlocal; ++i ) {
+	std::vector<GenEvent*>& events = m_local[i].events;
+	for ( std::size_t j = 0; j < events.size(); ++j ) delete events[j];
+    }
+    GenEvent* evt;
+    while ( m_shared.try_pop( evt ) ) delete evt;
+}
+
+GenEventPool::Local& GenEventPool::local()
+{
+    return m_local[ thread_number() % m_nlocal ];
+}
+
+GenEvent* GenEventPool::acquire()
+{
+    GenEvent* evt = 0;
+    {
+	Local& l = local();
+	std::lock_guard<std::mutex> guard( l.lock );
+	if ( !l.events.empty() ) {
+	    evt = l.events.back();
+	    l.events.pop_back();
+	    return evt;
+	}
+    }
+    if ( m_shared.try_pop( evt ) ) return evt;
+    m_created.fetch_add( 1, std::memory_order_relaxed );
+    return new GenEvent();
+}
+
+void GenEventPool::release( GenEvent* evt )
+{
+    if ( !evt ) return;
+    evt->clear();
+    {
+	Local& l = local();
+	std::lock_guard<std::mutex> guard( l.lock );
+	if ( l.events.size() < local_size ) {
+	    l.events.push_back( evt );
+	    return;
+	}
+    }
+    if ( !m_shared.try_push( evt ) ) delete evt;
+}
+
+} // HepMC
@@ -23,18 +23,33 @@ namespace HepMC {
 
 // ------------------------- local methods ----------------
 
-/// This method is called by the stream destructor.
+/// The index of the StreamInfo pointer in the user data of every stream.
+/// It comes from std::ios_base::xalloc(), so that it cannot collide with
+/// the user data of other libraries; the initialization of a local
+/// static is thread safe.
+int stream_info_index()
+{
+  static const int index = std::ios_base::xalloc();
+  return index;
+}
+
+/// This method is called by the stream destructor and by copyfmt().
 /// It does cleanup on stored user data (StreamInfo)
 /// and is registered by the first call to get_stream_info().
 void HepMCStreamCallback(std::ios_base::event e, std::ios_base& b, int i)
 {
+  // copyfmt() has copied the pointer of the source stream:
+  // the copy gets its own StreamInfo when it is first used
+  if(e == std::ios_base::copyfmt_event) {
+      b.pword(i) = 0;
+      return;
+  }
   // only clean up if the stream object is going away.
-  if(i!=0 && e!= std::ios_base::erase_event) return;
+  if(e != std::ios_base::erase_event) return;
 
   // retrieve the pointer to the object
   StreamInfo* hd = (StreamInfo*)b.pword(i);
   b.pword(i) = 0;
-  b.iword(i) = 0;
 #ifdef HEPMC_DEBUG
   // the following line is just for sanity checking
   if(hd) std::cerr << "deleted StreamInfo " << hd->stream_id() << "\n";
@@ -47,24 +62,30 @@ void HepMCStreamCallback(std::ios_base::event e, std::ios_base& b, int i)
 /// A custom iomanip that allows us to store and access user data (StreamInfo)
 /// associated with the stream.
 /// This method creates the StreamInfo object the first time it is called.
+/// Different streams may be used by different threads at the same time;
+/// a single stream must be used by one thread at a time.
 template <class IO>
 StreamInfo& get_stream_info(IO& iost)
 {
-  if(iost.iword(0) == 0)
+  const int index = stream_info_index();
+  if(iost.pword(index) == 0)
     {
-      // make sure we add the callback if this is the first time through
-      iost.iword(0)=1;
-      iost.register_callback(&HepMCStreamCallback, 0);
+      // make sure we add the callback if this is the first time through;
+      // iword remembers it, and copyfmt() copies both
+      if(iost.iword(index) == 0) {
+          iost.iword(index)=1;
+          iost.register_callback(&HepMCStreamCallback, index);
+      }
       // this is our special "context" record.
       // there is one of these at the head of each IO block.
       // allocate room for a StreamInfo in the userdata area
-      iost.pword(0) = new StreamInfo;
+      iost.pword(index) = new StreamInfo;
 #ifdef HEPMC_DEBUG
       // the following line is just for sanity checking
-      std::cerr << "created StreamInfo " << ((StreamInfo*)iost.pword(0))->stream_id() << "\n";
+      std::cerr << "created StreamInfo " << ((StreamInfo*)iost.pword(index))->stream_id() << "\n";
 #endif
     }
-  return *(StreamInfo*)iost.pword(0);
+  return *(StreamInfo*)iost.pword(index);
 }
 	
 // ------------------------- GenEvent member functions ----------------
@@ -290,6 +311,10 @@ std::istream& GenEvent::read( std::istream& is )
 	        break;
 	} // switch on line type
     } // while reading_event_header
+    // files written before 2.06.00 have no weight names
+    if( !m_weights.empty() && m_weights.map_begin() == m_weights.map_end() ) {
+        m_weights.set_default_names( m_weights.size() );
+    }
     // before proceeding - did we find a units line?
     if( !units_line ) {
  	use_units( info.io_momentum_unit(), 
@@ -377,6 +402,15 @@ std::istream & set_input_units(std::istream & is,
     return is;
 }
 
+// ------------------------- weight names ----------------
+
+const WeightContainer & stream_weight_names(std::istream & is)
+{
+    //
+    StreamInfo & info = get_stream_info(is);
+    return info.weight_names();
+}
+
 // ------------------------- begin and end block lines ----------------
 
 std::ostream & write_HepMC_IO_block_begin(std::ostream & os )
@@ -467,8 +501,10 @@ std::istream & GenEvent::process_event_line( std::istream & is,
       if(!iline) detail::find_event_end( is );
       iline >> wgt[ii];
     }
-    // weight names will be added later if they exist
-    if( weights_size > 0 ) m_weights = wgt;
+    // weight names will be added later if they exist,
+    // so do not build default names which would be thrown away
+    m_weights.m_weights.swap( wgt );
+    m_weights.release_names();
     // 
     // fill signal_process_id, event_number, random_states, etc.
     set_signal_process_id( signal_process_id );
@@ -516,6 +552,13 @@ std::istream & GenEvent::read_weight_names( std::istream & is )
 	is.clear(std::ios::badbit);
 	return is;
     }
+    // events from the same stream usually carry the same weight names,
+    // in which case we simply share the name table of the previous event
+    StreamInfo & info = get_stream_info(is);
+    if( line == info.weight_names_line() ) {
+        m_weights.share_names( info.weight_names() );
+	return is;
+    }
     std::string name;
     std::string::size_type i1 = line.find("\"");
     std::string::size_type i2;
@@ -535,6 +578,10 @@ std::istream & GenEvent::read_weight_names( std::istream & is )
 	i1 = line.find("\"",i2+1);
     }
     m_weights = namedWeight;
+    // remember the names unless some of them were duplicates
+    if( m_weights.size() == name_size ) {
+        info.set_weight_names( line, m_weights );
+    }
     return is;
 }
 
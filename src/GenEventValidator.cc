@@ -0,0 +1,231 @@
+//////////////////////////////////////////////////////////////////////////
+// GenEventValidator.cc
+//
+// consistency checks of a GenEvent
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <sstream>
+
+#include "HepMC/GenEventValidator.h"
+#include "HepMC/GenEvent.h"
+#include "HepMC/GenealogyIndex.h"
+#include "HepMC/ParallelAlgorithms.h"
+
+namespace HepMC {
+
+namespace {
+
+    typedef std::vector<ValidationIssue> issue_list;
+
+    void add_issue( issue_list& issues, unsigned check, int barcode,
+                    const std::string& message, double value = 0 )
+    {
+	ValidationIssue issue;
+	issue.check = check;
+	issue.barcode = barcode;
+	issue.value = value;
+	issue.message = message;
+	issues.push_back( issue );
+    }
+
+    issue_list append( issue_list a, const issue_list& b )
+    {
+	a.insert( a.end(), b.begin(), b.end() );
+	return a;
+    }
+
+    /// the barcode checks of a particle, run for each particle attached
+    /// to a vertex of the event, and the link check, run for each particle
+    /// registered in the event
+    void check_particle( const GenEvent& evt, const GenParticle* p,
+                         unsigned checks, issue_list& issues )
+    {
+	std::ostringstream os;
+	if ( checks & GenEventValidator::barcodes ) {
+	    if ( p->barcode() <= 0 ) {
+		os << "particle barcode " << p->barcode() << " is not positive";
+		add_issue( issues, GenEventValidator::barcodes, p->barcode(), os.str() );
+		os.str( "" );
+	    }
+	    if ( evt.barcode_to_particle( p->barcode() ) != p ) {
+		os << "particle " << p->barcode() << " is not in the event under its barcode";
+		add_issue( issues, GenEventValidator::barcodes, p->barcode(), os.str() );
+		os.str( "" );
+	    }
+	}
+	if ( checks & GenEventValidator::links ) {
+	    const GenVertex* prod = p->production_vertex();
+	    const GenVertex* end = p->end_vertex();
+	    if ( ( !prod || prod->parent_event() != &evt ) &&
+	         ( !end || end->parent_event() != &evt ) ) {
+		os << "particle " << p->barcode() << " is not attached to a vertex of the event";
+		add_issue( issues, GenEventValidator::links, p->barcode(), os.str() );
+		os.str( "" );
+	    }
+	    if ( prod && std::find( prod->particles_out_const_begin(),
+	                            prod->particles_out_const_end(), p )
+		         == prod->particles_out_const_end() ) {
+		os << "particle " << p->barcode() << " is not listed by its production vertex "
+		   << prod->barcode();
+		add_issue( issues, GenEventValidator::links, p->barcode(), os.str() );
+		os.str( "" );
+	    }
+	    if ( end && std::find( end->particles_in_const_begin(),
+	                           end->particles_in_const_end(), p )
+		        == end->particles_in_const_end() ) {
+		os << "particle " << p->barcode() << " is not listed by its end vertex "
+		   << end->barcode();
+		add_issue( issues, GenEventValidator::links, p->barcode(), os.str() );
+	    }
+	}
+    }
+
+    /// the checks of one vertex and of the particles it produces
+    void check_vertex( const GenEvent& evt, const GenVertex* v,
+                       unsigned checks, double tolerance, issue_list& issues )
+    {
+	std::ostringstream os;
+	if ( ( checks & GenEventValidator::parent_event ) && v->parent_event() != &evt ) {
+	    os << "vertex " << v->barcode() << " does not point back to the event";
+	    add_issue( issues, GenEventValidator::parent_event, v->barcode(), os.str() );
+	    os.str( "" );
+	}
+	if ( checks & GenEventValidator::barcodes ) {
+	    if ( v->barcode() >= 0 ) {
+		os << "vertex barcode " << v->barcode() << " is not negative";
+		add_issue( issues, GenEventValidator::barcodes, v->barcode(), os.str() );
+		os.str( "" );
+	    }
+	    if ( evt.barcode_to_vertex( v->barcode() ) != v ) {
+		os << "vertex " << v->barcode() << " is not in the event under its barcode";
+		add_issue( issues, GenEventValidator::barcodes, v->barcode(), os.str() );
+		os.str( "" );
+	    }
+	}
+	if ( checks & GenEventValidator::links ) {
+	    for ( GenVertex::particles_in_const_iterator p = v->particles_in_const_begin();
+		  p != v->particles_in_const_end(); ++p ) {
+		if ( (*p)->end_vertex() != v ) {
+		    os << "incoming particle " << (*p)->barcode() << " of vertex " 
+		       << v->barcode() << " does not end there";
+		    add_issue( issues, GenEventValidator::links, (*p)->barcode(), os.str() );
+		    os.str( "" );
+		}
+		const GenVertex* prod = (*p)->production_vertex();
+		if ( prod && prod->parent_event() != &evt ) {
+		    os << "incoming particle " << (*p)->barcode() << " of vertex " 
+		       << v->barcode() << " comes from a vertex outside the event";
+		    add_issue( issues, GenEventValidator::links, (*p)->barcode(), os.str() );
+		    os.str( "" );
+		}
+	    }
+	    for ( GenVertex::particles_out_const_iterator p = v->particles_out_const_begin();
+		  p != v->particles_out_const_end(); ++p ) {
+		if ( (*p)->production_vertex() != v ) {
+		    os << "outgoing particle " << (*p)->barcode() << " of vertex " 
+		       << v->barcode() << " is not produced there";
+		    add_issue( issues, GenEventValidator::links, (*p)->barcode(), os.str() );
+		    os.str( "" );
+		}
+		const GenVertex* end = (*p)->end_vertex();
+		if ( end && end->parent_event() != &evt ) {
+		    os << "outgoing particle " << (*p)->barcode() << " of vertex " 
+		       << v->barcode() << " ends at a vertex outside the event";
+		    add_issue( issues, GenEventValidator::links, (*p)->barcode(), os.str() );
+		    os.str( "" );
+		}
+	    }
+	}
+	if ( checks & GenEventValidator::barcodes ) {
+	    // each particle once: where it is produced, or where it ends
+	    // if it is not produced in the event
+	    for ( GenVertex::particles_in_const_iterator p = v->particles_in_const_begin();
+		  p != v->particles_in_const_end(); ++p ) {
+		const GenVertex* prod = (*p)->production_vertex();
+		if ( !prod || prod->parent_event() != &evt ) {
+		    check_particle( evt, *p, GenEventValidator::barcodes, issues );
+		}
+	    }
+	    for ( GenVertex::particles_out_const_iterator p = v->particles_out_const_begin();
+		  p != v->particles_out_const_end(); ++p ) {
+		check_particle( evt, *p, GenEventValidator::barcodes, issues );
+	    }
+	}
+	if ( ( checks & GenEventValidator::momentum_conservation ) &&
+	     v->particles_in_size() > 0 && v->particles_out_size() > 0 ) {
+	    double imbalance = v->check_momentum_conservation();
+	    if ( !( imbalance <= tolerance ) ) {
+		os << "vertex " << v->barcode() << " does not conserve momentum, |p_in - p_out| = "
+		   << imbalance;
+		add_issue( issues, GenEventValidator::momentum_conservation, v->barcode(),
+		           os.str(), imbalance );
+	    }
+	}
+    }
+
+} // unnamed namespace
+
+GenEventValidator::GenEventValidator( unsigned checks, double momentum_tolerance,
+                                      ThreadPool& pool )
+  : m_checks( checks ), m_tolerance( momentum_tolerance ), m_pool( &pool )
+{}
+
+std::vector<ValidationIssue> GenEventValidator::validate( const GenEvent& evt ) const
+{
+    GraphSnapshot g( evt );
+    const unsigned checks = m_checks;
+    const double tolerance = m_tolerance;
+    issue_list issues;
+    if ( checks & ( momentum_conservation | barcodes | links | parent_event ) ) {
+	issues = parallel_reduce( g.vertices().size(), issue_list(),
+	    [&]( issue_list& found, std::size_t i ) {
+		check_vertex( evt, g.vertex( (int)i ), checks, tolerance, found );
+	    }, append, *m_pool, 256 );
+    }
+    if ( checks & links ) {
+	issue_list found = parallel_reduce( g.particles().size(), issue_list(),
+	    [&]( issue_list& found, std::size_t i ) {
+		check_particle( evt, g.particle( (int)i ), links, found );
+	    }, append, *m_pool );
+	issues.insert( issues.end(), found.begin(), found.end() );
+    }
+    if ( ( checks & cycles ) && g.vertices_size() > 0 ) {
+	// the bitsets are not needed to find the loops
+	GenealogyIndex genealogy( evt, 0 );
+	for ( int i = 0; i < g.vertices_size(); ++i ) {
+	    if ( !genealogy.is_in_loop( g.vertex(i) ) ) continue;
+	    std::ostringstream os;
+	    os << "vertex " << g.vertex(i)->barcode() << " is its own ancestor";
+	    add_issue( issues, cycles, g.vertex(i)->barcode(), os.str() );
+	}
+    }
+    if ( ( checks & beam_particles ) && !evt.valid_beam_particles() ) {
+	add_issue( issues, beam_particles, 0, 
+	           "the beam particles are not set or not in the event" );
+    }
+    return issues;
+}
+
+const char* GenEventValidator::check_name( unsigned check )
+{
+    switch ( check ) {
+    case momentum_conservation: return "momentum_conservation";
+    case barcodes:              return "barcodes";
+    case links:                 return "links";
+    case beam_particles:        return "beam_particles";
+    case parent_event:          return "parent_event";
+    case cycles:                return "cycles";
+    default:                    return "unknown";
+    }
+}
+
+void GenEventValidator::print( const std::vector<ValidationIssue>& issues,
+                               std::ostream& ostr )
+{
+    for ( std::size_t i = 0; i < issues.size(); ++i ) {
+	ostr << check_name( issues[i].check ) << ": " << issues[i].message << "\n";
+    }
+}
+
+} // HepMC
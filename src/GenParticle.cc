@@ -7,6 +7,7 @@
 #include "HepMC/GenEvent.h"
 #include "HepMC/GenVertex.h"
 #include "HepMC/GenParticle.h"
+#include "HepMC/RecyclingStore.h"
 #include <iomanip>       // needed for formatted output
 
 namespace HepMC {
@@ -60,6 +61,26 @@ namespace HepMC {
 	//s_counter--;
     }
 
+    void* GenParticle::operator new( std::size_t size )
+    { return RecyclingStore<GenParticle>::allocate( size ); }
+
+    void GenParticle::operator delete( void* p, std::size_t size )
+    { RecyclingStore<GenParticle>::deallocate( p, size ); }
+
+    void* GenParticle::operator new( std::size_t size, const std::nothrow_t& ) throw()
+    {
+	try {
+	    return RecyclingStore<GenParticle>::allocate( size );
+	} catch ( std::bad_alloc& ) {
+	    return 0;
+	}
+    }
+
+    // the size is not known here; every block of the store comes from
+    // the global operator new, so it can go back there
+    void GenParticle::operator delete( void* p, const std::nothrow_t& ) throw()
+    { ::operator delete( p ); }
+
     void GenParticle::swap( GenParticle & other)
     {
         // if a container has a swap method, use that for improved performance
@@ -7,6 +7,7 @@
 #include "HepMC/GenVertex.h"
 #include "HepMC/GenEvent.h"
 #include "HepMC/SearchVector.h"
+#include "HepMC/RecyclingStore.h"
 #include <iomanip>       // needed for formatted output
 
 namespace HepMC {
@@ -27,7 +28,7 @@ namespace HepMC {
       m_id( invertex.id() ),
       m_weights( invertex.weights() ),
       m_event(0),
-      m_barcode(0) 
+      m_barcode(0)
     {
 	/// Shallow copy: does not copy the FULL list of particle pointers.
 	/// Creates a copy of  - invertex
@@ -68,6 +69,26 @@ namespace HepMC {
 	//s_counter--;
     }
 
+    void* GenVertex::operator new( std::size_t size )
+    { return RecyclingStore<GenVertex>::allocate( size ); }
+
+    void GenVertex::operator delete( void* p, std::size_t size )
+    { RecyclingStore<GenVertex>::deallocate( p, size ); }
+
+    void* GenVertex::operator new( std::size_t size, const std::nothrow_t& ) throw()
+    {
+	try {
+	    return RecyclingStore<GenVertex>::allocate( size );
+	} catch ( std::bad_alloc& ) {
+	    return 0;
+	}
+    }
+
+    // the size is not known here; every block of the store comes from
+    // the global operator new, so it can go back there
+    void GenVertex::operator delete( void* p, const std::nothrow_t& ) throw()
+    { ::operator delete( p ); }
+
     void GenVertex::swap( GenVertex & other)
     {
         m_position.swap( other.m_position );
@@ -272,6 +293,7 @@ namespace HepMC {
 
     void GenVertex::add_particle_in( GenParticle* inparticle ) {
 	if ( !inparticle ) return;
+	if ( m_event ) m_event->event->invalidate_genealogy_index();
 	// if inparticle previously had a decay vertex, remove it from that
 	// vertex's list
 	if ( inparticle->end_vertex() ) {
@@ -283,6 +305,7 @@ namespace HepMC {
 
     void GenVertex::add_particle_out( GenParticle* outparticle ) {
 	if ( !outparticle ) return;
+	if ( m_event ) m_event->event->invalidate_genealogy_index();
 	// if outparticle previously had a production vertex,
 	// remove it from that vertex's list
 	if ( outparticle->production_vertex() ) {
@@ -317,12 +340,14 @@ namespace HepMC {
     void GenVertex::remove_particle_in( GenParticle* particle ) {
 	/// this finds *particle in m_particles_in and removes it from that list
 	if ( !particle ) return;
+	if ( m_event ) m_event->event->invalidate_genealogy_index();
 	m_particles_in.erase( already_in_vector( &m_particles_in, particle ) );
     }
 
     void GenVertex::remove_particle_out( GenParticle* particle ) {
 	/// this finds *particle in m_particles_out and removes it from that list
 	if ( !particle ) return;
+	if ( m_event ) m_event->event->invalidate_genealogy_index();
 	m_particles_out.erase( already_in_vector( &m_particles_out, particle ) );
     }
 
@@ -387,8 +412,8 @@ namespace HepMC {
 
     void GenVertex::set_parent_event_( GenEvent* new_evt ) 
     { 
-	GenEvent* orig_evt = m_event;
-	m_event = new_evt; 
+	GenEvent* orig_evt = parent_event();
+	m_event = new_evt ? new_evt->m_link : 0;
 	//
 	// every time a vertex's parent event changes, the map of barcodes
 	//   in the new and old parent event needs to be modified to 
@@ -416,16 +441,6 @@ namespace HepMC {
 	}
     }
 
-    void GenVertex::change_parent_event_( GenEvent* new_evt ) 
-    { 
-	//
-	// this method is for use with swap
-	// particles and vertices have already been exchanged, 
-	// but the backpointer needs to be fixed
-	//GenEvent* orig_evt = m_event;
-	m_event = new_evt; 
-    }
-
     /////////////
     // Static  //
     /////////////
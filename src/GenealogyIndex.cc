@@ -0,0 +1,358 @@
+//////////////////////////////////////////////////////////////////////////
+// GenealogyIndex.cc
+//
+// precomputed ancestor/descendant relations of an event
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include "HepMC/GenealogyIndex.h"
+#include "HepMC/GenEvent.h"
+
+namespace HepMC {
+
+namespace {
+
+    typedef std::pair<const GenVertex*,int> vertex_node;
+
+    struct by_vertex {
+	bool operator()( const vertex_node& a, const vertex_node& b ) const
+	{ return a.first < b.first; }
+    };
+
+    const int bits_per_word = 32;
+
+    typedef std::pair<int,int> interval;
+
+    struct starts_after {
+	bool operator()( int p, const interval& i ) const
+	{ return p < i.first; }
+    };
+
+} // unnamed namespace
+
+GenealogyIndex::GenealogyIndex( const GenEvent& evt, 
+                                std::size_t max_bitset_nodes )
+  : m_lookup(), m_order(), m_first(), m_cyclic(),
+    m_parent_begin(), m_parents(), m_nodes(0), m_has_bitsets(false),
+    m_words(0), m_ancestors(), m_preorder(), m_interval_begin(), m_intervals()
+{
+    //
+    // 1. number the vertices, and find the children of each vertex
+    std::vector<GenVertex*> vertices;
+    vertices.reserve( evt.vertices_size() );
+    for ( GenEvent::vertex_const_iterator v = evt.vertices_begin();
+	  v != evt.vertices_end(); ++v ) {
+	m_lookup.push_back( vertex_node( *v, (int)vertices.size() ) );
+	vertices.push_back( *v );
+    }
+    std::sort( m_lookup.begin(), m_lookup.end(), by_vertex() );
+    int n = (int)vertices.size();
+    std::vector<int> child_begin( n+1, 0 );
+    std::vector<int> children;
+    std::vector<char> self_loop( n, 0 );
+    for ( int i = 0; i < n; ++i ) {
+	child_begin[i] = (int)children.size();
+	for ( GenVertex::particles_out_const_iterator 
+		  p = vertices[i]->particles_out_const_begin();
+	      p != vertices[i]->particles_out_const_end(); ++p ) {
+	    int c = node( (*p)->end_vertex() );   // still the vertex number
+	    if ( c < 0 ) continue;
+	    if ( c == i ) self_loop[i] = 1;
+	    else children.push_back( c );
+	}
+    }
+    child_begin[n] = (int)children.size();
+    //
+    // 2. find the loops (strongly connected vertices) with Tarjan's 
+    //    algorithm, using an explicit stack instead of recursion
+    std::vector<int> index( n, -1 ), low( n, 0 ), comp( n, -1 );
+    std::vector<int> open;                        // Tarjan's vertex stack
+    std::vector<std::pair<int,int> > calls;       // (vertex, next child)
+    int counter = 0, ncomp = 0;
+    for ( int s = 0; s < n; ++s ) {
+	if ( index[s] >= 0 ) continue;
+	index[s] = low[s] = counter++;
+	open.push_back( s );
+	calls.push_back( std::make_pair( s, child_begin[s] ) );
+	while ( !calls.empty() ) {
+	    int v = calls.back().first;
+	    if ( calls.back().second < child_begin[v+1] ) {
+		int w = children[ calls.back().second++ ];
+		if ( index[w] < 0 ) {
+		    index[w] = low[w] = counter++;
+		    open.push_back( w );
+		    calls.push_back( std::make_pair( w, child_begin[w] ) );
+		} else if ( comp[w] < 0 ) {
+		    // w is still on the stack
+		    low[v] = std::min( low[v], index[w] );
+		}
+		continue;
+	    }
+	    calls.pop_back();
+	    if ( low[v] == index[v] ) {
+		int w;
+		do {
+		    w = open.back();
+		    open.pop_back();
+		    comp[w] = ncomp;
+		} while ( w != v );
+		++ncomp;
+	    }
+	    if ( !calls.empty() ) {
+		int u = calls.back().first;
+		low[u] = std::min( low[u], low[v] );
+	    }
+	}
+    }
+    //
+    // 3. Tarjan finds descendants first, so reverse to get the node 
+    //    numbers in topological order
+    m_nodes = ncomp;
+    std::vector<int> size( ncomp, 0 );
+    m_cyclic.assign( ncomp, 0 );
+    for ( int i = 0; i < n; ++i ) {
+	comp[i] = ncomp - 1 - comp[i];
+	++size[comp[i]];
+	if ( self_loop[i] ) m_cyclic[comp[i]] = 1;
+    }
+    m_first.assign( ncomp+1, 0 );
+    for ( int c = 0; c < ncomp; ++c ) {
+	m_first[c+1] = m_first[c] + size[c];
+	if ( size[c] > 1 ) m_cyclic[c] = 1;
+    }
+    m_order.resize( n );
+    std::vector<int> fill( m_first.begin(), m_first.end()-1 );
+    for ( int i = 0; i < n; ++i ) m_order[ fill[comp[i]]++ ] = vertices[i];
+    for ( std::vector<vertex_node>::iterator l = m_lookup.begin();
+	  l != m_lookup.end(); ++l ) {
+	l->second = comp[l->second];
+    }
+    //
+    // 4. parent nodes of each node
+    std::vector<std::vector<int> > parents( ncomp );
+    for ( int i = 0; i < n; ++i ) {
+	for ( int k = child_begin[i]; k < child_begin[i+1]; ++k ) {
+	    int c = comp[children[k]];
+	    if ( c != comp[i] ) parents[c].push_back( comp[i] );
+	}
+    }
+    m_parent_begin.assign( ncomp+1, 0 );
+    for ( int c = 0; c < ncomp; ++c ) {
+	std::sort( parents[c].begin(), parents[c].end() );
+	parents[c].erase( std::unique( parents[c].begin(), parents[c].end() ),
+	                  parents[c].end() );
+	m_parent_begin[c] = (int)m_parents.size();
+	m_parents.insert( m_parents.end(), parents[c].begin(), parents[c].end() );
+    }
+    m_parent_begin[ncomp] = (int)m_parents.size();
+    //
+    // 5. ancestor bitsets, filled in topological order
+    if ( (std::size_t)ncomp > max_bitset_nodes ) {
+	build_intervals();
+	return;
+    }
+    m_has_bitsets = true;
+    m_words = ( ncomp + bits_per_word - 1 ) / bits_per_word;
+    m_ancestors.assign( m_words * ncomp, 0u );
+    for ( int c = 0; c < ncomp; ++c ) {
+	unsigned int* mine = &m_ancestors[ c * m_words ];
+	mine[ c / bits_per_word ] |= 1u << ( c % bits_per_word );
+	for ( int k = m_parent_begin[c]; k < m_parent_begin[c+1]; ++k ) {
+	    const unsigned int* theirs = &m_ancestors[ m_parents[k] * m_words ];
+	    // parents come earlier, so only their first words can be set
+	    std::size_t nw = m_parents[k] / bits_per_word + 1;
+	    for ( std::size_t w = 0; w < nw; ++w ) mine[w] |= theirs[w];
+	}
+    }
+}
+
+void GenealogyIndex::build_intervals()
+{
+    //
+    // 1. a spanning forest, taking the latest parent of each node as its
+    //    parent in the tree; parents come before their children, so the
+    //    subtree sizes are summed backwards and the preorder numbers
+    //    handed out forwards
+    std::vector<int> tree_parent( m_nodes, -1 ), subtree( m_nodes, 1 );
+    for ( int c = m_nodes - 1; c >= 0; --c ) {
+	if ( m_parent_begin[c] == m_parent_begin[c+1] ) continue;
+	tree_parent[c] = m_parents[ m_parent_begin[c+1] - 1 ];
+	subtree[ tree_parent[c] ] += subtree[c];
+    }
+    m_preorder.assign( m_nodes, 0 );
+    std::vector<int> next_free( m_nodes, 0 );
+    int roots = 0;
+    for ( int c = 0; c < m_nodes; ++c ) {
+	int p = tree_parent[c];
+	if ( p < 0 ) {
+	    m_preorder[c] = roots;
+	    roots += subtree[c];
+	} else {
+	    m_preorder[c] = next_free[p];
+	    next_free[p] += subtree[c];
+	}
+	next_free[c] = m_preorder[c] + 1;
+    }
+    //
+    // 2. children of each node
+    std::vector<int> child_begin( m_nodes+1, 0 ), children( m_parents.size() );
+    for ( std::size_t k = 0; k < m_parents.size(); ++k ) ++child_begin[ m_parents[k] + 1 ];
+    for ( int c = 0; c < m_nodes; ++c ) child_begin[c+1] += child_begin[c];
+    std::vector<int> fill( child_begin.begin(), child_begin.end() - 1 );
+    for ( int c = 0; c < m_nodes; ++c ) {
+	for ( int k = m_parent_begin[c]; k < m_parent_begin[c+1]; ++k ) {
+	    children[ fill[ m_parents[k] ]++ ] = c;
+	}
+    }
+    //
+    // 3. the descendants of a node are its subtree and the descendants
+    //    of its children; children come later, so fill the labels from
+    //    the last node backwards, merging overlapping and adjacent
+    //    intervals
+    m_interval_begin.assign( m_nodes+1, 0 );
+    std::vector<interval> all;
+    for ( int c = m_nodes - 1; c >= 0; --c ) {
+	// the labels of c start here, and end those of c+1
+	m_interval_begin[ m_nodes - 1 - c ] = (int)m_intervals.size();
+	all.clear();
+	all.push_back( interval( m_preorder[c], m_preorder[c] + subtree[c] - 1 ) );
+	for ( int k = child_begin[c]; k < child_begin[c+1]; ++k ) {
+	    int b = m_nodes - 1 - children[k];
+	    all.insert( all.end(), m_intervals.begin() + m_interval_begin[b],
+	                m_intervals.begin() + m_interval_begin[b+1] );
+	}
+	std::sort( all.begin(), all.end() );
+	interval merged = all[0];
+	for ( std::size_t i = 1; i < all.size(); ++i ) {
+	    if ( all[i].first <= merged.second + 1 ) {
+		merged.second = std::max( merged.second, all[i].second );
+	    } else {
+		m_intervals.push_back( merged );
+		merged = all[i];
+	    }
+	}
+	m_intervals.push_back( merged );
+    }
+    m_interval_begin[m_nodes] = (int)m_intervals.size();
+}
+
+int GenealogyIndex::node( const GenVertex* v ) const
+{
+    if ( !v ) return -1;
+    std::vector<vertex_node>::const_iterator l = 
+	std::lower_bound( m_lookup.begin(), m_lookup.end(), 
+	                  vertex_node( v, 0 ), by_vertex() );
+    if ( l == m_lookup.end() || l->first != v ) return -1;
+    return l->second;
+}
+
+int GenealogyIndex::topological_index( const GenVertex* v ) const
+{
+    int c = node( v );
+    if ( c < 0 ) return -1;
+    for ( int i = m_first[c]; i < m_first[c+1]; ++i ) {
+	if ( m_order[i] == v ) return i;
+    }
+    return -1;
+}
+
+bool GenealogyIndex::is_in_loop( const GenVertex* v ) const
+{
+    int c = node( v );
+    return c >= 0 && m_cyclic[c];
+}
+
+bool GenealogyIndex::reaches( int a, int b ) const
+{
+    if ( a > b ) return false;		// topological order
+    if ( a == b ) return true;
+    if ( m_has_bitsets ) {
+	return ( m_ancestors[ b * m_words + a / bits_per_word ] 
+	         >> ( a % bits_per_word ) ) & 1u;
+    }
+    // is the preorder number of b in one of the intervals of a?
+    int p = m_preorder[b];
+    std::vector<interval>::const_iterator first 
+	= m_intervals.begin() + m_interval_begin[ m_nodes - 1 - a ];
+    std::vector<interval>::const_iterator last 
+	= m_intervals.begin() + m_interval_begin[ m_nodes - a ];
+    std::vector<interval>::const_iterator i 
+	= std::upper_bound( first, last, p, starts_after() );
+    return i != first && (i-1)->second >= p;
+}
+
+int GenealogyIndex::common_ancestor_node( int a, int b ) const
+{
+    /// the ancestors of a are visited latest first, through a heap of
+    /// node numbers; a node reached along several paths comes out of the
+    /// heap several times in a row and is tested once
+    static thread_local std::vector<int> heap;
+    heap.clear();
+    heap.push_back( a );
+    int previous = -1;
+    while ( !heap.empty() ) {
+	std::pop_heap( heap.begin(), heap.end() );
+	int c = heap.back();
+	heap.pop_back();
+	if ( c == previous ) continue;
+	previous = c;
+	if ( reaches( c, b ) ) return c;
+	for ( int k = m_parent_begin[c]; k < m_parent_begin[c+1]; ++k ) {
+	    heap.push_back( m_parents[k] );
+	    std::push_heap( heap.begin(), heap.end() );
+	}
+    }
+    return -1;
+}
+
+bool GenealogyIndex::is_ancestor( const GenVertex* a, const GenVertex* b ) const
+{
+    int ca = node( a ), cb = node( b );
+    if ( ca < 0 || cb < 0 ) return false;
+    if ( ca == cb ) return m_cyclic[ca];
+    return reaches( ca, cb );
+}
+
+bool GenealogyIndex::is_ancestor( const GenParticle* a, 
+                                  const GenParticle* b ) const
+{
+    if ( !a || !b ) return false;
+    const GenVertex* end = a->end_vertex();
+    const GenVertex* prod = b->production_vertex();
+    if ( !end || !prod ) return false;
+    int ca = node( end ), cb = node( prod );
+    if ( ca < 0 || cb < 0 ) return false;
+    return reaches( ca, cb );
+}
+
+GenVertex* GenealogyIndex::common_ancestor( const GenVertex* a, 
+                                            const GenVertex* b ) const
+{
+    int ca = node( a ), cb = node( b );
+    if ( ca < 0 || cb < 0 ) return 0;
+    int last = std::min( ca, cb );
+    if ( m_has_bitsets ) {
+	const unsigned int* x = &m_ancestors[ ca * m_words ];
+	const unsigned int* y = &m_ancestors[ cb * m_words ];
+	for ( int w = last / bits_per_word; w >= 0; --w ) {
+	    unsigned int both = x[w] & y[w];
+	    if ( !both ) continue;
+	    int bit = bits_per_word - 1;
+	    while ( !( ( both >> bit ) & 1u ) ) --bit;
+	    return m_order[ m_first[ w * bits_per_word + bit ] ];
+	}
+	return 0;
+    }
+    int c = common_ancestor_node( last, std::max( ca, cb ) );
+    return c < 0 ? 0 : m_order[ m_first[c] ];
+}
+
+GenVertex* GenealogyIndex::common_ancestor( const GenParticle* a, 
+                                            const GenParticle* b ) const
+{
+    if ( !a || !b ) return 0;
+    return common_ancestor( a->production_vertex(), b->production_vertex() );
+}
+
+} // HepMC
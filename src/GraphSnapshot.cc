@@ -0,0 +1,216 @@
+//////////////////////////////////////////////////////////////////////////
+// GraphSnapshot.cc
+//
+// the vertex and particle graph of an event in CSR arrays
+//////////////////////////////////////////////////////////////////////////
+
+#include "HepMC/GraphSnapshot.h"
+#include "HepMC/GenEvent.h"
+#include "src/AddressSlot.h"
+
+namespace HepMC {
+
+GraphSnapshot::GraphSnapshot()
+  : m_vertices(), m_particles(), m_in_offset(1,0), m_in(),
+    m_out_offset(1,0), m_out(), m_production(), m_end(),
+    m_vertex_lookup(), m_particle_lookup()
+{
+    reset( m_vertex_lookup, 0 );
+    reset( m_particle_lookup, 0 );
+}
+
+GraphSnapshot::GraphSnapshot( const GenEvent& evt )
+  : m_vertices(), m_particles(), m_in_offset(), m_in(),
+    m_out_offset(), m_out(), m_production(), m_end(),
+    m_vertex_lookup(), m_particle_lookup()
+{
+    build( evt );
+}
+
+void GraphSnapshot::swap( GraphSnapshot& other )
+{
+    m_vertices.swap( other.m_vertices );
+    m_particles.swap( other.m_particles );
+    m_in_offset.swap( other.m_in_offset );
+    m_in.swap( other.m_in );
+    m_out_offset.swap( other.m_out_offset );
+    m_out.swap( other.m_out );
+    m_production.swap( other.m_production );
+    m_end.swap( other.m_end );
+    m_vertex_lookup.swap( other.m_vertex_lookup );
+    m_particle_lookup.swap( other.m_particle_lookup );
+}
+
+void GraphSnapshot::build( const GenEvent& evt )
+{
+    /// linear in the size of the event: one pass numbers the vertices,
+    /// one the particles and their vertices, and one fills the particle
+    /// lists of the vertices, with hashed lookups of the addresses
+    //
+    m_vertices.clear();
+    m_particles.clear();
+    m_vertices.reserve( evt.vertices_size() );
+    m_particles.reserve( evt.particles_size() );
+    reset( m_vertex_lookup, evt.vertices_size() );
+    reset( m_particle_lookup, evt.particles_size() );
+    for ( GenEvent::vertex_const_iterator v = evt.vertices_begin();
+	  v != evt.vertices_end(); ++v ) {
+	insert( m_vertex_lookup, *v, (int)m_vertices.size() );
+	m_vertices.push_back( *v );
+    }
+    //
+    // particle -> vertex
+    m_production.clear();
+    m_end.clear();
+    m_production.reserve( evt.particles_size() );
+    m_end.reserve( evt.particles_size() );
+    for ( GenEvent::particle_const_iterator p = evt.particles_begin();
+	  p != evt.particles_end(); ++p ) {
+	insert( m_particle_lookup, *p, (int)m_particles.size() );
+	m_particles.push_back( *p );
+	m_production.push_back( find( m_vertex_lookup, (*p)->production_vertex() ) );
+	m_end.push_back( find( m_vertex_lookup, (*p)->end_vertex() ) );
+    }
+    //
+    // vertex -> particles, in the order of the vertex lists
+    std::size_t np = m_particles.size();
+    std::size_t nv = m_vertices.size();
+    m_in_offset.resize( nv+1 );
+    m_out_offset.resize( nv+1 );
+    m_in.clear();
+    m_out.clear();
+    m_in.reserve( np );
+    m_out.reserve( np );
+    for ( std::size_t v = 0; v < nv; ++v ) {
+	m_in_offset[v] = (int)m_in.size();
+	m_out_offset[v] = (int)m_out.size();
+	const GenVertex* vtx = m_vertices[v];
+	for ( GenVertex::particles_in_const_iterator 
+		  p = vtx->particles_in_const_begin();
+	      p != vtx->particles_in_const_end(); ++p ) {
+	    m_in.push_back( find( m_particle_lookup, *p ) );
+	}
+	for ( GenVertex::particles_out_const_iterator 
+		  p = vtx->particles_out_const_begin();
+	      p != vtx->particles_out_const_end(); ++p ) {
+	    m_out.push_back( find( m_particle_lookup, *p ) );
+	}
+    }
+    m_in_offset[nv] = (int)m_in.size();
+    m_out_offset[nv] = (int)m_out.size();
+}
+
+void GraphSnapshot::reset( address_table& table, std::size_t n )
+{
+    // at most half full, so that probe sequences stay short
+    std::size_t size = 16;
+    while ( size < 2 * n ) size *= 2;
+    table.assign( size, address_index( 0, -1 ) );
+}
+
+void GraphSnapshot::insert( address_table& table, const void* a, int i )
+{
+    std::size_t mask = table.size() - 1;
+    std::size_t k = detail::address_slot( a, mask );
+    while ( table[k].first ) k = ( k + 1 ) & mask;
+    table[k] = address_index( a, i );
+}
+
+int GraphSnapshot::find( const address_table& table, const void* a )
+{
+    if ( !a ) return -1;
+    std::size_t mask = table.size() - 1;
+    for ( std::size_t k = detail::address_slot( a, mask ); table[k].first; k = ( k + 1 ) & mask ) {
+	if ( table[k].first == a ) return table[k].second;
+    }
+    return -1;
+}
+
+int GraphSnapshot::index( const GenVertex* v ) const
+{ return find( m_vertex_lookup, v ); }
+
+int GraphSnapshot::index( const GenParticle* p ) const
+{ return find( m_particle_lookup, p ); }
+
+void GraphSnapshot::vertices( int root, IteratorRange range,
+                              std::vector<int>& result ) const
+{
+    result.clear();
+    if ( root < 0 || root >= vertices_size() ) return;
+    bool up   = ( range != children && range != descendants );
+    bool down = ( range != parents  && range != ancestors );
+    bool deep = ( range > family );
+    std::vector<char> seen( m_vertices.size(), 0 );
+    seen[root] = 1;
+    result.push_back( root );
+    // result doubles as the queue
+    for ( std::size_t next = 0; next < result.size(); ++next ) {
+	int v = result[next];
+	if ( up ) {
+	    for ( int k = m_in_offset[v]; k < m_in_offset[v+1]; ++k ) {
+		int w = m_production[ m_in[k] ];
+		if ( w >= 0 && !seen[w] ) { seen[w] = 1; result.push_back( w ); }
+	    }
+	}
+	if ( down ) {
+	    for ( int k = m_out_offset[v]; k < m_out_offset[v+1]; ++k ) {
+		int w = m_end[ m_out[k] ];
+		if ( w >= 0 && !seen[w] ) { seen[w] = 1; result.push_back( w ); }
+	    }
+	}
+	if ( !deep ) break;
+    }
+}
+
+void GraphSnapshot::decay_chain( int p, std::vector<int>& result ) const
+{
+    result.clear();
+    if ( p < 0 || p >= particles_size() ) return;
+    result.push_back( p );
+    if ( m_end[p] < 0 ) return;
+    std::vector<int> decays;
+    vertices( m_end[p], descendants, decays );
+    for ( std::size_t i = 0; i < decays.size(); ++i ) {
+	int v = decays[i];
+	for ( int k = m_out_offset[v]; k < m_out_offset[v+1]; ++k ) {
+	    // p itself comes back if it is part of a loop
+	    if ( m_out[k] != p ) result.push_back( m_out[k] );
+	}
+    }
+}
+
+int GraphSnapshot::connected_components( std::vector<int>& component ) const
+{
+    int nv = vertices_size();
+    component.assign( nv, -1 );
+    std::vector<int> queue;
+    queue.reserve( nv );
+    int ncomp = 0;
+    for ( int s = 0; s < nv; ++s ) {
+	if ( component[s] >= 0 ) continue;
+	queue.clear();
+	queue.push_back( s );
+	component[s] = ncomp;
+	for ( std::size_t next = 0; next < queue.size(); ++next ) {
+	    int v = queue[next];
+	    for ( int k = m_in_offset[v]; k < m_in_offset[v+1]; ++k ) {
+		int w = m_production[ m_in[k] ];
+		if ( w >= 0 && component[w] < 0 ) {
+		    component[w] = ncomp;
+		    queue.push_back( w );
+		}
+	    }
+	    for ( int k = m_out_offset[v]; k < m_out_offset[v+1]; ++k ) {
+		int w = m_end[ m_out[k] ];
+		if ( w >= 0 && component[w] < 0 ) {
+		    component[w] = ncomp;
+		    queue.push_back( w );
+		}
+	    }
+	}
+	++ncomp;
+    }
+    return ncomp;
+}
+
+} // HepMC
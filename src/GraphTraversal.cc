@@ -0,0 +1,204 @@
+//////////////////////////////////////////////////////////////////////////
+// GraphTraversal.cc
+//
+// iterative walks over the vertices and particles connected to a vertex
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include "HepMC/GraphTraversal.h"
+#include "HepMC/GenEvent.h"
+#include "HepMC/GenVertex.h"
+#include "HepMC/GenParticle.h"
+#include "src/AddressSlot.h"
+
+namespace HepMC {
+
+namespace {
+
+    // the edge iterator only distinguishes parents, children and family
+    IteratorRange edge_range( IteratorRange range )
+    {
+	if ( range == descendants || range == children ) return children;
+	if ( range == ancestors   || range == parents  ) return parents;
+	return family;
+    }
+
+} // unnamed namespace
+
+GraphTraversal::GraphTraversal()
+  : m_stack(), m_vertices(), m_particles(), m_visited(), m_nvisited(0),
+    m_mark(0)
+{}
+
+void GraphTraversal::start_walk( std::size_t n )
+{
+    /// a new mark empties all slots at once; the table is only cleared
+    /// when the marks wrap around
+    m_nvisited = 0;
+    if ( ++m_mark == 0 ) {
+	Slot empty = { 0, 0 };
+	std::fill( m_visited.begin(), m_visited.end(), empty );
+	m_mark = 1;
+    }
+    std::size_t size = 16;
+    while ( size < 2 * n ) size *= 2;
+    if ( size > m_visited.size() ) {
+	Slot empty = { 0, 0 };
+	m_visited.assign( size, empty );
+    }
+}
+
+bool GraphTraversal::mark_visited( const GenVertex* v )
+{
+    if ( 2 * ( m_nvisited + 1 ) > m_visited.size() ) {
+	// more vertices than expected: double the table, keeping the
+	// vertices of this walk
+	std::vector<Slot> old( 2 * m_visited.size() );
+	old.swap( m_visited );
+	std::size_t mask = m_visited.size() - 1;
+	for ( std::size_t i = 0; i < old.size(); ++i ) {
+	    if ( old[i].mark != m_mark ) continue;
+	    std::size_t j = detail::address_slot( old[i].vertex, mask );
+	    while ( m_visited[j].mark == m_mark ) j = ( j + 1 ) & mask;
+	    m_visited[j] = old[i];
+	}
+    }
+    std::size_t mask = m_visited.size() - 1;
+    std::size_t i = detail::address_slot( v, mask );
+    while ( m_visited[i].mark == m_mark ) {
+	if ( m_visited[i].vertex == v ) return false;
+	i = ( i + 1 ) & mask;
+    }
+    m_visited[i].vertex = v;
+    m_visited[i].mark = m_mark;
+    ++m_nvisited;
+    return true;
+}
+
+void GraphTraversal::push( GenVertex* v, IteratorRange range,
+                           bool follow_edges )
+{
+    // edges are numbered with the incoming particles first,
+    // as in GenVertex::edge_iterator
+    Frame f;
+    f.vertex = v;
+    std::size_t nin = v->m_particles_in.size();
+    std::size_t nall = nin + v->m_particles_out.size();
+    IteratorRange r = edge_range( range );
+    f.next = ( r == children ? nin : 0 );
+    f.end  = ( r == parents ? nin : nall );
+    if ( !follow_edges ) f.next = f.end;
+    m_stack.push_back( f );
+}
+
+void GraphTraversal::walk_vertices( GenVertex& root, IteratorRange range )
+{
+    /// depth first walk returning vertices in post order,
+    /// equivalent to GenVertex::vertex_iterator
+    //
+    m_vertices.clear();
+    m_stack.clear();
+    // for parents, children and family we only look at the neighbours
+    bool deep = ( range > family );
+    // room for the whole event, so that the table does not grow during
+    // the walk
+    start_walk( deep && root.parent_event() ? root.parent_event()->vertices_size()
+	                                    : 8 );
+    mark_visited( &root );
+    push( &root, range, true );
+    while ( !m_stack.empty() ) {
+	Frame& f = m_stack.back();
+	if ( f.next == f.end ) {
+	    m_vertices.push_back( f.vertex );
+	    m_stack.pop_back();
+	    continue;
+	}
+	GenVertex* v = f.vertex;
+	std::size_t nin = v->m_particles_in.size();
+	GenParticle* p = ( f.next < nin ? v->m_particles_in[f.next]
+	                                : v->m_particles_out[f.next-nin] );
+	++f.next;
+	// a particle which starts and ends at the same vertex leads nowhere
+	if ( p->production_vertex() == p->end_vertex() ) continue;
+	GenVertex* next = ( p->end_vertex() == v ? p->production_vertex()
+	                                         : p->end_vertex() );
+	if ( !next || !mark_visited( next ) ) continue;
+	// f is invalidated by push
+	push( next, range, deep );
+    }
+}
+
+const std::vector<GenVertex*>& GraphTraversal::vertices( GenVertex& root,
+                                                  IteratorRange range )
+{
+    walk_vertices( root, range );
+    return m_vertices;
+}
+
+const std::vector<GenParticle*>& GraphTraversal::particles( GenVertex& root,
+                                                  IteratorRange range )
+{
+    /// each particle is assigned to exactly one vertex,
+    /// equivalent to GenVertex::particle_iterator
+    //
+    m_particles.clear();
+    IteratorRange r = edge_range( range );
+    if ( range <= family ) {
+	// only the edges of the root vertex
+	if ( r != children ) {
+	    m_particles.insert( m_particles.end(), root.m_particles_in.begin(),
+	                        root.m_particles_in.end() );
+	}
+	if ( r != parents ) {
+	    m_particles.insert( m_particles.end(), root.m_particles_out.begin(),
+	                        root.m_particles_out.end() );
+	}
+	return m_particles;
+    }
+    walk_vertices( root, range );
+    for ( std::vector<GenVertex*>::const_iterator v = m_vertices.begin();
+	  v != m_vertices.end(); ++v ) {
+	if ( r != children ) {
+	    for ( std::vector<GenParticle*>::const_iterator
+		      p = (*v)->m_particles_in.begin();
+		  p != (*v)->m_particles_in.end(); ++p ) {
+		// for relatives, incoming particles belong to their
+		// production vertex if they have one
+		if ( range == relatives && (*p)->end_vertex() == *v
+		     && (*p)->production_vertex() ) continue;
+		m_particles.push_back( *p );
+	    }
+	}
+	if ( r != parents ) {
+	    for ( std::vector<GenParticle*>::const_iterator
+		      p = (*v)->m_particles_out.begin();
+		  p != (*v)->m_particles_out.end(); ++p ) {
+		if ( range == relatives && (*p)->end_vertex() == *v
+		     && (*p)->production_vertex() ) continue;
+		m_particles.push_back( *p );
+	    }
+	}
+    }
+    return m_particles;
+}
+
+void GraphTraversal::visit( GenVertex& root, IteratorRange range,
+                            VertexVisitor& visitor )
+{
+    walk_vertices( root, range );
+    for ( std::size_t i = 0; i < m_vertices.size(); ++i ) {
+	visitor.visit( m_vertices[i] );
+    }
+}
+
+void GraphTraversal::visit( GenVertex& root, IteratorRange range,
+                            ParticleVisitor& visitor )
+{
+    particles( root, range );
+    for ( std::size_t i = 0; i < m_particles.size(); ++i ) {
+	visitor.visit( m_particles[i] );
+    }
+}
+
+} // HepMC
@@ -121,9 +121,9 @@ std::istream & operator >> (std::istream & is, HeavyIon * ion)
     iline >> inel;
     if(!iline) throw IO_Exception("HeavyIon input stream encounterd invalid data");
     // centrality was added in HepMC 2.06.10
-    // since we don't know if this event has centrality, set to zero if not found.
+    // since we don't know if this event has centrality, leave it unset if not found.
     iline >> cent;
-    if(!iline) cent=0.;
+    if(!iline) cent=-1.;
 
     ion->set_Ncoll_hard(nh);
     ion->set_Npart_proj(np);
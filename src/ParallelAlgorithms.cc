@@ -0,0 +1,94 @@
+//////////////////////////////////////////////////////////////////////////
+// ParallelAlgorithms.cc
+//
+// reductions over the particles and vertices of one event
+//////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+
+#include "HepMC/ParallelAlgorithms.h"
+#include "HepMC/GenParticle.h"
+#include "HepMC/GenVertex.h"
+
+namespace HepMC {
+
+namespace {
+
+    FourVector add( const FourVector& a, const FourVector& b )
+    {
+	return FourVector( a.px() + b.px(), a.py() + b.py(),
+	                   a.pz() + b.pz(), a.e() + b.e() );
+    }
+
+    std::map<int,int> merge( std::map<int,int> a, const std::map<int,int>& b )
+    {
+	for ( std::map<int,int>::const_iterator i = b.begin(); i != b.end(); ++i ) {
+	    a[i->first] += i->second;
+	}
+	return a;
+    }
+
+    std::vector<int> append( std::vector<int> a, const std::vector<int>& b )
+    {
+	a.insert( a.end(), b.begin(), b.end() );
+	return a;
+    }
+
+} // unnamed namespace
+
+FourVector parallel_sum_momentum( const GraphSnapshot& g, int status,
+                                  ThreadPool& pool )
+{
+    return parallel_reduce( g.particles().size(), FourVector( 0, 0, 0, 0 ),
+                            [&]( FourVector& sum, std::size_t i ) {
+				const GenParticle* p = g.particle( (int)i );
+				if ( status == 0 || p->status() == status ) {
+				    sum = add( sum, p->momentum() );
+				}
+			    },
+			    add, pool );
+}
+
+std::map<int,int> parallel_count_by_status( const GraphSnapshot& g,
+                                            ThreadPool& pool )
+{
+    return parallel_reduce( g.particles().size(), std::map<int,int>(),
+                            [&]( std::map<int,int>& count, std::size_t i ) {
+				++count[ g.particle( (int)i )->status() ];
+			    },
+			    merge, pool );
+}
+
+std::vector<int> parallel_check_momentum_conservation( const GraphSnapshot& g,
+                                                       double tolerance,
+                                                       ThreadPool& pool )
+{
+    return parallel_reduce( g.vertices().size(), std::vector<int>(),
+                            [&]( std::vector<int>& bad, std::size_t i ) {
+				int v = (int)i;
+				if ( g.particles_in_size(v) == 0 ||
+				     g.particles_out_size(v) == 0 ) return;
+				double d[4] = { 0, 0, 0, 0 };
+				for ( const int* p = g.particles_in_begin(v);
+				      p != g.particles_in_end(v); ++p ) {
+				    const FourVector& m = g.particle(*p)->momentum();
+				    d[0] += m.px(); d[1] += m.py();
+				    d[2] += m.pz(); d[3] += m.e();
+				}
+				for ( const int* p = g.particles_out_begin(v);
+				      p != g.particles_out_end(v); ++p ) {
+				    const FourVector& m = g.particle(*p)->momentum();
+				    d[0] -= m.px(); d[1] -= m.py();
+				    d[2] -= m.pz(); d[3] -= m.e();
+				}
+				for ( int k = 0; k < 4; ++k ) {
+				    if ( std::fabs( d[k] ) > tolerance ) {
+					bad.push_back( v );
+					return;
+				    }
+				}
+			    },
+			    append, pool );
+}
+
+} // HepMC
@@ -0,0 +1,154 @@
+//////////////////////////////////////////////////////////////////////////
+// PileupOverlay.cc
+//
+// merge many events into one, as for pile-up
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include "HepMC/PileupOverlay.h"
+#include "HepMC/GenEvent.h"
+
+namespace HepMC {
+
+namespace {
+
+    // sub-events are ordered by increasing particle barcodes
+    // and decreasing vertex barcodes
+    bool before_particle( int barcode, const PileupOverlay::SubEvent& s )
+    { return barcode < s.first_particle; }
+
+    bool before_vertex( int barcode, const PileupOverlay::SubEvent& s )
+    { return barcode > s.first_vertex; }
+
+} // unnamed namespace
+
+PileupOverlay::PileupOverlay( GenEvent& target )
+  : m_target(&target), m_sub_events()
+{
+    SubEvent s;
+    s.particle_offset = 0;
+    s.vertex_offset = 0;
+    s.shift = FourVector(0,0,0,0);
+    if ( target.m_particle_barcodes.empty() ) {
+	s.first_particle = 1;
+	s.last_particle = 0;
+    } else {
+	s.first_particle = target.m_particle_barcodes.begin()->first;
+	s.last_particle = target.m_particle_barcodes.rbegin()->first;
+    }
+    // the vertex map is sorted by decreasing barcode
+    if ( target.m_vertex_barcodes.empty() ) {
+	s.first_vertex = -1;
+	s.last_vertex = 0;
+    } else {
+	s.first_vertex = target.m_vertex_barcodes.begin()->first;
+	s.last_vertex = target.m_vertex_barcodes.rbegin()->first;
+    }
+    m_sub_events.push_back( s );
+}
+
+bool PileupOverlay::add( GenEvent& source, const FourVector& shift )
+{
+    if ( &source == m_target ) return false;
+    GenEvent& evt = *m_target;
+    if ( source.momentum_unit() != evt.momentum_unit()
+	 || source.length_unit() != evt.length_unit() ) {
+	source.use_units( evt.momentum_unit(), evt.length_unit() );
+    }
+    // the offsets put the barcodes of source after all those in use,
+    // unless they are already
+    int last_particle = evt.m_particle_barcodes.empty()
+	? 0 : evt.m_particle_barcodes.rbegin()->first;
+    int last_vertex = evt.m_vertex_barcodes.empty()
+	? 0 : evt.m_vertex_barcodes.rbegin()->first;
+    SubEvent s;
+    s.shift = shift;
+    s.particle_offset = 0;
+    s.first_particle = last_particle + 1;
+    s.last_particle = last_particle;
+    if ( !source.m_particle_barcodes.empty() ) {
+	int lowest = source.m_particle_barcodes.begin()->first;
+	if ( lowest <= last_particle ) s.particle_offset = last_particle + 1 - lowest;
+	s.first_particle = lowest + s.particle_offset;
+	s.last_particle = source.m_particle_barcodes.rbegin()->first + s.particle_offset;
+    }
+    s.vertex_offset = 0;
+    s.first_vertex = last_vertex - 1;
+    s.last_vertex = last_vertex;
+    if ( !source.m_vertex_barcodes.empty() ) {
+	int highest = source.m_vertex_barcodes.begin()->first;
+	if ( highest >= last_vertex ) s.vertex_offset = last_vertex - 1 - highest;
+	s.first_vertex = highest + s.vertex_offset;
+	s.last_vertex = source.m_vertex_barcodes.rbegin()->first + s.vertex_offset;
+    }
+    //
+    // both maps of source are traversed in the order of the target maps,
+    // and all new barcodes follow those in the target, so each insertion
+    // at the end takes constant time
+    evt.invalidate_genealogy_index();
+    source.invalidate_genealogy_index();
+    for ( std::map<int,GenVertex*,std::greater<int> >::const_iterator
+	      v = source.m_vertex_barcodes.begin();
+	  v != source.m_vertex_barcodes.end(); ++v ) {
+	GenVertex* vtx = v->second;
+	vtx->m_event = evt.m_link;
+	vtx->m_barcode = v->first + s.vertex_offset;
+	const FourVector& pos = vtx->m_position;
+	vtx->m_position = FourVector( pos.x() + shift.x(), pos.y() + shift.y(),
+	                              pos.z() + shift.z(), pos.t() + shift.t() );
+	evt.m_vertex_barcodes.insert( evt.m_vertex_barcodes.end(),
+	                              std::make_pair( vtx->m_barcode, vtx ) );
+    }
+    for ( std::map<int,GenParticle*,std::less<int> >::const_iterator
+	      p = source.m_particle_barcodes.begin();
+	  p != source.m_particle_barcodes.end(); ++p ) {
+	GenParticle* part = p->second;
+	part->m_barcode = p->first + s.particle_offset;
+	evt.m_particle_barcodes.insert( evt.m_particle_barcodes.end(),
+	                                std::make_pair( part->m_barcode, part ) );
+    }
+    source.m_vertex_barcodes.clear();
+    source.m_particle_barcodes.clear();
+    source.m_signal_process_vertex = 0;
+    source.m_beam_particle_1 = 0;
+    source.m_beam_particle_2 = 0;
+    m_sub_events.push_back( s );
+    return true;
+}
+
+int PileupOverlay::find( int barcode ) const
+{
+    // the last sub-event starting at or before barcode; empty sub-events
+    // come before a non empty one starting at the same barcode
+    std::vector<SubEvent>::const_iterator s;
+    if ( barcode > 0 ) {
+	s = std::upper_bound( m_sub_events.begin(), m_sub_events.end(),
+	                      barcode, before_particle );
+	if ( s == m_sub_events.begin() ) return -1;
+	--s;
+	return barcode <= s->last_particle ? int( s - m_sub_events.begin() ) : -1;
+    }
+    if ( barcode < 0 ) {
+	s = std::upper_bound( m_sub_events.begin(), m_sub_events.end(),
+	                      barcode, before_vertex );
+	if ( s == m_sub_events.begin() ) return -1;
+	--s;
+	return barcode >= s->last_vertex ? int( s - m_sub_events.begin() ) : -1;
+    }
+    return -1;
+}
+
+int PileupOverlay::sub_event( const GenParticle* p ) const
+{
+    if ( !p || p->parent_event() != m_target ) return -1;
+    return find( p->barcode() );
+}
+
+int PileupOverlay::sub_event( const GenVertex* v ) const
+{
+    if ( !v || v->parent_event() != m_target ) return -1;
+    return find( v->barcode() );
+}
+
+} // HepMC
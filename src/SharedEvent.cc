@@ -0,0 +1,56 @@
+//////////////////////////////////////////////////////////////////////////
+// SharedEvent.cc
+//
+// a reference counted, copy-on-write handle to a GenEvent
+//////////////////////////////////////////////////////////////////////////
+
+#include "HepMC/SharedEvent.h"
+#include "HepMC/GenEvent.h"
+
+namespace HepMC {
+
+SharedEvent::SharedEvent( GenEvent* evt )
+  : m_holder( evt ? new Holder( evt ) : 0 )
+{}
+
+void SharedEvent::drop()
+{
+    if( m_holder && m_holder->count.fetch_sub( 1, std::memory_order_acq_rel ) == 1 ) {
+	delete m_holder->event;
+	delete m_holder;
+    }
+    m_holder = 0;
+}
+
+void SharedEvent::unshare()
+{
+    // copy-on-write: never modify an event that someone else can see
+    if( !m_holder || m_holder->count.load( std::memory_order_acquire ) == 1 ) return;
+    Holder* mine = new Holder( new GenEvent( *m_holder->event ) );
+    drop();
+    m_holder = mine;
+}
+
+GenEvent* SharedEvent::mutable_event()
+{
+    unshare();
+    return m_holder ? m_holder->event : 0;
+}
+
+GenEvent* SharedEvent::release()
+{
+    unshare();
+    if( !m_holder ) return 0;
+    GenEvent* evt = m_holder->event;
+    delete m_holder;
+    m_holder = 0;
+    return evt;
+}
+
+void SharedEvent::reset( GenEvent* evt )
+{
+    SharedEvent tmp( evt );
+    swap( tmp );
+}
+
+} // HepMC
@@ -5,11 +5,18 @@
 //
 // ----------------------------------------------------------------------
 
+#include <atomic>
 #include <string>
 #include "HepMC/StreamInfo.h"
 
 namespace HepMC {
 
+namespace {
+    // counts the streams of all threads; kept here so that StreamInfo.h
+    // does not need <atomic>
+    std::atomic<unsigned int> stream_counter(0);
+}
+
 StreamInfo::StreamInfo( )
 : m_finished_first_event_io(false),
   m_io_genevent_start("HepMC::IO_GenEvent-START_EVENT_LISTING"),
@@ -26,15 +33,13 @@ StreamInfo::StreamInfo( )
   m_has_key(true),
   m_io_momentum_unit(Units::default_momentum_unit()),
   m_io_position_unit(Units::default_length_unit()),
-  m_stream_id(m_stream_counter),
-  m_reading_event_header(false)
+  m_stream_id(stream_counter++),
+  m_reading_event_header(false),
+  m_weight_names_line(),
+  m_weight_names()
 {
-    ++m_stream_counter;
 }
 
-/// static counter 
-unsigned int StreamInfo::m_stream_counter = 0; 
-
 void StreamInfo::use_input_units( Units::MomentumUnit mom, Units::LengthUnit len ) {
     m_io_momentum_unit = mom;
     m_io_position_unit = len;
@@ -56,4 +61,10 @@ void StreamInfo::set_reading_event_header(bool tf) {
     m_reading_event_header = tf;
 }
 
+void StreamInfo::set_weight_names( const std::string& line, 
+                                   const WeightContainer& w ) {
+    m_weight_names_line = line;
+    m_weight_names = w;
+}
+
 } // HepMC
@@ -0,0 +1,195 @@
+//////////////////////////////////////////////////////////////////////////
+// ThreadPool.cc
+//
+// a fixed set of threads which share the work of a loop
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include "HepMC/ThreadPool.h"
+
+namespace HepMC {
+
+namespace {
+
+    // size of the shared pool, and whether it was created
+    unsigned   global_size = 0;
+    bool       global_created = false;
+    std::mutex global_lock;
+
+} // unnamed namespace
+
+struct ThreadPool::LoopScope {
+    const ThreadPool* pool;
+    const LoopScope*  outer;
+};
+
+thread_local const ThreadPool::LoopScope* ThreadPool::s_scope = 0;
+
+ThreadPool::ThreadPool( unsigned nthreads )
+  : m_size( nthreads ), m_blocks(), m_threads(), m_run(), m_lock(),
+    m_start(), m_finished(), m_generation(0), m_busy(0), m_stop(false),
+    m_failed(false), m_error(), m_body(0), m_grain(1), m_scope(0)
+{
+    if ( m_size == 0 ) m_size = std::thread::hardware_concurrency();
+    if ( m_size == 0 ) m_size = 1;
+    m_blocks.reset( new Block[m_size] );
+    for ( unsigned i = 0; i < m_size; ++i ) {
+	m_blocks[i].begin = m_blocks[i].end = 0;
+    }
+    m_threads.reserve( m_size - 1 );
+    for ( unsigned i = 1; i < m_size; ++i ) {
+	m_threads.push_back( std::thread( &ThreadPool::worker, this, i ) );
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+	std::lock_guard<std::mutex> guard( m_lock );
+	m_stop = true;
+    }
+    m_start.notify_all();
+    for ( std::size_t i = 0; i < m_threads.size(); ++i ) m_threads[i].join();
+}
+
+ThreadPool& ThreadPool::global()
+{
+    std::lock_guard<std::mutex> guard( global_lock );
+    global_created = true;
+    static ThreadPool pool( global_size );
+    return pool;
+}
+
+bool ThreadPool::set_global_size( unsigned nthreads )
+{
+    std::lock_guard<std::mutex> guard( global_lock );
+    if ( global_created ) return false;
+    global_size = nthreads;
+    return true;
+}
+
+void ThreadPool::run( std::size_t n, const range_function& body, 
+                      std::size_t grain )
+{
+    if ( n == 0 ) return;
+    if ( grain == 0 ) grain = std::max<std::size_t>( 1, n / ( 8 * m_size ) );
+    if ( m_size == 1 || n <= grain || is_running_here() ) {
+	body( 0, n );
+	return;
+    }
+    std::lock_guard<std::mutex> running( m_run );
+    // the threads working on this loop are inside the loops of the caller
+    LoopScope scope = { this, s_scope };
+    // one contiguous block per thread
+    for ( unsigned i = 0; i < m_size; ++i ) {
+	std::lock_guard<std::mutex> guard( m_blocks[i].lock );
+	m_blocks[i].begin = n * i / m_size;
+	m_blocks[i].end   = n * (i+1) / m_size;
+    }
+    {
+	std::lock_guard<std::mutex> guard( m_lock );
+	m_body = &body;
+	m_grain = grain;
+	m_failed = false;
+	m_error = std::exception_ptr();
+	m_busy = m_size - 1;
+	m_scope = &scope;
+	++m_generation;
+    }
+    m_start.notify_all();
+    const LoopScope* outer = s_scope;
+    s_scope = &scope;
+    work( 0 );
+    s_scope = outer;
+    std::unique_lock<std::mutex> guard( m_lock );
+    while ( m_busy > 0 ) m_finished.wait( guard );
+    m_body = 0;
+    m_scope = 0;
+    if ( m_error ) {
+	std::exception_ptr error = m_error;
+	m_error = std::exception_ptr();
+	std::rethrow_exception( error );
+    }
+}
+
+bool ThreadPool::is_running_here() const
+{
+    for ( const LoopScope* s = s_scope; s; s = s->outer ) {
+	if ( s->pool == this ) return true;
+    }
+    return false;
+}
+
+void ThreadPool::worker( unsigned id )
+{
+    unsigned long done = 0;
+    for ( ;; ) {
+	{
+	    std::unique_lock<std::mutex> guard( m_lock );
+	    while ( !m_stop && m_generation == done ) m_start.wait( guard );
+	    if ( m_stop ) return;
+	    done = m_generation;
+	    s_scope = m_scope;
+	}
+	work( id );
+	s_scope = 0;
+	std::lock_guard<std::mutex> guard( m_lock );
+	if ( --m_busy == 0 ) m_finished.notify_one();
+    }
+}
+
+void ThreadPool::work( unsigned id )
+{
+    std::size_t begin, end;
+    while ( next_chunk( id, begin, end ) ) {
+	try {
+	    (*m_body)( begin, end );
+	} catch ( ... ) {
+	    std::lock_guard<std::mutex> guard( m_lock );
+	    if ( !m_error ) m_error = std::current_exception();
+	    m_failed = true;
+	}
+    }
+}
+
+bool ThreadPool::next_chunk( unsigned id, std::size_t& begin, std::size_t& end )
+{
+    if ( m_failed ) return false;
+    Block& mine = m_blocks[id];
+    for ( ;; ) {
+	{
+	    std::lock_guard<std::mutex> guard( mine.lock );
+	    if ( mine.begin < mine.end ) {
+		begin = mine.begin;
+		end = std::min( mine.end, begin + m_grain );
+		mine.begin = end;
+		return true;
+	    }
+	}
+	// steal the back half of the largest other block
+	unsigned victim = id;
+	std::size_t largest = 0;
+	for ( unsigned k = 1; k < m_size; ++k ) {
+	    unsigned i = ( id + k ) % m_size;
+	    std::lock_guard<std::mutex> guard( m_blocks[i].lock );
+	    std::size_t left = m_blocks[i].end - m_blocks[i].begin;
+	    if ( left > largest ) { largest = left; victim = i; }
+	}
+	if ( victim == id ) return false;
+	std::size_t from, to;
+	{
+	    std::lock_guard<std::mutex> guard( m_blocks[victim].lock );
+	    Block& other = m_blocks[victim];
+	    if ( other.begin >= other.end ) continue;	// taken meanwhile
+	    from = other.begin + ( other.end - other.begin ) / 2;
+	    to = other.end;
+	    other.end = from;
+	}
+	std::lock_guard<std::mutex> guard( mine.lock );
+	mine.begin = from;
+	mine.end = to;
+    }
+}
+
+} // HepMC
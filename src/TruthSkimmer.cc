@@ -0,0 +1,164 @@
+//////////////////////////////////////////////////////////////////////////
+// TruthSkimmer.cc
+//
+// copy selected particles with their ancestry and decays
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+#include "HepMC/TruthSkimmer.h"
+#include "HepMC/GenEvent.h"
+
+namespace HepMC {
+
+namespace {
+
+    // the order of GenEvent::vertex_iterator
+    struct event_order {
+	bool operator()( const GenVertex* a, const GenVertex* b ) const
+	{ return a->barcode() > b->barcode(); }
+    };
+
+} // unnamed namespace
+
+const int TruthSkimmer::all_generations;
+
+TruthSkimmer::TruthSkimmer( int ancestor_depth, int descendant_depth,
+                            bool keep_hard_process )
+  : m_ancestor_depth(ancestor_depth), m_descendant_depth(descendant_depth),
+    m_keep_hard_process(keep_hard_process),
+    m_seeds(), m_queue(), m_queued(), m_vertex_done(), m_copy(), m_vertices()
+{}
+
+std::size_t TruthSkimmer::skim( const GenEvent& evt,
+                                const std::vector<const GenParticle*>& seeds,
+                                GenEvent& out )
+{
+    m_seeds.clear();
+    for ( std::size_t i = 0; i < seeds.size(); ++i ) {
+	if ( seeds[i] && seeds[i]->parent_event() == &evt ) m_seeds.push_back( seeds[i] );
+    }
+    return copy( evt, out );
+}
+
+std::size_t TruthSkimmer::skim( const GenEvent& evt,
+                                const particle_predicate& is_seed,
+                                GenEvent& out )
+{
+    m_seeds.clear();
+    for ( GenEvent::particle_const_iterator p = evt.particles_begin();
+	  p != evt.particles_end(); ++p ) {
+	if ( is_seed( *p ) ) m_seeds.push_back( *p );
+    }
+    return copy( evt, out );
+}
+
+void TruthSkimmer::search( bool up, int depth )
+{
+    /// breadth first, so each particle is first reached in its
+    /// nearest generation from any seed
+    m_queue.clear();
+    m_queued.clear();
+    m_vertex_done.clear();
+    for ( std::size_t i = 0; i < m_seeds.size(); ++i ) {
+	if ( m_queued.insert( m_seeds[i] ).second ) {
+	    m_queue.push_back( particle_generation( m_seeds[i], 0 ) );
+	}
+    }
+    for ( std::size_t i = 0; i < m_queue.size(); ++i ) {
+	const GenParticle* p = m_queue[i].first;
+	int generation = m_queue[i].second;
+	keep( p );
+	if ( depth >= 0 && generation >= depth ) continue;
+	const GenVertex* v = ( up ? p->production_vertex() : p->end_vertex() );
+	if ( !v || !m_vertex_done.insert( v ).second ) continue;
+	if ( up ) {
+	    for ( GenVertex::particles_in_const_iterator q = v->particles_in_const_begin();
+		  q != v->particles_in_const_end(); ++q ) {
+		if ( m_queued.insert( *q ).second ) {
+		    m_queue.push_back( particle_generation( *q, generation + 1 ) );
+		}
+	    }
+	} else {
+	    for ( GenVertex::particles_out_const_iterator q = v->particles_out_const_begin();
+		  q != v->particles_out_const_end(); ++q ) {
+		if ( m_queued.insert( *q ).second ) {
+		    m_queue.push_back( particle_generation( *q, generation + 1 ) );
+		}
+	    }
+	}
+    }
+}
+
+std::size_t TruthSkimmer::copy( const GenEvent& evt, GenEvent& out )
+{
+    m_copy.clear();
+    const GenVertex* signal = evt.signal_process_vertex();
+    if ( m_keep_hard_process ) {
+	if ( signal ) {
+	    for ( GenVertex::particles_in_const_iterator p = signal->particles_in_const_begin();
+		  p != signal->particles_in_const_end(); ++p ) keep( *p );
+	    for ( GenVertex::particles_out_const_iterator p = signal->particles_out_const_begin();
+		  p != signal->particles_out_const_end(); ++p ) keep( *p );
+	}
+	if ( evt.beam_particles().first ) keep( evt.beam_particles().first );
+	if ( evt.beam_particles().second ) keep( evt.beam_particles().second );
+    }
+    search( true, m_ancestor_depth );
+    search( false, m_descendant_depth );
+
+    // the event information
+    out.clear();
+    out.set_signal_process_id( evt.signal_process_id() );
+    out.set_event_number( evt.event_number() );
+    out.set_mpi( evt.mpi() );
+    out.set_event_scale( evt.event_scale() );
+    out.set_alphaQCD( evt.alphaQCD() );
+    out.set_alphaQED( evt.alphaQED() );
+    out.set_random_states( evt.random_states() );
+    out.weights() = evt.weights();
+    out.define_units( evt.momentum_unit(), evt.length_unit() );
+    if ( evt.cross_section() ) out.set_cross_section( *evt.cross_section() );
+    if ( evt.heavy_ion() ) out.set_heavy_ion( *evt.heavy_ion() );
+    if ( evt.pdf_info() ) out.set_pdf_info( *evt.pdf_info() );
+
+    // every vertex with a kept particle, in the order of the event
+    m_vertices.clear();
+    m_vertex_done.clear();
+    typedef std::unordered_map<const GenParticle*,GenParticle*>::iterator copy_iterator;
+    for ( copy_iterator p = m_copy.begin(); p != m_copy.end(); ++p ) {
+	p->second = new GenParticle( *p->first );
+	const GenVertex* ends[2] = { p->first->production_vertex(), p->first->end_vertex() };
+	for ( int i = 0; i < 2; ++i ) {
+	    if ( ends[i] && m_vertex_done.insert( ends[i] ).second ) {
+		m_vertices.push_back( ends[i] );
+	    }
+	}
+    }
+    std::sort( m_vertices.begin(), m_vertices.end(), event_order() );
+    for ( std::size_t i = 0; i < m_vertices.size(); ++i ) {
+	const GenVertex* v = m_vertices[i];
+	GenVertex* newvertex = new GenVertex( v->position(), v->id(), v->weights() );
+	newvertex->suggest_barcode( v->barcode() );
+	out.add_vertex( newvertex );
+	if ( v == signal ) out.set_signal_process_vertex( newvertex );
+	// the particles keep their order at each vertex
+	for ( GenVertex::particles_in_const_iterator p = v->particles_in_const_begin();
+	      p != v->particles_in_const_end(); ++p ) {
+	    copy_iterator c = m_copy.find( *p );
+	    if ( c != m_copy.end() ) newvertex->add_particle_in( c->second );
+	}
+	for ( GenVertex::particles_out_const_iterator p = v->particles_out_const_begin();
+	      p != v->particles_out_const_end(); ++p ) {
+	    copy_iterator c = m_copy.find( *p );
+	    if ( c != m_copy.end() ) newvertex->add_particle_out( c->second );
+	}
+    }
+    copy_iterator b1 = m_copy.find( evt.beam_particles().first );
+    copy_iterator b2 = m_copy.find( evt.beam_particles().second );
+    out.set_beam_particles( b1 != m_copy.end() ? b1->second : 0,
+                            b2 != m_copy.end() ? b2->second : 0 );
+    return out.particles_size();
+}
+
+} // HepMC
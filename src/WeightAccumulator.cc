@@ -0,0 +1,215 @@
+//////////////////////////////////////////////////////////////////////////
+// WeightAccumulator.cc
+//
+// running sums of event weights
+//////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <iomanip>
+#include <stdexcept>
+
+#include "HepMC/WeightAccumulator.h"
+
+namespace HepMC {
+
+namespace {
+
+    // plain loops over contiguous arrays, which the compiler can vectorize
+    void add_weights( double* sumw, double* sumw2, const double* w, 
+                      std::size_t n )
+    {
+        for( std::size_t i = 0; i < n; ++i ) {
+	    sumw[i]  += w[i];
+	    sumw2[i] += w[i]*w[i];
+	}
+    }
+
+    void add_sums( double* sumw, double* sumw2, 
+                   const double* osumw, const double* osumw2, std::size_t n )
+    {
+        for( std::size_t i = 0; i < n; ++i ) {
+	    sumw[i]  += osumw[i];
+	    sumw2[i] += osumw2[i];
+	}
+    }
+
+} // unnamed namespace
+
+WeightAccumulator::WeightAccumulator()
+  : m_sumw(), m_sumw2(), m_entries(0), m_positions()
+{}
+
+WeightAccumulator::WeightAccumulator( const WeightContainer& w )
+  : m_sumw(), m_sumw2(), m_entries(0), m_positions()
+{
+    m_sumw.share_names( w );
+    resize( w.size() );
+}
+
+void WeightAccumulator::swap( WeightAccumulator & other )
+{
+    m_sumw.swap( other.m_sumw );
+    m_sumw2.swap( other.m_sumw2 );
+    std::swap( m_entries, other.m_entries );
+    m_positions.swap( other.m_positions );
+}
+
+void WeightAccumulator::resize( size_type n )
+{
+    m_sumw.m_weights.resize( n, 0. );
+    m_sumw2.resize( n, 0. );
+}
+
+void WeightAccumulator::reset()
+{
+    m_sumw.m_weights.assign( size(), 0. );
+    m_sumw2.assign( size(), 0. );
+    m_entries = 0;
+}
+
+void WeightAccumulator::add( const WeightContainer& w )
+{
+    // the first event defines the names
+    if( m_entries == 0 && empty_names() ) {
+        m_sumw.share_names( w );
+	resize( w.size() );
+    }
+    ++m_entries;
+    if( w.empty() ) return;
+    if( w.m_names == m_sumw.m_names && w.size() == size() ) {
+        add_weights( &m_sumw.m_weights[0], &m_sumw2[0], &w.m_weights[0], size() );
+	return;
+    }
+    // different names: match them one by one
+    map_names( w, m_positions );
+    for( size_type i = 0; i < w.size(); ++i ) {
+        size_type j = m_positions[i];
+	if( j == size_type(-1) ) continue;
+	m_sumw.m_weights[j] += w.m_weights[i];
+	m_sumw2[j] += w.m_weights[i]*w.m_weights[i];
+    }
+}
+
+void WeightAccumulator::merge( const WeightAccumulator& other )
+{
+    if( &other == this ) {
+        WeightAccumulator tmp( other );
+	merge( tmp );
+	return;
+    }
+    if( other.m_entries == 0 && other.size() == 0 ) return;
+    if( m_entries == 0 && empty_names() ) {
+        *this = other;
+	return;
+    }
+    m_entries += other.m_entries;
+    if( other.size() == 0 ) return;
+    if( other.m_sumw.m_names == m_sumw.m_names && other.size() == size() ) {
+        add_sums( &m_sumw.m_weights[0], &m_sumw2[0], 
+	          &other.m_sumw.m_weights[0], &other.m_sumw2[0], size() );
+	return;
+    }
+    map_names( other.m_sumw, m_positions );
+    for( size_type i = 0; i < other.size(); ++i ) {
+        size_type j = m_positions[i];
+	if( j == size_type(-1) ) continue;
+	m_sumw.m_weights[j] += other.m_sumw.m_weights[i];
+	m_sumw2[j] += other.m_sumw2[i];
+    }
+}
+
+WeightAccumulator& WeightAccumulator::operator+=( const WeightAccumulator& other )
+{
+    merge( other );
+    return *this;
+}
+
+bool WeightAccumulator::empty_names() const
+{
+    return m_sumw.map_begin() == m_sumw.map_end();
+}
+
+void WeightAccumulator::map_names( const WeightContainer& w, 
+                                   std::vector<size_type>& pos )
+{
+    pos.assign( w.size(), size_type(-1) );
+    bool same = ( w.size() == size() );
+    for( WeightContainer::const_map_iterator m = w.map_begin(); 
+         m != w.map_end(); ++m ) {
+	size_type j = index( m->first );
+	if( j == size() ) {
+	    // a new name: start a new sum
+	    m_sumw.unshared_names()[m->first] = j;
+	    resize( j+1 );
+	}
+	if( m->second < pos.size() ) pos[m->second] = j;
+	if( j != m->second ) same = false;
+    }
+    // identical names in a different table: share it from now on,
+    // so that the next event with this table is added directly
+    if( same && w.size() == size() ) m_sumw.share_names( w );
+}
+
+WeightAccumulator::size_type 
+WeightAccumulator::index( const std::string& name ) const
+{
+    WeightContainer::const_map_iterator m = m_sumw.find_name( name );
+    return m == m_sumw.map_end() ? size() : m->second;
+}
+
+double WeightAccumulator::mean( size_type i ) const
+{
+    if( m_entries == 0 ) return 0.;
+    return m_sumw.m_weights[i] / double(m_entries);
+}
+
+double WeightAccumulator::error_of_mean( size_type i ) const
+{
+    if( m_entries == 0 ) return 0.;
+    double n = double(m_entries);
+    double m = mean(i);
+    double var = m_sumw2[i]/n - m*m;
+    if( var < 0. ) var = 0.;	// rounding
+    return std::sqrt( var/n );
+}
+
+double WeightAccumulator::effective_entries( size_type i ) const
+{
+    if( m_sumw2[i] <= 0. ) return 0.;
+    return m_sumw.m_weights[i]*m_sumw.m_weights[i] / m_sumw2[i];
+}
+
+GenCrossSection WeightAccumulator::cross_section( size_type i ) const
+{
+    GenCrossSection xs;
+    xs.set_cross_section( mean(i), error_of_mean(i) );
+    return xs;
+}
+
+GenCrossSection WeightAccumulator::cross_section( const std::string& name ) const
+{
+    size_type i = index( name );
+    if( i == size() ) {
+        throw std::out_of_range("WeightAccumulator::cross_section ERROR: string "+name+" not found in WeightAccumulator" );
+    }
+    return cross_section( i );
+}
+
+void WeightAccumulator::write( std::ostream& ostr ) const
+{
+    ostr << "WeightAccumulator: " << m_entries << " events" << std::endl;
+    std::vector<std::string> names( size() );
+    for( WeightContainer::const_map_iterator m = m_sumw.map_begin(); 
+         m != m_sumw.map_end(); ++m ) {
+	if( m->second < size() ) names[m->second] = m->first;
+    }
+    for( size_type i = 0; i < size(); ++i ) {
+	ostr << "Weight " << std::setw(4) << i
+	     << " with name " << std::setw(10) << names[i]
+	     << " sum " << m_sumw.m_weights[i]
+	     << " mean " << mean(i) << " +- " << error_of_mean(i)
+	     << std::endl;
+    }
+}
+
+} // HepMC
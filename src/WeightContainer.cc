@@ -7,6 +7,7 @@
 // Basically just an interface to STL vector with extra map-like attributes
 //////////////////////////////////////////////////////////////////////////
 
+#include <atomic>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -19,33 +20,83 @@
 
 namespace HepMC {
 
+namespace {
+    // names of a container without a name table
+    const std::map<std::string,std::size_t> no_names;
+}
+
+/// the count is atomic, since the events read from one stream share a
+/// table and may be copied or destroyed in different threads; it is kept
+/// out of the header, which does not include <atomic>
+struct WeightContainer::NameTable {
+    NameTable() : names(), count(1) {}
+    NameTable( const name_map& n ) : names(n), count(1) {}
+    name_map         names;
+    std::atomic<int> count;
+};
+
+WeightContainer::NameTable* WeightContainer::acquire( NameTable* t )
+{
+    if( t ) t->count.fetch_add( 1, std::memory_order_relaxed );
+    return t;
+}
+
+void WeightContainer::release( NameTable* t )
+{
+    if( t && t->count.fetch_sub( 1, std::memory_order_acq_rel ) == 1 ) delete t;
+}
+
+WeightContainer::const_map_iterator WeightContainer::find_name( const std::string& s ) const
+{ return m_names ? m_names->names.find(s) : no_names.end(); }
+
 WeightContainer::WeightContainer( size_type n, double value ) 
-    : m_weights(n,value), m_names()
+    : m_weights(n,value), m_names(0)
 { set_default_names(n); }
 
 WeightContainer::WeightContainer( const std::vector<double>& wgts )
-    : m_weights(wgts), m_names()
+    : m_weights(wgts), m_names(0)
 { set_default_names(size()); }
 
 void WeightContainer::set_default_names( size_type n )
 {
     // internal program used by the constructors
+    if( n == 0 ) return;
+    name_map& names = unshared_names();
     std::ostringstream name;
     for ( size_type count = 0; count<n; ++count ) 
     { 
 	name.str(std::string());
 	name << count;
-	m_names[name.str()] = count;
+	names[name.str()] = count;
     }
 }
 
+WeightContainer::name_map& WeightContainer::unshared_names()
+{
+    // copy-on-write: never modify a table that someone else can see
+    if( !m_names ) {
+        m_names = new NameTable();
+    } else if( m_names->count.load( std::memory_order_acquire ) > 1 ) {
+        NameTable* mine = new NameTable( m_names->names );
+	release_names();
+	m_names = mine;
+    }
+    return m_names->names;
+}
+
+WeightContainer::const_map_iterator WeightContainer::map_begin() const
+{ return m_names ? m_names->names.begin() : no_names.begin(); }
+
+WeightContainer::const_map_iterator WeightContainer::map_end() const
+{ return m_names ? m_names->names.end() : no_names.end(); }
+
 void WeightContainer::push_back( const double& value) 
 { 
     size_type count = m_weights.size();
     m_weights.push_back(value); 
     std::ostringstream name;
     name << count;
-    m_names[name.str()] = count;
+    unshared_names()[name.str()] = count;
 }
 
 void WeightContainer::pop_back() 
@@ -53,36 +104,36 @@ void WeightContainer::pop_back()
     // this needs to remove the last entry in the vector 
     // and ALSO the associated map entry
     size_type vit = size() - 1;
-    for ( map_iterator m = m_names.begin(); m != m_names.end(); ++m ) 
+    for ( const_map_iterator m = map_begin(); m != map_end(); ++m ) 
     { 
         if( m->second == vit ) { 
-	    m_names.erase(m->first); 
+	    std::string name = m->first;
+	    unshared_names().erase(name); 
 	    break;
 	}
     }
+    if( m_names && m_names->names.empty() ) release_names();
     m_weights.pop_back(); 
 }
 
 double& WeightContainer::operator[]( const std::string& s ) 
 { 
-    const_map_iterator m = m_names.find(s);
-    if( m != m_names.end() ) {
+    const_map_iterator m = find_name(s);
+    if( m != map_end() ) {
         return m_weights[m->second]; 
     }
     // doesn't exist - have to create it
     size_type count = m_weights.size();
     m_weights.push_back(0); 
-    m_names[s] = count;
+    unshared_names()[s] = count;
     return m_weights.back(); 
 }
 
 
 const double& WeightContainer::operator[]( const std::string& s ) const
 { 
-    const_map_iterator m = m_names.find(s);
-    if( m != m_names.end() ) {
-        return m_weights[m->second]; 
-    }
+    const_map_iterator m = find_name(s);
+    if( m != map_end() ) return m_weights[m->second]; 
     // doesn't exist and we cannot create it
     // note that std::map does not support this (const) operator
     // throw an appropriate error, we choose the error thrown by std::vector
@@ -92,9 +143,12 @@ const double& WeightContainer::operator[]( const std::string& s ) const
 bool WeightContainer::operator==( const WeightContainer & other ) const
 {
    if( size() != other.size() ) { return false; }
-   if( m_names != other.m_names ) { return false; }
    if( m_weights != other.m_weights ) { return false; }
-   return true;
+   // identical tables need not be compared name by name
+   if( m_names == other.m_names ) { return true; }
+   const name_map& names = m_names ? m_names->names : no_names;
+   const name_map& other_names = other.m_names ? other.m_names->names : no_names;
+   return names == other_names;
 }
 
 bool WeightContainer::operator!=( const WeightContainer & other ) const
@@ -105,7 +159,17 @@ bool WeightContainer::operator!=( const WeightContainer & other ) const
 bool WeightContainer::has_key( const std::string& s ) const
 {
     // look up the name in the map
-    return m_names.find(s) != m_names.end();
+    return find_name(s) != map_end();
+}
+
+std::vector<std::string> WeightContainer::names() const
+{
+    std::vector<std::string> n( size() );
+    for ( const_map_iterator m = map_begin(); m != map_end(); ++m )
+    {
+	if( m->second < n.size() ) n[m->second] = m->first;
+    }
+    return n;
 }
 
 void WeightContainer::print( std::ostream& ostr ) const 
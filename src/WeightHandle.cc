@@ -0,0 +1,102 @@
+//////////////////////////////////////////////////////////////////////////
+// WeightHandle.cc
+//
+// a weight name resolved to its position in a WeightContainer
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "HepMC/WeightHandle.h"
+#include "HepMC/GenEvent.h"
+
+namespace HepMC {
+
+WeightHandle::WeightHandle()
+  : m_name(), m_table(0), m_index(npos())
+{}
+
+WeightHandle::WeightHandle( const std::string& name )
+  : m_name(name), m_table(0), m_index(npos())
+{}
+
+WeightHandle::WeightHandle( const std::string& name, const WeightContainer& names )
+  : m_name(name), m_table(0), m_index(npos())
+{ resolve( names ); }
+
+WeightHandle::WeightHandle( const std::string& name, std::istream& is )
+  : m_name(name), m_table(0), m_index(npos())
+{ resolve( is ); }
+
+WeightHandle::WeightHandle( const WeightHandle& in )
+  : m_name(in.m_name), m_table(WeightContainer::acquire( in.m_table )), 
+    m_index(in.m_index)
+{}
+
+WeightHandle::~WeightHandle()
+{ release(); }
+
+void WeightHandle::swap( WeightHandle& other )
+{
+    m_name.swap( other.m_name );
+    std::swap( m_table, other.m_table );
+    std::swap( m_index, other.m_index );
+}
+
+WeightHandle& WeightHandle::operator=( const WeightHandle& in )
+{
+    /// best practices implementation
+    WeightHandle tmp( in );
+    swap( tmp );
+    return *this;
+}
+
+void WeightHandle::release() const
+{
+    WeightContainer::release( m_table );
+    m_table = 0;
+}
+
+bool WeightHandle::resolve( const WeightContainer& names ) const
+{
+    // keep a reference to the table, so that it cannot be deleted 
+    // and replaced by another table at the same address
+    if( m_table != names.m_names ) {
+        release();
+	m_table = WeightContainer::acquire( names.m_names );
+    }
+    m_index = npos();
+    WeightContainer::const_map_iterator m = names.find_name( m_name );
+    if( m != names.map_end() ) m_index = m->second;
+    return is_found();
+}
+
+bool WeightHandle::resolve( std::istream& is ) const
+{
+    return resolve( stream_weight_names( is ) );
+}
+
+void WeightHandle::not_found() const
+{
+    throw std::out_of_range("WeightHandle ERROR: string "+m_name+" not found in  WeightContainer" );
+}
+
+void get_weights( const WeightContainer& w,
+                  const std::vector<WeightHandle>& handles,
+                  std::vector<double>& values )
+{
+    values.resize( handles.size() );
+    for( std::vector<WeightHandle>::size_type i = 0; i < handles.size(); ++i ) {
+        values[i] = handles[i].value( w );
+    }
+}
+
+std::vector<double> get_weights( const WeightContainer& w,
+                                 const std::vector<WeightHandle>& handles )
+{
+    std::vector<double> values;
+    get_weights( w, handles, values );
+    return values;
+}
+
+} // HepMC
@@ -0,0 +1,469 @@
+//////////////////////////////////////////////////////////////////////////
+// benchmarkHepMC.cc
+//
+// time the faster algorithms of HepMC against the ones they replace;
+// not one of the tests: build it with make check and run it by hand
+//////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include "HepMC/EventLibrary.h"
+#include "HepMC/EventPipeline.h"
+#include "HepMC/EventSlimmer.h"
+#include "HepMC/FlowIndex.h"
+#include "HepMC/GenEvent.h"
+#include "HepMC/GenEventPool.h"
+#include "HepMC/GenEventValidator.h"
+#include "HepMC/GraphTraversal.h"
+#include "HepMC/HEPEVT_Wrapper.h"
+#include "HepMC/IO_GenEvent.h"
+#include "HepMC/IO_HEPEVT.h"
+#include "HepMC/ParallelAlgorithms.h"
+#include "HepMC/PileupOverlay.h"
+#include "HepMC/SharedEvent.h"
+#include "HepMC/TruthSkimmer.h"
+
+#include "testEvents.h"
+
+// the common block, which a fortran generator would otherwise provide
+decltype(hepevt) hepevt;
+
+double seconds( std::chrono::steady_clock::time_point t0 )
+{
+    return std::chrono::duration<double>( std::chrono::steady_clock::now() - t0 ).count();
+}
+
+// descendants of the first vertex with the iterators, GraphTraversal,
+// GraphSnapshot, and ancestor queries with the genealogy index
+void time_graphs()
+{
+    HepMC::GenEvent* evt = build_shower( 20000, true );
+    HepMC::GenVertex* root = evt->barcode_to_vertex(-1);
+    const int repeat = 20;
+    std::size_t nold = 0, nwalk = 0, nsnap = 0;
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for( int i = 0; i < repeat; ++i ) {
+	for( HepMC::GenVertex::particle_iterator p = root->particles_begin(HepMC::descendants);
+	     p != root->particles_end(HepMC::descendants); ++p ) ++nold;
+    }
+    double iterator_time = seconds( t0 );
+    HepMC::GraphTraversal walk;
+    t0 = std::chrono::steady_clock::now();
+    for( int i = 0; i < repeat; ++i ) nwalk += walk.particles( *root, HepMC::descendants ).size();
+    double walk_time = seconds( t0 );
+    t0 = std::chrono::steady_clock::now();
+    HepMC::GraphSnapshot g( *evt );
+    double build_time = seconds( t0 );
+    std::vector<int> found;
+    t0 = std::chrono::steady_clock::now();
+    for( int i = 0; i < repeat; ++i ) {
+	g.vertices( g.index( root ), HepMC::descendants, found );
+	for( std::size_t k = 0; k < found.size(); ++k ) nsnap += g.particles_out_size( found[k] );
+    }
+    double snapshot_time = seconds( t0 );
+    if( nwalk != nold || nsnap != nold ) std::cerr << "ERROR: descendants differ" << std::endl;
+    std::cout << "descendants of " << evt->vertices_size() << " vertices, " << repeat
+              << " times: particle_iterator " << iterator_time << " s, GraphTraversal "
+              << walk_time << " s, GraphSnapshot " << snapshot_time
+              << " s after building it in " << build_time << " s" << std::endl;
+    delete evt;
+
+    evt = build_shower( 10000 );
+    HepMC::GenParticle* first = *evt->barcode_to_vertex(-1)->particles_out_const_begin();
+    std::vector<HepMC::GenParticle*> sample;
+    for( HepMC::GenEvent::particle_iterator p = evt->particles_begin();
+         p != evt->particles_end(); ++p ) {
+	if( (*p)->barcode() % 100 == 0 ) sample.push_back( *p );
+    }
+    nold = 0;
+    t0 = std::chrono::steady_clock::now();
+    for( std::size_t i = 0; i < sample.size(); ++i ) {
+	HepMC::GenVertex* v = sample[i]->production_vertex();
+	std::set<const HepMC::GenParticle*> anc;
+	for( HepMC::GenVertex::particle_iterator p = v->particles_begin(HepMC::ancestors);
+	     p != v->particles_end(HepMC::ancestors); ++p ) anc.insert( *p );
+	if( anc.count( first ) ) ++nold;
+    }
+    iterator_time = seconds( t0 );
+    t0 = std::chrono::steady_clock::now();
+    evt->build_genealogy_index();
+    build_time = seconds( t0 );
+    std::size_t nnew = 0;
+    t0 = std::chrono::steady_clock::now();
+    for( std::size_t i = 0; i < sample.size(); ++i ) {
+	if( evt->is_ancestor( first, sample[i] ) ) ++nnew;
+    }
+    double index_time = seconds( t0 );
+    if( nnew != nold ) std::cerr << "ERROR: ancestors differ" << std::endl;
+    std::cout << sample.size() << " ancestor queries in " << evt->vertices_size()
+              << " vertices: particle_iterator " << iterator_time << " s, genealogy index "
+              << index_time << " s after building it in " << build_time << " s" << std::endl;
+    delete evt;
+}
+
+// a long colour line with Flow and FlowIndex
+void time_flow()
+{
+    HepMC::GenEvent* evt = new HepMC::GenEvent( 20, 2 );
+    const int length = 50000;
+    HepMC::GenParticle* q = new HepMC::GenParticle( HepMC::FourVector(0,0,1,1), 1, 3 );
+    q->set_flow( 1, 501 );
+    HepMC::GenParticle* first = q;
+    for( int i = 0; i < length; ++i ) {
+	HepMC::GenVertex* v = new HepMC::GenVertex();
+	evt->add_vertex( v );
+	v->add_particle_in( q );
+	q = new HepMC::GenParticle( HepMC::FourVector(0,0,1,1), 1, 2 );
+	q->set_flow( 1, 501 );
+	v->add_particle_out( q );
+	v->add_particle_out( new HepMC::GenParticle( HepMC::FourVector(0,0,1,1), 22, 1 ) );
+    }
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    std::size_t nflow = first->flow().connected_partners( 501 ).size();
+    first->flow().dangling_connected_partners( 501 );
+    double flow_time = seconds( t0 );
+    t0 = std::chrono::steady_clock::now();
+    HepMC::FlowIndex line( *evt );
+    double index_time = seconds( t0 );
+    if( line.size() != 1 || line.line(0).partners.size() != nflow ) {
+	std::cerr << "ERROR: colour lines differ" << std::endl;
+    }
+    std::cout << "colour line of " << length + 1 << " particles: Flow " << flow_time
+              << " s, FlowIndex " << index_time << " s" << std::endl;
+    delete evt;
+}
+
+// validation, momentum conservation and fingerprint with 1 and 4 threads
+void time_parallel()
+{
+    HepMC::GenEvent* evt = make_balanced_shower( 50000 );
+    HepMC::ThreadPool one( 1 ), four( 4 );
+    HepMC::GenEventValidator serial( HepMC::GenEventValidator::all_checks, 1e-9, one );
+    HepMC::GenEventValidator validator( HepMC::GenEventValidator::all_checks, 1e-9, four );
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    std::size_t n1 = serial.validate( *evt ).size();
+    double serial_time = seconds( t0 );
+    t0 = std::chrono::steady_clock::now();
+    std::size_t n4 = validator.validate( *evt ).size();
+    double parallel_time = seconds( t0 );
+    if( n1 != 0 || n4 != 0 ) std::cerr << "ERROR: problems found in a valid event" << std::endl;
+    std::cout << "validation of " << evt->vertices_size() << " vertices: 1 thread "
+              << serial_time << " s, 4 threads " << parallel_time << " s" << std::endl;
+
+    HepMC::GraphSnapshot g( *evt );
+    const unsigned sizes[4] = { 1, 2, 3, 8 };
+    std::cout << "momentum conservation of " << g.vertices_size() << " vertices:";
+    for( int s = 0; s < 4; ++s ) {
+	HepMC::ThreadPool pool( sizes[s] );
+	t0 = std::chrono::steady_clock::now();
+	for( int i = 0; i < 20; ++i ) HepMC::parallel_check_momentum_conservation( g, 1e-9, pool );
+	std::cout << " " << sizes[s] << " threads " << seconds( t0 ) << " s";
+    }
+    std::cout << std::endl;
+
+    t0 = std::chrono::steady_clock::now();
+    HepMC::EventFingerprint f = evt->fingerprint();
+    serial_time = seconds( t0 );
+    t0 = std::chrono::steady_clock::now();
+    HepMC::EventFingerprint pf = HepMC::parallel_fingerprint( *evt, 0, four );
+    parallel_time = seconds( t0 );
+    if( f != pf ) std::cerr << "ERROR: fingerprints differ" << std::endl;
+    std::cout << "fingerprint of " << evt->particles_size() << " particles: "
+              << serial_time << " s, 4 threads " << parallel_time << " s" << std::endl;
+    delete evt;
+}
+
+// EventSlimmer and TruthSkimmer against one particle or one walk at a time
+void time_slimming()
+{
+    for( int nvertices = 5000; nvertices <= 50000; nvertices *= 10 ) {
+	HepMC::GenEvent* evt = make_balanced_shower( nvertices );
+	int before = evt->particles_size();
+	HepMC::EventSlimmer slimmer( [] ( const HepMC::GenParticle* p ) {
+		return p->status() != 2 || p->barcode() % 3 == 0; } );
+	std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+	slimmer.slim( *evt );
+	std::cout << "slimming " << before << " particles to " << evt->particles_size()
+	          << ": EventSlimmer " << seconds( t0 ) << " s" << std::endl;
+	delete evt;
+    }
+
+    HepMC::GenEvent* evt = make_balanced_shower( 25000 );
+    std::vector<const HepMC::GenParticle*> seeds;
+    for( int bc = 10100; bc < 60000; bc += 500 ) seeds.push_back( evt->barcode_to_particle( bc ) );
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    std::set<const HepMC::GenParticle*> kept;
+    for( std::size_t i = 0; i < seeds.size(); ++i ) {
+	HepMC::GenVertex* v = seeds[i]->production_vertex();
+	kept.insert( seeds[i] );
+	for( HepMC::GenVertex::particle_iterator p = v->particles_begin(HepMC::ancestors);
+	     p != v->particles_end(HepMC::ancestors); ++p ) kept.insert( *p );
+    }
+    double iterator_time = seconds( t0 );
+    HepMC::TruthSkimmer skimmer;
+    HepMC::GenEvent skim;
+    t0 = std::chrono::steady_clock::now();
+    std::size_t n = skimmer.skim( *evt, seeds, skim );
+    std::cout << seeds.size() << " seeds in " << evt->particles_size() << " particles, keeping "
+              << n << ": iterators " << iterator_time << " s (without copying), TruthSkimmer "
+              << seconds( t0 ) << " s" << std::endl;
+    delete evt;
+}
+
+// new and delete against GenEventPool, copies against SharedEvent,
+// and GenEvent::swap for events of any size
+void time_events()
+{
+    const int nevents = 5000;
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for( int i = 0; i < nevents; ++i ) {
+	HepMC::GenEvent* evt = make_star_event( i, 50 );
+	delete evt;
+    }
+    double plain_time = seconds( t0 );
+    HepMC::GenEventPool pool;
+    t0 = std::chrono::steady_clock::now();
+    for( int i = 0; i < nevents; ++i ) {
+	HepMC::GenEvent* evt = pool.acquire();
+	fill_star_event( evt, i, 50 );
+	pool.release( evt );
+    }
+    std::cout << nevents << " events: new and delete " << plain_time
+              << " s, GenEventPool " << seconds( t0 ) << " s" << std::endl;
+
+    const int nshared = 200, nanalyses = 5;
+    double copied = 0, shared = 0;
+    t0 = std::chrono::steady_clock::now();
+    for( int i = 0; i < nshared; ++i ) {
+	HepMC::GenEvent* evt = make_star_event( i, 500 );
+	for( int a = 0; a < nanalyses; ++a ) {
+	    HepMC::GenEvent copy( *evt );
+	    copied += copy.particles_size();
+	}
+	delete evt;
+    }
+    double copy_time = seconds( t0 );
+    t0 = std::chrono::steady_clock::now();
+    for( int i = 0; i < nshared; ++i ) {
+	HepMC::SharedEvent evt( make_star_event( i, 500 ) );
+	for( int a = 0; a < nanalyses; ++a ) {
+	    HepMC::SharedEvent copy( evt );
+	    shared += copy->particles_size();
+	}
+    }
+    if( copied != shared ) std::cerr << "ERROR: shared and copied events differ" << std::endl;
+    std::cout << nshared << " events, " << nanalyses << " analyses: copies "
+              << copy_time << " s, shared " << seconds( t0 ) << " s" << std::endl;
+
+    HepMC::GenEvent* small_1 = make_chain_event( 1, 1 );
+    HepMC::GenEvent* small_2 = make_chain_event( 2, 1 );
+    HepMC::GenEvent* large_1 = make_chain_event( 3, 50000 );
+    HepMC::GenEvent* large_2 = make_chain_event( 4, 50000 );
+    const int nswaps = 100000;
+    t0 = std::chrono::steady_clock::now();
+    for( int i = 0; i < nswaps; ++i ) small_1->swap( *small_2 );
+    double small_time = seconds( t0 );
+    t0 = std::chrono::steady_clock::now();
+    for( int i = 0; i < nswaps; ++i ) large_1->swap( *large_2 );
+    std::cout << nswaps << " swaps: " << small_1->vertices_size() << " vertices "
+              << small_time << " s, " << large_1->vertices_size() << " vertices "
+              << seconds( t0 ) << " s" << std::endl;
+    delete small_1;
+    delete small_2;
+    delete large_1;
+    delete large_2;
+}
+
+// moving vertices one by one against splice and PileupOverlay
+void time_merging()
+{
+    const int depth = 14;
+    HepMC::GenEvent* from = make_tree_event( 1, depth );
+    HepMC::GenEvent* to = make_tree_event( 2, 2 );
+    HepMC::GenVertex* start = from->signal_process_vertex();
+    std::vector<HepMC::GenVertex*> vertices;
+    for( HepMC::GenVertex::vertex_iterator v = start->vertices_begin( HepMC::descendants );
+	 v != start->vertices_end( HepMC::descendants ); ++v ) vertices.push_back( *v );
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for( std::size_t i = 0; i < vertices.size(); ++i ) to->add_vertex( vertices[i] );
+    double add_vertex_time = seconds( t0 );
+    delete from;
+    delete to;
+    from = make_tree_event( 1, depth );
+    to = make_tree_event( 2, 2 );
+    t0 = std::chrono::steady_clock::now();
+    to->splice( from->signal_process_vertex(), *from, HepMC::GenEvent::offset_barcodes );
+    std::cout << vertices.size() << " vertices: add_vertex " << add_vertex_time
+              << " s, splice " << seconds( t0 ) << " s" << std::endl;
+    delete from;
+    delete to;
+
+    const int npileup = 200, ndecays = 100;
+    std::vector<HepMC::GenEvent*> minbias;
+    for( int i = 0; i < npileup; ++i ) minbias.push_back( make_chain_event( i, ndecays ) );
+    HepMC::GenEvent* merged = make_chain_event( 0, ndecays );
+    t0 = std::chrono::steady_clock::now();
+    for( int i = 0; i < npileup; ++i ) {
+	std::vector<HepMC::GenVertex*> moved( minbias[i]->vertices_begin(), minbias[i]->vertices_end() );
+	for( std::size_t j = 0; j < moved.size(); ++j ) merged->add_vertex( moved[j] );
+    }
+    add_vertex_time = seconds( t0 );
+    int nparticles = merged->particles_size();
+    delete merged;
+    for( int i = 0; i < npileup; ++i ) delete minbias[i];
+    for( int i = 0; i < npileup; ++i ) minbias[i] = make_chain_event( i, ndecays );
+    merged = make_chain_event( 0, ndecays );
+    t0 = std::chrono::steady_clock::now();
+    HepMC::PileupOverlay overlay( *merged );
+    for( int i = 0; i < npileup; ++i ) overlay.add( *minbias[i], HepMC::FourVector( 0, 0, i, i ) );
+    std::cout << npileup << " events overlaid, " << nparticles << " particles: add_vertex "
+              << add_vertex_time << " s, PileupOverlay " << seconds( t0 ) << " s" << std::endl;
+    delete merged;
+    for( int i = 0; i < npileup; ++i ) delete minbias[i];
+}
+
+// an input which makes events, with a shower of nparticles particles
+class EventSource : public HepMC::IO_BaseClass {
+public:
+    EventSource( int nevents, int nparticles ) : m_left(nevents), m_number(0), m_nparticles(nparticles) {}
+    bool fill_next_event( HepMC::GenEvent* evt )
+    {
+	if ( m_left-- <= 0 ) return false;
+	fill_star_event( evt, ++m_number, m_nparticles );
+	return true;
+    }
+    void write_event( const HepMC::GenEvent* ) {}
+private:
+    int m_left;
+    int m_number;
+    int m_nparticles;
+};
+
+// some work on each event
+bool scale_energies( HepMC::GenEvent* evt )
+{
+    for ( HepMC::GenEvent::particle_iterator p = evt->particles_begin();
+	  p != evt->particles_end(); ++p ) {
+	HepMC::FourVector m = (*p)->momentum();
+	double f = 1;
+	for ( int i = 0; i < 50; ++i ) f = std::sqrt( f + 2 );
+	(*p)->set_momentum( HepMC::FourVector( m.px(), m.py(), m.pz(), f * m.e() ) );
+    }
+    return true;
+}
+
+// a serial loop against EventPipeline, and reading a file against
+// sampling an EventLibrary
+void time_input()
+{
+    const int nevents = 3000;
+    EventSource serial_source( nevents, 100 );
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for ( HepMC::GenEvent* evt = serial_source.read_next_event(); evt;
+	  evt = serial_source.read_next_event() ) {
+	scale_energies( evt );
+	delete evt;
+    }
+    double serial_time = seconds( t0 );
+    EventSource source( nevents, 100 );
+    HepMC::EventPipeline pipeline( source, 0, scale_energies, 4 );
+    t0 = std::chrono::steady_clock::now();
+    pipeline.run();
+    std::cout << nevents << " events: serial " << serial_time
+              << " s, pipeline with 4 workers " << seconds( t0 ) << " s" << std::endl;
+
+    const int nlibrary = 300;
+    std::ostringstream file;
+    {
+	HepMC::IO_GenEvent out( file );
+	for ( int i = 1; i <= nlibrary; ++i ) {
+	    HepMC::GenEvent* evt = make_chain_event( i, 20 + i % 30 );
+	    out << evt;
+	    delete evt;
+	}
+    }
+    std::istringstream input( file.str() );
+    HepMC::IO_GenEvent in( input );
+    t0 = std::chrono::steady_clock::now();
+    for ( HepMC::GenEvent* evt = in.read_next_event(); evt; evt = in.read_next_event() ) delete evt;
+    double read_time = seconds( t0 );
+    std::istringstream again( file.str() );
+    HepMC::IO_GenEvent reread( again );
+    HepMC::EventLibrary library;
+    library.load( reread );
+    HepMC::GenEvent reused;
+    t0 = std::chrono::steady_clock::now();
+    for ( std::size_t i = 0; i < library.size(); ++i ) library.fill_event( i, &reused );
+    std::cout << nlibrary << " events in " << library.memory_size() << " bytes: read "
+              << read_time << " s, sampled " << seconds( t0 ) << " s" << std::endl;
+}
+
+// reading the HEPEVT common block with the wrapper and the layout, and
+// IO_HEPEVT::write_event for several event sizes
+void time_hepevt()
+{
+    typedef HepMC::HEPEVT_Wrapper W;
+    const int nentries = 10000, nrepeat = 20;
+    W::set_sizeof_int( sizeof(int) );
+    W::set_sizeof_real( sizeof(double) );
+    W::set_max_number_entries( nentries );
+    HepMC::HEPEVT_Layout<int,double> block = W::layout<int,double>();
+    block.zero_everything();
+    block.set_number_entries( nentries );
+    for ( int i = 1; i <= nentries; ++i ) {
+	block.set_id( i, 211 );
+	block.set_parents( i, i / 2, i / 2 );
+	block.set_momentum( i, i, 0, 0, i );
+	block.set_position( i, 0, 0, i, i );
+    }
+    double wrapper_sum = 0, layout_sum = 0;
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for ( int r = 0; r < nrepeat; ++r ) {
+	for ( int i = 1; i <= W::number_entries(); ++i ) {
+	    wrapper_sum += W::status(i) + W::id(i) + W::first_parent(i) + W::last_parent(i)
+		+ W::px(i) + W::py(i) + W::pz(i) + W::e(i) + W::m(i)
+		+ W::x(i) + W::y(i) + W::z(i) + W::t(i);
+	}
+    }
+    double wrapper_time = seconds( t0 );
+    t0 = std::chrono::steady_clock::now();
+    for ( int r = 0; r < nrepeat; ++r ) {
+	for ( int i = 1; i <= block.number_entries(); ++i ) {
+	    layout_sum += block.status(i) + block.id(i) + block.first_parent(i) + block.last_parent(i)
+		+ block.px(i) + block.py(i) + block.pz(i) + block.e(i) + block.m(i)
+		+ block.x(i) + block.y(i) + block.z(i) + block.t(i);
+	}
+    }
+    if ( wrapper_sum != layout_sum ) std::cerr << "ERROR: HEPEVT sums differ" << std::endl;
+    std::cout << nentries << " entries: HEPEVT_Wrapper " << wrapper_time / nrepeat
+              << " s, HEPEVT_Layout " << seconds( t0 ) / nrepeat << " s" << std::endl;
+
+    W::set_max_number_entries( 40000 );
+    HepMC::IO_HEPEVT io;
+    for ( int depth = 8; depth <= 14; depth += 2 ) {
+	HepMC::GenEvent* evt = make_tree_event( 1, depth );
+	t0 = std::chrono::steady_clock::now();
+	for ( int r = 0; r < nrepeat; ++r ) io.write_event( evt );
+	std::cout << W::number_entries() << " entries: write_event "
+	          << seconds( t0 ) / nrepeat << " s" << std::endl;
+	delete evt;
+    }
+}
+
+int main()
+{
+    time_graphs();
+    time_flow();
+    time_parallel();
+    time_slimming();
+    time_events();
+    time_merging();
+    time_input();
+    time_hepevt();
+    return 0;
+}
@@ -0,0 +1,118 @@
+//////////////////////////////////////////////////////////////////////////
+// testCompareGenEvent.cc
+//
+// check the differences reported by compareGenEvent with a tolerance
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/CompareGenEvent.h"
+
+// a hard process with a two body decay of each outgoing particle
+HepMC::GenEvent* build_event()
+{
+    HepMC::GenEvent* evt = new HepMC::GenEvent( 20, 1 );
+    evt->weights().push_back( 1.0 );
+    evt->weights().push_back( 0.5 );
+    HepMC::GenVertex* v0 = new HepMC::GenVertex( HepMC::FourVector(0,0,0,0) );
+    evt->add_vertex( v0 );
+    evt->set_signal_process_vertex( v0 );
+    HepMC::GenParticle* b1 = new HepMC::GenParticle( HepMC::FourVector(0,0,100,100), 2212, 4 );
+    HepMC::GenParticle* b2 = new HepMC::GenParticle( HepMC::FourVector(0,0,-100,100), 2212, 4 );
+    v0->add_particle_in( b1 );
+    v0->add_particle_in( b2 );
+    evt->set_beam_particles( b1, b2 );
+    for( int i = 0; i < 2; ++i ) {
+	HepMC::GenParticle* p = new HepMC::GenParticle( HepMC::FourVector(i ? -20 : 20,0,0,80), 23, 2 );
+	v0->add_particle_out( p );
+	HepMC::GenVertex* v = new HepMC::GenVertex( HepMC::FourVector(0,0,0.1*i,0.1) );
+	evt->add_vertex( v );
+	v->add_particle_in( p );
+	v->add_particle_out( new HepMC::GenParticle( HepMC::FourVector(10,0,30,40), 13, 1 ) );
+	v->add_particle_out( new HepMC::GenParticle( HepMC::FourVector(10,0,-30,40), -13, 1 ) );
+    }
+    return evt;
+}
+
+int check( bool expect_equal, const HepMC::GenEvent& e1, const HepMC::GenEvent& e2,
+           double tolerance, std::size_t ndifferences, const std::string& field,
+           const std::string& what )
+{
+    std::vector<HepMC::GenEventDifference> d;
+    bool equal = HepMC::compareGenEvent( e1, e2, tolerance, d );
+    if( equal != expect_equal || d.size() != ndifferences
+	|| ( !d.empty() && d[0].field != field ) ) {
+	std::cerr << "ERROR: " << what << ": " << d.size() << " differences, expected "
+	          << ndifferences << std::endl;
+	HepMC::printDifferences( d, std::cerr );
+	return 1;
+    }
+    return 0;
+}
+
+int main()
+{
+    int numbad = 0;
+    HepMC::GenEvent* evt = build_event();
+    HepMC::GenEvent* copy = new HepMC::GenEvent( *evt );
+    numbad += check( true, *evt, *copy, 0, 0, "", "copy" );
+
+    // a small change of momentum, within and beyond the tolerance
+    HepMC::GenParticle* p = copy->barcode_to_particle( 10003 );
+    p->set_momentum( HepMC::FourVector( 20 * ( 1 + 1e-9 ), 0, 0, 80 ) );
+    numbad += check( false, *evt, *copy, 0, 1, "momentum", "exact momentum" );
+    numbad += check( true, *evt, *copy, 1e-6, 0, "", "momentum within tolerance" );
+    copy->barcode_to_vertex( -2 )->set_position( HepMC::FourVector( 0, 0, 0, 0.2 ) );
+    numbad += check( false, *evt, *copy, 1e-6, 1, "position", "vertex position" );
+    delete copy;
+
+    // event information
+    copy = new HepMC::GenEvent( *evt );
+    copy->weights()[1] = 0.25;
+    numbad += check( false, *evt, *copy, 1e-6, 1, "weights", "weights" );
+    copy->set_event_number( 2 );
+    numbad += check( false, *evt, *copy, 1e-6, 2, "event_number", "event number" );
+    delete copy;
+
+    // a particle moved to another vertex
+    copy = new HepMC::GenEvent( *evt );
+    copy->barcode_to_vertex( -3 )->add_particle_out( copy->barcode_to_particle( 10004 ) );
+    numbad += check( false, *evt, *copy, 0, 3, "production_vertex", "moved particle" );
+
+    // missing particles, and the maximum number of differences
+    delete copy->barcode_to_vertex( -3 )->remove_particle( copy->barcode_to_particle( 10008 ) );
+    std::vector<HepMC::GenEventDifference> d;
+    if( HepMC::compareGenEvent( *evt, *copy, 0, d, 2 ) || d.size() != 2 ) {
+	std::cerr << "ERROR: " << d.size() << " differences kept, not 2" << std::endl;
+	++numbad;
+    }
+    d.clear();
+    HepMC::compareParticles( *evt, *copy, 0, d );
+    bool missing = false;
+    for( std::size_t i = 0; i < d.size(); ++i ) {
+	if( d[i].field == "presence" && d[i].barcode == 10008 && d[i].second == "absent" ) missing = true;
+    }
+    if( !missing ) {
+	std::cerr << "ERROR: missing particle not reported" << std::endl;
+	HepMC::printDifferences( d, std::cerr );
+	++numbad;
+    }
+    // the older comparisons give the same answers, and print what differs
+    HepMC::GenEvent* same = new HepMC::GenEvent( *evt );
+    std::cerr << "expect differences from compareGenEvent and compareParticles:" << std::endl;
+    if( !HepMC::compareGenEvent( evt, same ) || HepMC::compareGenEvent( evt, copy ) ||
+        !HepMC::compareVertices( evt, same ) || HepMC::compareParticles( evt, copy ) ||
+	!HepMC::compareWeights( evt, copy ) ) {
+	std::cerr << "ERROR: compareGenEvent without tolerance disagrees" << std::endl;
+	++numbad;
+    }
+    delete same;
+    delete copy;
+    delete evt;
+
+    if( numbad > 0 ) std::cerr << numbad << " errors in testCompareGenEvent" << std::endl;
+    return numbad;
+}
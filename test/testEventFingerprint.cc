@@ -0,0 +1,99 @@
+//////////////////////////////////////////////////////////////////////////
+// testEventFingerprint.cc
+//
+// the fingerprint ignores storage order but sees every change of content,
+// and the parallel fingerprint is the same as the serial one
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <sstream>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/IO_GenEvent.h"
+#include "HepMC/ParallelAlgorithms.h"
+
+#include "testEvents.h"
+
+int expect( bool same, const HepMC::EventFingerprint& a, const HepMC::EventFingerprint& b,
+            const char* what )
+{
+    if( ( a == b ) == same ) return 0;
+    std::cerr << "ERROR: " << what << ": " << a << " and " << b 
+              << ( same ? " differ" : " are equal" ) << std::endl;
+    return 1;
+}
+
+int main()
+{
+    int numbad = 0;
+    HepMC::GenEvent* evt = make_balanced_shower( 2000 );
+    HepMC::EventFingerprint f = evt->fingerprint();
+    if( f.str().size() != 32 ) ++numbad;
+
+    // storage order does not matter
+    HepMC::GenEvent* rev = make_balanced_shower( 2000, true );
+    numbad += expect( true, f, rev->fingerprint(), "reversed particle order" );
+    HepMC::GenEvent* copy = new HepMC::GenEvent( *evt );
+    numbad += expect( true, f, copy->fingerprint(), "copied event" );
+    delete rev;
+
+    // the parallel fingerprint is the same
+    HepMC::ThreadPool one( 1 ), four( 4 );
+    numbad += expect( true, f, HepMC::parallel_fingerprint( *evt, 0, one ), "1 thread" );
+    numbad += expect( true, f, HepMC::parallel_fingerprint( *evt, 0, four ), "4 threads" );
+    numbad += expect( true, evt->fingerprint( 1e-3 ), 
+                      HepMC::parallel_fingerprint( *evt, 1e-3, four ), "4 threads, rounded" );
+
+    // every change of content is seen
+    HepMC::GenParticle* p = copy->barcode_to_particle( 11001 );
+    HepMC::FourVector m = p->momentum();
+    p->set_momentum( HepMC::FourVector( m.px() + 1e-10, m.py(), m.pz(), m.e() ) );
+    numbad += expect( false, f, copy->fingerprint(), "momentum change" );
+    numbad += expect( true, evt->fingerprint( 1e-3 ), copy->fingerprint( 1e-3 ),
+                      "momentum change within tolerance" );
+    p->set_momentum( m );
+    p->set_status( 3 );
+    numbad += expect( false, f, copy->fingerprint(), "status change" );
+    p->set_status( evt->barcode_to_particle( 11001 )->status() );
+    p->set_flow( 1, 501 );
+    numbad += expect( false, f, copy->fingerprint(), "flow change" );
+    delete copy;
+    copy = new HepMC::GenEvent( *evt );
+    // move a final particle to another vertex
+    HepMC::GenParticle* moved = copy->barcode_to_particle( 13999 );
+    copy->barcode_to_vertex( -1500 )->add_particle_out( moved );
+    numbad += expect( false, f, copy->fingerprint(), "particle moved" );
+    delete copy;
+    copy = new HepMC::GenEvent( *evt );
+    copy->set_event_number( 2 );
+    numbad += expect( false, f, copy->fingerprint(), "event number" );
+    delete copy;
+
+    // a round trip through a file keeps the fingerprint within rounding
+    std::ostringstream file;
+    {
+	HepMC::IO_GenEvent out( file );
+	out << evt;
+    }
+    std::istringstream input( file.str() );
+    HepMC::IO_GenEvent in( input );
+    HepMC::GenEvent* back = in.read_next_event();
+    if( !back ) {
+	std::cerr << "ERROR: event not read back" << std::endl;
+	++numbad;
+    } else {
+	numbad += expect( true, evt->fingerprint( 1e-6 ), back->fingerprint( 1e-6 ),
+	                  "event read back" );
+    }
+    delete back;
+    delete evt;
+
+    // an event larger than the grain of the parallel loops
+    evt = make_balanced_shower( 5000 );
+    f = evt->fingerprint();
+    numbad += expect( true, f, HepMC::parallel_fingerprint( *evt, 0, four ), "large event" );
+    delete evt;
+
+    if( numbad > 0 ) std::cerr << numbad << " errors in testEventFingerprint" << std::endl;
+    return numbad;
+}
@@ -0,0 +1,132 @@
+//////////////////////////////////////////////////////////////////////////
+// testEventLibrary.cc
+//
+// check that EventLibrary gives back the events it was loaded with, also
+// to several threads at once
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "HepMC/EventLibrary.h"
+#include "HepMC/GenEvent.h"
+#include "HepMC/IO_GenEvent.h"
+#include "HepMC/PileupOverlay.h"
+
+#include "testEvents.h"
+
+// a chain of decays whose length depends on the number
+HepMC::GenEvent* make_event( int number )
+{
+    HepMC::GenEvent* evt = make_chain_event( number, 20 + number % 30 );
+    evt->set_event_scale( 2.5 * number );
+    evt->set_mpi( number % 7 );
+    return evt;
+}
+
+int main()
+{
+    int numbad = 0;
+    const int nevents = 300;
+
+    // a file of events, and the fingerprints of the events read from it
+    std::ostringstream file;
+    {
+	HepMC::IO_GenEvent out( file );
+	for ( int i = 1; i <= nevents; ++i ) {
+	    HepMC::GenEvent* evt = make_event( i );
+	    out << evt;
+	    delete evt;
+	}
+    }
+    std::vector<HepMC::EventFingerprint> expect;
+    std::istringstream input( file.str() );
+    HepMC::IO_GenEvent in( input );
+    for ( HepMC::GenEvent* evt = in.read_next_event(); evt; evt = in.read_next_event() ) {
+	expect.push_back( evt->fingerprint() );
+	delete evt;
+    }
+
+    // load the library, and get each event back
+    std::istringstream again( file.str() );
+    HepMC::IO_GenEvent reread( again );
+    HepMC::EventLibrary library;
+    if ( library.load( reread, 10 ) != 10 || library.load( reread ) != (std::size_t)nevents - 10
+	 || library.size() != (std::size_t)nevents ) {
+	std::cerr << "ERROR: library has " << library.size() << " events, not " << nevents << std::endl;
+	++numbad;
+    }
+    HepMC::GenEvent reused;
+    for ( std::size_t i = 0; i < library.size(); ++i ) {
+	HepMC::GenEvent* evt = library.event( i );
+	library.fill_event( i, &reused );
+	if ( evt->fingerprint() != expect[i] || reused.fingerprint() != expect[i]
+	     || evt->beam_particles().second->momentum().pz() != -7000
+	     || evt->signal_process_vertex()->barcode() != -1
+	     || library.particles_size( i ) != evt->particles_size() ) {
+	    std::cerr << "ERROR: event " << i << " from the library differs" << std::endl;
+	    ++numbad;
+	}
+	delete evt;
+    }
+
+    // nothing to draw from an empty library
+    HepMC::EventLibrary none;
+    std::mt19937 engine;
+    bool thrown = false;
+    try {
+	none.random_index( engine );
+    } catch ( std::range_error& ) {
+	thrown = true;
+    }
+    if ( !thrown ) {
+	std::cerr << "ERROR: random_index of an empty library" << std::endl;
+	++numbad;
+    }
+
+    // several threads sampling at random
+    const int nthreads = 4, nsamples = 500;
+    std::vector<int> errors( nthreads, 0 );
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < nthreads; ++t ) {
+	threads.push_back( std::thread( [&, t]() {
+		std::mt19937 engine( t + 1 );
+		HepMC::GenEvent evt;
+		for ( int n = 0; n < nsamples; ++n ) {
+		    std::size_t i = library.random_index( engine );
+		    library.fill_event( i, &evt );
+		    if ( evt.fingerprint() != expect[i] ) ++errors[t];
+		}
+	    } ) );
+    }
+    for ( int t = 0; t < nthreads; ++t ) {
+	threads[t].join();
+	if ( errors[t] ) {
+	    std::cerr << "ERROR: thread " << t << " sampled " << errors[t] << " wrong events" << std::endl;
+	    ++numbad;
+	}
+    }
+
+    // overlay directly from the library
+    HepMC::GenEvent* signal = make_event( 0 );
+    int expect_particles = signal->particles_size();
+    HepMC::PileupOverlay overlay( *signal );
+    for ( std::size_t i = 0; i < 50; ++i ) {
+	library.overlay( i, overlay, HepMC::FourVector( 0, 0, 1, 1 ) );
+	expect_particles += library.particles_size( i );
+    }
+    if ( signal->particles_size() != expect_particles || overlay.sub_events_size() != 51
+	 || overlay.sub_event( signal->barcode_to_particle( signal->particles_size() + 10000 ) ) != 50 ) {
+	std::cerr << "ERROR: overlay from the library has " << signal->particles_size()
+	          << " particles, not " << expect_particles << std::endl;
+	++numbad;
+    }
+    delete signal;
+
+    if ( numbad > 0 ) std::cerr << numbad << " errors in testEventLibrary" << std::endl;
+    return numbad;
+}
@@ -0,0 +1,166 @@
+//////////////////////////////////////////////////////////////////////////
+// testEventPipeline.cc
+//
+// check that EventPipeline processes and writes every event once, in
+// order when asked to, as a serial loop does
+//////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/EventPipeline.h"
+#include "HepMC/IO_GenEvent.h"
+
+#include "testEvents.h"
+
+// an input which makes events, with a shower of nparticles particles
+class EventSource : public HepMC::IO_BaseClass {
+public:
+    EventSource( int nevents, int nparticles ) : m_left(nevents), m_number(0), m_nparticles(nparticles) {}
+    bool fill_next_event( HepMC::GenEvent* evt )
+    {
+	if ( m_left-- <= 0 ) return false;
+	fill_star_event( evt, ++m_number, m_nparticles );
+	return true;
+    }
+    void write_event( const HepMC::GenEvent* ) {}
+private:
+    int m_left;
+    int m_number;
+    int m_nparticles;
+};
+
+// an output which remembers the event numbers and a sum over the particles
+class EventSink : public HepMC::IO_BaseClass {
+public:
+    EventSink() : numbers(), sum(0) {}
+    void write_event( const HepMC::GenEvent* evt )
+    {
+	numbers.push_back( evt->event_number() );
+	for ( HepMC::GenEvent::particle_const_iterator p = evt->particles_begin();
+	      p != evt->particles_end(); ++p ) sum += (*p)->momentum().e();
+    }
+    bool fill_next_event( HepMC::GenEvent* ) { return false; }
+    std::vector<int> numbers;
+    double sum;
+};
+
+// some work on each event: scale the energies, and drop every third event
+bool scale_energies( HepMC::GenEvent* evt )
+{
+    for ( HepMC::GenEvent::particle_iterator p = evt->particles_begin();
+	  p != evt->particles_end(); ++p ) {
+	HepMC::FourVector m = (*p)->momentum();
+	double f = 1;
+	for ( int i = 0; i < 50; ++i ) f = std::sqrt( f + 2 );   // converges to 2
+	(*p)->set_momentum( HepMC::FourVector( m.px(), m.py(), m.pz(), f * m.e() ) );
+    }
+    return evt->event_number() % 3 != 0;
+}
+
+int main()
+{
+    int numbad = 0;
+    const int nevents = 1000;
+
+    // reference: a serial loop
+    EventSource serial_source( nevents, 100 );
+    EventSink reference;
+    for ( HepMC::GenEvent* evt = serial_source.read_next_event(); evt;
+	  evt = serial_source.read_next_event() ) {
+	if ( scale_energies( evt ) ) reference.write_event( evt );
+	delete evt;
+    }
+
+    // ordered and unordered, with and without recycling
+    for ( int mode = 0; mode < 4; ++mode ) {
+	bool ordered = mode < 2;
+	bool recycle = mode % 2 == 0;
+	EventSource source( nevents, 100 );
+	EventSink sink;
+	HepMC::EventPipeline pipeline( source, &sink, scale_energies, 4 );
+	pipeline.set_ordered( ordered );
+	pipeline.set_recycle_events( recycle );
+	pipeline.set_queue_size( 8 );
+	std::size_t written = pipeline.run();
+	std::vector<int> numbers( sink.numbers );
+	if ( !ordered ) {
+	    std::set<int> sorted( numbers.begin(), numbers.end() );
+	    numbers.assign( sorted.begin(), sorted.end() );
+	}
+	if ( numbers != reference.numbers || sink.sum != reference.sum
+	     || written != reference.numbers.size()
+	     || pipeline.events_read() != (std::size_t)nevents
+	     || pipeline.events_dropped() + written != (std::size_t)nevents ) {
+	    std::cerr << "ERROR: pipeline with ordered " << ordered << " recycle " << recycle
+	              << " wrote " << written << " events, not " << reference.numbers.size()
+	              << std::endl;
+	    ++numbad;
+	}
+    }
+
+    // through files, and stopping after some events
+    std::ostringstream file;
+    {
+	HepMC::IO_GenEvent out( file );
+	EventSource source( 50, 10 );
+	for ( HepMC::GenEvent* evt = source.read_next_event(); evt;
+	      evt = source.read_next_event() ) {
+	    out << evt;
+	    delete evt;
+	}
+    }
+    std::istringstream input( file.str() );
+    std::ostringstream output;
+    {
+	HepMC::IO_GenEvent in( input );
+	HepMC::IO_GenEvent out( output );
+	HepMC::EventPipeline pipeline( in, &out, scale_energies, 3 );
+	pipeline.set_max_events( 30 );
+	pipeline.run();
+    }
+    std::istringstream result( output.str() );
+    HepMC::IO_GenEvent back( result );
+    int expect = 1, nback = 0;
+    for ( HepMC::GenEvent* evt = back.read_next_event(); evt; evt = back.read_next_event() ) {
+	if ( expect % 3 == 0 ) ++expect;
+	if ( evt->event_number() != expect
+	     || evt->barcode_to_particle( 10002 )->momentum().e() != 2 ) {
+	    std::cerr << "ERROR: event " << evt->event_number() << " read back, expected "
+	              << expect << std::endl;
+	    ++numbad;
+	}
+	++expect;
+	++nback;
+	delete evt;
+    }
+    if ( nback != 20 ) {
+	std::cerr << "ERROR: " << nback << " events read back, not 20" << std::endl;
+	++numbad;
+    }
+
+    // an exception in a worker stops the pipeline and is rethrown
+    EventSource source( nevents, 10 );
+    HepMC::EventPipeline failing( source, 0, []( HepMC::GenEvent* evt ) -> bool {
+	    if ( evt->event_number() == 100 ) throw std::runtime_error( "event 100" );
+	    return true;
+	}, 4 );
+    bool thrown = false;
+    try {
+	failing.run();
+    } catch ( std::runtime_error& e ) {
+	thrown = true;
+    }
+    if ( !thrown || failing.events_read() == (std::size_t)nevents ) {
+	std::cerr << "ERROR: exception not passed on, or pipeline not stopped" << std::endl;
+	++numbad;
+    }
+
+    if ( numbad > 0 ) std::cerr << numbad << " errors in testEventPipeline" << std::endl;
+    return numbad;
+}
@@ -0,0 +1,247 @@
+//////////////////////////////////////////////////////////////////////////
+// testEventSlimmer.cc
+//
+// compare EventSlimmer with the old filterEvent algorithm, which
+// removes particles one at a time
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/EventSlimmer.h"
+#include "HepMC/GenEventValidator.h"
+
+// a small linear congruential generator, so the events are reproducible
+struct Random {
+    explicit Random( unsigned long seed ) : state(seed) {}
+    unsigned long next( unsigned long n )
+    {
+	state = state * 6364136223846793005UL + 1442695040888963407UL;
+	return ( state >> 33 ) % n;
+    }
+    unsigned long state;
+};
+
+// a shower with unphysical intermediate particles (status 3 and 11),
+// where status 11 particles end in a string with many hadrons;
+// some vertices join two particles when merge is true
+HepMC::GenEvent* build_event( int nparticles, unsigned long seed, bool merge )
+{
+    Random rnd( seed );
+    HepMC::GenEvent* evt = new HepMC::GenEvent( 20, 1 );
+    HepMC::GenVertex* v0 = new HepMC::GenVertex();
+    evt->add_vertex( v0 );
+    evt->set_signal_process_vertex( v0 );
+    HepMC::GenParticle* b1 = new HepMC::GenParticle( HepMC::FourVector(0,0,7000,7000), 2212, 4 );
+    HepMC::GenParticle* b2 = new HepMC::GenParticle( HepMC::FourVector(0,0,-7000,7000), 2212, 4 );
+    v0->add_particle_in( b1 );
+    v0->add_particle_in( b2 );
+    evt->set_beam_particles( b1, b2 );
+    std::vector<HepMC::GenParticle*> open;
+    for( int i = 0; i < 2; ++i ) {
+	HepMC::GenParticle* p = new HepMC::GenParticle( HepMC::FourVector(0,0,0,100), 21, 3 );
+	v0->add_particle_out( p );
+	open.push_back( p );
+    }
+    static const int statuses[] = { 1, 2, 2, 3, 11 };
+    int n = 4;
+    while( n < nparticles && !open.empty() ) {
+	HepMC::GenVertex* v = new HepMC::GenVertex();
+	evt->add_vertex( v );
+	int joined = ( merge && open.size() > 4 && rnd.next(8) == 0 ) ? 2 : 1;
+	for( int j = 0; j < joined; ++j ) {
+	    std::size_t k = rnd.next( open.size() );
+	    v->add_particle_in( open[k] );
+	    open[k] = open.back();
+	    open.pop_back();
+	}
+	int nout = ( (*v->particles_in_const_begin())->status() == 11 ?
+	             10 + rnd.next( 100 ) : 1 + rnd.next( 3 ) );
+	for( int j = 0; j < nout; ++j, ++n ) {
+	    HepMC::GenParticle* p = new HepMC::GenParticle(
+		HepMC::FourVector(0,0,0,10), 211, statuses[rnd.next(5)] );
+	    v->add_particle_out( p );
+	    if( rnd.next(4) != 0 ) open.push_back( p );
+	}
+    }
+    return evt;
+}
+
+// the filterEvent algorithm before EventSlimmer, as reference
+void filter_event_reference( HepMC::GenEvent* ge )
+{
+    const std::pair<HepMC::GenParticle*, HepMC::GenParticle*> beams = ge->beam_particles();
+    std::vector<HepMC::GenParticle*> unphys_particles;
+    for( HepMC::GenEvent::particle_const_iterator pi = ge->particles_begin();
+         pi != ge->particles_end(); ++pi ) {
+	if( beams.first == *pi || beams.second == *pi ) continue;
+	const int status = (*pi)->status();
+	if( status != 1 && status != 2 && status != 4 ) unphys_particles.push_back( *pi );
+    }
+    while( unphys_particles.size() ) {
+	HepMC::GenParticle* gp = unphys_particles.back();
+	HepMC::GenVertex* vstart = gp->production_vertex();
+	HepMC::GenVertex* vend = gp->end_vertex();
+	if( vend == vstart ) {
+	    vstart->remove_particle( gp );
+	} else {
+	    if( vend && vend->particles_out_size() ) {
+		std::vector<HepMC::GenParticle*> end_particles;
+		for( HepMC::GenVertex::particles_out_const_iterator gpe = vend->particles_out_const_begin();
+		     gpe != vend->particles_out_const_end(); ++gpe ) {
+		    end_particles.push_back( *gpe );
+		}
+		for( std::vector<HepMC::GenParticle*>::const_iterator gpe = end_particles.begin();
+		     gpe != end_particles.end(); ++gpe ) {
+		    if( vstart ) vstart->add_particle_out( *gpe );
+		}
+	    }
+	    delete vend;
+	    if( vstart ) delete vstart->remove_particle( gp );
+	}
+	unphys_particles.pop_back();
+    }
+    std::vector<HepMC::GenVertex*> orphaned_vtxs;
+    for( HepMC::GenEvent::vertex_const_iterator vi = ge->vertices_begin();
+         vi != ge->vertices_end(); ++vi ) {
+	if( (*vi)->particles_in_size() == 0 && (*vi)->particles_out_size() == 0 ) {
+	    orphaned_vtxs.push_back( *vi );
+	}
+    }
+    while( orphaned_vtxs.size() ) {
+	delete orphaned_vtxs.back();
+	orphaned_vtxs.pop_back();
+    }
+}
+
+bool is_physical( const HepMC::GenParticle* p )
+{
+    if( p->barcode() == 10001 || p->barcode() == 10002 ) return true;
+    return p->status() == 1 || p->status() == 2 || p->status() == 4;
+}
+
+bool physical_or_final( const HepMC::GenParticle* p )
+{
+    return is_physical( p ) || !p->end_vertex();
+}
+
+bool first_parent_is_physical( const HepMC::GenVertex* v )
+{
+    return v->particles_in_size() == 0 || is_physical( *v->particles_in_const_begin() );
+}
+
+int barcode( const HepMC::GenVertex* v ) { return v ? v->barcode() : 0; }
+int barcode( const HepMC::GenParticle* p ) { return p ? p->barcode() : 0; }
+
+// the whole graph, by barcode and in list order
+std::string describe( const HepMC::GenEvent& evt )
+{
+    std::ostringstream os;
+    os << "beams " << barcode( evt.beam_particles().first ) << " "
+       << barcode( evt.beam_particles().second ) << " signal "
+       << barcode( evt.signal_process_vertex() ) << "\n";
+    for( HepMC::GenEvent::vertex_const_iterator v = evt.vertices_begin();
+	 v != evt.vertices_end(); ++v ) {
+	os << (*v)->barcode() << " in";
+	for( HepMC::GenVertex::particles_in_const_iterator p = (*v)->particles_in_const_begin();
+	     p != (*v)->particles_in_const_end(); ++p ) os << " " << (*p)->barcode();
+	os << " out";
+	for( HepMC::GenVertex::particles_out_const_iterator p = (*v)->particles_out_const_begin();
+	     p != (*v)->particles_out_const_end(); ++p ) os << " " << (*p)->barcode();
+	os << "\n";
+    }
+    for( HepMC::GenEvent::particle_const_iterator p = evt.particles_begin();
+	 p != evt.particles_end(); ++p ) {
+	os << (*p)->barcode() << " " << barcode( (*p)->production_vertex() )
+	   << " " << barcode( (*p)->end_vertex() ) << "\n";
+    }
+    return os.str();
+}
+
+int main()
+{
+    int numbad = 0;
+    HepMC::GenEventValidator consistent( HepMC::GenEventValidator::barcodes
+                                         | HepMC::GenEventValidator::links
+                                         | HepMC::GenEventValidator::parent_event );
+
+    // same result as the old algorithm, with and without joined particles
+    HepMC::EventSlimmer slimmer( is_physical );
+    for( unsigned long seed = 1; seed <= 20; ++seed ) {
+	// both are copies, since copying an event can reorder the particles
+	HepMC::GenEvent* orig = build_event( 2000, seed, seed % 2 == 0 );
+	HepMC::GenEvent* evt = new HepMC::GenEvent( *orig );
+	HepMC::GenEvent* ref = new HepMC::GenEvent( *orig );
+	delete orig;
+	int before = evt->particles_size();
+	filter_event_reference( ref );
+	std::size_t removed = slimmer.slim( *evt );
+	if( describe( *evt ) != describe( *ref ) ) {
+	    std::cerr << "ERROR: slimmed event " << seed << " differs from filterEvent" << std::endl;
+	    ++numbad;
+	}
+	if( (int)removed != before - evt->particles_size() ) {
+	    std::cerr << "ERROR: " << removed << " particles reported as removed, not "
+	              << before - evt->particles_size() << std::endl;
+	    ++numbad;
+	}
+	if( !consistent.is_valid( *evt ) ) {
+	    std::cerr << "ERROR: slimmed event " << seed << " is not consistent" << std::endl;
+	    HepMC::GenEventValidator::print( consistent.validate( *evt ), std::cerr );
+	    ++numbad;
+	}
+	delete ref;
+	delete evt;
+    }
+
+    // removing a vertex is removing its incoming particle
+    HepMC::EventSlimmer by_vertex( HepMC::EventSlimmer::particle_predicate(),
+                                   first_parent_is_physical );
+    HepMC::GenEvent* orig = build_event( 2000, 99, false );
+    HepMC::GenEvent* evt = new HepMC::GenEvent( *orig );
+    HepMC::GenEvent* ref = new HepMC::GenEvent( *orig );
+    delete orig;
+    by_vertex.slim( *evt );
+    HepMC::EventSlimmer( physical_or_final ).slim( *ref );
+    if( describe( *evt ) != describe( *ref ) || by_vertex.removed_vertices() == 0 ) {
+	std::cerr << "ERROR: vertex and particle predicates disagree" << std::endl;
+	++numbad;
+    }
+    delete ref;
+
+    // removing a beam removes everything below the primary vertex
+    // which is not part of a longer decay chain
+    HepMC::EventSlimmer no_beam( [] ( const HepMC::GenParticle* p ) { return p->barcode() != 10001; } );
+    no_beam.slim( *evt );
+    if( evt->beam_particles().first || evt->beam_particles().second
+	|| evt->signal_process_vertex() || evt->barcode_to_particle( 10002 ) ) {
+	std::cerr << "ERROR: beams or signal vertex not reset" << std::endl;
+	++numbad;
+    }
+    if( !consistent.is_valid( *evt ) ) {
+	std::cerr << "ERROR: event without beams is not consistent" << std::endl;
+	HepMC::GenEventValidator::print( consistent.validate( *evt ), std::cerr );
+	++numbad;
+    }
+    delete evt;
+
+    // a larger event
+    orig = build_event( 2000, 7, true );
+    evt = new HepMC::GenEvent( *orig );
+    ref = new HepMC::GenEvent( *orig );
+    delete orig;
+    filter_event_reference( ref );
+    slimmer.slim( *evt );
+    if( describe( *evt ) != describe( *ref ) ) {
+	std::cerr << "ERROR: slimmed large event differs from filterEvent" << std::endl;
+	++numbad;
+    }
+    delete ref;
+    delete evt;
+
+    if( numbad > 0 ) std::cerr << numbad << " errors in testEventSlimmer" << std::endl;
+    return numbad;
+}
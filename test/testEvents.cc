@@ -0,0 +1,175 @@
+//////////////////////////////////////////////////////////////////////////
+// testEvents.cc
+//
+// events built by the test jobs and the benchmark
+//////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "testEvents.h"
+
+void fill_star_event( HepMC::GenEvent* evt, int number, int nparticles )
+{
+    evt->set_event_number( number );
+    evt->weights().push_back( 1. );
+    HepMC::GenVertex* v = new HepMC::GenVertex();
+    evt->add_vertex( v );
+    v->add_particle_in( new HepMC::GenParticle( HepMC::FourVector(0,0,0,number), 23, 2 ) );
+    for ( int i = 1; i < nparticles; ++i ) {
+	v->add_particle_out( new HepMC::GenParticle( HepMC::FourVector(i,0,0,i), 211, 1 ) );
+    }
+}
+
+HepMC::GenEvent* make_star_event( int number, int nparticles )
+{
+    HepMC::GenEvent* evt = new HepMC::GenEvent( 20, number );
+    fill_star_event( evt, number, nparticles );
+    return evt;
+}
+
+namespace {
+
+    // two beams at a new signal process vertex
+    HepMC::GenVertex* add_beams( HepMC::GenEvent* evt )
+    {
+	HepMC::GenVertex* v = new HepMC::GenVertex( HepMC::FourVector(0,0,0,0) );
+	evt->add_vertex( v );
+	HepMC::GenParticle* b1 = new HepMC::GenParticle( HepMC::FourVector(0,0,7000,7000), 2212, 3 );
+	HepMC::GenParticle* b2 = new HepMC::GenParticle( HepMC::FourVector(0,0,-7000,7000), 2212, 3 );
+	v->add_particle_in( b1 );
+	v->add_particle_in( b2 );
+	evt->set_beam_particles( b1, b2 );
+	evt->set_signal_process_vertex( v );
+	return v;
+    }
+
+} // unnamed namespace
+
+HepMC::GenEvent* make_chain_event( int number, int ndecays )
+{
+    HepMC::GenEvent* evt = new HepMC::GenEvent( 20, number );
+    HepMC::GenVertex* v = add_beams( evt );
+    for ( int i = 0; i < ndecays; ++i ) {
+	HepMC::GenParticle* p = new HepMC::GenParticle( HepMC::FourVector(i,0,number,i+number+2), 113, 2 );
+	p->set_generated_mass( 0.75 );
+	v->add_particle_out( p );
+	v->add_particle_out( new HepMC::GenParticle( HepMC::FourVector(-i,0,1,i+2), 211, 1 ) );
+	v = new HepMC::GenVertex( HepMC::FourVector(0,0,0.5*i,i) );
+	evt->add_vertex( v );
+	v->add_particle_in( p );
+    }
+    v->add_particle_out( new HepMC::GenParticle( HepMC::FourVector(1,1,0,2), 22, 1 ) );
+    return evt;
+}
+
+HepMC::GenEvent* make_tree_event( int number, int depth, int barcode_step )
+{
+    HepMC::GenEvent* evt = new HepMC::GenEvent( 20, number );
+    HepMC::GenVertex* v = add_beams( evt );
+    int barcode = -barcode_step;
+    v->suggest_barcode( barcode );
+    HepMC::GenParticle* z = new HepMC::GenParticle( HepMC::FourVector(0,0,1,2), 23, 2 );
+    v->add_particle_out( z );
+    v->add_particle_out( new HepMC::GenParticle( HepMC::FourVector(0,0,-1,1), 22, 1 ) );
+    std::vector<HepMC::GenParticle*> level( 1, z );
+    for ( int d = 0; d < depth; ++d ) {
+	std::vector<HepMC::GenParticle*> next;
+	for ( std::size_t i = 0; i < level.size(); ++i ) {
+	    HepMC::GenVertex* decay = new HepMC::GenVertex( HepMC::FourVector(i,0,d,d+1) );
+	    barcode -= barcode_step;
+	    decay->suggest_barcode( barcode );
+	    evt->add_vertex( decay );
+	    decay->add_particle_in( level[i] );
+	    for ( int k = 0; k < 2; ++k ) {
+		HepMC::GenParticle* p = new HepMC::GenParticle( HepMC::FourVector(k,i,d,d+k+1),
+		                                                211, d + 1 < depth ? 2 : 1 );
+		p->set_generated_mass( 0.14 );
+		decay->add_particle_out( p );
+		next.push_back( p );
+	    }
+	}
+	level.swap( next );
+    }
+    HepMC::GenVertex* orphan = new HepMC::GenVertex( HepMC::FourVector(1,1,1,1) );
+    evt->add_vertex( orphan );
+    orphan->add_particle_out( new HepMC::GenParticle( HepMC::FourVector(0,1,0,1), 22, 1 ) );
+    orphan->add_particle_out( new HepMC::GenParticle( HepMC::FourVector(0,-1,0,1), 22, 1 ) );
+    return evt;
+}
+
+HepMC::GenEvent* make_balanced_shower( int nvertices, bool reversed )
+{
+    HepMC::GenEvent* evt = new HepMC::GenEvent( 20, 1 );
+    HepMC::GenVertex* v0 = new HepMC::GenVertex();
+    evt->add_vertex( v0 );
+    evt->set_signal_process_vertex( v0 );
+    // the barcodes are those given in the order the particles are made
+    int barcode = 10000;
+    HepMC::GenParticle* b1 = new HepMC::GenParticle( HepMC::FourVector(0,0,32,32), 2212, 4 );
+    HepMC::GenParticle* b2 = new HepMC::GenParticle( HepMC::FourVector(0,0,-32,32), 2212, 4 );
+    b1->suggest_barcode( ++barcode );
+    b2->suggest_barcode( ++barcode );
+    v0->add_particle_in( reversed ? b2 : b1 );
+    v0->add_particle_in( reversed ? b1 : b2 );
+    evt->set_beam_particles( b1, b2 );
+    std::vector<HepMC::GenParticle*> open;
+    open.push_back( new HepMC::GenParticle( HepMC::FourVector(1,0,0,32), 21, 1 ) );
+    open.push_back( new HepMC::GenParticle( HepMC::FourVector(-1,0,0,32), 21, 1 ) );
+    open[0]->suggest_barcode( ++barcode );
+    open[1]->suggest_barcode( ++barcode );
+    v0->add_particle_out( open[reversed ? 1 : 0] );
+    v0->add_particle_out( open[reversed ? 0 : 1] );
+    for( int i = 1; i < nvertices; ++i ) {
+	HepMC::GenParticle* in = open[i-1];
+	in->set_status( 2 );
+	HepMC::GenVertex* v = new HepMC::GenVertex( HepMC::FourVector(0,0,0.1*i,0.1*i) );
+	evt->add_vertex( v );
+	v->add_particle_in( in );
+	const HepMC::FourVector& p = in->momentum();
+	HepMC::GenParticle* out[2];
+	for( int j = 0; j < 2; ++j ) {
+	    double s = ( j ? 0.25 : 0.75 );
+	    out[j] = new HepMC::GenParticle( 
+		HepMC::FourVector( p.px()*s, p.py()*s + (j ? 0.5 : -0.5), p.pz()*s, p.e()*s ), 21, 1 );
+	    out[j]->suggest_barcode( ++barcode );
+	    open.push_back( out[j] );
+	}
+	v->add_particle_out( out[reversed ? 1 : 0] );
+	v->add_particle_out( out[reversed ? 0 : 1] );
+    }
+    return evt;
+}
+
+HepMC::GenEvent* build_shower( int nvertices, bool close_loop )
+{
+    HepMC::GenEvent* evt = new HepMC::GenEvent( 20, 1 );
+    std::vector<HepMC::GenParticle*> open;
+    HepMC::GenVertex* v0 = new HepMC::GenVertex();
+    evt->add_vertex( v0 );
+    v0->add_particle_in( new HepMC::GenParticle( HepMC::FourVector(0,0,7000,7000), 2212, 3 ) );
+    v0->add_particle_in( new HepMC::GenParticle( HepMC::FourVector(0,0,-7000,7000), 2212, 3 ) );
+    for( int i = 0; i < 2; ++i ) {
+        HepMC::GenParticle* p = new HepMC::GenParticle( HepMC::FourVector(1,1,1,2), 21, 2 );
+	v0->add_particle_out( p );
+	open.push_back( p );
+    }
+    std::size_t next = 0;
+    for( int i = 1; i < nvertices && next < open.size(); ++i ) {
+        HepMC::GenVertex* v = new HepMC::GenVertex();
+	evt->add_vertex( v );
+	v->add_particle_in( open[next++] );
+	if( i%10 == 0 && next < open.size() ) v->add_particle_in( open[next++] );
+	for( int j = 0; j < 2; ++j ) {
+	    HepMC::GenParticle* p = new HepMC::GenParticle( HepMC::FourVector(1,1,1,2), 21, 2 );
+	    v->add_particle_out( p );
+	    open.push_back( p );
+	}
+	if( i == nvertices/2 ) {
+	    HepMC::GenParticle* self = new HepMC::GenParticle( HepMC::FourVector(1,1,1,2), 22, 2 );
+	    v->add_particle_out( self );
+	    v->add_particle_in( self );
+	}
+    }
+    if( close_loop ) v0->add_particle_in( open[next++] );
+    return evt;
+}
@@ -0,0 +1,36 @@
+#ifndef TEST_EVENTS_H
+#define TEST_EVENTS_H
+//////////////////////////////////////////////////////////////////////////
+// testEvents.h
+//
+// events built by the test jobs and the benchmark
+//////////////////////////////////////////////////////////////////////////
+
+#include "HepMC/GenEvent.h"
+
+/// a Z decaying to nparticles-1 pions at one vertex, with one weight
+void              fill_star_event( HepMC::GenEvent* evt, int number, int nparticles );
+HepMC::GenEvent*  make_star_event( int number, int nparticles );
+
+/// two beams at the signal process vertex, and a chain of ndecays rho
+/// decays, each to a pion and the next rho; the last vertex gives a photon
+HepMC::GenEvent*  make_chain_event( int number, int ndecays );
+
+/// two beams at the signal process vertex, a Z whose decay is a binary
+/// tree with depth levels, a stable photon, and two photons from a vertex
+/// with no incoming particle.  Vertex barcodes are spaced by barcode_step.
+HepMC::GenEvent*  make_tree_event( int number, int depth, int barcode_step = 1 );
+
+/// a shower of two beams at the signal process vertex and nvertices
+/// vertices, each splitting one gluon in two, in which every vertex
+/// conserves momentum.  Particle barcodes count from 10001 in the order
+/// the particles are made; reversed adds the particles of each vertex in
+/// the opposite order, with the same barcodes.
+HepMC::GenEvent*  make_balanced_shower( int nvertices, bool reversed = false );
+
+/// a gluon shower of about nvertices vertices: every tenth vertex has a
+/// second incoming particle, and one particle starts and ends at the same
+/// vertex; with close_loop, the shower also feeds back into the first vertex
+HepMC::GenEvent*  build_shower( int nvertices, bool close_loop = false );
+
+#endif
@@ -8,12 +8,16 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <utility>
 
 #include "HepMC/GenEvent.h"
 #include "HepMC/IO_GenEvent.h"
 
 typedef std::vector<HepMC::GenParticle*> FlowVec;
 
+// codes used for the large flow pattern test
+int icode_expected( int index ) { return index == 3 ? 333 : 101*index; }
+
 int main() {
     //
     // In this example we will place the following event into HepMC "by hand"
@@ -189,6 +193,49 @@ int main() {
         ++numbad;
     }
 
+    // more flow codes than fit in the inline storage, set out of order
+    HepMC::Flow f3;
+    f3.set_icode(4,404);
+    f3.set_icode(1,101);
+    f3.set_icode(3,303);
+    f3.set_icode(2,202);
+    f3.set_icode(3,333);
+    HepMC::Flow f4( f3 );
+    int last = 0;
+    for( HepMC::Flow::const_iterator fi = f4.begin(); fi != f4.end(); ++fi ) {
+        if( (*fi).first <= last || (*fi).second != icode_expected((*fi).first) ) {
+	    std::cerr << "ERROR: flow codes out of order or wrong" << std::endl;
+	    ++numbad;
+	}
+	last = (*fi).first;
+    }
+    if( f4.size() != 4 || f4 != f3 || f4.icode(5) != 0 ) {
+        std::cerr << "ERROR: copy of large flow pattern differs" << std::endl;
+        ++numbad;
+    }
+    f4.erase(4);
+    f4.erase(1);
+    if( f4.size() != 2 || f4.icode(2) != 202 || f4.icode(3) != 333 || f4 == f3 ) {
+        std::cerr << "ERROR: erase from large flow pattern failed" << std::endl;
+        ++numbad;
+    }
+    // the codes may be changed through an iterator, the code indices not
+    for( HepMC::Flow::iterator fi = f4.begin(); fi != f4.end(); ++fi ) {
+        fi->second += 1000;
+    }
+    HepMC::Flow::iterator f4first = f4.begin();
+    std::pair<int,int> pair3 = *(++f4first);
+    if( f4.icode(2) != 1202 || f4.icode(3) != 1333 || pair3 != std::make_pair(3,1333) ) {
+        std::cerr << "ERROR: flow codes not changed through an iterator" << std::endl;
+        ++numbad;
+    }
+    f3 = f4;
+    f4.clear();
+    if( f3.size() != 2 || !f4.empty() || f4.begin() != f4.end() ) {
+        std::cerr << "ERROR: flow assignment or clear failed" << std::endl;
+        ++numbad;
+    }
+
     // now clean-up by deleteing all objects from memory
     //
     // deleting the event deletes all contained vertices, and all particles
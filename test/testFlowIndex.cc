@@ -0,0 +1,153 @@
+//////////////////////////////////////////////////////////////////////////
+// testFlowIndex.cc
+//
+// compare FlowIndex with Flow::connected_partners and
+// Flow::dangling_connected_partners
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/FlowIndex.h"
+
+typedef std::vector<HepMC::GenParticle*> FlowVec;
+
+// a colour shower: quarks carry colour (index 1), antiquarks anticolour
+// (index 2) and gluons both.  Quarks and antiquarks radiate gluons and
+// gluons split into two gluons, each time creating a new colour line.
+HepMC::GenEvent* build_colour_shower( int nvertices )
+{
+    HepMC::GenEvent* evt = new HepMC::GenEvent( 20, 1 );
+    HepMC::FourVector p( 0, 0, 1, 1 );
+    int next_colour = 501;
+    unsigned long random = 12345;
+    HepMC::GenVertex* v0 = new HepMC::GenVertex();
+    evt->add_vertex( v0 );
+    v0->add_particle_in( new HepMC::GenParticle( p, 11, 3 ) );
+    v0->add_particle_in( new HepMC::GenParticle( p, -11, 3 ) );
+    std::vector<HepMC::GenParticle*> open;
+    HepMC::GenParticle* q = new HepMC::GenParticle( p, 1, 2 );
+    HepMC::GenParticle* qbar = new HepMC::GenParticle( p, -1, 2 );
+    q->set_flow( 1, next_colour );
+    qbar->set_flow( 2, next_colour++ );
+    v0->add_particle_out( q );
+    v0->add_particle_out( qbar );
+    open.push_back( q );
+    open.push_back( qbar );
+    for( int i = 1; i < nvertices && !open.empty(); ++i ) {
+	random = random * 1103515245 + 12345;
+	std::size_t pick = ( random >> 8 ) % open.size();
+	HepMC::GenParticle* in = open[pick];
+	open[pick] = open.back();
+	open.pop_back();
+	HepMC::GenVertex* v = new HepMC::GenVertex();
+	evt->add_vertex( v );
+	v->add_particle_in( in );
+	int c = in->flow(1), a = in->flow(2), n = next_colour++;
+	HepMC::GenParticle* out1 = new HepMC::GenParticle( p, in->pdg_id(), 2 );
+	HepMC::GenParticle* out2 = new HepMC::GenParticle( p, 21, 2 );
+	if( in->pdg_id() > 0 && in->pdg_id() < 21 ) {
+	    out1->set_flow( 1, n );
+	    out2->set_flow( 1, c );
+	    out2->set_flow( 2, n );
+	} else if( in->pdg_id() < 0 ) {
+	    out1->set_flow( 2, n );
+	    out2->set_flow( 1, n );
+	    out2->set_flow( 2, a );
+	} else {
+	    out1->set_flow( 1, c );
+	    out1->set_flow( 2, n );
+	    out2->set_flow( 1, n );
+	    out2->set_flow( 2, a );
+	}
+	v->add_particle_out( out1 );
+	v->add_particle_out( out2 );
+	open.push_back( out1 );
+	open.push_back( out2 );
+    }
+    for( std::size_t i = 0; i < open.size(); ++i ) open[i]->set_status( 1 );
+    return evt;
+}
+
+FlowVec sorted( FlowVec v )
+{
+    std::sort( v.begin(), v.end() );
+    return v;
+}
+
+int main() {
+
+    int numbad = 0;
+    HepMC::GenEvent* evt = build_colour_shower( 500 );
+    // a particle which starts and ends at the same vertex
+    HepMC::GenVertex* v = evt->barcode_to_vertex(-100);
+    HepMC::GenParticle* loop = new HepMC::GenParticle( 
+	HepMC::FourVector( 0, 0, 1, 1 ), 21, 2 );
+    loop->set_flow( 1, (*v->particles_in_const_begin())->flow(1) );
+    v->add_particle_out( loop );
+    v->add_particle_in( loop );
+
+    HepMC::FlowIndex colour( *evt );
+    std::size_t nlines = 0;
+    for( HepMC::GenEvent::particle_iterator p = evt->particles_begin();
+         p != evt->particles_end(); ++p ) {
+	for( int index = 1; index <= 2; ++index ) {
+	    int code = (*p)->flow(index);
+	    if( code == 0 ) {
+		if( colour.line_of( *p, code ) != -1 ) ++numbad;
+		continue;
+	    }
+	    if( sorted( colour.connected_partners( *p, code ) ) !=
+	        sorted( (*p)->flow().connected_partners( code ) ) ||
+		sorted( colour.dangling_connected_partners( *p, code ) ) !=
+		sorted( (*p)->flow().dangling_connected_partners( code ) ) ) {
+		std::cerr << "ERROR: partners differ for particle " 
+		          << (*p)->barcode() << " code " << code << std::endl;
+		++numbad;
+	    }
+	    if( colour.line( colour.line_of( *p, code ) ).code != code ) ++numbad;
+	}
+    }
+    for( std::size_t i = 0; i < colour.size(); ++i ) {
+	nlines += colour.line(i).partners.size();
+	if( i > 0 && colour.line(i).code < colour.line(i-1).code ) ++numbad;
+    }
+    if( colour.size() == 0 || nlines < (std::size_t)evt->particles_size() ) {
+	std::cerr << "ERROR: " << colour.size() << " colour lines with " 
+	          << nlines << " particles" << std::endl;
+	++numbad;
+    }
+    delete evt;
+
+    // a long line: a quark radiating photons keeps its colour
+    evt = new HepMC::GenEvent( 20, 2 );
+    const int length = 2000;
+    HepMC::GenParticle* q = new HepMC::GenParticle( HepMC::FourVector(0,0,1,1), 1, 3 );
+    q->set_flow( 1, 501 );
+    HepMC::GenParticle* first = q;
+    for( int i = 0; i < length; ++i ) {
+	HepMC::GenVertex* v = new HepMC::GenVertex();
+	evt->add_vertex( v );
+	v->add_particle_in( q );
+	q = new HepMC::GenParticle( HepMC::FourVector(0,0,1,1), 1, 2 );
+	q->set_flow( 1, 501 );
+	v->add_particle_out( q );
+	v->add_particle_out( new HepMC::GenParticle( HepMC::FourVector(0,0,1,1), 22, 1 ) );
+    }
+    FlowVec all = first->flow().connected_partners( 501 );
+    FlowVec ends = first->flow().dangling_connected_partners( 501 );
+    HepMC::FlowIndex line( *evt );
+    if( all.size() != length + 1 || ends.size() != 2 || line.size() != 1 ||
+        sorted( all ) != sorted( line.line(0).partners ) ||
+	sorted( ends ) != sorted( line.line(0).dangling ) ) {
+	std::cerr << "ERROR: long colour line has " << all.size() << " particles and "
+	          << ends.size() << " ends" << std::endl;
+	++numbad;
+    }
+    delete evt;
+
+    if( numbad > 0 ) std::cerr << numbad << " errors in testFlowIndex" << std::endl;
+    return numbad;
+}
@@ -0,0 +1,211 @@
+//////////////////////////////////////////////////////////////////////////
+// testGenEventPool.cc
+//
+// check that GenEventPool reuses events, also when they are released by
+// another thread
+//////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/GenEventPool.h"
+
+#include "testEvents.h"
+
+// count the blocks allocated with the global operator new and not yet
+// deleted, to see whether a destroyed pool leaves events behind
+std::atomic<long> live_blocks( 0 );
+
+void* operator new( std::size_t size )
+{
+    void* p = std::malloc( size ? size : 1 );
+    if ( !p ) throw std::bad_alloc();
+    ++live_blocks;
+    return p;
+}
+
+void operator delete( void* p ) noexcept
+{
+    if ( !p ) return;
+    --live_blocks;
+    std::free( p );
+}
+
+bool is_empty( const HepMC::GenEvent* evt )
+{
+    return evt->particles_size() == 0 && evt->vertices_size() == 0
+	&& evt->weights().size() == 0 && evt->event_number() == 0;
+}
+
+int main()
+{
+    int numbad = 0;
+
+    // released events come back cleared, and no more are created
+    {
+	HepMC::GenEventPool pool( 16 );
+	std::vector<HepMC::GenEvent*> events;
+	for ( int i = 0; i < 10; ++i ) {
+	    events.push_back( pool.acquire() );
+	    fill_star_event( events.back(), i + 1, 20 );
+	}
+	for ( std::size_t i = 0; i < events.size(); ++i ) pool.release( events[i] );
+	for ( int round = 0; round < 5; ++round ) {
+	    for ( std::size_t i = 0; i < events.size(); ++i ) {
+		events[i] = pool.acquire();
+		if ( !is_empty( events[i] ) ) {
+		    std::cerr << "ERROR: acquired event is not empty" << std::endl;
+		    ++numbad;
+		}
+		fill_star_event( events[i], round, 20 );
+	    }
+	    for ( std::size_t i = 0; i < events.size(); ++i ) pool.release( events[i] );
+	}
+	if ( pool.created() != 10 ) {
+	    std::cerr << "ERROR: pool created " << pool.created() << " events, not 10" << std::endl;
+	    ++numbad;
+	}
+	pool.release( 0 );
+    }
+
+    // events acquired by one thread and released by another, as in a pipeline
+    {
+	HepMC::GenEventPool pool( 64 );
+	const int nevents = 2000;
+	std::vector<HepMC::GenEvent*> passed( nevents, (HepMC::GenEvent*)0 );
+	std::thread producer( [&]() {
+		for ( int i = 0; i < nevents; ++i ) {
+		    HepMC::GenEvent* evt = pool.acquire();
+		    fill_star_event( evt, i + 1, 10 );
+		    passed[i] = evt;
+		}
+	    } );
+	producer.join();
+	std::thread consumer( [&]() {
+		for ( int i = 0; i < nevents; ++i ) pool.release( passed[i] );
+	    } );
+	consumer.join();
+	std::size_t before = pool.created();
+	std::thread again( [&]() {
+		for ( int i = 0; i < 64; ++i ) passed[i] = pool.acquire();
+		for ( int i = 0; i < 64; ++i ) pool.release( passed[i] );
+	    } );
+	again.join();
+	if ( pool.created() != before ) {
+	    std::cerr << "ERROR: events released by another thread were not reused" << std::endl;
+	    ++numbad;
+	}
+    }
+
+    // several threads acquiring and releasing at once
+    {
+	HepMC::GenEventPool pool( 32 );
+	std::vector<std::thread> threads;
+	for ( int t = 0; t < 4; ++t ) {
+	    threads.push_back( std::thread( [&pool, t]() {
+		    std::vector<HepMC::GenEvent*> held;
+		    for ( int i = 0; i < 500; ++i ) {
+			held.push_back( pool.acquire() );
+			fill_star_event( held.back(), i, 5 + t );
+			if ( held.size() == 8 ) {
+			    for ( std::size_t j = 0; j < held.size(); ++j ) pool.release( held[j] );
+			    held.clear();
+			}
+		    }
+		    for ( std::size_t j = 0; j < held.size(); ++j ) pool.release( held[j] );
+		} ) );
+	}
+	for ( std::size_t t = 0; t < threads.size(); ++t ) threads[t].join();
+	// without reuse, 2000 events would be created
+	if ( pool.created() > 200 ) {
+	    std::cerr << "ERROR: pool created " << pool.created() << " events" << std::endl;
+	    ++numbad;
+	}
+    }
+
+    // the memory of deleted particles and vertices is used again
+    {
+	HepMC::GenParticle* p = new HepMC::GenParticle( HepMC::FourVector(1,2,3,4), 11, 1 );
+	void* address = p;
+	delete p;
+	p = new HepMC::GenParticle( HepMC::FourVector(1,2,3,4), 11, 1 );
+	if ( (void*)p != address || p->pdg_id() != 11 || p->momentum().e() != 4 ) {
+	    std::cerr << "ERROR: particle memory not recycled" << std::endl;
+	    ++numbad;
+	}
+	delete p;
+	HepMC::GenVertex* v = new HepMC::GenVertex();
+	address = v;
+	delete v;
+	v = new HepMC::GenVertex();
+	if ( (void*)v != address ) {
+	    std::cerr << "ERROR: vertex memory not recycled" << std::endl;
+	    ++numbad;
+	}
+	delete v;
+	// the nothrow and placement forms of operator new
+	p = new( std::nothrow ) HepMC::GenParticle( HepMC::FourVector(1,2,3,4), 11, 1 );
+	v = new( std::nothrow ) HepMC::GenVertex();
+	if ( !p || !v || p->pdg_id() != 11 ) {
+	    std::cerr << "ERROR: nothrow new failed" << std::endl;
+	    ++numbad;
+	}
+	delete p;
+	delete v;
+	void* memory = ::operator new( sizeof(HepMC::GenParticle) );
+	p = new( memory ) HepMC::GenParticle( HepMC::FourVector(1,2,3,4), 13, 1 );
+	if ( (void*)p != memory || p->pdg_id() != 13 ) {
+	    std::cerr << "ERROR: placement new did not use the memory given" << std::endl;
+	    ++numbad;
+	}
+	p->~GenParticle();
+	::operator delete( memory );
+    }
+
+    // pools destroyed while another thread, which released events to
+    // them, still runs: the events go with the pool
+    {
+	std::mutex lock;
+	std::condition_variable changed;
+	HepMC::GenEventPool* current = 0;
+	int done = 0;
+	const int npools = 50;
+	std::thread worker( [&]() {
+		for ( int i = 0; i < npools; ++i ) {
+		    std::unique_lock<std::mutex> guard( lock );
+		    while ( !current ) changed.wait( guard );
+		    for ( int j = 0; j < 3; ++j ) current->release( new HepMC::GenEvent() );
+		    current = 0;
+		    ++done;
+		    changed.notify_all();
+		}
+	    } );
+	long before = 0;
+	for ( int i = 0; i < npools; ++i ) {
+	    HepMC::GenEventPool* pool = new HepMC::GenEventPool( 16 );
+	    std::unique_lock<std::mutex> guard( lock );
+	    current = pool;
+	    changed.notify_all();
+	    while ( done <= i ) changed.wait( guard );
+	    delete pool;
+	    // the first rounds allocate what the worker keeps for itself
+	    if ( i == 4 ) before = live_blocks;
+	}
+	if ( live_blocks > before ) {
+	    std::cerr << "ERROR: " << live_blocks - before 
+	              << " blocks left by destroyed pools" << std::endl;
+	    ++numbad;
+	}
+	worker.join();
+    }
+
+    if ( numbad > 0 ) std::cerr << numbad << " errors in testGenEventPool" << std::endl;
+    return numbad;
+}
@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////////
+// testGenEventSplice.cc
+//
+// check GenEvent::splice and extract_subgraph by replacing the decay of
+// a particle, and against moving vertices with add_vertex
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/GenEventValidator.h"
+
+#include "testEvents.h"
+
+int main()
+{
+    int numbad = 0;
+    HepMC::GenEventValidator consistent( HepMC::GenEventValidator::barcodes
+                                         | HepMC::GenEventValidator::links
+                                         | HepMC::GenEventValidator::parent_event );
+
+    // extract the decay of the Z: the Z stays, without end vertex
+    HepMC::GenEvent* evt = make_tree_event( 1, 3 );
+    HepMC::GenParticle* tau = evt->barcode_to_particle( 10003 );
+    HepMC::GenVertex* old_decay = tau->end_vertex();
+    int nvertices = evt->vertices_size(), nparticles = evt->particles_size();
+    HepMC::GenEvent* decay = evt->extract_subgraph( old_decay );
+    if ( !decay || decay->vertices_size() != 7 || decay->particles_size() != 14
+	 || evt->vertices_size() != nvertices - 7 || evt->particles_size() != nparticles - 14
+	 || tau->end_vertex() != 0 || tau->parent_event() != evt || old_decay->parent_event() != decay
+	 || old_decay->particles_in_size() != 0 || decay->event_number() != 1
+	 || evt->signal_process_vertex() == 0 || decay->signal_process_vertex() != 0
+	 || !consistent.is_valid( *evt ) || !consistent.is_valid( *decay ) ) {
+	std::cerr << "ERROR: extract_subgraph" << std::endl;
+	++numbad;
+    }
+    if ( evt->extract_subgraph( old_decay ) != 0 || evt->splice( old_decay, *evt ) ) {
+	std::cerr << "ERROR: splice of a vertex from another event accepted" << std::endl;
+	++numbad;
+    }
+    delete decay;
+
+    // a new decay from another event, attached to the Z
+    HepMC::GenEvent* other = make_tree_event( 2, 4 );
+    HepMC::GenVertex* new_decay = other->barcode_to_particle( 10003 )->end_vertex();
+    int before = evt->particles_size();
+    if ( !evt->splice( new_decay, *other, HepMC::GenEvent::offset_barcodes ) ) {
+	std::cerr << "ERROR: splice refused" << std::endl;
+	++numbad;
+    }
+    new_decay->add_particle_in( tau );
+    if ( evt->particles_size() != before + 30 || other->vertices_size() != 2
+	 || other->particles_size() != 6 || new_decay->parent_event() != evt
+	 || tau->end_vertex() != new_decay || evt->barcode_to_particle( 10004 ) == 0
+	 || evt->barcode_to_particle( 10004 )->parent_event() != evt
+	 || !consistent.is_valid( *evt ) || !consistent.is_valid( *other ) ) {
+	std::cerr << "ERROR: splice with offset barcodes" << std::endl;
+	HepMC::GenEventValidator::print( consistent.validate( *evt ), std::cerr );
+	++numbad;
+    }
+    // offset barcodes follow all those in use, in the same order
+    int last = 0;
+    for ( HepMC::GenVertex::particle_iterator p = new_decay->particles_begin( HepMC::descendants );
+	  p != new_decay->particles_end( HepMC::descendants ); ++p ) {
+	if ( (*p)->barcode() <= 10000 + nparticles ) {
+	    std::cerr << "ERROR: spliced particle has barcode " << (*p)->barcode() << std::endl;
+	    ++numbad;
+	}
+	last = std::max( last, (*p)->barcode() );
+    }
+    if ( last != 10000 + nparticles + 30 ) {
+	std::cerr << "ERROR: highest spliced barcode " << last << std::endl;
+	++numbad;
+    }
+    delete other;
+
+    // keeping barcodes: free ones are kept, taken ones are replaced
+    HepMC::GenEvent* target = make_tree_event( 3, 1 );
+    HepMC::GenEvent* source = make_tree_event( 4, 2 );
+    HepMC::GenVertex* root = source->signal_process_vertex();
+    HepMC::GenParticle* deep = source->barcode_to_particle( 10010 );
+    target->splice( root, *source );
+    // the two photons of the vertex without incoming particle stay
+    if ( source->vertices_size() != 1 || source->particles_size() != 2
+	 || source->signal_process_vertex() != 0 || source->beam_particles().first != 0
+	 || source->beam_particles().second != 0
+	 || deep->barcode() != 10010 || target->barcode_to_particle( 10010 ) != deep
+	 || target->particles_size() != 8 + 10 || !consistent.is_valid( *target )
+	 || !consistent.is_valid( *source ) ) {
+	std::cerr << "ERROR: splice keeping barcodes" << std::endl;
+	++numbad;
+    }
+    delete source;
+    delete target;
+    delete evt;
+
+    // the same as moving the vertices one by one
+    HepMC::GenEvent* from = make_tree_event( 1, 4 );
+    HepMC::GenEvent* to = make_tree_event( 2, 2 );
+    // moved together with its production vertex, so that no link is cut
+    HepMC::GenVertex* start = from->signal_process_vertex();
+    std::vector<HepMC::GenVertex*> vertices;
+    for ( HepMC::GenVertex::vertex_iterator v = start->vertices_begin( HepMC::descendants );
+	  v != start->vertices_end( HepMC::descendants ); ++v ) vertices.push_back( *v );
+    for ( std::size_t i = 0; i < vertices.size(); ++i ) to->add_vertex( vertices[i] );
+    int moved = to->particles_size();
+    delete from;
+    delete to;
+    from = make_tree_event( 1, 4 );
+    to = make_tree_event( 2, 2 );
+    to->splice( from->signal_process_vertex(), *from, HepMC::GenEvent::offset_barcodes );
+    if ( to->particles_size() != moved || from->particles_size() != 2
+	 || !consistent.is_valid( *to ) ) {
+	std::cerr << "ERROR: splice moved " << to->particles_size() << " particles, not "
+	          << moved << std::endl;
+	++numbad;
+    }
+    delete from;
+    delete to;
+
+    if ( numbad > 0 ) std::cerr << numbad << " errors in testGenEventSplice" << std::endl;
+    return numbad;
+}
@@ -0,0 +1,100 @@
+//////////////////////////////////////////////////////////////////////////
+// testGenEventSwap.cc
+//
+// check that swap, move and assignment of GenEvent keep the parent
+// events of vertices and particles right
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <utility>
+
+#include "HepMC/GenEvent.h"
+
+#include "testEvents.h"
+
+// an event with nvertices vertices in a chain
+HepMC::GenEvent* make_event( int number, int nvertices )
+{
+    return make_chain_event( number, nvertices - 1 );
+}
+
+// number of vertices and particles which do not point back to evt
+int wrong_parents( const HepMC::GenEvent& evt )
+{
+    int n = 0;
+    for ( HepMC::GenEvent::vertex_const_iterator v = evt.vertices_begin();
+	  v != evt.vertices_end(); ++v ) {
+	if ( (*v)->parent_event() != &evt ) ++n;
+    }
+    for ( HepMC::GenEvent::particle_const_iterator p = evt.particles_begin();
+	  p != evt.particles_end(); ++p ) {
+	if ( (*p)->parent_event() != &evt ) ++n;
+    }
+    return n;
+}
+
+int main()
+{
+    int numbad = 0;
+
+    // swap
+    HepMC::GenEvent* a = make_event( 1, 10 );
+    HepMC::GenEvent* b = make_event( 2, 20 );
+    HepMC::GenVertex* va = a->barcode_to_vertex( -3 );
+    HepMC::GenParticle* pb = b->barcode_to_particle( 10005 );
+    a->swap( *b );
+    if ( a->event_number() != 2 || a->vertices_size() != 20 || b->vertices_size() != 10
+	 || va->parent_event() != b || pb->parent_event() != a
+	 || wrong_parents( *a ) || wrong_parents( *b ) ) {
+	std::cerr << "ERROR: swap" << std::endl;
+	++numbad;
+    }
+    // the events go on working after the swap
+    HepMC::GenVertex* extra = new HepMC::GenVertex();
+    b->add_vertex( extra );
+    va->add_particle_out( new HepMC::GenParticle( HepMC::FourVector(1,1,1,3), 22, 1 ) );
+    if ( extra->parent_event() != b || b->vertices_size() != 11 || wrong_parents( *b )
+	 || b->remove_vertex( extra ) != true || extra->parent_event() != 0 ) {
+	std::cerr << "ERROR: event modified after swap" << std::endl;
+	++numbad;
+    }
+    delete extra;
+
+    // move construction and assignment
+    HepMC::GenEvent moved( std::move( *a ) );
+    if ( moved.event_number() != 2 || moved.vertices_size() != 20 || pb->parent_event() != &moved
+	 || wrong_parents( moved ) || a->vertices_size() != 0 || a->particles_size() != 0 ) {
+	std::cerr << "ERROR: move construction" << std::endl;
+	++numbad;
+    }
+    moved = std::move( *b );
+    if ( moved.event_number() != 1 || va->parent_event() != &moved || pb->parent_event() != b
+	 || wrong_parents( moved ) || wrong_parents( *b ) ) {
+	std::cerr << "ERROR: move assignment" << std::endl;
+	++numbad;
+    }
+    // copy assignment
+    *a = moved;
+    if ( a->vertices_size() != moved.vertices_size() || a->barcode_to_vertex( -3 ) == va
+	 || wrong_parents( *a ) || va->parent_event() != &moved ) {
+	std::cerr << "ERROR: copy assignment" << std::endl;
+	++numbad;
+    }
+    delete a;
+    delete b;
+
+    // repeated swaps of events of different sizes
+    HepMC::GenEvent* small = make_event( 1, 2 );
+    HepMC::GenEvent* large = make_event( 2, 1000 );
+    for ( int i = 0; i < 11; ++i ) small->swap( *large );
+    if ( small->vertices_size() != 1000 || large->vertices_size() != 2
+	 || wrong_parents( *small ) || wrong_parents( *large ) ) {
+	std::cerr << "ERROR: repeated swaps" << std::endl;
+	++numbad;
+    }
+    delete small;
+    delete large;
+
+    if ( numbad > 0 ) std::cerr << numbad << " errors in testGenEventSwap" << std::endl;
+    return numbad;
+}
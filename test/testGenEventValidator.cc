@@ -0,0 +1,155 @@
+//////////////////////////////////////////////////////////////////////////
+// testGenEventValidator.cc
+//
+// break an event in several ways and check that GenEventValidator
+// reports each problem, with any number of threads
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <vector>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/GenEventValidator.h"
+
+#include "testEvents.h"
+
+int count( const std::vector<HepMC::ValidationIssue>& issues, unsigned check )
+{
+    int n = 0;
+    for( std::size_t i = 0; i < issues.size(); ++i ) if( issues[i].check == check ) ++n;
+    return n;
+}
+
+int expect( const std::vector<HepMC::ValidationIssue>& issues, unsigned check,
+            int n, const char* what )
+{
+    if( count( issues, check ) == n && (int)issues.size() == n ) return 0;
+    std::cerr << "ERROR: " << what << ": expected " << n << " " 
+              << HepMC::GenEventValidator::check_name( check ) << " issues, got:" << std::endl;
+    HepMC::GenEventValidator::print( issues, std::cerr );
+    return 1;
+}
+
+int main() {
+
+    int numbad = 0;
+    HepMC::ThreadPool one( 1 ), four( 4 );
+    HepMC::GenEventValidator serial( HepMC::GenEventValidator::all_checks, 1e-9, one );
+    HepMC::GenEventValidator validator( HepMC::GenEventValidator::all_checks, 1e-9, four );
+
+    HepMC::GenEvent* evt = make_balanced_shower( 2000 );
+    if( !serial.validate( *evt ).empty() || !validator.is_valid( *evt ) ) {
+	std::cerr << "ERROR: a valid event fails validation" << std::endl;
+	HepMC::GenEventValidator::print( validator.validate( *evt ), std::cerr );
+	++numbad;
+    }
+
+    // momentum: both vertices of the particle see the change
+    HepMC::GenParticle* p = evt->barcode_to_particle( 11000 );
+    HepMC::FourVector m = p->momentum();
+    p->set_momentum( HepMC::FourVector( m.px() + 1, m.py(), m.pz(), m.e() ) );
+    std::vector<HepMC::ValidationIssue> issues = validator.validate( *evt );
+    numbad += expect( issues, HepMC::GenEventValidator::momentum_conservation, 
+                      2, "changed momentum" );
+    if( issues.size() == 2 && ( issues[0].value < 0.99 || issues[0].value > 1.01 ) ) ++numbad;
+    // the order of the issues does not depend on the number of threads
+    std::vector<HepMC::ValidationIssue> again = serial.validate( *evt );
+    if( again.size() != issues.size() || again[0].barcode != issues[0].barcode ) {
+	std::cerr << "ERROR: serial and parallel validation differ" << std::endl;
+	++numbad;
+    }
+    p->set_momentum( m );
+
+    // checks can be switched off
+    p->set_momentum( HepMC::FourVector( m.px() + 1, m.py(), m.pz(), m.e() ) );
+    validator.set_checks( HepMC::GenEventValidator::all_checks 
+                          & ~HepMC::GenEventValidator::momentum_conservation );
+    if( !validator.is_valid( *evt ) ) ++numbad;
+    validator.set_checks( HepMC::GenEventValidator::all_checks );
+    p->set_momentum( m );
+
+    // beam particles
+    std::pair<HepMC::GenParticle*,HepMC::GenParticle*> beams = evt->beam_particles();
+    evt->set_beam_particles( beams.first, 0 );
+    numbad += expect( validator.validate( *evt ), HepMC::GenEventValidator::beam_particles,
+                      1, "missing beam particle" );
+    evt->set_beam_particles( beams );
+
+    // a loop, with momentum conserved
+    HepMC::GenVertex* v = evt->barcode_to_vertex( -500 );
+    HepMC::GenParticle* self = new HepMC::GenParticle( HepMC::FourVector(0,0,0,0), 22, 2 );
+    v->add_particle_out( self );
+    v->add_particle_in( self );
+    numbad += expect( validator.validate( *evt ), HepMC::GenEventValidator::cycles,
+                      1, "loop" );
+    delete v->remove_particle( self );
+
+    // a vertex taken out of the event leaves its neighbours dangling
+    HepMC::GenVertex* other = evt->barcode_to_vertex( -700 );
+    HepMC::GenParticle* in = *other->particles_in_const_begin();
+    evt->remove_vertex( other );
+    issues = validator.validate( *evt );
+    bool found = false;
+    for( std::size_t i = 0; i < issues.size(); ++i ) {
+	if( issues[i].check == HepMC::GenEventValidator::links && 
+	    issues[i].barcode == in->barcode() ) found = true;
+    }
+    if( !found || count( issues, HepMC::GenEventValidator::barcodes ) == 0 ) {
+	std::cerr << "ERROR: dangling particles not found:" << std::endl;
+	HepMC::GenEventValidator::print( issues, std::cerr );
+	++numbad;
+    }
+    evt->add_vertex( other );
+    if( !validator.is_valid( *evt ) ) {
+	std::cerr << "ERROR: event not valid after adding the vertex again" << std::endl;
+	++numbad;
+    }
+    delete evt;
+
+    // deleting the vertex of the beams deletes them too; a particle
+    // which may reuse the memory of a beam must not be taken for it
+    evt = make_chain_event( 1, 3 );
+    delete evt->signal_process_vertex();
+    if( evt->valid_beam_particles() || evt->beam_particles().first ) {
+	std::cerr << "ERROR: deleted beam particles still valid" << std::endl;
+	++numbad;
+    }
+    HepMC::GenVertex* last = evt->barcode_to_vertex( -4 );
+    last->add_particle_out( new HepMC::GenParticle( HepMC::FourVector(0,0,1,1), 22, 1 ) );
+    last->add_particle_out( new HepMC::GenParticle( HepMC::FourVector(0,0,-1,1), 22, 1 ) );
+    if( evt->valid_beam_particles() ) {
+	std::cerr << "ERROR: new particles taken for the deleted beams" << std::endl;
+	++numbad;
+    }
+    delete evt;
+
+    // beam particles may be set before they are added to the event
+    evt = new HepMC::GenEvent( 20, 1 );
+    HepMC::GenParticle* b1 = new HepMC::GenParticle( HepMC::FourVector(0,0,1,1), 2212, 4 );
+    HepMC::GenParticle* b2 = new HepMC::GenParticle( HepMC::FourVector(0,0,-1,1), 2212, 4 );
+    evt->set_beam_particles( b1, b2 );
+    HepMC::GenVertex* v0 = new HepMC::GenVertex();
+    v0->add_particle_in( b1 );
+    v0->add_particle_in( b2 );
+    if( evt->valid_beam_particles() ) {
+	std::cerr << "ERROR: beam particles valid before they are in the event" << std::endl;
+	++numbad;
+    }
+    evt->add_vertex( v0 );
+    if( !evt->valid_beam_particles() ) {
+	std::cerr << "ERROR: beam particles not valid once in the event" << std::endl;
+	++numbad;
+    }
+    delete evt;
+
+    // a valid event larger than the grain of the parallel loops
+    evt = make_balanced_shower( 5000 );
+    if( serial.validate( *evt ).size() != 0 || validator.validate( *evt ).size() != 0 ) {
+	std::cerr << "ERROR: problems found in a large valid event" << std::endl;
+	++numbad;
+    }
+    delete evt;
+
+    if( numbad > 0 ) std::cerr << numbad << " errors in testGenEventValidator" << std::endl;
+    return numbad;
+}
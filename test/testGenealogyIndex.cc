@@ -0,0 +1,178 @@
+//////////////////////////////////////////////////////////////////////////
+// testGenealogyIndex.cc
+//
+// compare the genealogy index with GenVertex::particle_iterator
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/GenealogyIndex.h"
+
+#include "testEvents.h"
+
+// ancestors of a particle using the iterators
+std::set<const HepMC::GenParticle*> ancestors_of( HepMC::GenParticle* p )
+{
+    std::set<const HepMC::GenParticle*> a;
+    HepMC::GenVertex* v = p->production_vertex();
+    if( !v ) return a;
+    for( HepMC::GenVertex::particle_iterator i = v->particles_begin(HepMC::ancestors);
+         i != v->particles_end(HepMC::ancestors); ++i ) a.insert( *i );
+    return a;
+}
+
+// compare all pairs of a sample of particles
+int compare( const HepMC::GenEvent& evt, const HepMC::GenealogyIndex& index,
+             const char* what )
+{
+    int numbad = 0;
+    std::vector<HepMC::GenParticle*> sample;
+    for( HepMC::GenEvent::particle_const_iterator p = evt.particles_begin();
+         p != evt.particles_end(); ++p ) {
+	if( (*p)->barcode() % 23 == 1 ) sample.push_back( *p );
+    }
+    for( std::size_t j = 0; j < sample.size(); ++j ) {
+	std::set<const HepMC::GenParticle*> anc = ancestors_of( sample[j] );
+	for( std::size_t i = 0; i < sample.size(); ++i ) {
+	    bool expected = anc.count( sample[i] ) > 0;
+	    if( index.is_ancestor( sample[i], sample[j] ) != expected ||
+	        index.is_descendant( sample[j], sample[i] ) != expected ) {
+		std::cerr << "ERROR (" << what << "): is_ancestor( "
+		          << sample[i]->barcode() << ", " << sample[j]->barcode()
+			  << " ) should be " << expected << std::endl;
+		++numbad;
+	    }
+	    // the common ancestor must be the production vertex of both,
+	    // or an ancestor of it
+	    HepMC::GenVertex* c = index.common_ancestor( sample[i], sample[j] );
+	    HepMC::GenVertex* vi = sample[i]->production_vertex();
+	    HepMC::GenVertex* vj = sample[j]->production_vertex();
+	    if( !c ) {
+		if( vi && vj ) {
+		    std::cerr << "ERROR (" << what << "): no common ancestor for "
+		              << sample[i]->barcode() << " and " 
+			      << sample[j]->barcode() << std::endl;
+		    ++numbad;
+		}
+		continue;
+	    }
+	    if( ( c != vi && !index.is_ancestor( c, vi ) ) ||
+	        ( c != vj && !index.is_ancestor( c, vj ) ) ) {
+		std::cerr << "ERROR (" << what << "): bad common ancestor for "
+		          << sample[i]->barcode() << " and " 
+			  << sample[j]->barcode() << std::endl;
+		++numbad;
+	    }
+	}
+    }
+    return numbad;
+}
+
+int main() {
+
+    int numbad = 0;
+    HepMC::GenEvent* evt = build_shower( 2000 );
+
+    // with and without the reachability bitsets
+    HepMC::GenealogyIndex index( *evt );
+    HepMC::GenealogyIndex intervals( *evt, 0 );
+    if( !index.has_bitsets() || intervals.has_bitsets() ) {
+	std::cerr << "ERROR: unexpected has_bitsets()" << std::endl;
+	++numbad;
+    }
+    if( index.size() != (std::size_t)evt->vertices_size() ) {
+	std::cerr << "ERROR: index has " << index.size() << " vertices" << std::endl;
+	++numbad;
+    }
+    numbad += compare( *evt, index, "bitsets" );
+    numbad += compare( *evt, intervals, "intervals" );
+    // both give the very same latest common ancestor
+    for( HepMC::GenEvent::vertex_const_iterator a = evt->vertices_begin();
+         a != evt->vertices_end(); ++a ) {
+	if( (*a)->barcode() % 13 != 0 ) continue;
+	for( HepMC::GenEvent::vertex_const_iterator b = evt->vertices_begin();
+	     b != evt->vertices_end(); ++b ) {
+	    if( (*b)->barcode() % 17 != 0 ) continue;
+	    if( index.common_ancestor( *a, *b ) != intervals.common_ancestor( *a, *b ) ) {
+		std::cerr << "ERROR: common ancestors of vertices " << (*a)->barcode()
+		          << " and " << (*b)->barcode() << " differ" << std::endl;
+		++numbad;
+	    }
+	}
+    }
+
+    // topological order: production before end vertex
+    for( HepMC::GenEvent::particle_const_iterator p = evt->particles_begin();
+         p != evt->particles_end(); ++p ) {
+	if( !(*p)->production_vertex() || !(*p)->end_vertex() ) continue;
+	if( (*p)->production_vertex() == (*p)->end_vertex() ) continue;
+	if( index.topological_index( (*p)->production_vertex() ) >=
+	    index.topological_index( (*p)->end_vertex() ) ) {
+	    std::cerr << "ERROR: particle " << (*p)->barcode()
+	              << " is not in topological order" << std::endl;
+	    ++numbad;
+	}
+    }
+
+    // the event index is deleted when the graph changes;
+    // a loop makes the first vertex descend from everything
+    HepMC::GenParticle* last = 0;
+    for( HepMC::GenEvent::particle_iterator p = evt->particles_begin();
+         p != evt->particles_end(); ++p ) {
+	if( !(*p)->end_vertex() ) last = *p;
+    }
+    HepMC::GenVertex* v0 = evt->barcode_to_vertex(-1);
+    HepMC::GenParticle* first = *v0->particles_out_const_begin();
+    if( evt->is_ancestor( last, first ) || !evt->has_genealogy_index() ) {
+	std::cerr << "ERROR: unexpected ancestor before the loop" << std::endl;
+	++numbad;
+    }
+    v0->add_particle_in( last );
+    if( evt->has_genealogy_index() ) {
+	std::cerr << "ERROR: genealogy index not invalidated" << std::endl;
+	++numbad;
+    }
+    if( !evt->is_ancestor( last, first ) || !evt->is_ancestor( first, last ) ) {
+	std::cerr << "ERROR: loop not found" << std::endl;
+	++numbad;
+    }
+    numbad += compare( *evt, evt->genealogy_index(), "loop" );
+    numbad += compare( *evt, HepMC::GenealogyIndex( *evt, 0 ), "loop, intervals" );
+    HepMC::GenVertex* extra = new HepMC::GenVertex();
+    evt->add_vertex( extra );
+    if( evt->has_genealogy_index() ) {
+	std::cerr << "ERROR: genealogy index not invalidated by add_vertex" << std::endl;
+	++numbad;
+    }
+    delete evt;
+
+    // is a particle descended from the first particles?
+    evt = build_shower( 2000 );
+    std::vector<HepMC::GenParticle*> roots, all;
+    v0 = evt->barcode_to_vertex(-1);
+    roots.assign( v0->particles_out_const_begin(), v0->particles_out_const_end() );
+    for( HepMC::GenEvent::particle_iterator p = evt->particles_begin();
+         p != evt->particles_end(); ++p ) {
+	if( (*p)->barcode() % 20 == 0 ) all.push_back( *p );
+    }
+    std::size_t nold = 0, nnew = 0;
+    for( std::size_t i = 0; i < all.size(); ++i ) {
+	std::set<const HepMC::GenParticle*> anc = ancestors_of( all[i] );
+	if( anc.count( roots[0] ) ) ++nold;
+    }
+    for( std::size_t i = 0; i < all.size(); ++i ) {
+	if( evt->is_ancestor( roots[0], all[i] ) ) ++nnew;
+    }
+    if( nold != nnew ) {
+	std::cerr << "ERROR: " << nold << " descendants from particle_iterator, "
+	          << nnew << " from the genealogy index" << std::endl;
+	++numbad;
+    }
+    delete evt;
+    if( numbad > 0 ) std::cerr << numbad << " errors in testGenealogyIndex" << std::endl;
+    return numbad;
+}
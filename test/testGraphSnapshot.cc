@@ -0,0 +1,122 @@
+//////////////////////////////////////////////////////////////////////////
+// testGraphSnapshot.cc
+//
+// compare GraphSnapshot with the GenVertex iterators
+//////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/GraphSnapshot.h"
+
+#include "testEvents.h"
+
+int main() {
+
+    int numbad = 0;
+    HepMC::GenEvent* evt = build_shower( 3000, true );
+    // a second, unconnected, decay
+    HepMC::GenVertex* lone = new HepMC::GenVertex();
+    evt->add_vertex( lone );
+    lone->add_particle_in( new HepMC::GenParticle( HepMC::FourVector(0,0,1,1), 22, 1 ) );
+    lone->add_particle_out( new HepMC::GenParticle( HepMC::FourVector(0,0,1,1), 22, 1 ) );
+
+    HepMC::GraphSnapshot g( *evt );
+    if( g.vertices_size() != evt->vertices_size() ||
+        g.particles_size() != evt->particles_size() ) {
+	std::cerr << "ERROR: snapshot has " << g.vertices_size() << " vertices and "
+	          << g.particles_size() << " particles" << std::endl;
+	++numbad;
+    }
+
+    // the CSR arrays reproduce the pointers
+    for( int v = 0; v < g.vertices_size(); ++v ) {
+	HepMC::GenVertex* vtx = g.vertex(v);
+	std::vector<HepMC::GenParticle*> in, out;
+	for( const int* p = g.particles_in_begin(v); p != g.particles_in_end(v); ++p ) {
+	    in.push_back( g.particle(*p) );
+	    if( g.end_vertex(*p) != v ) ++numbad;
+	}
+	for( const int* p = g.particles_out_begin(v); p != g.particles_out_end(v); ++p ) {
+	    out.push_back( g.particle(*p) );
+	    if( g.production_vertex(*p) != v ) ++numbad;
+	}
+	if( g.index(vtx) != v ||
+	    in != std::vector<HepMC::GenParticle*>( vtx->particles_in_const_begin(),
+	                                            vtx->particles_in_const_end() ) ||
+	    out != std::vector<HepMC::GenParticle*>( vtx->particles_out_const_begin(),
+	                                             vtx->particles_out_const_end() ) ) {
+	    std::cerr << "ERROR: CSR arrays differ for vertex " << vtx->barcode() << std::endl;
+	    ++numbad;
+	}
+    }
+    for( int p = 0; p < g.particles_size(); ++p ) {
+	if( g.index( g.particle(p) ) != p ) ++numbad;
+    }
+
+    // the same vertices as the iterators, in any order
+    HepMC::IteratorRange ranges[6] = { HepMC::parents, HepMC::children,
+                                       HepMC::family, HepMC::ancestors,
+				       HepMC::descendants, HepMC::relatives };
+    std::vector<int> found;
+    for( int v = 0; v < g.vertices_size(); v += 97 ) {
+	for( int r = 0; r < 6; ++r ) {
+	    std::set<HepMC::GenVertex*> vold, vnew;
+	    for( HepMC::GenVertex::vertex_iterator i = g.vertex(v)->vertices_begin(ranges[r]);
+	         i != g.vertex(v)->vertices_end(ranges[r]); ++i ) vold.insert( *i );
+	    g.vertices( v, ranges[r], found );
+	    for( std::size_t i = 0; i < found.size(); ++i ) vnew.insert( g.vertex(found[i]) );
+	    if( vold != vnew || vnew.size() != found.size() || found[0] != v ) {
+	        std::cerr << "ERROR: vertices differ for vertex " << g.vertex(v)->barcode()
+		          << " range " << r << std::endl;
+		++numbad;
+	    }
+	}
+    }
+
+    // decay chains
+    for( int p = 0; p < g.particles_size(); p += 89 ) {
+	std::set<HepMC::GenParticle*> pold, pnew;
+	pold.insert( g.particle(p) );
+	if( HepMC::GenVertex* end = g.particle(p)->end_vertex() ) {
+	    for( HepMC::GenVertex::particle_iterator i = end->particles_begin(HepMC::descendants);
+		 i != end->particles_end(HepMC::descendants); ++i ) pold.insert( *i );
+	}
+	g.decay_chain( p, found );
+	for( std::size_t i = 0; i < found.size(); ++i ) pnew.insert( g.particle(found[i]) );
+	if( pold != pnew || pnew.size() != found.size() || found[0] != p ) {
+	    std::cerr << "ERROR: decay chain differs for particle "
+	              << g.particle(p)->barcode() << std::endl;
+	    ++numbad;
+	}
+    }
+
+    // the shower and the lone vertex
+    std::vector<int> component;
+    int ncomp = g.connected_components( component );
+    if( ncomp != 2 || component[ g.index(lone) ] == component[0] ) {
+	std::cerr << "ERROR: " << ncomp << " connected components" << std::endl;
+	++numbad;
+    }
+    // the particles below the first vertex, which is the whole shower
+    HepMC::GenVertex* root = evt->barcode_to_vertex(-1);
+    std::size_t nold = 0, nnew = 0;
+    for( HepMC::GenVertex::particle_iterator p = root->particles_begin(HepMC::descendants);
+         p != root->particles_end(HepMC::descendants); ++p ) ++nold;
+    g.vertices( g.index( root ), HepMC::descendants, found );
+    for( std::size_t k = 0; k < found.size(); ++k ) {
+	nnew += g.particles_out_size( found[k] );
+    }
+    if( nold != nnew ) {
+	std::cerr << "ERROR: " << nold << " particles from particle_iterator, "
+	          << nnew << " from GraphSnapshot" << std::endl;
+	++numbad;
+    }
+
+    delete evt;
+    if( numbad > 0 ) std::cerr << numbad << " errors in testGraphSnapshot" << std::endl;
+    return numbad;
+}
@@ -0,0 +1,102 @@
+//////////////////////////////////////////////////////////////////////////
+// testGraphTraversal.cc
+//
+// compare GraphTraversal with the GenVertex iterators, also with several
+// threads walking the same event
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/GraphTraversal.h"
+
+#include "testEvents.h"
+
+int main() {
+
+    int numbad = 0;
+    HepMC::GenEvent* evt = build_shower( 3000, true );
+    HepMC::GraphTraversal walk;
+    HepMC::IteratorRange ranges[6] = { HepMC::parents, HepMC::children,
+                                       HepMC::family, HepMC::ancestors,
+				       HepMC::descendants, HepMC::relatives };
+
+    // same vertices and particles, in the same order, as the iterators
+    for( HepMC::GenEvent::vertex_iterator v = evt->vertices_begin();
+         v != evt->vertices_end(); ++v ) {
+	if( (*v)->barcode() % 97 != -1 ) continue;
+	for( int r = 0; r < 6; ++r ) {
+	    std::vector<HepMC::GenVertex*> vold;
+	    for( HepMC::GenVertex::vertex_iterator i = (*v)->vertices_begin(ranges[r]);
+	         i != (*v)->vertices_end(ranges[r]); ++i ) vold.push_back( *i );
+	    if( vold != walk.vertices( **v, ranges[r] ) ) {
+	        std::cerr << "ERROR: vertices differ for vertex " << (*v)->barcode()
+		          << " range " << r << std::endl;
+		++numbad;
+	    }
+	    std::vector<HepMC::GenParticle*> pold;
+	    for( HepMC::GenVertex::particle_iterator i = (*v)->particles_begin(ranges[r]);
+	         i != (*v)->particles_end(ranges[r]); ++i ) pold.push_back( *i );
+	    if( pold != walk.particles( **v, ranges[r] ) ) {
+	        std::cerr << "ERROR: particles differ for vertex " << (*v)->barcode()
+		          << " range " << r << std::endl;
+		++numbad;
+	    }
+	}
+    }
+
+    // several threads walking the same event, each with its own traversal
+    {
+	const int nthreads = 4;
+	std::vector<HepMC::GenVertex*> roots;
+	for( HepMC::GenEvent::vertex_iterator v = evt->vertices_begin();
+	     v != evt->vertices_end(); ++v ) {
+	    if( (*v)->barcode() % 7 == 0 ) roots.push_back( *v );
+	}
+	std::vector<std::size_t> expect;
+	for( std::size_t i = 0; i < roots.size(); ++i ) {
+	    expect.push_back( walk.particles( *roots[i], HepMC::relatives ).size()
+	                      + walk.vertices( *roots[i], HepMC::ancestors ).size() );
+	}
+	std::vector<int> errors( nthreads, 0 );
+	std::vector<std::thread> threads;
+	for( int t = 0; t < nthreads; ++t ) {
+	    threads.push_back( std::thread( [&, t]() {
+		    HepMC::GraphTraversal mine;
+		    for( int repeat = 0; repeat < 5; ++repeat ) {
+			for( std::size_t i = 0; i < roots.size(); ++i ) {
+			    std::size_t n = mine.particles( *roots[i], HepMC::relatives ).size()
+			                    + mine.vertices( *roots[i], HepMC::ancestors ).size();
+			    if( n != expect[i] ) ++errors[t];
+			}
+		    }
+		} ) );
+	}
+	for( int t = 0; t < nthreads; ++t ) {
+	    threads[t].join();
+	    if( errors[t] ) {
+		std::cerr << "ERROR: thread " << t << " found " << errors[t]
+		          << " walks which differ" << std::endl;
+		++numbad;
+	    }
+	}
+    }
+
+    // the particles below the first vertex, which is the whole shower
+    HepMC::GenVertex* root = evt->barcode_to_vertex(-1);
+    std::size_t nold = 0;
+    for( HepMC::GenVertex::particle_iterator p = root->particles_begin(HepMC::descendants);
+         p != root->particles_end(HepMC::descendants); ++p ) ++nold;
+    std::size_t nnew = walk.particles( *root, HepMC::descendants ).size();
+    if( nold != nnew ) {
+	std::cerr << "ERROR: " << nold << " particles from particle_iterator, "
+	          << nnew << " from GraphTraversal" << std::endl;
+	++numbad;
+    }
+
+    delete evt;
+    if( numbad > 0 ) std::cerr << numbad << " errors in testGraphTraversal" << std::endl;
+    return numbad;
+}
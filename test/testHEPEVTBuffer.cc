@@ -0,0 +1,138 @@
+//////////////////////////////////////////////////////////////////////////
+// testHEPEVTBuffer.cc
+//
+// check HEPEVT_Buffer storage and floorplans, and that events converted
+// through buffers of their own on several threads come out as those
+// converted through the HEPEVT common block
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/HEPEVT_Buffer.h"
+#include "HepMC/HEPEVT_Wrapper.h"
+#include "HepMC/IO_HEPEVT.h"
+
+#include "testEvents.h"
+
+// the common block, which a fortran generator would otherwise provide
+decltype(hepevt) hepevt;
+
+// a chain of decays whose length depends on the number
+HepMC::GenEvent* make_event( int number )
+{
+    return make_chain_event( number, 10 + number % 40 );
+}
+
+int main()
+{
+    int numbad = 0;
+
+    // storage of its own, growing with the floorplan
+    HepMC::HEPEVT_Buffer owned( 100 );
+    if ( !owned.owns_data() || owned.bytes() != 4 * ( 2 + 600 ) + 8 * 900
+	 || owned.capacity() < owned.bytes() ) {
+	std::cerr << "ERROR: buffer of 100 entries has " << owned.capacity() << " bytes" << std::endl;
+	++numbad;
+    }
+    owned.set_max_number_entries( 10000 );
+    owned.set_sizeof_int( sizeof(long int) );
+    HepMC::HEPEVT_Layout<long int,double> wide = owned.layout<long int,double>();
+    wide.set_number_entries( 10000 );
+    wide.set_position( 10000, 1, 2, 3, 4 );
+    if ( owned.capacity() < owned.bytes() || wide.t(10000) != 4 || wide.px(10000) != 0 ) {
+	std::cerr << "ERROR: buffer did not grow" << std::endl;
+	++numbad;
+    }
+
+    // a view can not grow
+    std::vector<double> storage( 2000 );
+    HepMC::HEPEVT_Buffer view( &storage[0], storage.size() * sizeof(double), 100, 4, sizeof(double) );
+    HepMC::HEPEVT_Wrapper::set_max_number_entries( 4000 );
+    HepMC::HEPEVT_Wrapper::set_sizeof_int( 4 );
+    HepMC::HEPEVT_Wrapper::set_sizeof_real( sizeof(double) );
+    HepMC::IO_HEPEVT io;
+    HepMC::GenEvent* evt = make_event( 1 );
+    io.write_event( evt, view );
+    HepMC::GenEvent read;
+    if ( view.owns_data() || !io.fill_next_event( view, &read )
+	 || read.particles_size() != evt->particles_size() ) {
+	std::cerr << "ERROR: event through a view" << std::endl;
+	++numbad;
+    }
+    std::cerr << "expect messages about the allocation:" << std::endl;
+    view.set_max_number_entries( 1000 );
+    if ( io.fill_next_event( view, &read ) ) {
+	std::cerr << "ERROR: view larger than its storage accepted" << std::endl;
+	++numbad;
+    }
+    view.set_max_number_entries( 100 );
+
+    // the common block is one buffer among others
+    io.write_event( evt );
+    HepMC::HEPEVT_Buffer copy( HepMC::HEPEVT_Wrapper::common_block() );
+    HepMC::HEPEVT_Wrapper::zero_everything();
+    HepMC::GenEvent from_copy;
+    if ( !copy.owns_data() || copy.max_number_entries() != 4000
+	 || HepMC::HEPEVT_Wrapper::number_entries() != 0
+	 || !io.fill_next_event( copy, &from_copy )
+	 || from_copy.fingerprint() != read.fingerprint() ) {
+	std::cerr << "ERROR: copy of the common block" << std::endl;
+	++numbad;
+    }
+    view = copy;
+    if ( view.max_number_entries() != 100 ) {
+	std::cerr << "ERROR: view took a floorplan larger than its storage" << std::endl;
+	++numbad;
+    }
+    copy.set_max_number_entries( 100 );
+    io.write_event( evt, copy );
+    view = copy;
+    if ( std::memcmp( view.data(), copy.data(), copy.bytes() ) != 0 ) {
+	std::cerr << "ERROR: assignment to a view" << std::endl;
+	++numbad;
+    }
+    delete evt;
+
+    // conversion on several threads, against the common block
+    const int nevents = 200, nthreads = 4;
+    std::vector<HepMC::EventFingerprint> expect;
+    for ( int i = 0; i < nevents; ++i ) {
+	HepMC::GenEvent* e = make_event( i );
+	io.write_event( e );
+	HepMC::GenEvent back;
+	io.fill_next_event( &back );
+	expect.push_back( back.fingerprint() );
+	delete e;
+    }
+    std::vector<int> errors( nthreads, 0 );
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < nthreads; ++t ) {
+	threads.push_back( std::thread( [&, t]() {
+		HepMC::IO_HEPEVT converter;
+		HepMC::HEPEVT_Buffer buffer( 200 );
+		for ( int i = t; i < nevents; i += nthreads ) {
+		    HepMC::GenEvent* e = make_event( i );
+		    converter.write_event( e, buffer );
+		    HepMC::GenEvent back;
+		    if ( !converter.fill_next_event( buffer, &back )
+			 || back.fingerprint() != expect[i] ) ++errors[t];
+		    delete e;
+		}
+	    } ) );
+    }
+    for ( int t = 0; t < nthreads; ++t ) {
+	threads[t].join();
+	if ( errors[t] ) {
+	    std::cerr << "ERROR: thread " << t << " converted " << errors[t]
+	              << " events differently" << std::endl;
+	    ++numbad;
+	}
+    }
+
+    if ( numbad > 0 ) std::cerr << numbad << " errors in testHEPEVTBuffer" << std::endl;
+    return numbad;
+}
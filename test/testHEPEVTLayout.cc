@@ -0,0 +1,181 @@
+//////////////////////////////////////////////////////////////////////////
+// testHEPEVTLayout.cc
+//
+// check that HEPEVT_Layout reads and writes the HEPEVT common block as
+// HEPEVT_Wrapper does, for each floorplan, that IO_HEPEVT gives back the
+// events it wrote
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/HEPEVT_Wrapper.h"
+#include "HepMC/IO_HEPEVT.h"
+
+#include "testEvents.h"
+
+// the common block, which a fortran generator would otherwise provide
+decltype(hepevt) hepevt;
+
+template <class IntT, class RealT>
+void use_floorplan( int nentries )
+{
+    HepMC::HEPEVT_Wrapper::set_sizeof_int( sizeof(IntT) );
+    HepMC::HEPEVT_Wrapper::set_sizeof_real( sizeof(RealT) );
+    HepMC::HEPEVT_Wrapper::set_max_number_entries( nentries );
+}
+
+// the same entry, read with the wrapper and with the layout
+template <class Layout>
+bool same_entry( const Layout& block, int i )
+{
+    typedef HepMC::HEPEVT_Wrapper W;
+    return block.status(i) == W::status(i) && block.id(i) == W::id(i)
+	&& block.first_parent(i) == W::first_parent(i) && block.last_parent(i) == W::last_parent(i)
+	&& block.number_parents(i) == W::number_parents(i)
+	&& block.first_child(i) == W::first_child(i) && block.last_child(i) == W::last_child(i)
+	&& block.number_children(i) == W::number_children(i)
+	&& block.px(i) == W::px(i) && block.py(i) == W::py(i) && block.pz(i) == W::pz(i)
+	&& block.e(i) == W::e(i) && block.m(i) == W::m(i)
+	&& block.x(i) == W::x(i) && block.y(i) == W::y(i) && block.z(i) == W::z(i)
+	&& block.t(i) == W::t(i);
+}
+
+// write with the wrapper and read with the layout, then the other way round
+template <class IntT, class RealT>
+int check_floorplan( const char* name )
+{
+    typedef HepMC::HEPEVT_Wrapper W;
+    const int nentries = 100;
+    int numbad = 0;
+    use_floorplan<IntT,RealT>( nentries );
+    W::zero_everything();
+    W::set_event_number( 7 );
+    // one entry less than allocated, so that some children are out of range
+    W::set_number_entries( nentries - 1 );
+    for ( int i = 1; i < nentries; ++i ) {
+	W::set_status( i, i % 3 + 1 );
+	W::set_id( i, 100 + i );
+	W::set_parents( i, i / 2, i / 2 + 1 );
+	W::set_children( i, 2 * i, 2 * i + 1 );
+	W::set_momentum( i, i, -i, 0.5 * i, 2 * i );
+	W::set_mass( i, 0.25 * i );
+	W::set_position( i, 0.5, i, 0, i );
+    }
+    HepMC::HEPEVT_Layout<IntT,RealT> block = W::layout<IntT,RealT>();
+    if ( block.event_number() != 7 || block.number_entries() != nentries - 1
+	 || block.max_number_entries() != nentries ) ++numbad;
+    for ( int i = 1; i < nentries; ++i ) {
+	if ( !same_entry( block, i ) ) ++numbad;
+    }
+    for ( int i = 1; i < nentries; ++i ) {
+	block.set_id( i, -W::id(i) );
+	block.set_parents( i, 0, 0 );
+	block.set_momentum( i, 1, 2, 3, i );
+	block.set_position( i, 0, 0, 0, -i );
+    }
+    for ( int i = 1; i < nentries; ++i ) {
+	if ( W::id(i) != -100 - i || W::first_parent(i) != 0 || W::e(i) != i
+	     || W::t(i) != -i || !same_entry( block, i ) ) ++numbad;
+    }
+    W::zero_everything();
+    if ( W::number_entries() != 0 || block.status(1) != 0 || block.px(nentries) != 0
+	 || block.t(nentries) != 0 ) ++numbad;
+    if ( numbad > 0 ) {
+	std::cerr << "ERROR: " << numbad << " differences with " << name << std::endl;
+    }
+    return numbad;
+}
+
+// the bytes of the common block in use
+std::vector<char> block_bytes()
+{
+    std::size_t n = HepMC::HEPEVT_Wrapper::sizeof_int()
+	* ( 2 + 6 * HepMC::HEPEVT_Wrapper::max_number_entries() )
+	+ HepMC::HEPEVT_Wrapper::sizeof_real() * 9 * HepMC::HEPEVT_Wrapper::max_number_entries();
+    return std::vector<char>( hepevt.data, hepevt.data + n );
+}
+
+// write an event, read it back and write it again: the blocks agree
+template <class IntT, class RealT>
+int check_io( const char* name )
+{
+    use_floorplan<IntT,RealT>( 4000 );
+    HepMC::HEPEVT_Wrapper::zero_everything();
+    HepMC::IO_HEPEVT io;
+    HepMC::GenEvent* evt = make_chain_event( 3, 50 );
+    io.write_event( evt );
+    std::vector<char> first = block_bytes();
+    HepMC::GenEvent read;
+    HepMC::HEPEVT_Wrapper::zero_everything();
+    std::memcpy( hepevt.data, &first[0], first.size() );
+    bool ok = io.fill_next_event( &read );
+    HepMC::HEPEVT_Wrapper::zero_everything();
+    io.write_event( &read );
+    int numbad = 0;
+    if ( !ok || read.event_number() != 3 || read.particles_size() != evt->particles_size()
+	 || read.vertices_size() != evt->vertices_size()
+	 || read.beam_particles().second->momentum().pz() != -7000
+	 || HepMC::HEPEVT_Wrapper::check_hepevt_consistency( std::cerr ) != true
+	 || block_bytes() != first ) {
+	std::cerr << "ERROR: IO_HEPEVT round trip with " << name << std::endl;
+	++numbad;
+    }
+    delete evt;
+    return numbad;
+}
+
+int main()
+{
+    int numbad = 0;
+
+    numbad += check_floorplan<short int,float>( "short int, float" );
+    numbad += check_floorplan<short int,double>( "short int, double" );
+    numbad += check_floorplan<int,float>( "int, float" );
+    numbad += check_floorplan<int,double>( "int, double" );
+    numbad += check_floorplan<long int,float>( "long int, float" );
+    numbad += check_floorplan<long int,double>( "long int, double" );
+
+    numbad += check_io<int,double>( "int, double" );
+    numbad += check_io<short int,float>( "short int, float" );
+
+    // a fixed size block, outside the common block
+    typedef HepMC::HEPEVT_Layout<int,double,10000> Block;
+    std::vector<double> storage( Block::bytes() / sizeof(double) + 1 );
+    Block fixed( &storage[0] );
+    fixed.zero_everything();
+    fixed.set_number_entries( 10000 );
+    fixed.set_momentum( 10000, 1, 2, 3, 4 );
+    fixed.set_children( 10000, 9999, 10000 );
+    if ( fixed.max_number_entries() != 10000 || fixed.e(10000) != 4
+	 || fixed.last_child(10000) != 10000 || fixed.number_children(10000) != 2
+	 || storage.back() != 0 ) {
+	std::cerr << "ERROR: fixed size layout" << std::endl;
+	++numbad;
+    }
+
+    // every field of a filled block, read both ways
+    const int nentries = 1000;
+    use_floorplan<int,double>( nentries );
+    HepMC::HEPEVT_Layout<int,double> block = HepMC::HEPEVT_Wrapper::layout<int,double>();
+    block.zero_everything();
+    block.set_number_entries( nentries );
+    for ( int i = 1; i <= nentries; ++i ) {
+	block.set_id( i, 211 );
+	block.set_parents( i, i / 2, i / 2 );
+	block.set_momentum( i, i, 0, 0, i );
+	block.set_position( i, 0, 0, i, i );
+    }
+    for ( int i = 1; i <= nentries; ++i ) {
+	if ( !same_entry( block, i ) ) {
+	    std::cerr << "ERROR: entry " << i << " of a filled block differs" << std::endl;
+	    ++numbad;
+	    break;
+	}
+    }
+
+    if ( numbad > 0 ) std::cerr << numbad << " errors in testHEPEVTLayout" << std::endl;
+    return numbad;
+}
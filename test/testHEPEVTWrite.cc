@@ -0,0 +1,112 @@
+//////////////////////////////////////////////////////////////////////////
+// testHEPEVTWrite.cc
+//
+// check that IO_HEPEVT::write_event fills the HEPEVT common block as the
+// former implementation, with a map from particles to indices, did
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/HEPEVT_Wrapper.h"
+#include "HepMC/IO_HEPEVT.h"
+
+#include "testEvents.h"
+
+// the common block, which a fortran generator would otherwise provide
+decltype(hepevt) hepevt;
+
+typedef HepMC::HEPEVT_Wrapper W;
+
+// the former IO_HEPEVT::write_event
+void reference_write_event( const HepMC::GenEvent* evt )
+{
+    std::vector<HepMC::GenParticle*> index_to_particle( W::max_number_entries()+1 );
+    std::map<HepMC::GenParticle*,int> particle_to_index;
+    int particle_counter = 0;
+    for ( HepMC::GenEvent::vertex_const_iterator v = evt->vertices_begin();
+	  v != evt->vertices_end(); ++v ) {
+	for ( HepMC::GenVertex::particles_in_const_iterator p1 = (*v)->particles_in_const_begin();
+	      p1 != (*v)->particles_in_const_end(); ++p1 ) {
+	    ++particle_counter;
+	    if ( particle_counter > W::max_number_entries() ) break;
+	    index_to_particle[particle_counter] = *p1;
+	    particle_to_index[*p1] = particle_counter;
+	}
+	for ( HepMC::GenVertex::particles_out_const_iterator p2 = (*v)->particles_out_const_begin();
+	      p2 != (*v)->particles_out_const_end(); ++p2 ) {
+	    if ( !(*p2)->end_vertex() ) {
+		++particle_counter;
+		if ( particle_counter > W::max_number_entries() ) break;
+		index_to_particle[particle_counter] = *p2;
+		particle_to_index[*p2] = particle_counter;
+	    }
+	}
+    }
+    if ( particle_counter > W::max_number_entries() ) particle_counter = W::max_number_entries();
+    W::set_event_number( evt->event_number() );
+    W::set_number_entries( particle_counter );
+    for ( int i = 1; i <= particle_counter; ++i ) {
+	HepMC::GenParticle* p = index_to_particle[i];
+	W::set_status( i, p->status() );
+	W::set_id( i, p->pdg_id() );
+	HepMC::FourVector m = p->momentum();
+	W::set_momentum( i, m.px(), m.py(), m.pz(), m.e() );
+	W::set_mass( i, p->generated_mass() );
+	if ( p->production_vertex() && p->production_vertex()->particles_in_size() ) {
+	    HepMC::FourVector x = p->production_vertex()->position();
+	    W::set_position( i, x.x(), x.y(), x.z(), x.t() );
+	    int num_mothers = p->production_vertex()->particles_in_size();
+	    std::map<HepMC::GenParticle*,int>::const_iterator found
+		= particle_to_index.find( *p->production_vertex()->particles_in_const_begin() );
+	    int first_mother = found == particle_to_index.end() ? 0 : found->second;
+	    int last_mother = first_mother + num_mothers - 1;
+	    if ( first_mother == 0 ) last_mother = 0;
+	    W::set_parents( i, first_mother, last_mother );
+	} else {
+	    W::set_position( i, 0, 0, 0, 0 );
+	    W::set_parents( i, 0, 0 );
+	}
+	W::set_children( i, 0, 0 );
+    }
+}
+
+std::vector<char> block_bytes()
+{
+    std::size_t n = W::sizeof_int() * ( 2 + 6 * W::max_number_entries() )
+	+ W::sizeof_real() * 9 * W::max_number_entries();
+    return std::vector<char>( hepevt.data, hepevt.data + n );
+}
+
+int main()
+{
+    int numbad = 0;
+    HepMC::IO_HEPEVT io;
+
+    // dense and sparse vertex barcodes, and blocks too small for the event
+    const int max_entries[] = { 4000, 100, 31 };
+    for ( int m = 0; m < 3; ++m ) {
+	W::set_max_number_entries( max_entries[m] );
+	for ( int step = 1; step <= 3; step += 2 ) {
+	    for ( int depth = 1; depth <= 6; ++depth ) {
+		HepMC::GenEvent* evt = make_tree_event( depth, depth, step );
+		W::zero_everything();
+		reference_write_event( evt );
+		std::vector<char> expect = block_bytes();
+		W::zero_everything();
+		io.write_event( evt );
+		if ( block_bytes() != expect ) {
+		    std::cerr << "ERROR: event of depth " << depth << " with barcode step "
+		              << step << " in " << max_entries[m] << " entries differs" << std::endl;
+		    ++numbad;
+		}
+		delete evt;
+	    }
+	}
+    }
+
+    if ( numbad > 0 ) std::cerr << numbad << " errors in testHEPEVTWrite" << std::endl;
+    return numbad;
+}
@@ -0,0 +1,194 @@
+//////////////////////////////////////////////////////////////////////////
+// testParallel.cc
+//
+// compare the parallel algorithms with serial loops, check concurrent
+// read-only access to an event, for several pool sizes
+//////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/GenealogyIndex.h"
+#include "HepMC/ParallelAlgorithms.h"
+
+#include "testEvents.h"
+
+// what one thread reads from the event
+struct Reading {
+    double            sum;
+    std::size_t       descendants;
+    std::size_t       ancestors;
+};
+
+Reading read_event( const HepMC::GenEvent& evt, 
+                    const std::vector<HepMC::GenParticle*>& sample )
+{
+    Reading r = { 0, 0, 0 };
+    for( HepMC::GenEvent::particle_const_iterator p = evt.particles_begin();
+         p != evt.particles_end(); ++p ) r.sum += (*p)->momentum().e();
+    HepMC::GenVertex* root = evt.barcode_to_vertex(-1);
+    for( HepMC::GenVertex::particle_iterator p = root->particles_begin(HepMC::descendants);
+         p != root->particles_end(HepMC::descendants); ++p ) ++r.descendants;
+    for( std::size_t i = 0; i < sample.size(); ++i ) {
+	for( std::size_t j = 0; j < sample.size(); ++j ) {
+	    if( evt.is_ancestor( sample[i], sample[j] ) ) ++r.ancestors;
+	}
+    }
+    return r;
+}
+
+int main() {
+
+    int numbad = 0;
+    HepMC::GenEvent* evt = make_balanced_shower( 30000 );
+    // every hundredth vertex does not conserve momentum, and neither does
+    // the decay vertex of the particle changed
+    for( int bc = -100; bc >= -30000; bc -= 100 ) {
+	HepMC::GenParticle* p = *( evt->barcode_to_vertex( bc )->particles_out_const_end() - 1 );
+	HepMC::FourVector m = p->momentum();
+	p->set_momentum( HepMC::FourVector( m.px(), m.py() + 1, m.pz(), m.e() ) );
+    }
+    HepMC::GraphSnapshot g( *evt );
+
+    // serial results
+    double sum[4] = { 0, 0, 0, 0 };
+    std::map<int,int> status;
+    for( int i = 0; i < g.particles_size(); ++i ) {
+	const HepMC::FourVector& m = g.particle(i)->momentum();
+	++status[ g.particle(i)->status() ];
+	if( g.particle(i)->status() != 1 ) continue;
+	sum[0] += m.px(); sum[1] += m.py(); sum[2] += m.pz(); sum[3] += m.e();
+    }
+    std::vector<int> unbalanced;
+    for( int v = 0; v < g.vertices_size(); ++v ) {
+	if( g.vertex(v)->particles_in_size() == 0 ) continue;
+	double d[4] = { 0, 0, 0, 0 };
+	for( HepMC::GenVertex::particles_in_const_iterator p = g.vertex(v)->particles_in_const_begin();
+	     p != g.vertex(v)->particles_in_const_end(); ++p ) {
+	    const HepMC::FourVector& m = (*p)->momentum();
+	    d[0] += m.px(); d[1] += m.py(); d[2] += m.pz(); d[3] += m.e();
+	}
+	for( HepMC::GenVertex::particles_out_const_iterator p = g.vertex(v)->particles_out_const_begin();
+	     p != g.vertex(v)->particles_out_const_end(); ++p ) {
+	    const HepMC::FourVector& m = (*p)->momentum();
+	    d[0] -= m.px(); d[1] -= m.py(); d[2] -= m.pz(); d[3] -= m.e();
+	}
+	if( std::fabs( d[0] ) > 1e-9 || std::fabs( d[1] ) > 1e-9 ||
+	    std::fabs( d[2] ) > 1e-9 || std::fabs( d[3] ) > 1e-9 ) unbalanced.push_back( v );
+    }
+    if( unbalanced.size() < 300 ) {
+	std::cerr << "ERROR: only " << unbalanced.size() << " unbalanced vertices" << std::endl;
+	++numbad;
+    }
+
+    unsigned sizes[4] = { 1, 2, 3, 8 };
+    HepMC::FourVector first;
+    for( int s = 0; s < 4; ++s ) {
+	HepMC::ThreadPool pool( sizes[s] );
+	if( pool.size() != sizes[s] ) ++numbad;
+	HepMC::FourVector p = HepMC::parallel_sum_momentum( g, 1, pool );
+	if( s == 0 ) first = p;
+	if( p != first || std::fabs( p.e() - sum[3] ) > 1e-6 * sum[3] ||
+	    std::fabs( p.py() - sum[1] ) > 1e-6 ) {
+	    std::cerr << "ERROR: momentum sum differs with " << sizes[s] 
+	              << " threads" << std::endl;
+	    ++numbad;
+	}
+	if( HepMC::parallel_count_by_status( g, pool ) != status ) {
+	    std::cerr << "ERROR: status counts differ with " << sizes[s] 
+	              << " threads" << std::endl;
+	    ++numbad;
+	}
+	if( HepMC::parallel_check_momentum_conservation( g, 1e-9, pool ) != unbalanced ) {
+	    std::cerr << "ERROR: unbalanced vertices differ with " << sizes[s] 
+	              << " threads" << std::endl;
+	    ++numbad;
+	}
+	// each particle and vertex exactly once
+	std::vector<int> hits( g.particles_size(), 0 );
+	HepMC::parallel_for_particles( *evt, 
+	    [&]( HepMC::GenParticle* q ) { ++hits[ g.index(q) ]; }, pool );
+	std::vector<int> vhits( g.vertices_size(), 0 );
+	HepMC::parallel_for_vertices( g, 
+	    [&]( HepMC::GenVertex* v ) { ++vhits[ g.index(v) ]; }, pool );
+	if( hits != std::vector<int>( hits.size(), 1 ) ||
+	    vhits != std::vector<int>( vhits.size(), 1 ) ) {
+	    std::cerr << "ERROR: loop not complete with " << sizes[s] 
+	              << " threads" << std::endl;
+	    ++numbad;
+	}
+	// a nested loop runs in the calling thread
+	std::atomic<long> inner( 0 );
+	pool.run( 100, [&]( std::size_t b, std::size_t e ) {
+	    for( std::size_t i = b; i < e; ++i ) {
+		pool.run( 10, [&]( std::size_t b2, std::size_t e2 ) { inner += e2 - b2; } );
+	    }
+	}, 1 );
+	if( inner != 1000 ) {
+	    std::cerr << "ERROR: nested loop counted " << inner << std::endl;
+	    ++numbad;
+	}
+	// loops of another pool run from inside a loop, and run loops
+	// of the outer pool again, which must not wait for themselves
+	HepMC::ThreadPool other( 2 );
+	std::atomic<long> through( 0 );
+	pool.run( 20, [&]( std::size_t b, std::size_t e ) {
+	    for( std::size_t i = b; i < e; ++i ) {
+		other.run( 10, [&]( std::size_t b2, std::size_t e2 ) {
+		    for( std::size_t j = b2; j < e2; ++j ) {
+			pool.run( 5, [&]( std::size_t b3, std::size_t e3 ) { through += e3 - b3; }, 1 );
+		    }
+		}, 1 );
+	    }
+	}, 1 );
+	if( through != 1000 ) {
+	    std::cerr << "ERROR: loop nested through another pool counted "
+	              << through << std::endl;
+	    ++numbad;
+	}
+	// exceptions reach the caller, and the pool is usable afterwards
+	bool caught = false;
+	try {
+	    pool.run( 1000, [&]( std::size_t, std::size_t e ) {
+		if( e > 500 ) throw std::runtime_error( "stop" );
+	    }, 10 );
+	} catch( std::runtime_error& ) { caught = true; }
+	std::atomic<long> after( 0 );
+	pool.run( 1000, [&]( std::size_t b, std::size_t e ) { after += e - b; } );
+	if( !caught || after != 1000 ) {
+	    std::cerr << "ERROR: exception handling with " << sizes[s] 
+	              << " threads" << std::endl;
+	    ++numbad;
+	}
+    }
+
+    // several threads reading the same event
+    std::vector<HepMC::GenParticle*> sample;
+    for( int i = 0; i < g.particles_size(); i += 400 ) sample.push_back( g.particle(i) );
+    evt->build_genealogy_index();
+    Reading serial = read_event( *evt, sample );
+    std::vector<Reading> readings( 4 );
+    std::vector<std::thread> readers;
+    for( int t = 0; t < 4; ++t ) {
+	readers.push_back( std::thread( [&, t]() { readings[t] = read_event( *evt, sample ); } ) );
+    }
+    for( int t = 0; t < 4; ++t ) readers[t].join();
+    for( int t = 0; t < 4; ++t ) {
+	if( readings[t].sum != serial.sum || 
+	    readings[t].descendants != serial.descendants ||
+	    readings[t].ancestors != serial.ancestors ) {
+	    std::cerr << "ERROR: thread " << t << " read a different event" << std::endl;
+	    ++numbad;
+	}
+    }
+
+    delete evt;
+    if( numbad > 0 ) std::cerr << numbad << " errors in testParallel" << std::endl;
+    return numbad;
+}
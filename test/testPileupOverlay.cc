@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////////
+// testPileupOverlay.cc
+//
+// check that PileupOverlay merges events into a consistent event,
+// remembers where each particle and vertex came from
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/GenEventValidator.h"
+#include "HepMC/PileupOverlay.h"
+
+#include "testEvents.h"
+
+int main()
+{
+    int numbad = 0;
+    HepMC::GenEventValidator consistent( HepMC::GenEventValidator::barcodes
+                                         | HepMC::GenEventValidator::links
+                                         | HepMC::GenEventValidator::parent_event );
+
+    // a signal and a few sub-events, one of them empty
+    HepMC::GenEvent* signal = make_chain_event( 1, 5 );
+    std::map<const HepMC::GenParticle*,int> particle_origin;
+    std::map<const HepMC::GenVertex*,int> vertex_origin;
+    std::map<const HepMC::GenVertex*,HepMC::FourVector> position;
+    for ( HepMC::GenEvent::particle_const_iterator p = signal->particles_begin();
+	  p != signal->particles_end(); ++p ) particle_origin[*p] = 0;
+    for ( HepMC::GenEvent::vertex_const_iterator v = signal->vertices_begin();
+	  v != signal->vertices_end(); ++v ) {
+	vertex_origin[*v] = 0;
+	position[*v] = (*v)->position();
+    }
+    HepMC::GenVertex* signal_vertex = signal->signal_process_vertex();
+    HepMC::PileupOverlay overlay( *signal );
+    std::vector<HepMC::FourVector> shifts;
+    for ( int i = 1; i <= 4; ++i ) {
+	HepMC::GenEvent* minbias = ( i == 2 ? new HepMC::GenEvent() : make_chain_event( i + 1, i ) );
+	HepMC::FourVector shift( 0, 0, 10 * i, 25 * i );
+	for ( HepMC::GenEvent::particle_const_iterator p = minbias->particles_begin();
+	      p != minbias->particles_end(); ++p ) particle_origin[*p] = i;
+	for ( HepMC::GenEvent::vertex_const_iterator v = minbias->vertices_begin();
+	      v != minbias->vertices_end(); ++v ) {
+	    vertex_origin[*v] = i;
+	    HepMC::FourVector pos = (*v)->position();
+	    position[*v] = HepMC::FourVector( pos.x(), pos.y(), pos.z() + shift.z(), pos.t() + shift.t() );
+	}
+	if ( !overlay.add( *minbias, shift ) ) {
+	    std::cerr << "ERROR: sub-event " << i << " not added" << std::endl;
+	    ++numbad;
+	}
+	if ( !minbias->vertices_empty() || !minbias->particles_empty()
+	     || minbias->signal_process_vertex() || minbias->beam_particles().first ) {
+	    std::cerr << "ERROR: sub-event " << i << " not emptied" << std::endl;
+	    ++numbad;
+	}
+	delete minbias;
+    }
+    if ( overlay.add( *signal ) || overlay.sub_events_size() != 5 ) {
+	std::cerr << "ERROR: " << overlay.sub_events_size() << " sub-events" << std::endl;
+	++numbad;
+    }
+    if ( !consistent.is_valid( *signal ) ) {
+	HepMC::GenEventValidator::print( consistent.validate( *signal ), std::cerr );
+	++numbad;
+    }
+    if ( (std::size_t)signal->particles_size() != particle_origin.size()
+	 || (std::size_t)signal->vertices_size() != vertex_origin.size()
+	 || signal->signal_process_vertex() != signal_vertex
+	 || signal->event_number() != 1 ) {
+	std::cerr << "ERROR: merged event has " << signal->particles_size() << " particles and "
+	          << signal->vertices_size() << " vertices" << std::endl;
+	++numbad;
+    }
+    for ( HepMC::GenEvent::particle_const_iterator p = signal->particles_begin();
+	  p != signal->particles_end(); ++p ) {
+	if ( overlay.sub_event( *p ) != particle_origin[*p] ) {
+	    std::cerr << "ERROR: particle " << (*p)->barcode() << " from sub-event "
+	              << overlay.sub_event( *p ) << ", not " << particle_origin[*p] << std::endl;
+	    ++numbad;
+	}
+    }
+    for ( HepMC::GenEvent::vertex_const_iterator v = signal->vertices_begin();
+	  v != signal->vertices_end(); ++v ) {
+	if ( overlay.sub_event( *v ) != vertex_origin[*v] || (*v)->position() != position[*v] ) {
+	    std::cerr << "ERROR: vertex " << (*v)->barcode() << " from sub-event "
+	              << overlay.sub_event( *v ) << ", not " << vertex_origin[*v] << std::endl;
+	    ++numbad;
+	}
+    }
+    const HepMC::PileupOverlay::SubEvent& empty = overlay.sub_event( 2 );
+    if ( empty.last_particle >= empty.first_particle || empty.last_vertex <= empty.first_vertex ) {
+	std::cerr << "ERROR: empty sub-event has barcodes" << std::endl;
+	++numbad;
+    }
+    delete signal;
+
+    // barcodes which do not collide are kept, units are converted
+    HepMC::GenEvent target( HepMC::Units::GEV, HepMC::Units::MM );
+    HepMC::PileupOverlay into( target );
+    HepMC::GenEvent first( HepMC::Units::GEV, HepMC::Units::MM );
+    HepMC::GenVertex* v = new HepMC::GenVertex();
+    first.add_vertex( v );
+    v->add_particle_out( new HepMC::GenParticle( HepMC::FourVector(1,0,0,1), 22, 1 ) );
+    HepMC::GenEvent second( HepMC::Units::MEV, HepMC::Units::CM );
+    v = new HepMC::GenVertex( HepMC::FourVector(0,0,1,0) );
+    second.add_vertex( v );
+    v->suggest_barcode( -5 );
+    HepMC::GenParticle* photon = new HepMC::GenParticle( HepMC::FourVector(1000,0,0,1000), 22, 1 );
+    v->add_particle_out( photon );
+    photon->suggest_barcode( 20000 );
+    into.add( first );
+    into.add( second );
+    if ( photon->barcode() != 20000 || v->barcode() != -5
+	 || photon->momentum().e() != 1 || v->position().z() != 10
+	 || into.sub_event( photon ) != 2 || into.sub_event( v ) != 2
+	 || into.sub_event( target.barcode_to_particle( 10001 ) ) != 1 ) {
+	std::cerr << "ERROR: barcodes or units changed in overlay: " << photon->barcode()
+	          << " " << v->barcode() << " " << photon->momentum().e()
+	          << " " << v->position().z() << std::endl;
+	++numbad;
+    }
+
+    if ( numbad > 0 ) std::cerr << numbad << " errors in testPileupOverlay" << std::endl;
+    return numbad;
+}
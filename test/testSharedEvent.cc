@@ -0,0 +1,126 @@
+//////////////////////////////////////////////////////////////////////////
+// testSharedEvent.cc
+//
+// check that SharedEvent shares one event between readers, copies it for
+// a writer, and can be used by several threads at once
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/SharedEvent.h"
+
+#include "testEvents.h"
+
+// a read only analysis
+double energy_sum( const HepMC::GenEvent& evt )
+{
+    double sum = 0;
+    for ( HepMC::GenEvent::particle_const_iterator p = evt.particles_begin();
+	  p != evt.particles_end(); ++p ) sum += (*p)->momentum().e();
+    return sum;
+}
+
+// an analysis which modifies its event
+double scaled_energy_sum( HepMC::SharedEvent evt )
+{
+    HepMC::GenEvent* mine = evt.mutable_event();
+    for ( HepMC::GenEvent::particle_iterator p = mine->particles_begin();
+	  p != mine->particles_end(); ++p ) {
+	HepMC::FourVector m = (*p)->momentum();
+	(*p)->set_momentum( HepMC::FourVector( m.px(), m.py(), m.pz(), 2 * m.e() ) );
+    }
+    return energy_sum( *mine );
+}
+
+int main()
+{
+    int numbad = 0;
+
+    // copies share the event until one of them asks to modify it
+    HepMC::SharedEvent empty;
+    if ( !empty.empty() || empty.get() != 0 || empty.use_count() != 0
+	 || empty.mutable_event() != 0 || empty.release() != 0 ) {
+	std::cerr << "ERROR: empty handle is not empty" << std::endl;
+	++numbad;
+    }
+    HepMC::SharedEvent first( make_star_event( 1, 10 ) );
+    const HepMC::GenEvent* original = first.get();
+    double sum = energy_sum( *first );
+    HepMC::SharedEvent second( first );
+    HepMC::SharedEvent third;
+    third = second;
+    if ( second.get() != original || third.get() != original || first.use_count() != 3 ) {
+	std::cerr << "ERROR: copies do not share the event" << std::endl;
+	++numbad;
+    }
+    HepMC::GenEvent* modified = third.mutable_event();
+    modified->set_event_number( 2 );
+    modified->barcode_to_particle( 10002 )->set_pdg_id( 22 );
+    if ( modified == original || first.use_count() != 2 || !third.unique()
+	 || first->event_number() != 1 || second->barcode_to_particle( 10002 )->pdg_id() != 211
+	 || third->event_number() != 2 || energy_sum( *third ) != sum ) {
+	std::cerr << "ERROR: modified event is not a separate copy" << std::endl;
+	++numbad;
+    }
+    // the only handle modifies its event in place
+    if ( third.mutable_event() != modified ) {
+	std::cerr << "ERROR: unique event copied again" << std::endl;
+	++numbad;
+    }
+    if ( scaled_energy_sum( first ) != 2 * sum || energy_sum( *first ) != sum ) {
+	std::cerr << "ERROR: analysis modified the shared event" << std::endl;
+	++numbad;
+    }
+    // release hands out a copy while the event is shared
+    HepMC::GenEvent* released = second.release();
+    if ( released == original || !second.empty() || !first.unique()
+	 || released->event_number() != 1 ) {
+	std::cerr << "ERROR: release of a shared event" << std::endl;
+	++numbad;
+    }
+    delete released;
+    released = first.release();
+    if ( released != original ) {
+	std::cerr << "ERROR: release of a unique event made a copy" << std::endl;
+	++numbad;
+    }
+    first.reset( released );
+    third.reset();
+    if ( first.get() != original || !third.empty() ) {
+	std::cerr << "ERROR: reset" << std::endl;
+	++numbad;
+    }
+
+    // several analyses in different threads, one of them modifying the event
+    const int nthreads = 4;
+    for ( int round = 0; round < 20; ++round ) {
+	HepMC::SharedEvent evt( make_star_event( 1, 200 ) );
+	double expect = energy_sum( *evt );
+	std::vector<double> sums( nthreads, 0. );
+	std::vector<std::thread> threads;
+	for ( int t = 0; t < nthreads; ++t ) {
+	    HepMC::SharedEvent mine( evt );
+	    threads.push_back( std::thread( [mine, t, &sums]() {
+		    sums[t] = ( t == 0 ? scaled_energy_sum( mine ) / 2 : energy_sum( *mine ) );
+		} ) );
+	}
+	for ( int t = 0; t < nthreads; ++t ) threads[t].join();
+	for ( int t = 0; t < nthreads; ++t ) {
+	    if ( sums[t] != expect ) {
+		std::cerr << "ERROR: thread " << t << " saw sum " << sums[t]
+		          << ", not " << expect << std::endl;
+		++numbad;
+	    }
+	}
+	if ( !evt.unique() || energy_sum( *evt ) != expect ) {
+	    std::cerr << "ERROR: shared event changed by its readers" << std::endl;
+	    ++numbad;
+	}
+    }
+
+    if ( numbad > 0 ) std::cerr << numbad << " errors in testSharedEvent" << std::endl;
+    return numbad;
+}
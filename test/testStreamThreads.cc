@@ -0,0 +1,147 @@
+//////////////////////////////////////////////////////////////////////////
+// testStreamThreads.cc
+//
+// write and read several files at the same time, one stream per thread,
+// and check that the stream data of HepMC does not collide with the
+// user data of other code
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/IO_GenEvent.h"
+
+// a small event with named weights, different for each file and event
+HepMC::GenEvent* build_event( int file, int number )
+{
+    HepMC::GenEvent* evt = new HepMC::GenEvent( 20, number );
+    evt->weights()["nominal"] = 1.0 + file;
+    evt->weights()["scale_up"] = 0.5 * number;
+    HepMC::GenVertex* v0 = new HepMC::GenVertex( HepMC::FourVector(0,0,0,file) );
+    evt->add_vertex( v0 );
+    HepMC::GenParticle* b1 = new HepMC::GenParticle( HepMC::FourVector(0,0,100,100), 2212, 4 );
+    HepMC::GenParticle* b2 = new HepMC::GenParticle( HepMC::FourVector(0,0,-100,100), 2212, 4 );
+    v0->add_particle_in( b1 );
+    v0->add_particle_in( b2 );
+    evt->set_beam_particles( b1, b2 );
+    for( int i = 0; i < 20 + number % 7; ++i ) {
+	v0->add_particle_out( new HepMC::GenParticle(
+	    HepMC::FourVector( i, file, number, 10 * i + 1 ), 211, 1 ) );
+    }
+    return evt;
+}
+
+std::string file_name( int file )
+{
+    std::ostringstream name;
+    name << "testStreamThreads" << file << ".dat";
+    return name.str();
+}
+
+const int nfiles = 8;
+const int nevents = 200;
+
+void write_file( int file )
+{
+    HepMC::IO_GenEvent out( file_name( file ), std::ios::out );
+    for( int n = 1; n <= nevents; ++n ) {
+	HepMC::GenEvent* evt = build_event( file, n );
+	out << evt;
+	delete evt;
+    }
+}
+
+// the events read are kept, so that their weight names, shared with
+// the stream, are copied and released in other threads later
+void read_file( int file, std::vector<HepMC::GenEvent*>& events, int& numbad )
+{
+    HepMC::IO_GenEvent in( file_name( file ), std::ios::in );
+    for( HepMC::GenEvent* evt = in.read_next_event(); evt; evt = in.read_next_event() ) {
+	events.push_back( evt );
+    }
+    if( (int)events.size() != nevents ) {
+	std::cerr << "ERROR: " << events.size() << " events read from "
+	          << file_name( file ) << std::endl;
+	++numbad;
+    }
+}
+
+int main()
+{
+    int numbad = 0;
+
+    // write and read all files in parallel
+    std::vector<std::thread> threads;
+    for( int f = 0; f < nfiles; ++f ) threads.push_back( std::thread( write_file, f ) );
+    for( std::size_t i = 0; i < threads.size(); ++i ) threads[i].join();
+    threads.clear();
+    std::vector< std::vector<HepMC::GenEvent*> > events( nfiles );
+    std::vector<int> bad( nfiles, 0 );
+    for( int f = 0; f < nfiles; ++f ) {
+	threads.push_back( std::thread( read_file, f, std::ref( events[f] ), std::ref( bad[f] ) ) );
+    }
+    for( std::size_t i = 0; i < threads.size(); ++i ) threads[i].join();
+    threads.clear();
+
+    // check the events, each file in another thread than it was read in
+    for( int f = 0; f < nfiles; ++f ) {
+	threads.push_back( std::thread( [&events, &bad, f]() {
+	    const std::vector<HepMC::GenEvent*>& mine = events[( f + 1 ) % nfiles];
+	    int file = ( f + 1 ) % nfiles;
+	    for( std::size_t n = 0; n < mine.size(); ++n ) {
+		HepMC::GenEvent* expect = build_event( file, n + 1 );
+		HepMC::GenEvent copy( *mine[n] );
+		if( copy.fingerprint( 1e-12 ) != expect->fingerprint( 1e-12 )
+		    || !copy.weights().has_key( "scale_up" ) ) {
+		    std::cerr << "ERROR: event " << n + 1 << " of "
+		              << file_name( file ) << " differs" << std::endl;
+		    ++bad[f];
+		}
+		delete expect;
+		delete mine[n];
+	    }
+	} ) );
+    }
+    for( std::size_t i = 0; i < threads.size(); ++i ) threads[i].join();
+    for( int f = 0; f < nfiles; ++f ) {
+	numbad += bad[f];
+	std::remove( file_name( f ).c_str() );
+    }
+
+    // the user data of other code at index 0 is left alone
+    std::ostringstream os;
+    int other = 42;
+    os.pword( 0 ) = &other;
+    os.iword( 0 ) = 7;
+    {
+	HepMC::IO_GenEvent out( os );
+	HepMC::GenEvent* evt = build_event( 0, 1 );
+	out << evt;
+	delete evt;
+    }
+    if( os.pword( 0 ) != &other || os.iword( 0 ) != 7 ) {
+	std::cerr << "ERROR: user data of the stream overwritten" << std::endl;
+	++numbad;
+    }
+
+    // a stream whose format is copied gets its own stream data
+    std::istringstream is( os.str() );
+    std::istringstream is2( os.str() );
+    HepMC::GenEvent first;
+    is >> first;
+    is2.copyfmt( is );
+    HepMC::GenEvent second;
+    is2 >> second;
+    if( !is || !is2 || first.fingerprint() != second.fingerprint() ) {
+	std::cerr << "ERROR: reading from a stream with a copied format" << std::endl;
+	++numbad;
+    }
+
+    if( numbad > 0 ) std::cerr << numbad << " errors in testStreamThreads" << std::endl;
+    return numbad;
+}
@@ -0,0 +1,153 @@
+//////////////////////////////////////////////////////////////////////////
+// testTruthSkimmer.cc
+//
+// check that TruthSkimmer keeps the same particles as the GenVertex
+// iterators, with the same barcodes and links
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/TruthSkimmer.h"
+
+#include "testEvents.h"
+
+// the barcodes of the seeds and their relatives, found with the iterators
+std::set<int> expected( const std::vector<const HepMC::GenParticle*>& seeds,
+                        const HepMC::GenEvent& evt, bool hard )
+{
+    std::set<int> bc;
+    for( std::size_t i = 0; i < seeds.size(); ++i ) {
+	bc.insert( seeds[i]->barcode() );
+	if( HepMC::GenVertex* v = seeds[i]->production_vertex() ) {
+	    for( HepMC::GenVertex::particle_iterator p = v->particles_begin( HepMC::ancestors );
+		 p != v->particles_end( HepMC::ancestors ); ++p ) bc.insert( (*p)->barcode() );
+	}
+	if( HepMC::GenVertex* v = seeds[i]->end_vertex() ) {
+	    for( HepMC::GenVertex::particle_iterator p = v->particles_begin( HepMC::descendants );
+		 p != v->particles_end( HepMC::descendants ); ++p ) bc.insert( (*p)->barcode() );
+	}
+    }
+    if( hard ) {
+	HepMC::GenVertex* v = evt.signal_process_vertex();
+	for( HepMC::GenVertex::particle_iterator p = v->particles_begin( HepMC::family );
+	     p != v->particles_end( HepMC::family ); ++p ) bc.insert( (*p)->barcode() );
+    }
+    return bc;
+}
+
+std::set<int> barcodes( const HepMC::GenEvent& evt )
+{
+    std::set<int> bc;
+    for( HepMC::GenEvent::particle_const_iterator p = evt.particles_begin();
+	 p != evt.particles_end(); ++p ) bc.insert( (*p)->barcode() );
+    return bc;
+}
+
+int barcode( const HepMC::GenVertex* v ) { return v ? v->barcode() : 0; }
+
+// every copied particle has the vertices and properties of the original
+int check_copy( const HepMC::GenEvent& skim, const HepMC::GenEvent& evt )
+{
+    int numbad = 0;
+    for( HepMC::GenEvent::particle_const_iterator p = skim.particles_begin();
+	 p != skim.particles_end(); ++p ) {
+	const HepMC::GenParticle* orig = evt.barcode_to_particle( (*p)->barcode() );
+	if( !orig || orig->pdg_id() != (*p)->pdg_id() || orig->status() != (*p)->status()
+	    || barcode( orig->production_vertex() ) != barcode( (*p)->production_vertex() )
+	    || barcode( orig->end_vertex() ) != barcode( (*p)->end_vertex() ) ) {
+	    std::cerr << "ERROR: particle " << (*p)->barcode() << " is not copied correctly" << std::endl;
+	    ++numbad;
+	}
+    }
+    for( HepMC::GenEvent::vertex_const_iterator v = skim.vertices_begin();
+	 v != skim.vertices_end(); ++v ) {
+	const HepMC::GenVertex* orig = evt.barcode_to_vertex( (*v)->barcode() );
+	if( !orig || orig->position().z() != (*v)->position().z() || orig->id() != (*v)->id() ) {
+	    std::cerr << "ERROR: vertex " << (*v)->barcode() << " is not copied correctly" << std::endl;
+	    ++numbad;
+	}
+    }
+    return numbad;
+}
+
+int main()
+{
+    int numbad = 0;
+    HepMC::GenEvent* evt = make_balanced_shower( 2000 );
+
+    // seeds sharing most of their ancestry
+    std::vector<const HepMC::GenParticle*> seeds;
+    seeds.push_back( evt->barcode_to_particle( 10500 ) );
+    seeds.push_back( evt->barcode_to_particle( 10501 ) );
+    seeds.push_back( evt->barcode_to_particle( 11000 ) );
+    seeds.push_back( evt->barcode_to_particle( 10040 ) );
+
+    HepMC::TruthSkimmer skimmer;
+    HepMC::GenEvent skim;
+    std::size_t n = skimmer.skim( *evt, seeds, skim );
+    std::set<int> want = expected( seeds, *evt, true );
+    if( barcodes( skim ) != want || n != want.size() ) {
+	std::cerr << "ERROR: skim keeps " << n << " particles, expected " << want.size() << std::endl;
+	++numbad;
+    }
+    numbad += check_copy( skim, *evt );
+    if( !skim.signal_process_vertex() || skim.signal_process_vertex()->barcode() != -1
+	|| !skim.valid_beam_particles() || skim.event_number() != 1 ) {
+	std::cerr << "ERROR: event information is not copied" << std::endl;
+	++numbad;
+    }
+
+    // without the hard process
+    skimmer.set_keep_hard_process( false );
+    skimmer.skim( *evt, seeds, skim );
+    if( barcodes( skim ) != expected( seeds, *evt, false ) ) {
+	std::cerr << "ERROR: skim without hard process is wrong" << std::endl;
+	++numbad;
+    }
+
+    // parents and children only
+    HepMC::TruthSkimmer near( 1, 1, false );
+    std::vector<const HepMC::GenParticle*> one( 1, evt->barcode_to_particle( 10500 ) );
+    near.skim( *evt, one, skim );
+    std::set<int> family;
+    family.insert( 10500 );
+    const HepMC::GenVertex* prod = one[0]->production_vertex();
+    const HepMC::GenVertex* end = one[0]->end_vertex();
+    family.insert( (*prod->particles_in_const_begin())->barcode() );
+    for( HepMC::GenVertex::particles_out_const_iterator p = end->particles_out_const_begin();
+	 p != end->particles_out_const_end(); ++p ) family.insert( (*p)->barcode() );
+    // the vertices of the grandparent and of the children are copied too
+    if( barcodes( skim ) != family || skim.vertices_size() != 5 ) {
+	std::cerr << "ERROR: skim of one generation is wrong" << std::endl;
+	++numbad;
+    }
+    numbad += check_copy( skim, *evt );
+
+    // seeds by predicate: no relatives, so each seed is on its own
+    HepMC::TruthSkimmer alone( 0, 0, false );
+    alone.skim( *evt, [] ( const HepMC::GenParticle* p ) { return p->barcode() % 100 == 0; }, skim );
+    if( skim.particles_size() != 40 ) {
+	std::cerr << "ERROR: " << skim.particles_size() << " seeds selected, not 40" << std::endl;
+	++numbad;
+    }
+    delete evt;
+
+    // many seeds, with overlapping genealogies
+    evt = make_balanced_shower( 2000 );
+    seeds.clear();
+    for( int bc = 10100; bc < 14000; bc += 100 ) seeds.push_back( evt->barcode_to_particle( bc ) );
+    want = expected( seeds, *evt, true );
+    skimmer.set_keep_hard_process( true );
+    n = skimmer.skim( *evt, seeds, skim );
+    if( n != want.size() ) {
+	std::cerr << "ERROR: " << n << " particles kept for many seeds, not " << want.size() << std::endl;
+	++numbad;
+    }
+    delete evt;
+
+    if( numbad > 0 ) std::cerr << numbad << " errors in testTruthSkimmer" << std::endl;
+    return numbad;
+}
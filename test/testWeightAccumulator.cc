@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////////////////
+// testWeightAccumulator.cc
+//
+// test WeightAccumulator
+//////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "HepMC/WeightContainer.h"
+#include "HepMC/WeightAccumulator.h"
+
+bool close( double a, double b ) { return std::fabs(a-b) < 1.e-12*(1.+std::fabs(a)); }
+
+// count an error if ok is false
+int check( bool ok, const std::string& what )
+{
+    if( ok ) return 0;
+    std::cerr << "ERROR: " << what << std::endl;
+    return 1;
+}
+
+int main() {
+
+   int numbad = 0;
+
+   HepMC::WeightContainer w;
+   w["nominal"] = 0.;
+   w["up"] = 0.;
+   w["down"] = 0.;
+
+   // two "workers", each with its own accumulator
+   HepMC::WeightAccumulator acc1;
+   HepMC::WeightAccumulator acc2( w );
+   for( int i = 1; i <= 10; ++i ) {
+       HepMC::WeightContainer wi( w );   // shares the names
+       wi["nominal"] = 1.0*i;
+       wi["up"] = 2.0*i;
+       wi["down"] = 0.5*i;
+       if( i%2 ) acc1.add( wi );
+       else      acc2.add( wi );
+   }
+   numbad += check( acc1.entries() == 5 && acc2.entries() == 5, "entries per worker" );
+   numbad += check( acc1.size() == 3, "weights of the first worker" );
+
+   // an event with its own copy of the names, in a different order
+   HepMC::WeightContainer other;
+   other["up"] = 2.0;
+   other["nominal"] = 1.0;
+   other["down"] = 0.5;
+   other["extra"] = 3.0;
+   acc2.add( other );
+   numbad += check( acc2.size() == 4, "new name not added" );
+
+   HepMC::WeightAccumulator total;
+   total += acc1;
+   total += acc2;
+   numbad += check( total.entries() == 11, "total entries" );
+   numbad += check( total.size() == 4, "total weights" );
+   numbad += check( close( total.sum_of_weights( total.index("nominal") ), 56. ),
+                    "sum of nominal weights" );
+   numbad += check( close( total.sum_of_weights( total.index("up") ), 112. ),
+                    "sum of up weights" );
+   numbad += check( close( total.sum_of_squared_weights( total.index("nominal") ), 386. ),
+                    "sum of squared nominal weights" );
+   numbad += check( close( total.sum_of_weights( total.index("extra") ), 3. ),
+                    "sum of extra weights" );
+   numbad += check( total.index("bad") == total.size(), "index of an unknown name" );
+   numbad += check( close( total.sums()["down"], 28. ), "sums by name" );
+
+   HepMC::GenCrossSection xs = total.cross_section("nominal");
+   numbad += check( close( xs.cross_section(), 56./11. ), "cross section" );
+   numbad += check( close( xs.cross_section_error(), std::sqrt( (386./11. - 56.*56./121.)/11. ) ),
+                    "cross section error" );
+   numbad += check( close( total.effective_entries(0),
+                           total.sum_of_weights(0)*total.sum_of_weights(0)/total.sum_of_squared_weights(0) ),
+                    "effective entries" );
+
+   total.write();
+
+   total.reset();
+   numbad += check( total.entries() == 0 && total.size() == 4, "entries after reset" );
+   numbad += check( total.sum_of_weights(0) == 0., "sums after reset" );
+
+   if( numbad > 0 ) std::cerr << numbad << " errors in testWeightAccumulator" << std::endl;
+   return numbad;
+}
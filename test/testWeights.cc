@@ -10,11 +10,25 @@
 #include <string>
 #include <vector>
 
+#include <sstream>
+
 #include "HepMC/WeightContainer.h"
+#include "HepMC/WeightHandle.h"
+#include "HepMC/GenEvent.h"
+#include "HepMC/IO_GenEvent.h"
 #include <stdexcept>
 
+// count an error if ok is false
+int check( bool ok, const std::string& what )
+{
+    if( ok ) return 0;
+    std::cerr << "ERROR: " << what << std::endl;
+    return 1;
+}
+
 int main() {
 
+   int numbad = 0;
    HepMC::WeightContainer w;
 
    // original functionality
@@ -67,5 +81,79 @@ int main() {
 
    w.write();
 
-   return 0;
+   // copies share the names until one of them changes
+   HepMC::WeightContainer wcopy = w;
+   numbad += check( wcopy.shares_names_with(w), "copy does not share the names" );
+   numbad += check( wcopy == w, "copy differs" );
+   wcopy["extra"] = 1.5;
+   numbad += check( !wcopy.shares_names_with(w), "names still shared after adding one" );
+   numbad += check( !w.has_key("extra") && wcopy.has_key("extra"),
+                    "new name not only in the copy" );
+   numbad += check( w.size() == vs+1, "original changed with the copy" );
+   wcopy.clear();
+   numbad += check( wcopy.empty() && !wcopy.has_key(nm), "clear of the copy" );
+   numbad += check( w[nm] == 3.1, "original cleared with the copy" );
+
+   // events read from one stream share their weight names
+   std::stringstream ios;
+   {
+       HepMC::IO_GenEvent out( static_cast<std::ostream&>(ios) );
+       for( int i = 1; i < 3; ++i ) {
+	   HepMC::GenEvent evt( 20, i );
+	   evt.weights()["nominal"] = 1.0*i;
+	   evt.weights()["scale_up"] = 2.0*i;
+	   HepMC::GenVertex* v = new HepMC::GenVertex();
+	   v->add_particle_out( new HepMC::GenParticle( HepMC::FourVector(0,0,1,1), 22, 1 ) );
+	   evt.add_vertex( v );
+	   out.write_event( &evt );
+       }
+   }
+   HepMC::IO_GenEvent in( static_cast<std::istream&>(ios) );
+   HepMC::GenEvent* e1 = in.read_next_event();
+   HepMC::GenEvent* e2 = in.read_next_event();
+   if( !e1 || !e2 ) {
+       std::cerr << "ERROR: events not read back" << std::endl;
+       return numbad + 1;
+   }
+   numbad += check( e1->weights().shares_names_with( e2->weights() ),
+                    "events read from one stream do not share the names" );
+   numbad += check( e2->weights()["scale_up"] == 4.0 && e1->weights()["nominal"] == 1.0,
+                    "weights read back by name" );
+
+   // resolved handles
+   HepMC::WeightHandle hup( "scale_up", static_cast<std::istream&>(ios) );
+   HepMC::WeightHandle hnom( "nominal" );
+   numbad += check( hup.is_found() && hup.is_valid_for( e1->weights() ),
+                    "handle resolved from the stream" );
+   numbad += check( !hnom.is_valid_for( e1->weights() ), "unresolved handle valid" );
+   numbad += check( e1->weights()[hup] == 2.0 && e2->weights()[hup] == 4.0,
+                    "weights by resolved handle" );
+   numbad += check( e2->weights()[hnom] == 2.0, "weight by unresolved handle" );
+   numbad += check( hnom.is_valid_for( e1->weights() ), "handle not resolved by a lookup" );
+   std::vector<HepMC::WeightHandle> handles;
+   handles.push_back( hnom );
+   handles.push_back( hup );
+   std::vector<double> values = HepMC::get_weights( e2->weights(), handles );
+   numbad += check( values.size() == 2 && values[0] == 2.0 && values[1] == 4.0,
+                    "get_weights" );
+   // changing the names of one event invalidates the handle for that event only
+   e2->weights()["extra"] = 7.0;
+   numbad += check( !hup.is_valid_for( e2->weights() ), "handle valid for changed names" );
+   numbad += check( hup.is_valid_for( e1->weights() ), "handle invalid for unchanged names" );
+   numbad += check( e2->weights()[hup] == 4.0, "weight by handle after the names changed" );
+   HepMC::WeightHandle hbad( "bad", e1->weights() );
+   numbad += check( !hbad.is_found(), "handle of a nonexistent name found" );
+   try {
+       double x = e1->weights()[hbad];
+       std::cout << "lookup of nonexistent handle returns " << x << std::endl;
+   }
+   catch (std::exception& e) {
+       std::cout << e.what() << std::endl;
+       std::cout << "HepMC testWeights: the above error is intentional" << std::endl;
+   }
+   delete e1;
+   delete e2;
+
+   if( numbad > 0 ) std::cerr << numbad << " errors in testWeights" << std::endl;
+   return numbad;
 }
@@ -0,0 +1,212 @@
+//////////////////////////////////////////////////////////////////////////
+// hepmc-diff.cc
+//
+// Compare the events of two HepMC ascii files pairwise.
+//
+// usage: hepmc-diff [-t tolerance] [-n max_differences] [-j threads]
+//                   [-b batch_size] file1 file2
+//
+// The files are split into the text of single events on one thread,
+// which is cheap; decoding and comparing the events, which is not, is
+// shared among the threads of a ThreadPool, a batch of events at a time.
+//
+// Output: the first max_differences differences, one per line, with the
+// tab separated columns
+//     event index, event number, object, barcode, field, value1, value2
+// followed by a summary line starting with '#'.
+// The exit status is 0 if the files agree, 1 if they differ and 2 if
+// they could not be read.
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "HepMC/GenEvent.h"
+#include "HepMC/CompareGenEvent.h"
+#include "HepMC/ThreadPool.h"
+
+// split an ascii file into the text of its events
+class EventTextReader {
+public:
+    explicit EventTextReader( std::istream& is ) : m_is(is), m_start(), m_line(), m_have_line(false) {}
+
+    // the text of the next event, preceded by the start key of its block;
+    // false at the end of the file
+    bool next( std::string& text )
+    {
+	// find the next event line
+	bool found = false;
+	while ( !found && get_line() ) {
+	    m_have_line = false;
+	    if ( m_line.compare( 0, 2, "E " ) == 0 ) {
+		found = true;
+	    } else if ( m_line.find( "START_EVENT_LISTING" ) != std::string::npos ) {
+		m_start = m_line;
+	    }
+	}
+	if ( !found ) return false;
+	text = m_start;
+	text += '\n';
+	text += m_line;
+	text += '\n';
+	// the event ends at the next event line or key
+	while ( get_line() ) {
+	    if ( m_line.compare( 0, 2, "E " ) == 0 || m_line.compare( 0, 7, "HepMC::" ) == 0 ) break;
+	    m_have_line = false;
+	    text += m_line;
+	    text += '\n';
+	}
+	return true;
+    }
+
+private:
+    bool get_line()
+    {
+	if ( !m_have_line ) m_have_line = static_cast<bool>( std::getline( m_is, m_line ) );
+	return m_have_line;
+    }
+
+    std::istream& m_is;
+    std::string   m_start;     // the last start key
+    std::string   m_line;      // the current line
+    bool          m_have_line; // m_line is read but not used yet
+};
+
+// a pair of events and the result of their comparison
+struct EventPair {
+    std::string text1;
+    std::string text2;
+    bool        have1;
+    bool        have2;
+    int         event_number;
+    bool        differ;
+    std::vector<HepMC::GenEventDifference> differences;
+};
+
+// decode one event; false if the text cannot be read
+bool decode( const std::string& text, HepMC::GenEvent& evt )
+{
+    std::istringstream is( text );
+    evt.read( is );
+    return !is.bad();
+}
+
+void compare( EventPair& pair, double tolerance, std::size_t max_differences )
+{
+    pair.differences.clear();
+    HepMC::GenEvent e1, e2;
+    bool ok1 = pair.have1 && decode( pair.text1, e1 );
+    bool ok2 = pair.have2 && decode( pair.text2, e2 );
+    pair.event_number = pair.have1 ? e1.event_number() : e2.event_number();
+    if ( ok1 && ok2 ) {
+	pair.differ = !HepMC::compareGenEvent( e1, e2, tolerance, pair.differences,
+	                                       max_differences );
+	return;
+    }
+    // a missing or unreadable event
+    HepMC::GenEventDifference d;
+    d.object = "event";
+    d.barcode = 0;
+    d.field = ( pair.have1 && pair.have2 ) ? "read" : "presence";
+    d.first = !pair.have1 ? "absent" : ok1 ? "present" : "error";
+    d.second = !pair.have2 ? "absent" : ok2 ? "present" : "error";
+    pair.differences.push_back( d );
+    pair.differ = true;
+}
+
+void usage()
+{
+    std::cerr << "usage: hepmc-diff [-t tolerance] [-n max_differences] [-j threads]"
+	      << " [-b batch_size] file1 file2\n"
+	      << "  -t  relative tolerance for floating point values (default 0)\n"
+	      << "  -n  number of differences to print, 0 for all (default 10)\n"
+	      << "  -j  number of threads, 0 for one per hardware thread (default 0)\n"
+	      << "  -b  number of events decoded together (default 256)" << std::endl;
+}
+
+int main( int argc, char** argv )
+{
+    double tolerance = 0;
+    std::size_t max_differences = 10;
+    unsigned nthreads = 0;
+    std::size_t batch_size = 256;
+    std::vector<std::string> files;
+    for ( int i = 1; i < argc; ++i ) {
+	std::string arg( argv[i] );
+	if ( ( arg == "-t" || arg == "-n" || arg == "-j" || arg == "-b" ) && i + 1 < argc ) {
+	    const char* value = argv[++i];
+	    if ( arg == "-t" ) tolerance = std::atof( value );
+	    if ( arg == "-n" ) max_differences = std::strtoul( value, 0, 10 );
+	    if ( arg == "-j" ) nthreads = std::strtoul( value, 0, 10 );
+	    if ( arg == "-b" ) batch_size = std::strtoul( value, 0, 10 );
+	} else if ( arg.size() > 1 && arg[0] == '-' ) {
+	    usage();
+	    return 2;
+	} else {
+	    files.push_back( arg );
+	}
+    }
+    if ( files.size() != 2 || batch_size == 0 ) {
+	usage();
+	return 2;
+    }
+    std::ifstream in1( files[0].c_str() );
+    std::ifstream in2( files[1].c_str() );
+    if ( !in1 || !in2 ) {
+	std::cerr << "hepmc-diff: cannot open " << ( !in1 ? files[0] : files[1] ) << std::endl;
+	return 2;
+    }
+    EventTextReader reader1( in1 );
+    EventTextReader reader2( in2 );
+    HepMC::ThreadPool pool( nthreads );
+
+    std::vector<EventPair> batch( batch_size );
+    std::size_t nevents = 0, ndiffer = 0, nprinted = 0;
+    bool errors = false;
+    std::cout << "# event\tnumber\tobject\tbarcode\tfield\t" << files[0] << "\t" << files[1] << "\n";
+    std::cout.precision( 17 );
+    for ( bool more = true; more; ) {
+	std::size_t n = 0;
+	while ( n < batch_size ) {
+	    EventPair& pair = batch[n];
+	    pair.have1 = reader1.next( pair.text1 );
+	    pair.have2 = reader2.next( pair.text2 );
+	    if ( !pair.have1 && !pair.have2 ) {
+		more = false;
+		break;
+	    }
+	    ++n;
+	}
+	// once enough differences are printed, the events are only counted
+	std::size_t budget = max_differences == 0 ? 0
+	    : nprinted < max_differences ? max_differences - nprinted : 1;
+	pool.run( n, [&]( std::size_t begin, std::size_t end ) {
+			 for ( std::size_t i = begin; i < end; ++i ) {
+			     compare( batch[i], tolerance, budget );
+			 }
+		     }, 1 );
+	for ( std::size_t i = 0; i < n; ++i, ++nevents ) {
+	    const EventPair& pair = batch[i];
+	    if ( !pair.differ ) continue;
+	    ++ndiffer;
+	    for ( std::size_t j = 0; j < pair.differences.size(); ++j ) {
+		const HepMC::GenEventDifference& d = pair.differences[j];
+		if ( d.field == "read" ) errors = true;
+		if ( max_differences > 0 && nprinted >= max_differences ) break;
+		std::cout << nevents << "\t" << pair.event_number << "\t"
+			  << d.object << "\t" << d.barcode << "\t" << d.field << "\t"
+			  << d.first << "\t" << d.second << "\n";
+		++nprinted;
+	    }
+	}
+    }
+    std::cout << "# " << nevents << " events compared, " << ndiffer << " differ, "
+	      << nprinted << " differences printed" << std::endl;
+    if ( errors ) return 2;
+    return ndiffer > 0 ? 1 : 0;
+}